@@ -336,6 +336,9 @@ enum
 /* some spare for header size as well */
 #define MDAT_LARGE_FILE_LIMIT           ((guint64) 1024 * 1024 * 1024 * 2)
 
+/* size of the buffers the fast-start temporary file is sent in */
+#define FAST_START_CHUNK_SIZE           (4 * 1024 * 1024)
+
 #define DEFAULT_MOVIE_TIMESCALE         0
 #define DEFAULT_TRAK_TIMESCALE          0
 #define DEFAULT_DO_CTTS                 TRUE
@@ -1951,6 +1954,36 @@ gst_qt_mux_seek_to_beginning (FILE * f)
   return TRUE;
 }
 
+#ifdef G_OS_UNIX
+/* Sends the mapped temporary file in buffers that wrap the mapping, so that
+ * the data goes from the page cache to downstream without being copied */
+static GstFlowReturn
+gst_qt_mux_send_mapped_data (GstQTMux * qtmux, GMappedFile * mapped,
+    guint64 * offset)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  gchar *data;
+  gsize size, pos, chunk;
+
+  data = g_mapped_file_get_contents (mapped);
+  size = g_mapped_file_get_length (mapped);
+
+  GST_DEBUG_OBJECT (qtmux, "Sending %" G_GSIZE_FORMAT " bytes of mapped data",
+      size);
+  for (pos = 0; pos < size && ret == GST_FLOW_OK; pos += chunk) {
+    GstBuffer *buf;
+
+    chunk = MIN (size - pos, FAST_START_CHUNK_SIZE);
+    buf = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, data + pos,
+        chunk, 0, chunk, g_mapped_file_ref (mapped),
+        (GDestroyNotify) g_mapped_file_unref);
+    ret = gst_qt_mux_send_buffer (qtmux, buf, offset, FALSE);
+  }
+
+  return ret;
+}
+#endif
+
 static GstFlowReturn
 gst_qt_mux_send_buffered_data (GstQTMux * qtmux, guint64 * offset)
 {
@@ -1960,15 +1993,41 @@ gst_qt_mux_send_buffered_data (GstQTMux * qtmux, guint64 * offset)
   if (fflush (qtmux->fast_start_file))
     goto flush_failed;
 
+#ifdef G_OS_UNIX
+  /* Less than one chunk is cheaper to read than to map */
+  if (qtmux->mdat_size >= FAST_START_CHUNK_SIZE) {
+    GMappedFile *mapped;
+    GError *err = NULL;
+
+    mapped = g_mapped_file_new_from_fd (fileno (qtmux->fast_start_file),
+        FALSE, &err);
+    if (mapped) {
+      ret = gst_qt_mux_send_mapped_data (qtmux, mapped, offset);
+      g_mapped_file_unref (mapped);
+
+      /* The buffers sent may outlive this function, and truncating the file
+       * below them would make reading them fault. Close and remove it
+       * instead, the space is released with the last buffer. */
+      fclose (qtmux->fast_start_file);
+      qtmux->fast_start_file = NULL;
+      g_remove (qtmux->fast_start_file_path);
+      return ret;
+    }
+
+    GST_DEBUG_OBJECT (qtmux, "Failed to map temporary file: %s, reading it",
+        err->message);
+    g_clear_error (&err);
+  }
+#endif
+
   if (!gst_qt_mux_seek_to_beginning (qtmux->fast_start_file))
     goto seek_failed;
 
   /* hm, this could all take a really really long time,
-   * but there may not be another way to get moov atom first
-   * (somehow optimize copy?) */
+   * but there may not be another way to get moov atom first */
   GST_DEBUG_OBJECT (qtmux, "Sending buffered data");
   while (ret == GST_FLOW_OK) {
-    const int bufsize = 4096;
+    const int bufsize = FAST_START_CHUNK_SIZE;
     GstMapInfo map;
     gsize size;
 
@@ -53,6 +53,7 @@
 #include <glib/gi18n-lib.h>
 
 #include <glib/gprintf.h>
+#include <glib/gstdio.h>
 #include <gst/base/base.h>
 #include <gst/tag/tag.h>
 #include <gst/audio/audio.h>
@@ -88,6 +89,17 @@
 /* if the sample index is larger than this, something is likely wrong */
 #define QTDEMUX_MAX_SAMPLE_INDEX_SIZE (200*1024*1024)
 
+/* stts entries between two entries of the stts lookup table */
+#define QTDEMUX_STTS_INDEX_INTERVAL 64
+
+/* size of the reads and writes of [mdat] data spilled to a temporary file */
+#define QTDEMUX_MDAT_SPILL_CHUNK_SIZE (256*1024)
+
+/* max. upcoming samples per stream considered for a read-ahead */
+#define QTDEMUX_READAHEAD_MAX_SAMPLES 4096
+/* max. size of a read-ahead, output buffers keep all of it alive */
+#define QTDEMUX_READAHEAD_MAX_SIZE (16*1024*1024)
+
 /* For converting qt creation times to unix epoch times */
 #define QTDEMUX_SECONDS_PER_DAY (60 * 60 * 24)
 #define QTDEMUX_LEAP_YEARS_FROM_1904_TO_1970 17
@@ -295,6 +307,20 @@ GST_STATIC_PAD_TEMPLATE ("meta_%u",
     GST_PAD_SOMETIMES,
     GST_STATIC_CAPS_ANY);
 
+#define DEFAULT_MAX_MDAT_BUFFER_SIZE (10 * 1024 * 1024)
+#define DEFAULT_MAX_MDAT_SPILL_SIZE 0
+#define DEFAULT_READAHEAD_SIZE 0
+#define DEFAULT_READAHEAD_TIME GST_SECOND
+
+enum
+{
+  PROP_0,
+  PROP_MAX_MDAT_BUFFER_SIZE,
+  PROP_MAX_MDAT_SPILL_SIZE,
+  PROP_READAHEAD_SIZE,
+  PROP_READAHEAD_TIME,
+};
+
 #define gst_qtdemux_parent_class parent_class
 G_DEFINE_TYPE (GstQTDemux, gst_qtdemux, GST_TYPE_ELEMENT);
 GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (qtdemux, "qtdemux",
@@ -302,6 +328,10 @@ GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (qtdemux, "qtdemux",
 
 static void gst_qtdemux_dispose (GObject * object);
 static void gst_qtdemux_finalize (GObject * object);
+static void gst_qtdemux_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_qtdemux_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static guint32
 gst_qtdemux_find_index_linear (GstQTDemux * qtdemux, QtDemuxStream * str,
@@ -336,6 +366,7 @@ static void gst_qtdemux_stream_check_and_change_stsd_index (GstQTDemux * demux,
     QtDemuxStream * stream);
 static GstFlowReturn gst_qtdemux_process_adapter (GstQTDemux * demux,
     gboolean force);
+static void gst_qtdemux_spill_close (GstQTDemux * demux);
 
 static void gst_qtdemux_check_seekability (GstQTDemux * demux);
 
@@ -408,6 +439,84 @@ gst_qtdemux_class_init (GstQTDemuxClass * klass)
 
   gobject_class->dispose = gst_qtdemux_dispose;
   gobject_class->finalize = gst_qtdemux_finalize;
+  gobject_class->set_property = gst_qtdemux_set_property;
+  gobject_class->get_property = gst_qtdemux_get_property;
+
+  /**
+   * GstQTDemux:max-mdat-buffer-size:
+   *
+   * In push mode, media data that comes before the headers has to be
+   * buffered until the headers were received, unless upstream can seek
+   * past it. This is the number of bytes of it that are kept in memory.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_MDAT_BUFFER_SIZE,
+      g_param_spec_uint64 ("max-mdat-buffer-size", "Max mdat buffer size",
+          "Maximum number of bytes of media data before the headers to keep "
+          "in memory in push mode", 0, G_MAXUINT64,
+          DEFAULT_MAX_MDAT_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQTDemux:max-mdat-spill-size:
+   *
+   * In push mode, media data before the headers that does not fit in
+   * #GstQTDemux:max-mdat-buffer-size is written to a temporary file, up to
+   * this number of bytes, and read back once the headers were parsed. This
+   * allows playing files with the headers at the end from non-seekable
+   * sources without holding all their media data in memory.
+   *
+   * 0 disables the temporary file.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_MDAT_SPILL_SIZE,
+      g_param_spec_uint64 ("max-mdat-spill-size", "Max mdat spill size",
+          "Maximum number of bytes of media data before the headers to write "
+          "to a temporary file in push mode (0 = disabled)", 0, G_MAXUINT64,
+          DEFAULT_MAX_MDAT_SPILL_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQTDemux:readahead-size:
+   *
+   * In pull mode, samples are normally read one by one, in timestamp order
+   * across all streams. With a read-ahead size set, a read also covers the
+   * upcoming samples of all streams that follow it in the file, within this
+   * many bytes and #GstQTDemux:readahead-time. The following samples are then
+   * served from that data, which turns the many small reads of poorly
+   * interleaved files into a few large sequential ones. This mostly helps
+   * with network file systems.
+   *
+   * Each stream keeps at most one such read around, and output buffers share
+   * its memory, so it stays allocated as long as any of them is. This is why
+   * the read-ahead size is limited to 16 MiB.
+   *
+   * 0 disables the read-ahead.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_READAHEAD_SIZE,
+      g_param_spec_uint ("readahead-size", "Read-ahead size",
+          "Maximum number of bytes of upcoming samples to read at once in "
+          "pull mode (0 = disabled)", 0, QTDEMUX_READAHEAD_MAX_SIZE,
+          DEFAULT_READAHEAD_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstQTDemux:readahead-time:
+   *
+   * Duration of the upcoming samples of each stream considered for the
+   * read-ahead, see #GstQTDemux:readahead-size.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_READAHEAD_TIME,
+      g_param_spec_uint64 ("readahead-time", "Read-ahead time",
+          "Duration of the upcoming samples of each stream to read at once "
+          "in pull mode", 0, G_MAXUINT64, DEFAULT_READAHEAD_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_qtdemux_change_state);
 #if 0
@@ -449,6 +558,10 @@ gst_qtdemux_init (GstQTDemux * qtdemux)
   gst_element_add_pad (GST_ELEMENT_CAST (qtdemux), qtdemux->sinkpad);
 
   qtdemux->adapter = gst_adapter_new ();
+  qtdemux->max_mdat_buffer_size = DEFAULT_MAX_MDAT_BUFFER_SIZE;
+  qtdemux->max_mdat_spill_size = DEFAULT_MAX_MDAT_SPILL_SIZE;
+  qtdemux->readahead_size = DEFAULT_READAHEAD_SIZE;
+  qtdemux->readahead_time = DEFAULT_READAHEAD_TIME;
   g_queue_init (&qtdemux->protection_event_queue);
   qtdemux->flowcombiner = gst_flow_combiner_new ();
   g_mutex_init (&qtdemux->expose_lock);
@@ -482,6 +595,7 @@ gst_qtdemux_dispose (GObject * object)
     g_object_unref (G_OBJECT (qtdemux->adapter));
     qtdemux->adapter = NULL;
   }
+  gst_qtdemux_spill_close (qtdemux);
   gst_tag_list_unref (qtdemux->tag_list);
   gst_flow_combiner_free (qtdemux->flowcombiner);
   g_queue_clear_full (&qtdemux->protection_event_queue,
@@ -497,6 +611,60 @@ gst_qtdemux_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static void
+gst_qtdemux_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstQTDemux *qtdemux = GST_QTDEMUX (object);
+
+  GST_OBJECT_LOCK (qtdemux);
+  switch (prop_id) {
+    case PROP_MAX_MDAT_BUFFER_SIZE:
+      qtdemux->max_mdat_buffer_size = g_value_get_uint64 (value);
+      break;
+    case PROP_MAX_MDAT_SPILL_SIZE:
+      qtdemux->max_mdat_spill_size = g_value_get_uint64 (value);
+      break;
+    case PROP_READAHEAD_SIZE:
+      qtdemux->readahead_size = g_value_get_uint (value);
+      break;
+    case PROP_READAHEAD_TIME:
+      qtdemux->readahead_time = g_value_get_uint64 (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (qtdemux);
+}
+
+static void
+gst_qtdemux_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstQTDemux *qtdemux = GST_QTDEMUX (object);
+
+  GST_OBJECT_LOCK (qtdemux);
+  switch (prop_id) {
+    case PROP_MAX_MDAT_BUFFER_SIZE:
+      g_value_set_uint64 (value, qtdemux->max_mdat_buffer_size);
+      break;
+    case PROP_MAX_MDAT_SPILL_SIZE:
+      g_value_set_uint64 (value, qtdemux->max_mdat_spill_size);
+      break;
+    case PROP_READAHEAD_SIZE:
+      g_value_set_uint (value, qtdemux->readahead_size);
+      break;
+    case PROP_READAHEAD_TIME:
+      g_value_set_uint64 (value, qtdemux->readahead_time);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (qtdemux);
+}
+
 static void
 gst_qtdemux_post_no_playable_stream_error (GstQTDemux * qtdemux)
 {
@@ -895,6 +1063,227 @@ gst_qtdemux_find_index (GstQTDemux * qtdemux, QtDemuxStream * str,
   return index;
 }
 
+static gint
+find_stts_func (QtDemuxSttsIndexEntry * e, guint64 * mov_time,
+    gpointer user_data)
+{
+  if (e->timestamp > *mov_time)
+    return 1;
+  if (e->timestamp == *mov_time)
+    return 0;
+
+  return -1;
+}
+
+/* build the table to look samples up by time in the stts, must be called with
+ * the object lock */
+static gboolean
+qtdemux_stts_lookup_build (GstQTDemux * qtdemux, QtDemuxStream * str)
+{
+  GstByteReader stts;
+  guint64 timestamp = 0;
+  guint32 sample = 0;
+  guint i;
+
+  gst_byte_reader_init (&stts, str->stts.data, str->stts.size);
+  if (!gst_byte_reader_set_pos (&stts, str->stts_entries_pos))
+    goto failed;
+
+  str->stts_lookup = g_new (QtDemuxSttsIndexEntry,
+      str->n_sample_times / QTDEMUX_STTS_INDEX_INTERVAL + 1);
+  str->n_stts_lookup = 0;
+
+  for (i = 0; i < str->n_sample_times && sample < str->n_samples; i++) {
+    guint32 count;
+    gint32 duration;
+
+    count = gst_byte_reader_get_uint32_be_unchecked (&stts);
+    duration = gst_byte_reader_get_int32_be_unchecked (&stts);
+
+    /* timestamps are not ordered anymore */
+    if (duration < 0)
+      goto failed;
+
+    if (i % QTDEMUX_STTS_INDEX_INTERVAL == 0) {
+      QtDemuxSttsIndexEntry *entry = &str->stts_lookup[str->n_stts_lookup++];
+
+      entry->entry = i;
+      entry->sample = sample;
+      entry->timestamp = timestamp;
+    }
+
+    sample += MIN (count, str->n_samples - sample);
+    timestamp += (guint64) count * duration;
+  }
+
+  GST_DEBUG_OBJECT (qtdemux, "track-id %u: %u stts lookup entries for %u "
+      "stts entries", str->track_id, str->n_stts_lookup, str->n_sample_times);
+
+  return TRUE;
+
+failed:
+  {
+    GST_DEBUG_OBJECT (qtdemux, "track-id %u: stts can't be searched",
+        str->track_id);
+    g_free (str->stts_lookup);
+    str->stts_lookup = NULL;
+    str->n_stts_lookup = 0;
+    str->stts_lookup_failed = TRUE;
+    return FALSE;
+  }
+}
+
+/* find the index of the last sample with a DTS before or at @mov_time from
+ * the run-length encoded stts, without parsing the samples up to it
+ *
+ * Returns FALSE if the stts can't be used for this.
+ */
+static gboolean
+qtdemux_stts_lookup (GstQTDemux * qtdemux, QtDemuxStream * str,
+    guint64 mov_time, guint32 * index)
+{
+  QtDemuxSttsIndexEntry *entry;
+  GstByteReader stts;
+  guint64 timestamp;
+  guint32 sample, result;
+  guint i;
+  gboolean ret = FALSE;
+
+  GST_OBJECT_LOCK (qtdemux);
+  if (str->chunks_are_samples || !str->stts.data || str->stts_lookup_failed)
+    goto done;
+
+  if (!str->stts_lookup && !qtdemux_stts_lookup_build (qtdemux, str))
+    goto done;
+
+  entry = gst_util_array_binary_search (str->stts_lookup, str->n_stts_lookup,
+      sizeof (QtDemuxSttsIndexEntry), (GCompareDataFunc) find_stts_func,
+      GST_SEARCH_MODE_BEFORE, &mov_time, NULL);
+  if (!entry)
+    goto done;
+
+  /* walk the few stts entries from there */
+  gst_byte_reader_init (&stts, str->stts.data, str->stts.size);
+  gst_byte_reader_set_pos (&stts, str->stts_entries_pos + entry->entry * 8);
+  timestamp = entry->timestamp;
+  sample = result = entry->sample;
+
+  for (i = entry->entry; i < str->n_sample_times; i++) {
+    guint32 count, duration;
+
+    count = gst_byte_reader_get_uint32_be_unchecked (&stts);
+    duration = gst_byte_reader_get_uint32_be_unchecked (&stts);
+
+    if (count == 0)
+      continue;
+    if (timestamp > mov_time || sample >= str->n_samples)
+      break;
+
+    if (duration > 0 && mov_time - timestamp < (guint64) count * duration) {
+      result = sample + (mov_time - timestamp) / duration;
+      break;
+    }
+
+    result = sample + count - 1;
+    sample += count;
+    timestamp += (guint64) count * duration;
+  }
+
+  /* samples without stts entry get the last timestamp */
+  if (i == str->n_sample_times && timestamp <= mov_time)
+    result = str->n_samples - 1;
+
+  *index = MIN (result, str->n_samples - 1);
+  ret = TRUE;
+
+done:
+  GST_OBJECT_UNLOCK (qtdemux);
+
+  return ret;
+}
+
+/* find the position of the first entry of a sync sample table that is at or
+ * after @sample */
+static guint32
+qtdemux_sync_table_search (const guint8 * entries, guint32 n_entries,
+    guint32 sample)
+{
+  guint32 low = 0, high = n_entries;
+
+  while (low < high) {
+    guint32 mid = low + (high - low) / 2;
+
+    if (GST_READ_UINT32_BE (entries + mid * 4) < sample)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return low;
+}
+
+/* check that the sample numbers of a sync sample table are valid and strictly
+ * increasing, as qtdemux_sync_table_search() needs */
+static gboolean
+qtdemux_sync_table_is_sorted (const guint8 * entries, guint32 n_entries)
+{
+  guint32 i, prev = 0;
+
+  for (i = 0; i < n_entries; i++) {
+    guint32 sample = GST_READ_UINT32_BE (entries + i * 4);
+
+    if (sample <= prev)
+      return FALSE;
+    prev = sample;
+  }
+
+  return TRUE;
+}
+
+/* find the index of the first keyframe at or after @index from the stss and
+ * stps, without parsing the samples up to it. @kf_index is set to the number
+ * of samples if there is no such keyframe.
+ *
+ * Returns FALSE if the sync sample tables can't be used for this.
+ */
+static gboolean
+qtdemux_sync_lookup (GstQTDemux * qtdemux, QtDemuxStream * str, guint32 index,
+    guint32 * kf_index)
+{
+  guint32 result = G_MAXUINT32;
+  guint32 pos;
+  gboolean ret = FALSE;
+
+  GST_OBJECT_LOCK (qtdemux);
+  if (str->chunks_are_samples || !str->stss_present || !str->stss.data
+      || !str->n_sample_syncs || !str->sync_tables_sorted)
+    goto done;
+
+  /* entries are after version, flags and count, and count samples from 1 */
+  pos = qtdemux_sync_table_search (str->stss.data + 8, str->n_sample_syncs,
+      index + 1);
+  if (pos < str->n_sample_syncs)
+    result = GST_READ_UINT32_BE (str->stss.data + 8 + pos * 4);
+
+  if (str->stps_present && str->stps.data && str->n_sample_partial_syncs) {
+    pos = qtdemux_sync_table_search (str->stps.data + 8,
+        str->n_sample_partial_syncs, index + 1);
+    if (pos < str->n_sample_partial_syncs)
+      result = MIN (result, GST_READ_UINT32_BE (str->stps.data + 8 + pos * 4));
+  }
+
+  if (result > str->n_samples)
+    *kf_index = str->n_samples;
+  else
+    *kf_index = result - 1;
+  ret = TRUE;
+
+done:
+  GST_OBJECT_UNLOCK (qtdemux);
+
+  return ret;
+}
+
 
 
 /* find the index of the sample that includes the data for @media_offset using a
@@ -962,6 +1351,12 @@ gst_qtdemux_find_index_linear (GstQTDemux * qtdemux, QtDemuxStream * str,
   sample = str->samples + str->stbl_index;
   if (str->stbl_index >= 0 && mov_time <= sample->timestamp) {
     index = gst_qtdemux_find_index (qtdemux, str, media_time);
+    sample = str->samples + index;
+  } else if (qtdemux_stts_lookup (qtdemux, str, mov_time, &index)) {
+    /* else find it in the stts and parse up to it in one go */
+    if (!qtdemux_parse_samples (qtdemux, str, index))
+      goto parse_failed;
+
     sample = str->samples + index;
   } else {
     while (index < str->n_samples - 1) {
@@ -1017,6 +1412,18 @@ gst_qtdemux_find_keyframe (GstQTDemux * qtdemux, QtDemuxStream * str,
     goto beach;
   }
 
+  /* look the next keyframe up in the sync sample tables and parse up to it
+   * in one go, the search below then stops right away */
+  if (next && qtdemux_sync_lookup (qtdemux, str, index, &new_index)) {
+    if (new_index < str->n_samples) {
+      if (!qtdemux_parse_samples (qtdemux, str, new_index))
+        goto parse_failed;
+      /* tables not sorted, search sample by sample */
+      if (!str->samples[new_index].keyframe)
+        new_index = index;
+    }
+  }
+
   /* else search until we have a keyframe */
   while (new_index < str->n_samples) {
     if (next && !qtdemux_parse_samples (qtdemux, str, new_index))
@@ -1667,10 +2074,12 @@ gst_qtdemux_handle_src_event (GstPad * pad, GstObject * parent,
       gst_event_parse_seek_trickmode_interval (event,
           &qtdemux->trickmode_interval);
 
-      /* Build complete index for seeking;
+      /* Build complete index for seeking in push mode, where the samples
+       * are looked up by byte offset once upstream seeked;
        * if not a fragmented file at least and we're really doing a seek,
-       * not just an instant-rate-change */
-      if (!qtdemux->fragmented && !instant_rate_change) {
+       * not just an instant-rate-change. In pull mode, the seek only parses
+       * the samples up to its target */
+      if (!qtdemux->pullbased && !qtdemux->fragmented && !instant_rate_change) {
         if (!qtdemux_ensure_index (qtdemux))
           goto index_failed;
       }
@@ -2009,6 +2418,8 @@ gst_qtdemux_reset (GstQTDemux * qtdemux, gboolean hard)
       gst_buffer_unref (qtdemux->restoredata_buffer);
     qtdemux->mdatbuffer = NULL;
     qtdemux->restoredata_buffer = NULL;
+    qtdemux->mdat_buffer_left = 0;
+    gst_qtdemux_spill_close (qtdemux);
     qtdemux->mdatleft = 0;
     qtdemux->mdatsize = 0;
     if (qtdemux->comp_brands)
@@ -2501,6 +2912,10 @@ gst_qtdemux_stbl_free (QtDemuxStream * stream)
   stream->stsc.data = NULL;
   g_free ((gpointer) stream->stts.data);
   stream->stts.data = NULL;
+  g_free (stream->stts_lookup);
+  stream->stts_lookup = NULL;
+  stream->n_stts_lookup = 0;
+  stream->stts_lookup_failed = FALSE;
   g_free ((gpointer) stream->stss.data);
   stream->stss.data = NULL;
   g_free ((gpointer) stream->stps.data);
@@ -2529,11 +2944,15 @@ gst_qtdemux_stream_flush_samples_data (QtDemuxStream * stream)
   g_free (stream->ra_entries);
   stream->ra_entries = NULL;
   stream->n_ra_entries = 0;
+  stream->ra_entries_size = 0;
 
   stream->sample_index = -1;
   stream->stbl_index = -1;
   stream->n_samples = 0;
   stream->time_position = 0;
+  stream->readahead_window_start = 0;
+  stream->readahead_window_end = 0;
+  stream->readahead_window_sorted = 0;
 
   stream->n_samples_moof = 0;
   stream->duration_moof = 0;
@@ -2546,6 +2965,7 @@ gst_qtdemux_stream_clear (QtDemuxStream * stream)
   gint i;
   if (stream->allocator)
     gst_object_unref (stream->allocator);
+  gst_buffer_replace (&stream->readahead_buffer, NULL);
   while (stream->buffers) {
     gst_buffer_unref (GST_BUFFER_CAST (stream->buffers->data));
     stream->buffers = g_slist_delete_link (stream->buffers, stream->buffers);
@@ -3323,6 +3743,64 @@ check_update_duration (GstQTDemux * qtdemux, GstClockTime duration)
   }
 }
 
+/* find the position of the first random access entry after @pos */
+static guint
+qtdemux_ra_entries_search (QtDemuxStream * stream, GstClockTime pos)
+{
+  guint low = 0, high = stream->n_ra_entries;
+
+  while (low < high) {
+    guint mid = low + (high - low) / 2;
+
+    if (stream->ra_entries[mid].ts > pos)
+      high = mid;
+    else
+      low = mid + 1;
+  }
+
+  return low;
+}
+
+/* add the fragment at @moof_offset, which starts with a keyframe at @ts, to
+ * the random access entries so that later seeks can go there directly
+ * instead of scanning all fragments before it */
+static void
+qtdemux_stream_add_ra_entry (GstQTDemux * qtdemux, QtDemuxStream * stream,
+    GstClockTime ts, guint64 moof_offset)
+{
+  QtDemuxRandomAccessEntry *entry;
+  guint pos;
+
+  /* 0 means no next moof when seeking */
+  if (moof_offset == 0 || !GST_CLOCK_TIME_IS_VALID (ts))
+    return;
+
+  pos = qtdemux_ra_entries_search (stream, ts);
+
+  /* already known from the mfra or an earlier pass */
+  if ((pos > 0 && stream->ra_entries[pos - 1].moof_offset == moof_offset) ||
+      (pos < stream->n_ra_entries &&
+          stream->ra_entries[pos].moof_offset == moof_offset))
+    return;
+
+  if (stream->n_ra_entries == stream->ra_entries_size) {
+    stream->ra_entries_size = MAX (16, stream->ra_entries_size * 2);
+    stream->ra_entries = g_renew (QtDemuxRandomAccessEntry,
+        stream->ra_entries, stream->ra_entries_size);
+  }
+
+  entry = &stream->ra_entries[pos];
+  memmove (entry + 1, entry,
+      (stream->n_ra_entries - pos) * sizeof (QtDemuxRandomAccessEntry));
+  entry->ts = ts;
+  entry->moof_offset = moof_offset;
+  stream->n_ra_entries++;
+
+  GST_LOG_OBJECT (qtdemux, "track-id %u: indexed fragment time %"
+      GST_TIME_FORMAT ", moof_offset %" G_GUINT64_FORMAT ", %u entries",
+      stream->track_id, GST_TIME_ARGS (ts), moof_offset, stream->n_ra_entries);
+}
+
 static gboolean
 qtdemux_parse_trun (GstQTDemux * qtdemux, GstByteReader * trun,
     QtDemuxStream * stream, guint32 d_sample_duration, guint32 d_sample_size,
@@ -4116,6 +4594,7 @@ qtdemux_parse_moof (GstQTDemux * qtdemux, const guint8 * buffer, guint length,
   guint32 ds_size = 0, ds_duration = 0, ds_flags = 0;
   gint64 base_offset, running_offset;
   guint32 frag_num;
+  guint32 traf_first_sample;
   GstClockTime min_dts = GST_CLOCK_TIME_NONE;
 
   /* NOTE @stream ignored */
@@ -4261,6 +4740,7 @@ qtdemux_parse_moof (GstQTDemux * qtdemux, const guint8 * buffer, guint length,
     trun_node =
         qtdemux_tree_get_child_by_type_full (traf_node, FOURCC_trun,
         &trun_data);
+    traf_first_sample = stream->n_samples;
     while (trun_node) {
       qtdemux_parse_trun (qtdemux, &trun_data, stream,
           ds_duration, ds_size, ds_flags, moof_offset, length, &base_offset,
@@ -4272,6 +4752,17 @@ qtdemux_parse_moof (GstQTDemux * qtdemux, const guint8 * buffer, guint length,
       tfdt_node = NULL;
     }
 
+    /* Remember where to go to for seeking if the traf starts with a
+     * keyframe. Seeking resumes at the start of the moof, so only its first
+     * sample gives the right time. */
+    if (stream->index_fragments && stream->n_samples > traf_first_sample) {
+      QtDemuxSample *sample = &stream->samples[traf_first_sample];
+
+      if (QTSAMPLE_KEYFRAME (stream, sample))
+        qtdemux_stream_add_ra_entry (qtdemux, stream,
+            QTSAMPLE_DTS (stream, sample), moof_offset);
+    }
+
     uuid_node = qtdemux_tree_get_child_by_type (traf_node, FOURCC_uuid);
     if (uuid_node) {
       guint8 *uuid_buffer = (guint8 *) uuid_node->data;
@@ -4423,6 +4914,7 @@ qtdemux_parse_tfra (GstQTDemux * qtdemux, GNode * tfra_node)
   g_free (stream->ra_entries);
   stream->ra_entries = g_new (QtDemuxRandomAccessEntry, num_entries);
   stream->n_ra_entries = num_entries;
+  stream->ra_entries_size = num_entries;
 
   for (i = 0; i < num_entries; i++) {
     qt_atom_parser_get_offset (&tfra, value_size, &time);
@@ -6405,17 +6897,14 @@ gst_qtdemux_stream_seek_fragment (GstQTDemux * qtdemux, QtDemuxStream * stream,
   guint i;
 
   /* we assume the table is sorted */
-  for (i = 0; i < n_entries; ++i) {
-    if (entries[i].ts > pos)
-      break;
-  }
+  i = qtdemux_ra_entries_search (stream, pos);
 
   /* FIXME: maybe save first moof_offset somewhere instead, but for now it's
    * probably okay to assume that the index lists the very first fragment */
   if (i == 0)
     return &entries[0];
 
-  if (after)
+  if (after && i < n_entries)
     return &entries[i];
   else
     return &entries[i - 1];
@@ -6510,6 +6999,176 @@ gst_qtdemux_do_fragmented_seek (GstQTDemux * qtdemux)
   return TRUE;
 }
 
+/* Returns the index after the last upcoming sample of @stream within
+ * @readahead_time. The result is kept and only extended while the current
+ * sample moves forward, so that each sample is parsed and checked once */
+static guint32
+gst_qtdemux_get_readahead_window_end (GstQTDemux * qtdemux,
+    QtDemuxStream * stream, GstClockTime readahead_time)
+{
+  guint32 start = stream->sample_index;
+  guint32 end = stream->readahead_window_end;
+  GstClockTime first_dts;
+
+  /* after a seek back, start over */
+  if (start < stream->readahead_window_start || end < start) {
+    end = start;
+    stream->readahead_window_sorted = start;
+  }
+  stream->readahead_window_start = start;
+
+  if (start > stream->stbl_index && !qtdemux_parse_samples (qtdemux, stream,
+          start)) {
+    stream->readahead_window_end = start;
+    return start;
+  }
+  first_dts = QTSAMPLE_DTS (stream, &stream->samples[start]);
+
+  while (end < stream->n_samples
+      && end - start < QTDEMUX_READAHEAD_MAX_SAMPLES) {
+    if (end > stream->stbl_index && !qtdemux_parse_samples (qtdemux, stream,
+            end))
+      break;
+    if (QTSAMPLE_DTS (stream, &stream->samples[end]) - first_dts >
+        readahead_time)
+      break;
+    if (end > start && stream->samples[end].offset <
+        stream->samples[end - 1].offset + stream->samples[end - 1].size)
+      stream->readahead_window_sorted = end;
+    end++;
+  }
+  stream->readahead_window_end = end;
+
+  return end;
+}
+
+/* Returns the end of a read starting at @offset and going at least up to
+ * @end that also covers the upcoming samples of all streams that follow
+ * @offset in the file, within @readahead_size and @readahead_time */
+static guint64
+gst_qtdemux_get_readahead_end (GstQTDemux * qtdemux, guint64 offset,
+    guint64 end, guint readahead_size, GstClockTime readahead_time)
+{
+  guint64 limit = offset + readahead_size;
+  gint i;
+
+  for (i = 0; i < QTDEMUX_N_STREAMS (qtdemux); i++) {
+    QtDemuxStream *stream = QTDEMUX_NTH_STREAM (qtdemux, i);
+    guint32 index, last;
+
+    if (stream->sample_index == -1 || stream->sample_index >= stream->n_samples)
+      continue;
+
+    last = gst_qtdemux_get_readahead_window_end (qtdemux, stream,
+        readahead_time);
+
+    /* Samples stored one after the other in the file also end in file
+     * order, so the last one that fits is found with a binary search */
+    if (stream->readahead_window_sorted <= stream->sample_index) {
+      guint32 low = stream->sample_index, high = last;
+
+      while (low < high) {
+        guint32 mid = low + (high - low) / 2;
+        QtDemuxSample *sample = &stream->samples[mid];
+
+        if (sample->offset + sample->size <= limit)
+          low = mid + 1;
+        else
+          high = mid;
+      }
+      if (low > stream->sample_index) {
+        QtDemuxSample *sample = &stream->samples[low - 1];
+
+        if (sample->offset >= offset)
+          end = MAX (end, sample->offset + sample->size);
+      }
+      continue;
+    }
+
+    for (index = stream->sample_index; index < last; index++) {
+      QtDemuxSample *sample = &stream->samples[index];
+
+      if (sample->offset >= offset && sample->offset + sample->size <= limit)
+        end = MAX (end, sample->offset + sample->size);
+    }
+  }
+
+  return end;
+}
+
+/* Pulls @size bytes of sample data at @offset for @stream, from the data
+ * read ahead for any stream if possible */
+static GstFlowReturn
+gst_qtdemux_pull_sample_data (GstQTDemux * qtdemux, QtDemuxStream * stream,
+    guint64 offset, guint size, GstBuffer ** buf)
+{
+  QtDemuxStream *cached = NULL;
+  GstFlowReturn ret;
+  guint readahead_size;
+  GstClockTime readahead_time;
+  gint i;
+
+  GST_OBJECT_LOCK (qtdemux);
+  readahead_size = qtdemux->readahead_size;
+  readahead_time = qtdemux->readahead_time;
+  GST_OBJECT_UNLOCK (qtdemux);
+
+  if (readahead_size <= size)
+    return gst_qtdemux_pull_atom (qtdemux, offset, size, buf);
+
+  for (i = 0; i < QTDEMUX_N_STREAMS (qtdemux); i++) {
+    QtDemuxStream *str = QTDEMUX_NTH_STREAM (qtdemux, i);
+
+    if (str->readahead_buffer && offset >= str->readahead_offset &&
+        offset + size <= str->readahead_offset +
+        gst_buffer_get_size (str->readahead_buffer)) {
+      cached = str;
+      break;
+    }
+  }
+
+  if (cached == NULL) {
+    GstBuffer *readahead = NULL;
+    guint64 end;
+
+    end = gst_qtdemux_get_readahead_end (qtdemux, offset, offset + size,
+        readahead_size, readahead_time);
+    GST_LOG_OBJECT (qtdemux, "reading ahead %" G_GUINT64_FORMAT " bytes @ %"
+        G_GUINT64_FORMAT, end - offset, offset);
+
+    ret = gst_pad_pull_range (qtdemux->sinkpad, offset, end - offset,
+        &readahead);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      return ret;
+
+    /* truncated file, let the plain read deal with it */
+    if (G_UNLIKELY (gst_buffer_get_size (readahead) < size)) {
+      gst_buffer_unref (readahead);
+      return gst_qtdemux_pull_atom (qtdemux, offset, size, buf);
+    }
+
+    gst_buffer_replace (&stream->readahead_buffer, readahead);
+    gst_buffer_unref (readahead);
+    stream->readahead_offset = offset;
+    cached = stream;
+  }
+
+  if (*buf) {
+    GstMapInfo map;
+
+    /* fill the buffer from the stream allocator */
+    gst_buffer_map (cached->readahead_buffer, &map, GST_MAP_READ);
+    gst_buffer_fill (*buf, 0, map.data + offset - cached->readahead_offset,
+        size);
+    gst_buffer_unmap (cached->readahead_buffer, &map);
+  } else {
+    *buf = gst_buffer_copy_region (cached->readahead_buffer,
+        GST_BUFFER_COPY_ALL, offset - cached->readahead_offset, size);
+  }
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_qtdemux_loop_state_movie (GstQTDemux * qtdemux)
 {
@@ -6773,8 +7432,8 @@ gst_qtdemux_loop_state_movie (GstQTDemux * qtdemux)
     buf = gst_buffer_new_allocate (stream->allocator, size, &stream->params);
   }
 
-  ret = gst_qtdemux_pull_atom (qtdemux, offset + stream->offset_in_sample,
-      size, &buf);
+  ret = gst_qtdemux_pull_sample_data (qtdemux, stream,
+      offset + stream->offset_in_sample, size, &buf);
   if (G_UNLIKELY (ret != GST_FLOW_OK))
     goto beach;
 
@@ -7219,6 +7878,198 @@ gst_qtdemux_send_gap_for_segment (GstQTDemux * demux,
   }
 }
 
+static guint64
+gst_qtdemux_get_mdat_buffered_size (GstQTDemux * demux)
+{
+  if (demux->mdatbuffer)
+    return gst_buffer_get_size (demux->mdatbuffer);
+
+  return 0;
+}
+
+/* PUSH-MODE only: [mdat] data before the headers that does not fit in memory
+ * is spilled to a temporary file, which is read back into the adapter once
+ * the headers are parsed */
+static gboolean
+gst_qtdemux_spill_open (GstQTDemux * demux)
+{
+  GError *err = NULL;
+  gint fd;
+
+  /* created exclusively with a unique name, so that nobody else can open
+   * it first and read or replace the data */
+  fd = g_file_open_tmp ("qtdemux-XXXXXX", &demux->mdat_spill_path, &err);
+  if (fd == -1) {
+    GST_ELEMENT_ERROR (demux, RESOURCE, OPEN_WRITE,
+        ("Could not create temporary file"), ("%s", err->message));
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  demux->mdat_spill_out = fdopen (fd, "wb");
+  if (demux->mdat_spill_out == NULL) {
+    g_close (fd, NULL);
+    goto open_failed;
+  }
+
+  /* the data is read back with its own file position */
+  demux->mdat_spill_in = g_fopen (demux->mdat_spill_path, "rb");
+  if (demux->mdat_spill_in == NULL)
+    goto open_failed;
+
+#ifdef G_OS_UNIX
+  /* nothing opens it by name from here on, and it goes away with the
+   * element even if that does not shut down cleanly */
+  g_unlink (demux->mdat_spill_path);
+#endif
+
+  GST_DEBUG_OBJECT (demux, "spilling mdat data to %s", demux->mdat_spill_path);
+
+  return TRUE;
+
+open_failed:
+  {
+    GST_ELEMENT_ERROR (demux, RESOURCE, OPEN_WRITE,
+        (("Could not open temporary file \"%s\""), demux->mdat_spill_path),
+        GST_ERROR_SYSTEM);
+#ifdef G_OS_UNIX
+    g_unlink (demux->mdat_spill_path);
+#endif
+    gst_qtdemux_spill_close (demux);
+    return FALSE;
+  }
+}
+
+static void
+gst_qtdemux_spill_close (GstQTDemux * demux)
+{
+  if (demux->mdat_spill_in) {
+    fclose (demux->mdat_spill_in);
+    demux->mdat_spill_in = NULL;
+  }
+  if (demux->mdat_spill_out) {
+    fclose (demux->mdat_spill_out);
+    demux->mdat_spill_out = NULL;
+  }
+  if (demux->mdat_spill_path) {
+#ifndef G_OS_UNIX
+    g_remove (demux->mdat_spill_path);
+#endif
+    g_free (demux->mdat_spill_path);
+    demux->mdat_spill_path = NULL;
+  }
+  demux->mdat_spill_reading = FALSE;
+  demux->mdat_spill_size = 0;
+  demux->mdat_spill_read = 0;
+  demux->mdat_spill_end = G_MAXUINT64;
+}
+
+static gboolean
+gst_qtdemux_spill_write (GstQTDemux * demux, const guint8 * data, gsize size)
+{
+  if (fwrite (data, 1, size, demux->mdat_spill_out) != size)
+    goto write_failed;
+
+  /* make it visible to the reader right away */
+  if (demux->mdat_spill_reading && fflush (demux->mdat_spill_out) != 0)
+    goto write_failed;
+
+  demux->mdat_spill_size += size;
+
+  return TRUE;
+
+write_failed:
+  {
+    GST_ELEMENT_ERROR (demux, RESOURCE, WRITE,
+        (("Could not write to temporary file \"%s\""),
+            demux->mdat_spill_path), GST_ERROR_SYSTEM);
+    gst_qtdemux_spill_close (demux);
+    return FALSE;
+  }
+}
+
+static gboolean
+gst_qtdemux_spill_start_read (GstQTDemux * demux)
+{
+  GST_DEBUG_OBJECT (demux, "reading back %" G_GUINT64_FORMAT " spilled bytes",
+      demux->mdat_spill_size);
+
+  if (fflush (demux->mdat_spill_out) != 0)
+    goto flush_failed;
+
+  demux->mdat_spill_reading = TRUE;
+  demux->mdat_spill_read = 0;
+  /* In fragmented streams the data after the moov is restored once the mdat
+   * was consumed, keep what arrives meanwhile behind it */
+  if (demux->fragmented)
+    demux->mdat_spill_end = demux->mdat_spill_size;
+  else
+    demux->mdat_spill_end = G_MAXUINT64;
+
+  return TRUE;
+
+flush_failed:
+  {
+    GST_ELEMENT_ERROR (demux, RESOURCE, WRITE,
+        (("Could not write to temporary file \"%s\""),
+            demux->mdat_spill_path), GST_ERROR_SYSTEM);
+    gst_qtdemux_spill_close (demux);
+    return FALSE;
+  }
+}
+
+/* Moves spilled data back into the adapter until it has neededbytes or the
+ * readable part of the temporary file was read. Returns the available
+ * bytes. */
+static gsize
+gst_qtdemux_spill_refill (GstQTDemux * demux, GstFlowReturn * ret)
+{
+  gsize available = gst_adapter_available (demux->adapter);
+
+  while (demux->mdat_spill_reading) {
+    GstBuffer *buf;
+    GstMapInfo map;
+    guint64 end;
+    gsize size;
+
+    if (demux->mdat_spill_end == G_MAXUINT64 &&
+        demux->mdat_spill_read == demux->mdat_spill_size) {
+      GST_DEBUG_OBJECT (demux, "read back all spilled data");
+      gst_qtdemux_spill_close (demux);
+      break;
+    }
+
+    end = MIN (demux->mdat_spill_size, demux->mdat_spill_end);
+    if (demux->neededbytes == -1 || available >= demux->neededbytes ||
+        demux->mdat_spill_read == end)
+      break;
+
+    size = MIN (end - demux->mdat_spill_read,
+        MAX (demux->neededbytes - available, QTDEMUX_MDAT_SPILL_CHUNK_SIZE));
+    buf = gst_buffer_new_allocate (NULL, size, NULL);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    size = fread (map.data, 1, size, demux->mdat_spill_in);
+    gst_buffer_unmap (buf, &map);
+
+    if (size == 0) {
+      GST_ELEMENT_ERROR (demux, RESOURCE, READ,
+          (("Could not read temporary file \"%s\""), demux->mdat_spill_path),
+          GST_ERROR_SYSTEM);
+      gst_buffer_unref (buf);
+      gst_qtdemux_spill_close (demux);
+      *ret = GST_FLOW_ERROR;
+      break;
+    }
+
+    gst_buffer_set_size (buf, size);
+    gst_adapter_push (demux->adapter, buf);
+    available += size;
+    demux->mdat_spill_read += size;
+  }
+
+  return available;
+}
+
 static GstFlowReturn
 gst_qtdemux_chain (GstPad * sinkpad, GstObject * parent, GstBuffer * inbuf)
 {
@@ -7288,6 +8139,7 @@ gst_qtdemux_chain (GstPad * sinkpad, GstObject * parent, GstBuffer * inbuf)
         demux->state = QTDEMUX_STATE_INITIAL;
         demux->offset = GST_BUFFER_OFFSET (inbuf);
         gst_adapter_clear (demux->adapter);
+        gst_qtdemux_spill_close (demux);
       }
     }
     /* Reverse fragmented playback, need to flush all we have before
@@ -7303,6 +8155,21 @@ gst_qtdemux_chain (GstPad * sinkpad, GstObject * parent, GstBuffer * inbuf)
     }
   }
 
+  /* while spilled data is read back, new data has to queue up behind it */
+  if (G_UNLIKELY (demux->mdat_spill_reading)) {
+    GstMapInfo map;
+    gboolean res;
+
+    gst_buffer_map (inbuf, &map, GST_MAP_READ);
+    res = gst_qtdemux_spill_write (demux, map.data, map.size);
+    gst_buffer_unmap (inbuf, &map);
+    gst_buffer_unref (inbuf);
+    if (!res)
+      return GST_FLOW_ERROR;
+
+    return gst_qtdemux_process_adapter (demux, FALSE);
+  }
+
   gst_adapter_push (demux->adapter, inbuf);
 
   GST_DEBUG_OBJECT (demux,
@@ -7322,8 +8189,8 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
     goto eos;
   }
 
-  while (((gst_adapter_available (demux->adapter)) >= demux->neededbytes) &&
-      (ret == GST_FLOW_OK || (ret == GST_FLOW_NOT_LINKED && force))) {
+  while ((ret == GST_FLOW_OK || (ret == GST_FLOW_NOT_LINKED && force)) &&
+      (gst_qtdemux_spill_refill (demux, &ret) >= demux->neededbytes)) {
 
 #ifndef GST_DISABLE_GST_DEBUG
     {
@@ -7377,7 +8244,6 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
             demux->mdatsize = demux->mdatleft;
           } else {
             /* no headers yet, try to get them */
-            guint bs;
             gboolean res;
             guint64 old, target;
 
@@ -7413,18 +8279,27 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
               /* seek failed, need to buffer */
               demux->offset = old;
               GST_DEBUG_OBJECT (demux, "seek failed/skipped");
-              /* there may be multiple mdat (or alike) buffers */
-              /* sanity check */
-              if (demux->mdatbuffer)
-                bs = gst_buffer_get_size (demux->mdatbuffer);
-              else
-                bs = 0;
-              if (size + bs > 10 * (1 << 20))
-                goto no_moov;
-              demux->state = QTDEMUX_STATE_BUFFER_MDAT;
-              demux->neededbytes = size;
-              if (!demux->mdatbuffer)
+              /* there may be multiple mdat (or alike) buffers, keep them in
+               * memory as long as they fit and spill the rest to a
+               * temporary file, if allowed */
+              if (!demux->mdatbuffer && !demux->mdat_spill_out)
                 demux->mdatoffset = demux->offset;
+              if (!demux->mdat_spill_out && size <= G_MAXUINT &&
+                  gst_qtdemux_get_mdat_buffered_size (demux) + size <=
+                  demux->max_mdat_buffer_size) {
+                demux->neededbytes = size;
+              } else {
+                /* sanity check */
+                if (demux->mdat_spill_size + size > demux->max_mdat_spill_size)
+                  goto no_moov;
+                if (!demux->mdat_spill_out && !gst_qtdemux_spill_open (demux)) {
+                  ret = GST_FLOW_ERROR;
+                  break;
+                }
+                demux->neededbytes = MIN (size, QTDEMUX_MDAT_SPILL_CHUNK_SIZE);
+              }
+              demux->state = QTDEMUX_STATE_BUFFER_MDAT;
+              demux->mdat_buffer_left = size;
             }
           }
         } else if (G_UNLIKELY (size > QTDEMUX_MAX_ATOM_SIZE)) {
@@ -7437,8 +8312,8 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
         } else {
           /* this means we already started buffering and still no moov header,
            * let's continue buffering everything till we get moov */
-          if (demux->mdatbuffer && !(fourcc == FOURCC_moov
-                  || fourcc == FOURCC_moof))
+          if ((demux->mdatbuffer || demux->mdat_spill_out)
+              && !(fourcc == FOURCC_moov || fourcc == FOURCC_moof))
             goto buffer_data;
           demux->neededbytes = size;
           demux->state = QTDEMUX_STATE_HEADER;
@@ -7640,7 +8515,8 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
         gst_adapter_unmap (demux->adapter);
         data = NULL;
 
-        if (demux->mdatbuffer && QTDEMUX_N_STREAMS (demux)) {
+        if ((demux->mdatbuffer || demux->mdat_spill_out)
+            && QTDEMUX_N_STREAMS (demux)) {
           gsize remaining_data_size = 0;
 
           /* the mdat was before the header */
@@ -7664,13 +8540,20 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
                 demux->restoredata_offset);
           }
 
-          gst_adapter_push (demux->adapter, demux->mdatbuffer);
+          if (demux->mdatbuffer)
+            gst_adapter_push (demux->adapter, demux->mdatbuffer);
           demux->mdatbuffer = NULL;
           demux->offset = demux->mdatoffset;
           demux->neededbytes = next_entry_size (demux);
           demux->state = QTDEMUX_STATE_MOVIE;
-          demux->mdatleft = gst_adapter_available (demux->adapter);
+          demux->mdatleft =
+              gst_adapter_available (demux->adapter) + demux->mdat_spill_size;
           demux->mdatsize = demux->mdatleft;
+          /* the spilled data follows what was kept in memory */
+          if (demux->mdat_spill_out && !gst_qtdemux_spill_start_read (demux)) {
+            ret = GST_FLOW_ERROR;
+            break;
+          }
         } else {
           GST_DEBUG_OBJECT (demux, "Carrying on normally");
           gst_adapter_flush (demux->adapter, demux->neededbytes);
@@ -7697,20 +8580,41 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
         break;
       }
       case QTDEMUX_STATE_BUFFER_MDAT:{
-        GstBuffer *buf;
-        guint8 fourcc[4];
-
         GST_DEBUG_OBJECT (demux, "Got our buffer at offset %" G_GUINT64_FORMAT,
             demux->offset);
-        buf = gst_adapter_take_buffer (demux->adapter, demux->neededbytes);
-        gst_buffer_extract (buf, 0, fourcc, 4);
-        GST_DEBUG_OBJECT (demux, "mdatbuffer starts with %" GST_FOURCC_FORMAT,
-            GST_FOURCC_ARGS (QT_FOURCC (fourcc)));
-        if (demux->mdatbuffer)
-          demux->mdatbuffer = gst_buffer_append (demux->mdatbuffer, buf);
-        else
-          demux->mdatbuffer = buf;
+        if (demux->mdat_spill_out) {
+          const guint8 *data;
+          gboolean res;
+
+          data = gst_adapter_map (demux->adapter, demux->neededbytes);
+          res = gst_qtdemux_spill_write (demux, data, demux->neededbytes);
+          gst_adapter_unmap (demux->adapter);
+          if (!res) {
+            ret = GST_FLOW_ERROR;
+            break;
+          }
+          gst_adapter_flush (demux->adapter, demux->neededbytes);
+        } else {
+          GstBuffer *buf;
+          guint8 fourcc[4];
+
+          buf = gst_adapter_take_buffer (demux->adapter, demux->neededbytes);
+          gst_buffer_extract (buf, 0, fourcc, 4);
+          GST_DEBUG_OBJECT (demux,
+              "mdatbuffer starts with %" GST_FOURCC_FORMAT,
+              GST_FOURCC_ARGS (QT_FOURCC (fourcc)));
+          if (demux->mdatbuffer)
+            demux->mdatbuffer = gst_buffer_append (demux->mdatbuffer, buf);
+          else
+            demux->mdatbuffer = buf;
+        }
         demux->offset += demux->neededbytes;
+        demux->mdat_buffer_left -= demux->neededbytes;
+        if (demux->mdat_buffer_left > 0) {
+          demux->neededbytes =
+              MIN (demux->mdat_buffer_left, QTDEMUX_MDAT_SPILL_CHUNK_SIZE);
+          break;
+        }
         demux->neededbytes = 16;
         demux->state = QTDEMUX_STATE_INITIAL;
         gst_qtdemux_post_progress (demux, 1, 1);
@@ -7759,6 +8663,8 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
               demux->restoredata_buffer = NULL;
               demux->offset = demux->restoredata_offset;
             }
+            /* input that was spilled while the mdat was read back follows */
+            demux->mdat_spill_end = G_MAXUINT64;
 
             break;
           }
@@ -7857,8 +8763,11 @@ gst_qtdemux_process_adapter (GstQTDemux * demux, gboolean force)
           } else {
             GstBuffer *outbuf;
 
+            /* samples spanning several input buffers keep their memories
+             * instead of being copied into a new one */
             outbuf =
-                gst_adapter_take_buffer (demux->adapter, demux->neededbytes);
+                gst_adapter_take_buffer_fast (demux->adapter,
+                demux->neededbytes);
 
             /* FIXME: should either be an assert or a plain check */
             g_return_val_if_fail (outbuf != NULL, GST_FLOW_ERROR);
@@ -7952,7 +8861,9 @@ invalid_state:
 no_moov:
   {
     GST_ELEMENT_ERROR (demux, STREAM, FAILED,
-        (NULL), ("no 'moov' atom within the first 10 MB"));
+        (NULL), ("no 'moov' atom within the first %" G_GUINT64_FORMAT
+            " bytes", demux->max_mdat_buffer_size +
+            demux->max_mdat_spill_size));
     ret = GST_FLOW_ERROR;
     goto done;
   }
@@ -9582,6 +10493,17 @@ qtdemux_stbl_init (GstQTDemux * qtdemux, QtDemuxStream * stream, GNode * stbl)
           goto corrupt_file;
       }
     }
+
+    /* entries of 0 or out of order are skipped when parsing the samples, but
+     * would make the keyframe lookup pick the wrong sample */
+    stream->sync_tables_sorted =
+        qtdemux_sync_table_is_sorted (stream->stss.data + 8,
+        stream->n_sample_syncs) && (!stream->stps_present
+        || qtdemux_sync_table_is_sorted (stream->stps.data + 8,
+            stream->n_sample_partial_syncs));
+    if (!stream->sync_tables_sorted)
+      GST_WARNING_OBJECT (qtdemux, "sync sample tables are not sorted, "
+          "looking keyframes up sample by sample");
   }
 
   /* sample size */
@@ -9808,6 +10730,9 @@ qtdemux_stbl_init (GstQTDemux * qtdemux, QtDemuxStream * stream, GNode * stbl)
   }
 
 done:
+  /* remember where the stts entries start for looking samples up by time */
+  stream->stts_entries_pos = gst_byte_reader_get_pos (&stream->stts);
+
   GST_DEBUG_OBJECT (qtdemux, "allocating n_samples %u * %u (%.2f MB)",
       stream->n_samples, (guint) sizeof (QtDemuxSample),
       stream->n_samples * sizeof (QtDemuxSample) / (1024.0 * 1024.0));
@@ -13475,6 +14400,9 @@ qtdemux_parse_trak (GstQTDemux * qtdemux, GNode * trak)
     /* prevent moof parsing taking of at this time */
     offset = qtdemux->moof_offset;
     qtdemux->moof_offset = 0;
+    /* fragments can only be seeked to directly if all samples are in them,
+     * and in push mode the sample tables are dropped with every moof */
+    stream->index_fragments = qtdemux->pullbased && stream->n_samples == 0;
     if (stream->n_samples &&
         !qtdemux_parse_samples (qtdemux, stream, stream->n_samples - 1)) {
       qtdemux->moof_offset = offset;
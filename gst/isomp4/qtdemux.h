@@ -21,6 +21,7 @@
 #ifndef __GST_QTDEMUX_H__
 #define __GST_QTDEMUX_H__
 
+#include <stdio.h>
 #include <gst/gst.h>
 #include <gst/base/gstadapter.h>
 #include <gst/base/gstflowcombiner.h>
@@ -51,6 +52,7 @@ typedef struct _GstQTDemux GstQTDemux;
 typedef struct _GstQTDemuxClass GstQTDemuxClass;
 typedef struct _QtDemuxStream QtDemuxStream;
 typedef struct _QtDemuxSample QtDemuxSample;
+typedef struct _QtDemuxSttsIndexEntry QtDemuxSttsIndexEntry;
 typedef struct _QtDemuxSegment QtDemuxSegment;
 typedef struct _QtDemuxRandomAccessEntry QtDemuxRandomAccessEntry;
 typedef struct _QtDemuxStreamStsdEntry QtDemuxStreamStsdEntry;
@@ -189,6 +191,12 @@ struct _GstQTDemux {
    * add/remove streams at any point in time */
   gboolean streams_aware;
 
+  /* properties */
+  guint64 max_mdat_buffer_size;
+  guint64 max_mdat_spill_size;
+  guint readahead_size;
+  GstClockTime readahead_time;
+
   /*
    * ALL VARIABLES BELOW ARE ONLY USED IN PUSH-BASED MODE
    */
@@ -197,6 +205,20 @@ struct _GstQTDemux {
   guint todrop;
   /* Used to store data if [mdat] is before the headers */
   GstBuffer *mdatbuffer;
+  /* Bytes of the [mdat] being buffered that are still to be read */
+  guint64 mdat_buffer_left;
+  /* [mdat] data before the headers that did not fit in mdatbuffer is
+   * written to this temporary file and read back after the headers */
+  gchar *mdat_spill_path;
+  FILE *mdat_spill_out;
+  FILE *mdat_spill_in;
+  gboolean mdat_spill_reading;
+  guint64 mdat_spill_size;
+  guint64 mdat_spill_read;
+  /* End of the [mdat] data in the temporary file, input appended after it
+   * while reading back comes after restoredata_buffer. G_MAXUINT64 once
+   * everything can be read in order. */
+  guint64 mdat_spill_end;
   /* Amount of bytes left to read in the current [mdat] */
   guint64 mdatleft, mdatsize;
 
@@ -321,6 +343,9 @@ struct _QtDemuxStreamStsdEntry
 
 };
 
+/* Samples are decoded from the sample tables on demand and in order, up to
+ * the one that is needed. Seeking in pull mode only decodes up to its
+ * target, the complete array is only built for seeking in push mode */
 struct _QtDemuxSample
 {
   guint32 size;
@@ -331,6 +356,16 @@ struct _QtDemuxSample
   gboolean keyframe;            /* TRUE when this packet is a keyframe */
 };
 
+/* Position in the stts at the start of every QTDEMUX_STTS_INDEX_INTERVAL
+ * entries, allows to find the sample for a time without parsing the sample
+ * table up to it */
+struct _QtDemuxSttsIndexEntry
+{
+  guint32 entry;                /* stts entry */
+  guint32 sample;               /* first sample of the entry */
+  guint64 timestamp;            /* DTS of that sample in mov time */
+};
+
 struct _QtDemuxStream
 {
   GstPad *pad;
@@ -386,6 +421,15 @@ struct _QtDemuxStream
   guint32 max_buffer_size;      /* Maximum allowed size for output buffers.
                                  * Currently only set for raw audio streams*/
 
+  /* pull mode read-ahead, may hold samples of other streams too */
+  GstBuffer *readahead_buffer;
+  guint64 readahead_offset;
+  /* upcoming samples within readahead-time from readahead_window_start */
+  guint32 readahead_window_start;
+  guint32 readahead_window_end;
+  /* samples of the window from here on don't overlap and are in file order */
+  guint32 readahead_window_sorted;
+
   /* video info */
   /* aspect ratio */
   gint display_width;
@@ -471,6 +515,10 @@ struct _QtDemuxStream
   guint32 stts_sample_index;
   guint64 stts_time;
   guint32 stts_duration;
+  guint stts_entries_pos;       /* position of the first entry in stts */
+  QtDemuxSttsIndexEntry *stts_lookup;
+  guint n_stts_lookup;
+  gboolean stts_lookup_failed;  /* stts can't be searched (negative durations) */
   /* stss */
   gboolean stss_present;
   guint32 n_sample_syncs;
@@ -479,8 +527,11 @@ struct _QtDemuxStream
   gboolean stps_present;
   guint32 n_sample_partial_syncs;
   guint32 stps_index;
+  gboolean sync_tables_sorted;  /* stss and stps can be binary searched */
   QtDemuxRandomAccessEntry *ra_entries;
   guint n_ra_entries;
+  guint ra_entries_size;        /* allocated entries */
+  gboolean index_fragments;     /* add fragments to ra_entries as parsed */
 
   const QtDemuxRandomAccessEntry *pending_seek;
 
@@ -41,12 +41,14 @@ GST_DEBUG_CATEGORY_STATIC (rtph264depay_debug);
 #define DEFAULT_ACCESS_UNIT   FALSE
 #define DEFAULT_WAIT_FOR_KEYFRAME FALSE
 #define DEFAULT_REQUEST_KEYFRAME FALSE
+#define DEFAULT_ZERO_COPY FALSE
 
 enum
 {
   PROP_0,
   PROP_WAIT_FOR_KEYFRAME,
   PROP_REQUEST_KEYFRAME,
+  PROP_ZERO_COPY,
 };
 
 
@@ -126,6 +128,9 @@ gst_rtp_h264_depay_set_property (GObject * object, guint prop_id,
     case PROP_REQUEST_KEYFRAME:
       self->request_keyframe = g_value_get_boolean (value);
       break;
+    case PROP_ZERO_COPY:
+      self->zero_copy = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -145,6 +150,9 @@ gst_rtp_h264_depay_get_property (GObject * object, guint prop_id,
     case PROP_REQUEST_KEYFRAME:
       g_value_set_boolean (value, self->request_keyframe);
       break;
+    case PROP_ZERO_COPY:
+      g_value_set_boolean (value, self->zero_copy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -194,6 +202,23 @@ gst_rtp_h264_depay_class_init (GstRtpH264DepayClass * klass)
           DEFAULT_REQUEST_KEYFRAME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpH264Depay:zero-copy:
+   *
+   * Build the output NAL units and access units from the memory of the
+   * incoming RTP packets instead of copying the payload. Start codes and NAL
+   * headers are added as separate small memories.
+   *
+   * When downstream proposes an allocator in the ALLOCATION query the output
+   * is still copied into memory from that allocator.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero Copy",
+          "Reference the RTP packet memory in the output instead of copying",
+          DEFAULT_ZERO_COPY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_rtp_h264_depay_src_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -223,12 +248,14 @@ gst_rtp_h264_depay_init (GstRtpH264Depay * rtph264depay)
       (GDestroyNotify) gst_buffer_unref);
   rtph264depay->wait_for_keyframe = DEFAULT_WAIT_FOR_KEYFRAME;
   rtph264depay->request_keyframe = DEFAULT_REQUEST_KEYFRAME;
+  rtph264depay->zero_copy = DEFAULT_ZERO_COPY;
 }
 
 static void
 gst_rtp_h264_depay_reset (GstRtpH264Depay * rtph264depay, gboolean hard)
 {
   gst_adapter_clear (rtph264depay->adapter);
+  gst_clear_buffer (&rtph264depay->fu_header);
   rtph264depay->wait_start = TRUE;
   rtph264depay->waiting_for_keyframe = rtph264depay->wait_for_keyframe;
   gst_adapter_clear (rtph264depay->picture_adapter);
@@ -276,6 +303,7 @@ gst_rtp_h264_depay_finalize (GObject * object)
 
   g_object_unref (rtph264depay->adapter);
   g_object_unref (rtph264depay->picture_adapter);
+  gst_clear_buffer (&rtph264depay->fu_header);
 
   g_ptr_array_free (rtph264depay->sps, TRUE);
   g_ptr_array_free (rtph264depay->pps, TRUE);
@@ -894,6 +922,30 @@ gst_rtp_h264_depay_allocate_output_buffer (GstRtpH264Depay * depay, gsize size)
   return buffer;
 }
 
+/* Output can reference the RTP packet memory unless downstream wants the data
+ * in memory from its own allocator */
+static inline gboolean
+gst_rtp_h264_depay_use_zero_copy (GstRtpH264Depay * depay)
+{
+  return depay->zero_copy && depay->allocator == NULL;
+}
+
+/* Create a buffer referencing @size bytes of the payload of @rtp starting at
+ * @offset, preceded by a new memory of @prefix_size bytes that the caller
+ * fills with the start code or NAL length */
+static GstBuffer *
+gst_rtp_h264_depay_wrap_payload (GstRTPBuffer * rtp, guint prefix_size,
+    guint offset, guint size)
+{
+  GstBuffer *outbuf, *payload;
+
+  outbuf = gst_buffer_new_allocate (NULL, prefix_size, NULL);
+  payload = gst_buffer_copy_region (rtp->buffer, GST_BUFFER_COPY_MEMORY,
+      gst_rtp_buffer_get_header_len (rtp) + offset, size);
+
+  return gst_buffer_append (outbuf, payload);
+}
+
 static GstBuffer *
 gst_rtp_h264_complete_au (GstRtpH264Depay * rtph264depay,
     GstClockTime * out_timestamp, gboolean * out_keyframe)
@@ -908,6 +960,13 @@ gst_rtp_h264_complete_au (GstRtpH264Depay * rtph264depay,
   GST_DEBUG_OBJECT (rtph264depay, "taking completed AU");
   outsize = gst_adapter_available (rtph264depay->picture_adapter);
 
+  if (gst_rtp_h264_depay_use_zero_copy (rtph264depay)) {
+    /* chain the memories of the NAL units instead of copying them */
+    outbuf = gst_adapter_take_buffer_fast (rtph264depay->picture_adapter,
+        outsize);
+    goto done;
+  }
+
   outbuf = gst_rtp_h264_depay_allocate_output_buffer (rtph264depay, outsize);
 
   if (outbuf == NULL)
@@ -942,6 +1001,7 @@ gst_rtp_h264_complete_au (GstRtpH264Depay * rtph264depay,
   gst_buffer_list_unref (list);
   gst_buffer_unmap (outbuf, &outmap);
 
+done:
   *out_timestamp = rtph264depay->last_ts;
   *out_keyframe = rtph264depay->last_keyframe;
 
@@ -990,16 +1050,17 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
 {
   GstRTPBaseDepayload *depayload = GST_RTP_BASE_DEPAYLOAD (rtph264depay);
   gint nal_type;
-  GstMapInfo map;
+  guint8 header[6] = { 0, };
   GstBuffer *outbuf = NULL;
   GstClockTime out_timestamp;
   gboolean keyframe, out_keyframe;
 
-  gst_buffer_map (nal, &map, GST_MAP_READ);
-  if (G_UNLIKELY (map.size < 5))
+  /* only look at the prefix and NAL header, mapping the whole NAL would merge
+   * the memories of a zero-copy NAL */
+  if (G_UNLIKELY (gst_buffer_extract (nal, 0, header, sizeof (header)) < 5))
     goto short_nal;
 
-  nal_type = map.data[4] & 0x1f;
+  nal_type = header[4] & 0x1f;
   GST_DEBUG_OBJECT (rtph264depay, "handle NAL type %d", nal_type);
 
   keyframe = NAL_TYPE_IS_KEY (nal_type);
@@ -1012,7 +1073,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
       gst_rtp_h264_depay_add_sps_pps (rtph264depay,
           gst_buffer_copy_region (nal, GST_BUFFER_COPY_ALL,
               4, gst_buffer_get_size (nal) - 4));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     } else if (rtph264depay->sps->len == 0 || rtph264depay->pps->len == 0) {
@@ -1023,7 +1083,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
           gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
               gst_structure_new ("GstForceKeyUnit",
                   "all-headers", G_TYPE_BOOLEAN, TRUE, NULL)));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     }
@@ -1049,7 +1108,7 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
     if (nal_type == 1 || nal_type == 2 || nal_type == 5) {
       /* we have a picture start */
       start = TRUE;
-      if (map.data[5] & 0x80) {
+      if (header[5] & 0x80) {
         /* first_mb_in_slice == 0 completes a picture */
         complete = TRUE;
       }
@@ -1067,8 +1126,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
             &out_keyframe);
     }
     /* add to adapter */
-    gst_buffer_unmap (nal, &map);
-
     if (!rtph264depay->picture_start && start && out_keyframe)
       rtph264depay->waiting_for_keyframe = FALSE;
 
@@ -1085,7 +1142,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
     /* no merge, output is input nal */
     GST_DEBUG_OBJECT (depayload, "using NAL as output");
     outbuf = nal;
-    gst_buffer_unmap (nal, &map);
   }
 
   if (outbuf) {
@@ -1106,7 +1162,6 @@ gst_rtp_h264_depay_handle_nal (GstRtpH264Depay * rtph264depay, GstBuffer * nal,
 short_nal:
   {
     GST_WARNING_OBJECT (depayload, "dropping short NAL");
-    gst_buffer_unmap (nal, &map);
     gst_buffer_unref (nal);
     return;
   }
@@ -1120,9 +1175,21 @@ gst_rtp_h264_finish_fragmentation_unit (GstRtpH264Depay * rtph264depay)
   GstBuffer *outbuf;
 
   outsize = gst_adapter_available (rtph264depay->adapter);
-  outbuf = gst_adapter_take_buffer (rtph264depay->adapter, outsize);
 
-  gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
+  if (rtph264depay->fu_header) {
+    /* zero-copy: the fragments stay in the RTP packet memory, the prefix
+     * and NAL header live in their own memory */
+    outbuf = rtph264depay->fu_header;
+    rtph264depay->fu_header = NULL;
+    if (outsize > 0)
+      outbuf = gst_buffer_append (outbuf,
+          gst_adapter_take_buffer_fast (rtph264depay->adapter, outsize));
+    outsize += sizeof (sync_bytes) + 1;
+  } else {
+    outbuf = gst_adapter_take_buffer (rtph264depay->adapter, outsize);
+  }
+
+  gst_buffer_map_range (outbuf, 0, 1, &map, GST_MAP_WRITE);
   GST_DEBUG_OBJECT (rtph264depay, "output %d bytes", outsize);
 
   if (rtph264depay->byte_stream) {
@@ -1157,6 +1224,7 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
   /* flush remaining data on discont */
   if (GST_BUFFER_IS_DISCONT (rtp->buffer)) {
     gst_adapter_clear (rtph264depay->adapter);
+    gst_clear_buffer (&rtph264depay->fu_header);
     rtph264depay->wait_start = TRUE;
     rtph264depay->current_fu_type = 0;
     rtph264depay->last_fu_seqnum = 0;
@@ -1336,6 +1404,27 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           /* reconstruct NAL header */
           nal_header = (payload[0] & 0xe0) | (payload[1] & 0x1f);
 
+          if (gst_rtp_h264_depay_use_zero_copy (rtph264depay)) {
+            /* keep the prefix and NAL header aside until the size of the
+             * NAL is known and queue the fragment without copying */
+            rtph264depay->fu_header =
+                gst_buffer_new_allocate (NULL, sizeof (sync_bytes) + 1, NULL);
+            gst_buffer_fill (rtph264depay->fu_header, sizeof (sync_bytes),
+                &nal_header, 1);
+            gst_rtp_copy_video_meta (rtph264depay, rtph264depay->fu_header,
+                rtp->buffer);
+
+            outbuf = gst_buffer_copy_region (rtp->buffer,
+                GST_BUFFER_COPY_MEMORY,
+                gst_rtp_buffer_get_header_len (rtp) + 2, payload_len - 2);
+
+            GST_DEBUG_OBJECT (rtph264depay, "queueing %d bytes",
+                payload_len - 2);
+
+            gst_adapter_push (rtph264depay->adapter, outbuf);
+            goto fu_queued;
+          }
+
           /* strip type header, keep FU header, we'll reuse it to reconstruct
            * the NAL header. */
           payload += 1;
@@ -1362,6 +1451,7 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
             GST_WARNING_OBJECT (rtph264depay, "missing FU start bit on an "
                 "earlier packet. Dropping.");
             gst_adapter_clear (rtph264depay->adapter);
+            gst_clear_buffer (&rtph264depay->fu_header);
             return NULL;
           }
           if (gst_rtp_buffer_compare_seqnum (rtph264depay->last_fu_seqnum,
@@ -1372,6 +1462,7 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
                 "stored.", rtph264depay->last_fu_seqnum,
                 gst_rtp_buffer_get_seq (rtp));
             gst_adapter_clear (rtph264depay->adapter);
+            gst_clear_buffer (&rtph264depay->fu_header);
             return NULL;
           }
           rtph264depay->last_fu_seqnum = gst_rtp_buffer_get_seq (rtp);
@@ -1381,10 +1472,16 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           payload_len -= 2;
 
           outsize = payload_len;
-          outbuf = gst_buffer_new_and_alloc (outsize);
-          gst_buffer_fill (outbuf, 0, payload, outsize);
+          if (rtph264depay->fu_header) {
+            outbuf = gst_buffer_copy_region (rtp->buffer,
+                GST_BUFFER_COPY_MEMORY,
+                gst_rtp_buffer_get_header_len (rtp) + 2, outsize);
+          } else {
+            outbuf = gst_buffer_new_and_alloc (outsize);
+            gst_buffer_fill (outbuf, 0, payload, outsize);
 
-          gst_rtp_copy_video_meta (rtph264depay, outbuf, rtp->buffer);
+            gst_rtp_copy_video_meta (rtph264depay, outbuf, rtp->buffer);
+          }
 
           GST_DEBUG_OBJECT (rtph264depay, "queueing %d bytes", outsize);
 
@@ -1392,6 +1489,7 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           gst_adapter_push (rtph264depay->adapter, outbuf);
         }
 
+      fu_queued:
         outbuf = NULL;
         rtph264depay->fu_marker = marker;
 
@@ -1408,9 +1506,16 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
         /* the entire payload is the output buffer */
         nalu_size = payload_len;
         outsize = nalu_size + sizeof (sync_bytes);
-        outbuf = gst_buffer_new_and_alloc (outsize);
+        if (gst_rtp_h264_depay_use_zero_copy (rtph264depay)) {
+          outbuf = gst_rtp_h264_depay_wrap_payload (rtp, sizeof (sync_bytes),
+              0, nalu_size);
+          gst_buffer_map_range (outbuf, 0, 1, &map, GST_MAP_WRITE);
+        } else {
+          outbuf = gst_buffer_new_and_alloc (outsize);
+          gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
+          memcpy (map.data + sizeof (sync_bytes), payload, nalu_size);
+        }
 
-        gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
         if (rtph264depay->byte_stream) {
           memcpy (map.data, sync_bytes, sizeof (sync_bytes));
         } else {
@@ -1418,7 +1523,6 @@ gst_rtp_h264_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           map.data[2] = nalu_size >> 8;
           map.data[3] = nalu_size & 0xff;
         }
-        memcpy (map.data + sizeof (sync_bytes), payload, nalu_size);
         gst_buffer_unmap (outbuf, &map);
 
         gst_rtp_copy_video_meta (rtph264depay, outbuf, rtp->buffer);
@@ -75,6 +75,11 @@ struct _GstRtpH264Depay
   gboolean wait_for_keyframe;
   gboolean request_keyframe;
   gboolean waiting_for_keyframe;
+
+  /* reference the RTP packet memory in the output */
+  gboolean zero_copy;
+  /* prefix and NAL header of the zero-copy FU being assembled */
+  GstBuffer *fu_header;
 };
 
 struct _GstRtpH264DepayClass
@@ -101,6 +101,7 @@ GST_STATIC_PAD_TEMPLATE ("src",
 #define DEFAULT_SPROP_PARAMETER_SETS    NULL
 #define DEFAULT_CONFIG_INTERVAL         0
 #define DEFAULT_AGGREGATE_MODE          GST_RTP_H264_AGGREGATE_NONE
+#define DEFAULT_BUFFER_LIST             FALSE
 
 enum
 {
@@ -108,6 +109,7 @@ enum
   PROP_SPROP_PARAMETER_SETS,
   PROP_CONFIG_INTERVAL,
   PROP_AGGREGATE_MODE,
+  PROP_BUFFER_LIST,
 };
 
 static void gst_rtp_h264_pay_finalize (GObject * object);
@@ -193,6 +195,25 @@ gst_rtp_h264_pay_class_init (GstRtpH264PayClass * klass)
           DEFAULT_AGGREGATE_MODE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
 
+  /**
+   * GstRtpH264Pay:buffer-list
+   *
+   * Collect all RTP packets generated from one input buffer (one access unit
+   * for AU aligned input) and push them downstream as a single
+   * #GstBufferList instead of pushing them NAL unit by NAL unit.
+   *
+   * The packets reference the memory of the input buffer, so no NAL unit data
+   * is copied.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_BUFFER_LIST,
+      g_param_spec_boolean ("buffer-list", "Buffer List",
+          "Push all packets of an access unit as one buffer list",
+          DEFAULT_BUFFER_LIST, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
+
   gobject_class->finalize = gst_rtp_h264_pay_finalize;
 
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -231,6 +252,7 @@ gst_rtp_h264_pay_init (GstRtpH264Pay * rtph264pay)
   rtph264pay->last_spspps = -1;
   rtph264pay->spspps_interval = DEFAULT_CONFIG_INTERVAL;
   rtph264pay->aggregate_mode = DEFAULT_AGGREGATE_MODE;
+  rtph264pay->buffer_list = DEFAULT_BUFFER_LIST;
   rtph264pay->delta_unit = FALSE;
   rtph264pay->discont = FALSE;
 
@@ -263,6 +285,7 @@ gst_rtp_h264_pay_finalize (GObject * object)
 
   g_object_unref (rtph264pay->adapter);
   gst_rtp_h264_pay_reset_bundle (rtph264pay);
+  g_clear_pointer (&rtph264pay->au_list, gst_buffer_list_unref);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -846,6 +869,46 @@ gst_rtp_h264_pay_decode_nal (GstRtpH264Pay * payloader,
   return updated;
 }
 
+static GstFlowReturn
+gst_rtp_h264_pay_push_au_list (GstRtpH264Pay * rtph264pay)
+{
+  GstBufferList *list;
+
+  list = rtph264pay->au_list;
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  rtph264pay->au_list = NULL;
+
+  GST_LOG_OBJECT (rtph264pay, "pushing list of %u packets",
+      gst_buffer_list_length (list));
+
+  return gst_rtp_base_payload_push_list (GST_RTP_BASE_PAYLOAD (rtph264pay),
+      list);
+}
+
+/* Make sure there is a pending access unit list that packets with @pts can be
+ * added to. The base class gives all packets of a list the RTP timestamp of
+ * the first one, so a pending list with another timestamp is pushed first. */
+static GstFlowReturn
+gst_rtp_h264_pay_prepare_au_list (GstRtpH264Pay * rtph264pay, GstClockTime pts,
+    guint n_packets)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (rtph264pay->au_list) {
+    GstBuffer *first = gst_buffer_list_get (rtph264pay->au_list, 0);
+
+    if (GST_BUFFER_PTS (first) != pts)
+      ret = gst_rtp_h264_pay_push_au_list (rtph264pay);
+  }
+
+  if (rtph264pay->au_list == NULL)
+    rtph264pay->au_list = gst_buffer_list_new_sized (MAX (n_packets, 16));
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_h264_pay_payload_nal (GstRTPBasePayload * basepayload,
     GstBuffer * paybuf, GstClockTime dts, GstClockTime pts, gboolean end_of_au,
@@ -1036,6 +1099,7 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   guint8 *payload;
   GstBufferList *list = NULL;
   GstRTPBuffer rtp = { NULL };
+  GstFlowReturn ret;
 
   rtph264pay = GST_RTP_H264_PAY (basepayload);
   mtu = GST_RTP_BASE_PAYLOAD_MTU (rtph264pay);
@@ -1055,7 +1119,18 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   /* We keep 2 bytes for FU indicator and FU Header */
   max_fragment_size = gst_rtp_buffer_calc_payload_len (mtu - 2, 0, 0);
   max_fragments = (size + max_fragment_size - 2) / max_fragment_size;
-  list = gst_buffer_list_new_sized (max_fragments);
+
+  if (rtph264pay->buffer_list) {
+    /* add the fragments to the list of the current access unit */
+    ret = gst_rtp_h264_pay_prepare_au_list (rtph264pay, pts, max_fragments);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (paybuf);
+      return ret;
+    }
+    list = rtph264pay->au_list;
+  } else {
+    list = gst_buffer_list_new_sized (max_fragments);
+  }
 
   /* Start at the NALU payload */
   for (pos = 1, ii = 0; pos < size; pos += max_fragment_size, ii++) {
@@ -1122,6 +1197,10 @@ gst_rtp_h264_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
       "sending FU-A fragments: n=%u datasize=%u mtu=%u", ii, size, mtu);
 
   gst_buffer_unref (paybuf);
+
+  if (list == rtph264pay->au_list)
+    return GST_FLOW_OK;
+
   return gst_rtp_base_payload_push_list (basepayload, list);
 }
 
@@ -1163,6 +1242,18 @@ gst_rtp_h264_pay_payload_nal_single (GstRTPBasePayload * basepayload,
   gst_rtp_copy_video_meta (rtph264pay, outbuf, paybuf);
   outbuf = gst_buffer_append (outbuf, paybuf);
 
+  if (rtph264pay->buffer_list) {
+    GstFlowReturn ret;
+
+    ret = gst_rtp_h264_pay_prepare_au_list (rtph264pay, pts, 1);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (outbuf);
+      return ret;
+    }
+    gst_buffer_list_add (rtph264pay->au_list, outbuf);
+    return GST_FLOW_OK;
+  }
+
   /* push the buffer to the next element */
   return gst_rtp_base_payload_push (basepayload, outbuf);
 }
@@ -1640,7 +1731,12 @@ gst_rtp_h264_pay_handle_buffer (GstRTPBasePayload * basepayload,
             marker || draining)
           end_of_au = TRUE;
       }
-      paybuf = gst_adapter_take_buffer (rtph264pay->adapter, size);
+      /* in buffer-list mode, don't merge NAL units spanning multiple input
+       * memories, the packets only reference them */
+      if (rtph264pay->buffer_list)
+        paybuf = gst_adapter_take_buffer_fast (rtph264pay->adapter, size);
+      else
+        paybuf = gst_adapter_take_buffer (rtph264pay->adapter, size);
       g_assert (paybuf);
 
       /* put the data in one or more RTP packets */
@@ -1688,6 +1784,13 @@ done:
     gst_adapter_unmap (rtph264pay->adapter);
   }
 
+  if (rtph264pay->au_list) {
+    if (ret == GST_FLOW_OK)
+      ret = gst_rtp_h264_pay_push_au_list (rtph264pay);
+    else
+      g_clear_pointer (&rtph264pay->au_list, gst_buffer_list_unref);
+  }
+
   return ret;
 
 caps_rejected:
@@ -1711,6 +1814,7 @@ gst_rtp_h264_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
     case GST_EVENT_FLUSH_STOP:
       gst_adapter_clear (rtph264pay->adapter);
       gst_rtp_h264_pay_reset_bundle (rtph264pay);
+      g_clear_pointer (&rtph264pay->au_list, gst_buffer_list_unref);
       break;
     case GST_EVENT_CUSTOM_DOWNSTREAM:
       s = gst_event_get_structure (event);
@@ -1729,12 +1833,16 @@ gst_rtp_h264_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
        */
       gst_rtp_h264_pay_handle_buffer (payload, NULL);
       ret = gst_rtp_h264_pay_send_bundle (rtph264pay, TRUE);
+      if (ret == GST_FLOW_OK)
+        ret = gst_rtp_h264_pay_push_au_list (rtph264pay);
       break;
     }
     case GST_EVENT_STREAM_START:
       GST_DEBUG_OBJECT (rtph264pay, "New stream detected => Clear SPS and PPS");
       gst_rtp_h264_pay_clear_sps_pps (rtph264pay);
       ret = gst_rtp_h264_pay_send_bundle (rtph264pay, TRUE);
+      if (ret == GST_FLOW_OK)
+        ret = gst_rtp_h264_pay_push_au_list (rtph264pay);
       break;
     default:
       break;
@@ -1759,6 +1867,7 @@ gst_rtp_h264_pay_change_state (GstElement * element, GstStateChange transition)
       rtph264pay->send_spspps = FALSE;
       gst_adapter_clear (rtph264pay->adapter);
       gst_rtp_h264_pay_reset_bundle (rtph264pay);
+      g_clear_pointer (&rtph264pay->au_list, gst_buffer_list_unref);
       break;
     default:
       break;
@@ -1798,6 +1907,9 @@ gst_rtp_h264_pay_set_property (GObject * object, guint prop_id,
     case PROP_AGGREGATE_MODE:
       rtph264pay->aggregate_mode = g_value_get_enum (value);
       break;
+    case PROP_BUFFER_LIST:
+      rtph264pay->buffer_list = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1822,6 +1934,9 @@ gst_rtp_h264_pay_get_property (GObject * object, guint prop_id,
     case PROP_AGGREGATE_MODE:
       g_value_set_enum (value, rtph264pay->aggregate_mode);
       break;
+    case PROP_BUFFER_LIST:
+      g_value_set_boolean (value, rtph264pay->buffer_list);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
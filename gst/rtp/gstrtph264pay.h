@@ -95,6 +95,10 @@ struct _GstRtpH264Pay
   guint bundle_size;
   gboolean bundle_contains_vcl;
   GstRTPH264AggregateMode aggregate_mode;
+
+  /* packets of the current access unit in buffer-list mode */
+  gboolean buffer_list;
+  GstBufferList *au_list;
 };
 
 struct _GstRtpH264PayClass
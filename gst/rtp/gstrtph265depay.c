@@ -39,6 +39,13 @@ GST_DEBUG_CATEGORY_STATIC (rtph265depay_debug);
  * expressed a restriction or preference via caps */
 #define DEFAULT_STREAM_FORMAT GST_H265_STREAM_FORMAT_BYTESTREAM
 #define DEFAULT_ACCESS_UNIT   FALSE
+#define DEFAULT_ZERO_COPY     FALSE
+
+enum
+{
+  PROP_0,
+  PROP_ZERO_COPY,
+};
 
 /* 3 zero bytes syncword */
 static const guint8 sync_bytes[] = { 0, 0, 0, 1 };
@@ -119,6 +126,37 @@ static void gst_rtp_h265_depay_push (GstRtpH265Depay * rtph265depay,
     GstBuffer * outbuf, gboolean keyframe, GstClockTime timestamp,
     gboolean marker);
 
+static void
+gst_rtp_h265_depay_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRtpH265Depay *self = GST_RTP_H265_DEPAY (object);
+
+  switch (prop_id) {
+    case PROP_ZERO_COPY:
+      self->zero_copy = g_value_get_boolean (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_h265_depay_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpH265Depay *self = GST_RTP_H265_DEPAY (object);
+
+  switch (prop_id) {
+    case PROP_ZERO_COPY:
+      g_value_set_boolean (value, self->zero_copy);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
 
 static void
 gst_rtp_h265_depay_class_init (GstRtpH265DepayClass * klass)
@@ -132,6 +170,25 @@ gst_rtp_h265_depay_class_init (GstRtpH265DepayClass * klass)
   gstrtpbasedepayload_class = (GstRTPBaseDepayloadClass *) klass;
 
   gobject_class->finalize = gst_rtp_h265_depay_finalize;
+  gobject_class->set_property = gst_rtp_h265_depay_set_property;
+  gobject_class->get_property = gst_rtp_h265_depay_get_property;
+
+  /**
+   * GstRtpH265Depay:zero-copy:
+   *
+   * Build the output NAL units and access units from the memory of the
+   * incoming RTP packets instead of copying the payload. Start codes and NAL
+   * headers are added as separate small memories.
+   *
+   * When downstream proposes an allocator in the ALLOCATION query the output
+   * is still copied into memory from that allocator.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero Copy",
+          "Reference the RTP packet memory in the output instead of copying",
+          DEFAULT_ZERO_COPY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_rtp_h265_depay_src_template);
@@ -165,12 +222,14 @@ gst_rtp_h265_depay_init (GstRtpH265Depay * rtph265depay)
       (GDestroyNotify) gst_buffer_unref);
   rtph265depay->pps = g_ptr_array_new_with_free_func (
       (GDestroyNotify) gst_buffer_unref);
+  rtph265depay->zero_copy = DEFAULT_ZERO_COPY;
 }
 
 static void
 gst_rtp_h265_depay_reset (GstRtpH265Depay * rtph265depay, gboolean hard)
 {
   gst_adapter_clear (rtph265depay->adapter);
+  gst_clear_buffer (&rtph265depay->fu_header);
   rtph265depay->wait_start = TRUE;
   gst_adapter_clear (rtph265depay->picture_adapter);
   rtph265depay->picture_start = FALSE;
@@ -218,6 +277,7 @@ gst_rtp_h265_depay_finalize (GObject * object)
 
   g_object_unref (rtph265depay->adapter);
   g_object_unref (rtph265depay->picture_adapter);
+  gst_clear_buffer (&rtph265depay->fu_header);
 
   g_ptr_array_free (rtph265depay->vps, TRUE);
   g_ptr_array_free (rtph265depay->sps, TRUE);
@@ -965,6 +1025,30 @@ gst_rtp_h265_depay_allocate_output_buffer (GstRtpH265Depay * depay, gsize size)
   return buffer;
 }
 
+/* Output can reference the RTP packet memory unless downstream wants the data
+ * in memory from its own allocator */
+static inline gboolean
+gst_rtp_h265_depay_use_zero_copy (GstRtpH265Depay * depay)
+{
+  return depay->zero_copy && depay->allocator == NULL;
+}
+
+/* Create a buffer referencing @size bytes of the payload of @rtp starting at
+ * @offset, preceded by a new memory of @prefix_size bytes that the caller
+ * fills with the start code or NAL length */
+static GstBuffer *
+gst_rtp_h265_depay_wrap_payload (GstRTPBuffer * rtp, guint prefix_size,
+    guint offset, guint size)
+{
+  GstBuffer *outbuf, *payload;
+
+  outbuf = gst_buffer_new_allocate (NULL, prefix_size, NULL);
+  payload = gst_buffer_copy_region (rtp->buffer, GST_BUFFER_COPY_MEMORY,
+      gst_rtp_buffer_get_header_len (rtp) + offset, size);
+
+  return gst_buffer_append (outbuf, payload);
+}
+
 static GstBuffer *
 gst_rtp_h265_complete_au (GstRtpH265Depay * rtph265depay,
     GstClockTime * out_timestamp, gboolean * out_keyframe)
@@ -979,6 +1063,13 @@ gst_rtp_h265_complete_au (GstRtpH265Depay * rtph265depay,
   GST_DEBUG_OBJECT (rtph265depay, "taking completed AU");
   outsize = gst_adapter_available (rtph265depay->picture_adapter);
 
+  if (gst_rtp_h265_depay_use_zero_copy (rtph265depay)) {
+    /* chain the memories of the NAL units instead of copying them */
+    outbuf = gst_adapter_take_buffer_fast (rtph265depay->picture_adapter,
+        outsize);
+    goto done;
+  }
+
   outbuf = gst_rtp_h265_depay_allocate_output_buffer (rtph265depay, outsize);
 
   if (outbuf == NULL)
@@ -1013,6 +1104,7 @@ gst_rtp_h265_complete_au (GstRtpH265Depay * rtph265depay,
   gst_buffer_list_unref (list);
   gst_buffer_unmap (outbuf, &outmap);
 
+done:
   *out_timestamp = rtph265depay->last_ts;
   *out_keyframe = rtph265depay->last_keyframe;
 
@@ -1089,16 +1181,17 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
 {
   GstRTPBaseDepayload *depayload = GST_RTP_BASE_DEPAYLOAD (rtph265depay);
   gint nal_type;
-  GstMapInfo map;
+  guint8 header[7] = { 0, };
   GstBuffer *outbuf = NULL;
   GstClockTime out_timestamp;
   gboolean keyframe, out_keyframe;
 
-  gst_buffer_map (nal, &map, GST_MAP_READ);
-  if (G_UNLIKELY (map.size < 5))
+  /* only look at the prefix and NAL header, mapping the whole NAL would merge
+   * the memories of a zero-copy NAL */
+  if (G_UNLIKELY (gst_buffer_extract (nal, 0, header, sizeof (header)) < 5))
     goto short_nal;
 
-  nal_type = (map.data[4] >> 1) & 0x3f;
+  nal_type = (header[4] >> 1) & 0x3f;
   GST_DEBUG_OBJECT (rtph265depay, "handle NAL type %d (RTP marker bit %d)",
       nal_type, marker);
 
@@ -1112,7 +1205,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
       gst_rtp_h265_depay_add_vps_sps_pps (rtph265depay,
           gst_buffer_copy_region (nal, GST_BUFFER_COPY_ALL,
               4, gst_buffer_get_size (nal) - 4));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     } else if (rtph265depay->sps->len == 0 || rtph265depay->pps->len == 0) {
@@ -1123,7 +1215,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
           gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
               gst_structure_new ("GstForceKeyUnit",
                   "all-headers", G_TYPE_BOOLEAN, TRUE, NULL)));
-      gst_buffer_unmap (nal, &map);
       gst_buffer_unref (nal);
       return;
     }
@@ -1142,7 +1233,7 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
       if (NAL_TYPE_IS_CODED_SLICE_SEGMENT (nal_type)) {
         /* A NAL unit (X) ends an access unit if the next-occurring VCL NAL unit (Y) has the high-order bit of the first byte after its NAL unit header equal to 1 */
         start = TRUE;
-        if (((map.data[6] >> 7) & 0x01) == 1) {
+        if (((header[6] >> 7) & 0x01) == 1) {
           complete = TRUE;
         }
       } else if ((nal_type >= 32 && nal_type <= 35)
@@ -1158,8 +1249,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
             &out_keyframe);
     }
     /* add to adapter */
-    gst_buffer_unmap (nal, &map);
-
     GST_DEBUG_OBJECT (depayload, "adding NAL to picture adapter");
     gst_adapter_push (rtph265depay->picture_adapter, nal);
     rtph265depay->last_ts = in_timestamp;
@@ -1173,7 +1262,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
     /* no merge, output is input nal */
     GST_DEBUG_OBJECT (depayload, "using NAL as output");
     outbuf = nal;
-    gst_buffer_unmap (nal, &map);
   }
 
   if (outbuf) {
@@ -1187,7 +1275,6 @@ gst_rtp_h265_depay_handle_nal (GstRtpH265Depay * rtph265depay, GstBuffer * nal,
 short_nal:
   {
     GST_WARNING_OBJECT (depayload, "dropping short NAL");
-    gst_buffer_unmap (nal, &map);
     gst_buffer_unref (nal);
     return;
   }
@@ -1201,11 +1288,23 @@ gst_rtp_h265_finish_fragmentation_unit (GstRtpH265Depay * rtph265depay)
   GstBuffer *outbuf;
 
   outsize = gst_adapter_available (rtph265depay->adapter);
-  g_assert (outsize >= 4);
 
-  outbuf = gst_adapter_take_buffer (rtph265depay->adapter, outsize);
+  if (rtph265depay->fu_header) {
+    /* zero-copy: the fragments stay in the RTP packet memory, the prefix
+     * and NAL header live in their own memory */
+    outbuf = rtph265depay->fu_header;
+    rtph265depay->fu_header = NULL;
+    if (outsize > 0)
+      outbuf = gst_buffer_append (outbuf,
+          gst_adapter_take_buffer_fast (rtph265depay->adapter, outsize));
+    outsize += sizeof (sync_bytes) + 2;
+  } else {
+    g_assert (outsize >= 4);
 
-  gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
+    outbuf = gst_adapter_take_buffer (rtph265depay->adapter, outsize);
+  }
+
+  gst_buffer_map_range (outbuf, 0, 1, &map, GST_MAP_WRITE);
   GST_DEBUG_OBJECT (rtph265depay, "output %d bytes", outsize);
 
   if (rtph265depay->byte_stream) {
@@ -1233,6 +1332,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
   /* flush remaining data on discont */
   if (GST_BUFFER_IS_DISCONT (rtp->buffer)) {
     gst_adapter_clear (rtph265depay->adapter);
+    gst_clear_buffer (&rtph265depay->fu_header);
     rtph265depay->wait_start = TRUE;
     rtph265depay->current_fu_type = 0;
     rtph265depay->last_fu_seqnum = 0;
@@ -1442,6 +1542,33 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
               ((payload[0] & 0x3f) << 9) | (nuh_layer_id << 3) |
               nuh_temporal_id_plus1;
 
+          if (gst_rtp_h265_depay_use_zero_copy (rtph265depay)) {
+            guint8 hdr[2];
+
+            /* keep the prefix and NAL header aside until the size of the
+             * NAL is known and queue the fragment without copying */
+            hdr[0] = nal_header >> 8;
+            hdr[1] = nal_header & 0xff;
+            rtph265depay->fu_header =
+                gst_buffer_new_allocate (NULL, sizeof (sync_bytes) + 2, NULL);
+            gst_buffer_fill (rtph265depay->fu_header, sizeof (sync_bytes),
+                hdr, 2);
+            gst_rtp_copy_video_meta (rtph265depay, rtph265depay->fu_header,
+                rtp->buffer);
+
+            /* skip PayloadHdr and FU header */
+            outbuf = gst_buffer_copy_region (rtp->buffer,
+                GST_BUFFER_COPY_MEMORY,
+                gst_rtp_buffer_get_header_len (rtp) + header_len + 1,
+                payload_len - 1);
+
+            GST_DEBUG_OBJECT (rtph265depay, "queueing %d bytes",
+                payload_len - 1);
+
+            gst_adapter_push (rtph265depay->adapter, outbuf);
+            goto fu_queued;
+          }
+
           /* go back one byte so we can copy the payload + two bytes more in the front which
            * will be overwritten by the nal_header
            */
@@ -1476,6 +1603,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
             GST_WARNING_OBJECT (rtph265depay, "missing FU start bit on an "
                 "earlier packet. Dropping.");
             gst_adapter_clear (rtph265depay->adapter);
+            gst_clear_buffer (&rtph265depay->fu_header);
             return NULL;
           }
           if (gst_rtp_buffer_compare_seqnum (rtph265depay->last_fu_seqnum,
@@ -1486,6 +1614,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
                 "stored.", rtph265depay->last_fu_seqnum,
                 gst_rtp_buffer_get_seq (rtp));
             gst_adapter_clear (rtph265depay->adapter);
+            gst_clear_buffer (&rtph265depay->fu_header);
             return NULL;
           }
           rtph265depay->last_fu_seqnum = gst_rtp_buffer_get_seq (rtp);
@@ -1498,10 +1627,16 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           payload_len -= 1;
 
           outsize = payload_len;
-          outbuf = gst_buffer_new_and_alloc (outsize);
-          gst_buffer_fill (outbuf, 0, payload, outsize);
+          if (rtph265depay->fu_header) {
+            outbuf = gst_buffer_copy_region (rtp->buffer,
+                GST_BUFFER_COPY_MEMORY,
+                gst_rtp_buffer_get_header_len (rtp) + header_len + 1, outsize);
+          } else {
+            outbuf = gst_buffer_new_and_alloc (outsize);
+            gst_buffer_fill (outbuf, 0, payload, outsize);
 
-          gst_rtp_copy_video_meta (rtph265depay, outbuf, rtp->buffer);
+            gst_rtp_copy_video_meta (rtph265depay, outbuf, rtp->buffer);
+          }
 
           GST_DEBUG_OBJECT (rtph265depay, "queueing %d bytes", outsize);
 
@@ -1509,6 +1644,7 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
           gst_adapter_push (rtph265depay->adapter, outbuf);
         }
 
+      fu_queued:
         outbuf = NULL;
         rtph265depay->fu_marker = marker;
 
@@ -1535,15 +1671,21 @@ gst_rtp_h265_depay_process (GstRTPBaseDepayload * depayload, GstRTPBuffer * rtp)
 
         nalu_size = payload_len;
         outsize = nalu_size + sizeof (sync_bytes);
-        outbuf = gst_buffer_new_and_alloc (outsize);
+        if (gst_rtp_h265_depay_use_zero_copy (rtph265depay)) {
+          outbuf = gst_rtp_h265_depay_wrap_payload (rtp, sizeof (sync_bytes),
+              0, nalu_size);
+          gst_buffer_map_range (outbuf, 0, 1, &map, GST_MAP_WRITE);
+        } else {
+          outbuf = gst_buffer_new_and_alloc (outsize);
+          gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
+          memcpy (map.data + 4, payload, nalu_size);
+        }
 
-        gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
         if (rtph265depay->byte_stream) {
           memcpy (map.data, sync_bytes, sizeof (sync_bytes));
         } else {
           GST_WRITE_UINT32_BE (map.data, nalu_size);
         }
-        memcpy (map.data + 4, payload, nalu_size);
         gst_buffer_unmap (outbuf, &map);
 
         gst_rtp_copy_video_meta (rtph265depay, outbuf, rtp->buffer);
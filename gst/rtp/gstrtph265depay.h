@@ -86,6 +86,11 @@ struct _GstRtpH265Depay
   /* downstream allocator */
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  /* reference the RTP packet memory in the output */
+  gboolean zero_copy;
+  /* prefix and NAL header of the zero-copy FU being assembled */
+  GstBuffer *fu_header;
 };
 
 struct _GstRtpH265DepayClass
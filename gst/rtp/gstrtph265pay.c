@@ -135,12 +135,14 @@ GST_STATIC_PAD_TEMPLATE ("src",
 
 #define DEFAULT_CONFIG_INTERVAL         0
 #define DEFAULT_AGGREGATE_MODE          GST_RTP_H265_AGGREGATE_NONE
+#define DEFAULT_BUFFER_LIST             FALSE
 
 enum
 {
   PROP_0,
   PROP_CONFIG_INTERVAL,
   PROP_AGGREGATE_MODE,
+  PROP_BUFFER_LIST,
 };
 
 static void gst_rtp_h265_pay_finalize (GObject * object);
@@ -217,6 +219,25 @@ gst_rtp_h265_pay_class_init (GstRtpH265PayClass * klass)
           DEFAULT_AGGREGATE_MODE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
 
+  /**
+   * GstRtpH265Pay:buffer-list
+   *
+   * Collect all RTP packets generated from one input buffer (one access unit
+   * for AU aligned input) and push them downstream as a single
+   * #GstBufferList instead of one list per NAL unit.
+   *
+   * The packets reference the memory of the input buffer, so no NAL unit data
+   * is copied.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      PROP_BUFFER_LIST,
+      g_param_spec_boolean ("buffer-list", "Buffer List",
+          "Push all packets of an access unit as one buffer list",
+          DEFAULT_BUFFER_LIST, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
+
   gobject_class->finalize = gst_rtp_h265_pay_finalize;
 
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -256,6 +277,7 @@ gst_rtp_h265_pay_init (GstRtpH265Pay * rtph265pay)
   rtph265pay->last_vps_sps_pps = -1;
   rtph265pay->vps_sps_pps_interval = DEFAULT_CONFIG_INTERVAL;
   rtph265pay->aggregate_mode = DEFAULT_AGGREGATE_MODE;
+  rtph265pay->buffer_list = DEFAULT_BUFFER_LIST;
 
   rtph265pay->adapter = gst_adapter_new ();
 
@@ -287,6 +309,7 @@ gst_rtp_h265_pay_finalize (GObject * object)
   g_object_unref (rtph265pay->adapter);
 
   gst_rtp_h265_pay_reset_bundle (rtph265pay);
+  g_clear_pointer (&rtph265pay->au_list, gst_buffer_list_unref);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -994,6 +1017,46 @@ gst_rtp_h265_pay_reset_bundle (GstRtpH265Pay * rtph265pay)
   rtph265pay->bundle_contains_vcl_or_suffix = FALSE;
 }
 
+static GstFlowReturn
+gst_rtp_h265_pay_push_au_list (GstRtpH265Pay * rtph265pay)
+{
+  GstBufferList *list;
+
+  list = rtph265pay->au_list;
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  rtph265pay->au_list = NULL;
+
+  GST_LOG_OBJECT (rtph265pay, "pushing list of %u packets",
+      gst_buffer_list_length (list));
+
+  return gst_rtp_base_payload_push_list (GST_RTP_BASE_PAYLOAD (rtph265pay),
+      list);
+}
+
+/* Make sure there is a pending access unit list that packets with @pts can be
+ * added to. The base class gives all packets of a list the RTP timestamp of
+ * the first one, so a pending list with another timestamp is pushed first. */
+static GstFlowReturn
+gst_rtp_h265_pay_prepare_au_list (GstRtpH265Pay * rtph265pay, GstClockTime pts,
+    guint n_packets)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  if (rtph265pay->au_list) {
+    GstBuffer *first = gst_buffer_list_get (rtph265pay->au_list, 0);
+
+    if (GST_BUFFER_PTS (first) != pts)
+      ret = gst_rtp_h265_pay_push_au_list (rtph265pay);
+  }
+
+  if (rtph265pay->au_list == NULL)
+    rtph265pay->au_list = gst_buffer_list_new_sized (MAX (n_packets, 16));
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_h265_pay_payload_nal (GstRTPBasePayload * basepayload,
     GPtrArray * paybufs, GstClockTime dts, GstClockTime pts,
@@ -1133,6 +1196,7 @@ gst_rtp_h265_pay_payload_nal_single (GstRTPBasePayload * basepayload,
     GstBuffer * paybuf, GstClockTime dts, GstClockTime pts, gboolean marker,
     gboolean delta_unit)
 {
+  GstRtpH265Pay *rtph265pay = (GstRtpH265Pay *) basepayload;
   GstBufferList *outlist;
   GstBuffer *outbuf;
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
@@ -1159,13 +1223,25 @@ gst_rtp_h265_pay_payload_nal_single (GstRTPBasePayload * basepayload,
   gst_rtp_copy_video_meta (basepayload, outbuf, paybuf);
   outbuf = gst_buffer_append (outbuf, paybuf);
 
+  gst_rtp_buffer_unmap (&rtp);
+
+  if (rtph265pay->buffer_list) {
+    GstFlowReturn ret;
+
+    ret = gst_rtp_h265_pay_prepare_au_list (rtph265pay, pts, 1);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (outbuf);
+      return ret;
+    }
+    gst_buffer_list_add (rtph265pay->au_list, outbuf);
+    return GST_FLOW_OK;
+  }
+
   outlist = gst_buffer_list_new ();
 
   /* add the buffer to the buffer list */
   gst_buffer_list_add (outlist, outbuf);
 
-  gst_rtp_buffer_unmap (&rtp);
-
   /* push the list to the next element in the pipe */
   return gst_rtp_base_payload_push_list (basepayload, outlist);
 }
@@ -1201,7 +1277,18 @@ gst_rtp_h265_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
   /* We keep 3 bytes for PayloadHdr and FU Header */
   max_fragment_size = gst_rtp_buffer_calc_payload_len (mtu - 3, 0, 0);
 
-  outlist = gst_buffer_list_new ();
+  if (rtph265pay->buffer_list) {
+    /* add the fragments to the list of the current access unit */
+    ret = gst_rtp_h265_pay_prepare_au_list (rtph265pay, pts,
+        (size - 2 + max_fragment_size - 1) / max_fragment_size);
+    if (ret != GST_FLOW_OK) {
+      gst_buffer_unref (paybuf);
+      return ret;
+    }
+    outlist = rtph265pay->au_list;
+  } else {
+    outlist = gst_buffer_list_new ();
+  }
 
   for (pos = 2, ii = 0; pos < size; pos += max_fragment_size, ii++) {
     guint remaining, fragment_size;
@@ -1258,9 +1345,13 @@ gst_rtp_h265_pay_payload_nal_fragment (GstRTPBasePayload * basepayload,
     gst_buffer_list_add (outlist, outbuf);
   }
 
-  ret = gst_rtp_base_payload_push_list (basepayload, outlist);
   gst_buffer_unref (paybuf);
 
+  if (outlist == rtph265pay->au_list)
+    return GST_FLOW_OK;
+
+  ret = gst_rtp_base_payload_push_list (basepayload, outlist);
+
   return ret;
 }
 
@@ -1694,7 +1785,12 @@ gst_rtp_h265_pay_handle_buffer (GstRTPBasePayload * basepayload,
         for (; size > 2 && data[size - 1] == 0x0; size--)
           /* skip */ ;
 
-      paybuf = gst_adapter_take_buffer (rtph265pay->adapter, size);
+      /* in buffer-list mode, don't merge NAL units spanning multiple input
+       * memories, the packets only reference them */
+      if (rtph265pay->buffer_list)
+        paybuf = gst_adapter_take_buffer_fast (rtph265pay->adapter, size);
+      else
+        paybuf = gst_adapter_take_buffer (rtph265pay->adapter, size);
       g_assert (paybuf);
       g_ptr_array_add (paybufs, paybuf);
 
@@ -1744,6 +1840,13 @@ done:
     gst_adapter_unmap (rtph265pay->adapter);
   }
 
+  if (rtph265pay->au_list) {
+    if (ret == GST_FLOW_OK)
+      ret = gst_rtp_h265_pay_push_au_list (rtph265pay);
+    else
+      g_clear_pointer (&rtph265pay->au_list, gst_buffer_list_unref);
+  }
+
   return ret;
 
 caps_rejected:
@@ -1767,6 +1870,7 @@ gst_rtp_h265_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
     case GST_EVENT_FLUSH_STOP:
       gst_adapter_clear (rtph265pay->adapter);
       gst_rtp_h265_pay_reset_bundle (rtph265pay);
+      g_clear_pointer (&rtph265pay->au_list, gst_buffer_list_unref);
       break;
     case GST_EVENT_CUSTOM_DOWNSTREAM:
       s = gst_event_get_structure (event);
@@ -1785,6 +1889,8 @@ gst_rtp_h265_pay_sink_event (GstRTPBasePayload * payload, GstEvent * event)
        */
       gst_rtp_h265_pay_handle_buffer (payload, NULL);
       ret = gst_rtp_h265_pay_send_bundle (rtph265pay, TRUE);
+      if (ret == GST_FLOW_OK)
+        ret = gst_rtp_h265_pay_push_au_list (rtph265pay);
 
       break;
     }
@@ -1816,6 +1922,7 @@ gst_rtp_h265_pay_change_state (GstElement * element, GstStateChange transition)
       rtph265pay->send_vps_sps_pps = FALSE;
       gst_adapter_clear (rtph265pay->adapter);
       gst_rtp_h265_pay_reset_bundle (rtph265pay);
+      g_clear_pointer (&rtph265pay->au_list, gst_buffer_list_unref);
       break;
     default:
       break;
@@ -1850,6 +1957,9 @@ gst_rtp_h265_pay_set_property (GObject * object, guint prop_id,
     case PROP_AGGREGATE_MODE:
       rtph265pay->aggregate_mode = g_value_get_enum (value);
       break;
+    case PROP_BUFFER_LIST:
+      rtph265pay->buffer_list = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1871,6 +1981,9 @@ gst_rtp_h265_pay_get_property (GObject * object, guint prop_id,
     case PROP_AGGREGATE_MODE:
       g_value_set_enum (value, rtph265pay->aggregate_mode);
       break;
+    case PROP_BUFFER_LIST:
+      g_value_set_boolean (value, rtph265pay->buffer_list);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -81,6 +81,10 @@ struct _GstRtpH265Pay
   guint bundle_size;
   gboolean bundle_contains_vcl_or_suffix;
   GstRTPH265AggregateMode aggregate_mode;
+
+  /* packets of the current access unit in buffer-list mode */
+  gboolean buffer_list;
+  GstBufferList *au_list;
 };
 
 struct _GstRtpH265PayClass
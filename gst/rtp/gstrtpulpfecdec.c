@@ -434,6 +434,7 @@ gst_rtp_ulpfec_dec_handle_packet_loss (GstRtpUlpFecDec * self, guint16 seqnum,
       if (seqnum == recovered_seq) {
         GstBuffer *sent_buffer;
         GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+        GstMapInfo map;
 
         recovered_buffer = gst_buffer_make_writable (recovered_buffer);
         GST_BUFFER_PTS (recovered_buffer) = timestamp;
@@ -448,7 +449,15 @@ gst_rtp_ulpfec_dec_handle_packet_loss (GstRtpUlpFecDec * self, guint16 seqnum,
             "Pushing recovered packet ssrc=0x%08x seq=%u %" GST_PTR_FORMAT,
             self->caps_ssrc, seqnum, recovered_buffer);
 
-        sent_buffer = gst_buffer_copy_deep (recovered_buffer);
+        /* The recovered buffer stays in the storage, push a copy of it
+         * with our own seqnum */
+        sent_buffer = rtp_ulpfec_buffer_pool_acquire (self->pool,
+            gst_buffer_get_size (recovered_buffer));
+        gst_buffer_copy_into (sent_buffer, recovered_buffer,
+            GST_BUFFER_COPY_METADATA, 0, -1);
+        gst_buffer_map (recovered_buffer, &map, GST_MAP_READ);
+        gst_buffer_fill (sent_buffer, 0, map.data, map.size);
+        gst_buffer_unmap (recovered_buffer, &map);
 
         if (self->lost_packet_from_storage)
           gst_buffer_unref (recovered_buffer);
@@ -623,7 +632,9 @@ gst_rtp_ulpfec_dec_init (GstRtpUlpFecDec * self)
   self->info_arr = g_array_new (FALSE, TRUE, sizeof (RtpUlpFecMapInfo));
   g_array_set_clear_func (self->info_arr,
       (GDestroyNotify) rtp_ulpfec_map_info_unmap);
-  self->scratch_buf = g_array_new (FALSE, TRUE, sizeof (guint8));
+  self->scratch_buf = g_array_sized_new (FALSE, TRUE, sizeof (guint8),
+      RTP_ULPFEC_ARENA_BUFFER_SIZE);
+  self->pool = rtp_ulpfec_buffer_pool_new ();
 }
 
 static void
@@ -657,6 +668,8 @@ gst_rtp_ulpfec_dec_dispose (GObject * obj)
   g_ptr_array_free (self->info_fec, TRUE);
   g_array_free (self->info_arr, TRUE);
   g_array_free (self->scratch_buf, TRUE);
+  rtp_ulpfec_buffer_pool_free (self->pool);
+  self->pool = NULL;
 
   G_OBJECT_CLASS (gst_rtp_ulpfec_dec_parent_class)->dispose (obj);
 }
@@ -69,6 +69,7 @@ struct _GstRtpUlpFecDec {
   GPtrArray *info_fec;
   GArray *info_arr;
   GArray *scratch_buf;
+  GstBufferPool *pool;
   gboolean lost_packet_from_storage;
   gboolean lost_packet_returned;
   guint16 next_seqnum;
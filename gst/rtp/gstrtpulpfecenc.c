@@ -256,8 +256,8 @@ gst_rtp_ulpfec_enc_stream_ctx_protect (GstRtpUlpFecEncStreamCtx * ctx,
 
   g_assert (tmp_mask == 0);
   ret =
-      rtp_ulpfec_bitstring_to_fec_rtp_buffer (ctx->scratch_buf, seq_base,
-      fec_mask_long, fec_mask, FALSE, pt, seq, timestamp, ssrc);
+      rtp_ulpfec_bitstring_to_fec_rtp_buffer (ctx->scratch_buf, ctx->pool,
+      seq_base, fec_mask_long, fec_mask, FALSE, pt, seq, timestamp, ssrc);
   ++ctx->fec_packet_idx;
   return ret;
 }
@@ -472,7 +472,7 @@ gst_rtp_ulpfec_enc_stream_ctx_configure (GstRtpUlpFecEncStreamCtx * ctx,
 
 static GstRtpUlpFecEncStreamCtx *
 gst_rtp_ulpfec_enc_stream_ctx_new (guint ssrc,
-    GstElement * parent, GstPad * srcpad,
+    GstElement * parent, GstPad * srcpad, GstBufferPool * pool,
     guint pt, guint percentage, guint percentage_important,
     gboolean multipacket)
 {
@@ -488,7 +488,9 @@ gst_rtp_ulpfec_enc_stream_ctx_new (guint ssrc,
   g_array_set_clear_func (ctx->info_arr,
       (GDestroyNotify) rtp_ulpfec_map_info_unmap);
   ctx->parent = parent;
-  ctx->scratch_buf = g_array_new (FALSE, TRUE, sizeof (guint8));
+  ctx->scratch_buf = g_array_sized_new (FALSE, TRUE, sizeof (guint8),
+      RTP_ULPFEC_ARENA_BUFFER_SIZE);
+  ctx->pool = pool;
   gst_rtp_ulpfec_enc_stream_ctx_configure (ctx, pt,
       percentage, percentage_important, multipacket);
 
@@ -588,7 +590,7 @@ gst_rtp_ulpfec_enc_aquire_ctx (GstRtpUlpFecEnc * fec, guint ssrc)
   if (ctx == NULL) {
     ctx =
         gst_rtp_ulpfec_enc_stream_ctx_new (ssrc, GST_ELEMENT_CAST (fec),
-        fec->srcpad, fec->pt, fec->percentage,
+        fec->srcpad, fec->pool, fec->pt, fec->percentage,
         fec->percentage_important, fec->multipacket);
     g_hash_table_insert (fec->ssrc_to_ctx, GUINT_TO_POINTER (ssrc), ctx);
   }
@@ -757,6 +759,9 @@ gst_rtp_ulpfec_enc_dispose (GObject * obj)
     g_hash_table_destroy (fec->ssrc_to_ctx);
   fec->ssrc_to_ctx = NULL;
 
+  rtp_ulpfec_buffer_pool_free (fec->pool);
+  fec->pool = NULL;
+
   G_OBJECT_CLASS (gst_rtp_ulpfec_enc_parent_class)->dispose (obj);
 }
 
@@ -777,6 +782,7 @@ gst_rtp_ulpfec_enc_init (GstRtpUlpFecEnc * fec)
 
   fec->ssrc_to_ctx = g_hash_table_new_full (NULL, NULL, NULL,
       (GDestroyNotify) gst_rtp_ulpfec_enc_stream_ctx_free);
+  fec->pool = rtp_ulpfec_buffer_pool_new ();
 }
 
 static void
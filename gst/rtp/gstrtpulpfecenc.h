@@ -50,6 +50,7 @@ struct _GstRtpUlpFecEnc {
   guint8 twcc_ext_id;
 
   GHashTable *ssrc_to_ctx;
+  GstBufferPool *pool;
 
   /* properties */
   guint pt;
@@ -88,6 +89,7 @@ typedef struct {
 
   GArray *info_arr;
   GArray *scratch_buf;
+  GstBufferPool *pool;
 
   guint fec_packets;
   guint fec_packet_idx;
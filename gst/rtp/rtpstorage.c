@@ -94,7 +94,7 @@ rtp_storage_get_packets_for_recovery (RtpStorage * self, gint fec_pt,
     GST_ERROR_OBJECT (self, "Can't find ssrc = 0x08%x", ssrc);
   } else {
     STREAM_LOCK (stream);
-    if (stream->queue.length > 0) {
+    if (rtp_packet_ring_get_length (&stream->ring) > 0) {
       GST_LOG_OBJECT (self, "Looking for recovery packets for fec_pt=%u around"
           " lost_seq=%u for ssrc=%08x", fec_pt, lost_seq, ssrc);
       ret =
@@ -130,7 +130,7 @@ rtp_storage_get_redundant_packet (RtpStorage * self, guint32 ssrc,
     GST_ERROR_OBJECT (self, "Can't find ssrc = 0x%x", ssrc);
   } else {
     STREAM_LOCK (stream);
-    if (stream->queue.length > 0) {
+    if (rtp_packet_ring_get_length (&stream->ring) > 0) {
       ret = rtp_storage_stream_get_redundant_packet (stream, lost_seq);
     } else {
       GST_DEBUG_OBJECT (self, "Empty RTP storage for ssrc=%08x", ssrc);
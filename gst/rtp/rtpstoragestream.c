@@ -22,65 +22,44 @@
 
 #define GST_CAT_DEFAULT (gst_rtp_storage_debug)
 
-static RtpStorageItem *
-rtp_storage_item_new (GstBuffer * buffer, guint8 pt, guint16 seq)
-{
-  RtpStorageItem *ret = g_slice_new0 (RtpStorageItem);
-  ret->buffer = buffer;
-  ret->pt = pt;
-  ret->seq = seq;
-  return ret;
-}
-
-static void
-rtp_storage_item_free (RtpStorageItem * item)
-{
-  g_assert (item->buffer != NULL);
-  gst_buffer_unref (item->buffer);
-  g_slice_free (RtpStorageItem, item);
-}
-
-static gint
-rtp_storage_item_compare (gconstpointer a, gconstpointer b, gpointer userdata)
-{
-  gint seq_diff = gst_rtp_buffer_compare_seqnum (
-      ((RtpStorageItem const *) a)->seq, ((RtpStorageItem const *) b)->seq);
-
-  if (seq_diff >= 0)
-    return 0;
-
-  return 1;
-}
-
 static void
 rtp_storage_stream_resize (RtpStorageStream * stream, GstClockTime size_time)
 {
-  GList *it;
+  RtpPacketRing *ring = &stream->ring;
   guint i, too_old_buffers_num = 0;
+  guint16 seq;
 
   g_assert (GST_CLOCK_TIME_IS_VALID (stream->max_arrival_time));
   g_assert (GST_CLOCK_TIME_IS_VALID (size_time));
   g_assert_cmpint (size_time, >, 0);
 
   /* Iterating from oldest sequence numbers to newest */
-  for (i = 0, it = stream->queue.tail; it; it = it->prev, ++i) {
-    RtpStorageItem *item = it->data;
-    GstClockTime arrival_time = GST_BUFFER_DTS_OR_PTS (item->buffer);
+  for (i = 0, seq = ring->first; i < rtp_packet_ring_get_length (ring); ++seq) {
+    RtpPacketRingItem *item = rtp_packet_ring_lookup (ring, seq);
+    GstClockTime arrival_time;
+
+    if (!item)
+      continue;
+
+    ++i;
+    arrival_time = GST_BUFFER_DTS_OR_PTS (item->buffer);
     if (GST_CLOCK_TIME_IS_VALID (arrival_time)) {
       if (stream->max_arrival_time - arrival_time > size_time) {
-        too_old_buffers_num = i + 1;
+        too_old_buffers_num = i;
       } else
         break;
     }
   }
 
   for (i = 0; i < too_old_buffers_num; ++i) {
-    RtpStorageItem *item = g_queue_pop_tail (&stream->queue);
+#ifndef GST_DISABLE_GST_DEBUG
+    RtpPacketRingItem *item = rtp_packet_ring_peek_oldest (ring);
 
     GST_TRACE ("Removing %u/%u buffers, pt=%d seq=%d for ssrc=%08x",
         i, too_old_buffers_num, item->pt, item->seq, stream->ssrc);
+#endif
 
-    rtp_storage_item_free (item);
+    rtp_packet_ring_pop_oldest (ring);
   }
 }
 
@@ -92,12 +71,12 @@ static guint16
 rtp_storage_stream_get_seqnum_diff (RtpStorageStream * stream)
 {
   guint32 high_seqnum, low_seqnum;
-  RtpStorageItem *high_item, *low_item;
+  RtpPacketRingItem *high_item, *low_item;
   guint16 result;
 
 
-  high_item = (RtpStorageItem *) g_queue_peek_head (&stream->queue);
-  low_item = (RtpStorageItem *) g_queue_peek_tail (&stream->queue);
+  high_item = rtp_packet_ring_peek_newest (&stream->ring);
+  low_item = rtp_packet_ring_peek_oldest (&stream->ring);
 
   if (!high_item || !low_item || high_item == low_item)
     return 0;
@@ -125,13 +104,15 @@ rtp_storage_stream_resize_and_add_item (RtpStorageStream * stream,
    * jitterbuffer.
    */
   if (rtp_storage_stream_get_seqnum_diff (stream) >= 32765 ||
-      stream->queue.length > 10100) {
-    RtpStorageItem *item = g_queue_pop_tail (&stream->queue);
+      rtp_packet_ring_get_length (&stream->ring) > 10100) {
+#ifndef GST_DISABLE_GST_DEBUG
+    RtpPacketRingItem *item = rtp_packet_ring_peek_oldest (&stream->ring);
 
     GST_WARNING ("Queue too big, removing pt=%d seq=%d for ssrc=%08x",
         item->pt, item->seq, stream->ssrc);
+#endif
 
-    rtp_storage_item_free (item);
+    rtp_packet_ring_pop_oldest (&stream->ring);
   }
 
   if (G_LIKELY (GST_CLOCK_TIME_IS_VALID (arrival_time))) {
@@ -153,6 +134,7 @@ rtp_storage_stream_new (guint32 ssrc)
   RtpStorageStream *ret = g_slice_new0 (RtpStorageStream);
   ret->max_arrival_time = GST_CLOCK_TIME_NONE;
   ret->ssrc = ssrc;
+  rtp_packet_ring_init (&ret->ring);
   g_mutex_init (&ret->stream_lock);
   return ret;
 }
@@ -161,8 +143,7 @@ void
 rtp_storage_stream_free (RtpStorageStream * stream)
 {
   STREAM_LOCK (stream);
-  while (stream->queue.length)
-    rtp_storage_item_free (g_queue_pop_tail (&stream->queue));
+  rtp_packet_ring_clear (&stream->ring);
   STREAM_UNLOCK (stream);
   g_mutex_clear (&stream->stream_lock);
   g_slice_free (RtpStorageStream, stream);
@@ -172,22 +153,21 @@ void
 rtp_storage_stream_add_item (RtpStorageStream * stream, GstBuffer * buffer,
     guint8 pt, guint16 seq)
 {
-  RtpStorageItem *item = rtp_storage_item_new (buffer, pt, seq);
-  GList *sibling = g_queue_find_custom (&stream->queue, item,
-      (GCompareFunc) rtp_storage_item_compare);
-
-  g_queue_insert_before (&stream->queue, sibling, item);
+  if (!rtp_packet_ring_insert (&stream->ring, buffer, seq, pt, 0))
+    GST_DEBUG ("Dropping too old pt=%d seq=%d for ssrc=%08x", pt, seq,
+        stream->ssrc);
 }
 
 GstBufferList *
 rtp_storage_stream_get_packets_for_recovery (RtpStorageStream * stream,
     guint8 pt_fec, guint16 lost_seq)
 {
-  guint ret_length = 0;
-  GList *end = NULL;
-  GList *start = NULL;
-  gboolean saw_fec = TRUE;      /* To initialize the start pointer in the loop below */
-  GList *it;
+  RtpPacketRing *ring = &stream->ring;
+  RtpPacketRingItem *start = NULL;
+  RtpPacketRingItem *end = NULL;
+  RtpPacketRingItem *item;
+  GstBufferList *ret;
+  guint16 seq;
 
   /* Looking for media stream chunk with FEC packets at the end, which could
    * can have the lost packet. For example:
@@ -202,74 +182,76 @@ rtp_storage_stream_get_packets_for_recovery (RtpStorageStream * stream,
    * - it could have arrived right after it was considered lost (more of a corner case)
    * - it was recovered together with the other lost packet (most likely)
    */
-  for (it = stream->queue.tail; it; it = it->prev) {
-    RtpStorageItem *item = it->data;
-    gboolean found_end = FALSE;
-
-    /* Is the buffer we lost in the storage? */
-    if (item->seq == lost_seq) {
-      start = it;
-      end = it;
-      ret_length = 1;
-      break;
-    }
+  item = rtp_packet_ring_lookup (ring, lost_seq);
+  if (item) {
+    start = end = item;
+    goto done;
+  }
 
-    if (pt_fec == item->pt) {
-      gint seq_diff = gst_rtp_buffer_compare_seqnum (lost_seq, item->seq);
-
-      if (seq_diff >= 0) {
-        if (it->prev) {
-          gboolean media_next =
-              pt_fec != ((RtpStorageItem *) it->prev->data)->pt;
-          found_end = media_next;
-        } else
-          found_end = TRUE;
-      }
-      saw_fec = TRUE;
-    } else if (saw_fec) {
-      saw_fec = FALSE;
-      start = it;
-      ret_length = 0;
+  if (rtp_packet_ring_get_length (ring) == 0 ||
+      gst_rtp_buffer_compare_seqnum (ring->last, lost_seq) > 0)
+    return NULL;
+
+  /* The end is the last packet of the first FEC run after @lost_seq */
+  seq = lost_seq;
+  if (gst_rtp_buffer_compare_seqnum (ring->first, seq) < 0)
+    seq = ring->first;
+  for (;; ++seq) {
+    item = rtp_packet_ring_lookup (ring, seq);
+    if (item) {
+      if (item->pt == pt_fec)
+        end = item;
+      else if (end)
+        break;
     }
+    if (seq == ring->last)
+      break;
+  }
 
-    ++ret_length;
-    if (found_end) {
-      end = it;
+  if (!end)
+    return NULL;
+
+  /* The start is the first packet of the media run preceding that FEC run */
+  for (seq = end->seq; seq != ring->first;) {
+    item = rtp_packet_ring_lookup (ring, --seq);
+    if (!item)
+      continue;
+    if (item->pt != pt_fec)
+      start = item;
+    else if (start)
       break;
-    }
   }
 
-  if (end && !start)
+  if (!start)
     start = end;
 
-  if (start && end) {
-    GstBufferList *ret = gst_buffer_list_new_sized (ret_length);
-    GList *it;
-
-    GST_LOG ("Found %u buffers with lost seq=%d for ssrc=%08x, creating %"
-        GST_PTR_FORMAT, ret_length, lost_seq, stream->ssrc, ret);
-
-    for (it = start; it != end->prev; it = it->prev)
-      gst_buffer_list_add (ret,
-          gst_buffer_ref (((RtpStorageItem *) it->data)->buffer));
-    return ret;
+done:
+  ret = gst_buffer_list_new_sized ((guint16) (end->seq - start->seq) + 1);
+  for (seq = start->seq;; ++seq) {
+    item = rtp_packet_ring_lookup (ring, seq);
+    if (item)
+      gst_buffer_list_add (ret, gst_buffer_ref (item->buffer));
+    if (seq == end->seq)
+      break;
   }
 
-  return NULL;
+  GST_LOG ("Found %u buffers with lost seq=%d for ssrc=%08x, creating %"
+      GST_PTR_FORMAT, gst_buffer_list_length (ret), lost_seq, stream->ssrc,
+      ret);
+
+  return ret;
 }
 
 GstBuffer *
 rtp_storage_stream_get_redundant_packet (RtpStorageStream * stream,
     guint16 lost_seq)
 {
-  GList *it;
-  for (it = stream->queue.head; it; it = it->next) {
-    RtpStorageItem *item = it->data;
-    if (item->seq == lost_seq) {
-      GST_LOG ("Found buffer pt=%u seq=%u for ssrc=%08x %" GST_PTR_FORMAT,
-          item->pt, item->seq, stream->ssrc, item->buffer);
-      return gst_buffer_ref (item->buffer);
-    }
+  RtpPacketRingItem *item = rtp_packet_ring_lookup (&stream->ring, lost_seq);
+
+  if (item) {
+    GST_LOG ("Found buffer pt=%u seq=%u for ssrc=%08x %" GST_PTR_FORMAT,
+        item->pt, item->seq, stream->ssrc, item->buffer);
+    return gst_buffer_ref (item->buffer);
   }
   GST_DEBUG ("Could not find packet with seq=%u for ssrc=%08x",
       lost_seq, stream->ssrc);
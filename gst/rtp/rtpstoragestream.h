@@ -23,16 +23,12 @@
 
 #include <gst/rtp/gstrtpbuffer.h>
 
-GST_DEBUG_CATEGORY_EXTERN (gst_rtp_storage_debug);
+#include "../rtpmanager/rtppacketring.h"
 
-typedef struct {
-  GstBuffer *buffer;
-  guint16 seq;
-  guint8 pt;
-} RtpStorageItem;
+GST_DEBUG_CATEGORY_EXTERN (gst_rtp_storage_debug);
 
 typedef struct {
-  GQueue queue;
+  RtpPacketRing ring;
   GMutex stream_lock;
   guint32 ssrc;
   GstClockTime max_arrival_time;
@@ -20,6 +20,7 @@
 
 #include <string.h>
 #include "rtpulpfeccommon.h"
+#include "../rtpmanager/rtpxor.h"
 
 #define MIN_RTP_HEADER_LEN 12
 
@@ -117,26 +118,6 @@ fec_hdr_get_timestamp_recovery (RtpUlpFecHeader const *fec_hdr)
   return g_ntohl (fec_hdr->timestamp);
 }
 
-static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
-{
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
-  }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
-}
-
 guint16
 rtp_ulpfec_hdr_get_protection_len (RtpUlpFecHeader const *fec_hdr)
 {
@@ -246,7 +227,7 @@ rtp_buffer_to_ulpfec_bitstring (GstRTPBuffer * rtp, GArray * dst_arr,
 
     *((guint64 *) dst) ^= *((const guint64 *) src);
     ((RtpUlpFecHeader *) dst)->len ^= g_htons (len);
-    _xor_mem (dst + dst_offset, src + src_offset, len);
+    rtp_xor_mem (dst + dst_offset, src + src_offset, len);
   }
 }
 
@@ -283,11 +264,12 @@ rtp_ulpfec_bitstring_to_media_rtp_buffer (GArray * arr,
 }
 
 GstBuffer *
-rtp_ulpfec_bitstring_to_fec_rtp_buffer (GArray * arr,
+rtp_ulpfec_bitstring_to_fec_rtp_buffer (GArray * arr, GstBufferPool * pool,
     guint16 seq_base, gboolean fec_mask_long, guint64 fec_mask,
     gboolean marker, guint8 pt, guint16 seq, guint32 timestamp, guint32 ssrc)
 {
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstMapInfo ret_info = GST_MAP_INFO_INIT;
   GstBuffer *ret;
 
   /* Filling FEC headers */
@@ -305,7 +287,12 @@ rtp_ulpfec_bitstring_to_fec_rtp_buffer (GArray * arr,
   }
 
   /* Filling RTP header, copying payload */
-  ret = gst_rtp_buffer_new_allocate (arr->len, 0, 0);
+  ret = rtp_ulpfec_buffer_pool_acquire (pool, MIN_RTP_HEADER_LEN + arr->len);
+  gst_buffer_map (ret, &ret_info, GST_MAP_WRITE);
+  memset (ret_info.data, 0, MIN_RTP_HEADER_LEN);
+  ((RtpHeader *) ret_info.data)->version = 2;
+  gst_buffer_unmap (ret, &ret_info);
+
   if (!gst_rtp_buffer_map (ret, GST_MAP_READWRITE, &rtp))
     g_assert_not_reached ();
 
@@ -324,6 +311,74 @@ rtp_ulpfec_bitstring_to_fec_rtp_buffer (GArray * arr,
   return ret;
 }
 
+/**
+ * rtp_ulpfec_buffer_pool_new:
+ *
+ * Creates an active #GstBufferPool of %RTP_ULPFEC_ARENA_BUFFER_SIZE buffers,
+ * used as an arena for the packets produced by the FEC elements so they don't
+ * have to be allocated and freed one by one.
+ *
+ * Returns: (transfer full) (nullable): a new #GstBufferPool
+ **/
+GstBufferPool *
+rtp_ulpfec_buffer_pool_new (void)
+{
+  GstBufferPool *pool = gst_buffer_pool_new ();
+  GstStructure *config = gst_buffer_pool_get_config (pool);
+
+  gst_buffer_pool_config_set_params (config, NULL,
+      RTP_ULPFEC_ARENA_BUFFER_SIZE, RTP_ULPFEC_ARENA_MIN_BUFFERS, 0);
+
+  if (!gst_buffer_pool_set_config (pool, config) ||
+      !gst_buffer_pool_set_active (pool, TRUE)) {
+    GST_WARNING ("Failed to set up FEC buffer pool");
+    gst_object_unref (pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+/**
+ * rtp_ulpfec_buffer_pool_free:
+ * @pool: (transfer full) (nullable): a #GstBufferPool
+ *
+ * Deactivates and unrefs @pool. Buffers still in use are freed once they are
+ * released.
+ **/
+void
+rtp_ulpfec_buffer_pool_free (GstBufferPool * pool)
+{
+  if (pool) {
+    gst_buffer_pool_set_active (pool, FALSE);
+    gst_object_unref (pool);
+  }
+}
+
+/**
+ * rtp_ulpfec_buffer_pool_acquire:
+ * @pool: (nullable): a #GstBufferPool
+ * @size: the size of the buffer
+ *
+ * Returns a buffer of @size bytes with undefined content, taken from @pool
+ * when it fits in there and allocated otherwise.
+ *
+ * Returns: (transfer full): a #GstBuffer
+ **/
+GstBuffer *
+rtp_ulpfec_buffer_pool_acquire (GstBufferPool * pool, gsize size)
+{
+  GstBuffer *ret = NULL;
+
+  if (pool && size <= RTP_ULPFEC_ARENA_BUFFER_SIZE &&
+      gst_buffer_pool_acquire_buffer (pool, &ret, NULL) == GST_FLOW_OK) {
+    gst_buffer_set_size (ret, size);
+    return ret;
+  }
+
+  return gst_buffer_new_allocate (NULL, size, NULL);
+}
+
 /**
  * rtp_ulpfec_map_info_map:
  * @buffer: (transfer: full) #GstBuffer
@@ -37,6 +37,11 @@ G_BEGIN_DECLS
 #define RTP_ULPFEC_PROTECTED_PACKETS_MAX(L)    ((L) ? 48 : 16)
 #define RTP_ULPFEC_SEQ_BASE_OFFSET_MAX(L)      (RTP_ULPFEC_PROTECTED_PACKETS_MAX(L) - 1)
 
+/* Size of the preallocated scratch and output buffers, enough for any packet
+ * sent over a regular ethernet link plus the FEC headers */
+#define RTP_ULPFEC_ARENA_BUFFER_SIZE           2048
+#define RTP_ULPFEC_ARENA_MIN_BUFFERS           8
+
 /**
  * RtpUlpFecMapInfo: Helper wrapper around GstRTPBuffer
  *
@@ -132,10 +137,15 @@ void              rtp_buffer_to_ulpfec_bitstring           (GstRTPBuffer *rtp, G
                                                             gboolean fec_buffer, gboolean fec_mask_long);
 GstBuffer       * rtp_ulpfec_bitstring_to_media_rtp_buffer (GArray *arr,
                                                             gboolean fec_mask_long, guint32 ssrc, guint16 seq);
-GstBuffer       * rtp_ulpfec_bitstring_to_fec_rtp_buffer   (GArray *arr, guint16 seq_base, gboolean fec_mask_long,
+GstBuffer       * rtp_ulpfec_bitstring_to_fec_rtp_buffer   (GArray *arr, GstBufferPool *pool,
+                                                            guint16 seq_base, gboolean fec_mask_long,
                                                             guint64 fec_mask, gboolean marker, guint8 pt, guint16 seq,
                                                             guint32 timestamp, guint32 ssrc);
 
+GstBufferPool   * rtp_ulpfec_buffer_pool_new               (void);
+void              rtp_ulpfec_buffer_pool_free              (GstBufferPool *pool);
+GstBuffer       * rtp_ulpfec_buffer_pool_acquire           (GstBufferPool *pool, gsize size);
+
 #ifndef GST_DISABLE_GST_DEBUG
 void              rtp_ulpfec_log_rtppacket                 (GstDebugCategory * cat, GstDebugLevel level,
                                                             gpointer object, const gchar *name,
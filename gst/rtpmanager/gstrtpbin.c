@@ -278,6 +278,10 @@ struct _GstRtpBinPrivate
   /* NTP time in ns of last SR sync used */
   guint64 last_ntpnstime;
 
+  /* gst_util_get_timestamp() when going to PAUSED, the startup milestones
+   * of the streams are relative to it. Protected by the object lock */
+  GstClockTime startup_time;
+
   /* list of extra elements */
   GList *elements;
 };
@@ -358,6 +362,7 @@ enum
 #define DEFAULT_MIN_TS_OFFSET        MIN_TS_OFFSET_ROUND_OFF_COMP
 #define DEFAULT_TS_OFFSET_SMOOTHING_FACTOR  0
 #define DEFAULT_UPDATE_NTP64_HEADER_EXT TRUE
+#define DEFAULT_SHARED_TIMERS        FALSE
 
 enum
 {
@@ -391,6 +396,8 @@ enum
   PROP_FEC_DECODERS,
   PROP_FEC_ENCODERS,
   PROP_UPDATE_NTP64_HEADER_EXT,
+  PROP_SHARED_TIMERS,
+  PROP_STATS,
 };
 
 #define GST_RTP_BIN_RTCP_SYNC_TYPE (gst_rtp_bin_rtcp_sync_get_type())
@@ -441,6 +448,19 @@ static GstPad *complete_session_rtcp (GstRtpBin * rtpbin,
 static GstElement *session_request_element (GstRtpBinSession * session,
     guint signal);
 
+/* Milestones in the startup of a stream */
+typedef enum
+{
+  STARTUP_FIRST_RTP,
+  STARTUP_FIRST_RTCP_SR,
+  STARTUP_FIRST_PUSH,
+  STARTUP_LAST
+} GstRtpBinStartupMilestone;
+
+static const gchar *startup_milestone_names[STARTUP_LAST] = {
+  "first-rtp", "first-rtcp-sr", "first-push"
+};
+
 /* Manages the RTP stream for one SSRC.
  *
  * We pipe the stream (coming from the SSRC demuxer) into a jitterbuffer.
@@ -482,6 +502,11 @@ struct _GstRtpBinStream
   gboolean is_initialized;
   /* base rtptime in gst time */
   gint64 clock_base;
+
+  /* gst_util_get_timestamp() when the startup milestones were reached,
+   * protected by the object lock of the bin */
+  GstClockTime startup[STARTUP_LAST];
+  gulong first_push_probe;
 };
 
 #define GST_RTP_SESSION_LOCK(sess)   g_mutex_lock (&(sess)->lock)
@@ -1733,6 +1758,107 @@ gst_rtp_bin_associate (GstRtpBin * bin, GstRtpBinStream * stream, guint8 len,
   for ((b) = gst_rtcp_packet_sdes_first_entry ((packet)); (b); \
           (b) = gst_rtcp_packet_sdes_next_entry ((packet)))
 
+/* Records that @stream reached @milestone, if it did not before, and
+ * posts it on the bus. Must be called without any lock. */
+static void
+gst_rtp_bin_stream_milestone (GstRtpBinStream * stream,
+    GstRtpBinStartupMilestone milestone)
+{
+  GstRtpBin *bin = stream->bin;
+  GstClockTime elapsed;
+
+  GST_OBJECT_LOCK (bin);
+  if (GST_CLOCK_TIME_IS_VALID (stream->startup[milestone])) {
+    GST_OBJECT_UNLOCK (bin);
+    return;
+  }
+  stream->startup[milestone] = gst_util_get_timestamp ();
+  elapsed = stream->startup[milestone] - bin->priv->startup_time;
+  GST_OBJECT_UNLOCK (bin);
+
+  GST_DEBUG_OBJECT (bin, "SSRC %08x reached %s after %" GST_TIME_FORMAT,
+      stream->ssrc, startup_milestone_names[milestone],
+      GST_TIME_ARGS (elapsed));
+
+  gst_element_post_message (GST_ELEMENT_CAST (bin),
+      gst_message_new_element (GST_OBJECT_CAST (bin),
+          gst_structure_new ("GstRTPBinStartup",
+              "session", G_TYPE_UINT, stream->session->id,
+              "ssrc", G_TYPE_UINT, stream->ssrc,
+              "milestone", G_TYPE_STRING, startup_milestone_names[milestone],
+              "time", G_TYPE_UINT64, elapsed, NULL)));
+}
+
+static GstPadProbeReturn
+first_push_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRtpBinStream * stream)
+{
+  GstRtpBin *bin = stream->bin;
+
+  /* free_stream() may be removing the probe already */
+  GST_OBJECT_LOCK (bin);
+  if (stream->first_push_probe == 0) {
+    GST_OBJECT_UNLOCK (bin);
+    return GST_PAD_PROBE_OK;
+  }
+  stream->first_push_probe = 0;
+  GST_OBJECT_UNLOCK (bin);
+
+  gst_rtp_bin_stream_milestone (stream, STARTUP_FIRST_PUSH);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
+static GstStructure *
+gst_rtp_bin_create_stats (GstRtpBin * rtpbin)
+{
+  GstStructure *s;
+  GValue streams = G_VALUE_INIT;
+  GSList *walk, *swalk;
+
+  g_value_init (&streams, GST_TYPE_ARRAY);
+
+  GST_RTP_BIN_LOCK (rtpbin);
+  for (walk = rtpbin->sessions; walk; walk = g_slist_next (walk)) {
+    GstRtpBinSession *session = (GstRtpBinSession *) walk->data;
+
+    GST_RTP_SESSION_LOCK (session);
+    for (swalk = session->streams; swalk; swalk = g_slist_next (swalk)) {
+      GstRtpBinStream *stream = (GstRtpBinStream *) swalk->data;
+      GValue value = G_VALUE_INIT;
+      GstStructure *ss;
+      guint i;
+
+      ss = gst_structure_new ("application/x-rtp-bin-stream-stats",
+          "session", G_TYPE_UINT, session->id,
+          "ssrc", G_TYPE_UINT, stream->ssrc, NULL);
+
+      GST_OBJECT_LOCK (rtpbin);
+      for (i = 0; i < STARTUP_LAST; i++) {
+        if (GST_CLOCK_TIME_IS_VALID (stream->startup[i]))
+          gst_structure_set (ss, startup_milestone_names[i], G_TYPE_UINT64,
+              stream->startup[i] - rtpbin->priv->startup_time, NULL);
+      }
+      GST_OBJECT_UNLOCK (rtpbin);
+
+      g_value_init (&value, GST_TYPE_STRUCTURE);
+      g_value_take_boxed (&value, ss);
+      gst_value_array_append_and_take_value (&streams, &value);
+    }
+    GST_RTP_SESSION_UNLOCK (session);
+  }
+  GST_RTP_BIN_UNLOCK (rtpbin);
+
+  GST_OBJECT_LOCK (rtpbin);
+  s = gst_structure_new ("application/x-rtp-bin-stats",
+      "start-time", G_TYPE_UINT64, rtpbin->priv->startup_time, NULL);
+  GST_OBJECT_UNLOCK (rtpbin);
+
+  gst_structure_take_value (s, "streams", &streams);
+
+  return s;
+}
+
 static void
 gst_rtp_bin_handle_sync (GstElement * jitterbuffer, GstStructure * s,
     GstRtpBinStream * stream)
@@ -1798,6 +1924,8 @@ gst_rtp_bin_handle_sync (GstElement * jitterbuffer, GstStructure * s,
 
   GST_DEBUG_OBJECT (bin, "handle sync from RTCP SR information");
 
+  gst_rtp_bin_stream_milestone (stream, STARTUP_FIRST_RTCP_SR);
+
   /* get RTCP SR ntpnstime if available */
   if (gst_structure_get_uint64 (s, "sr-ntpnstime", &ntpnstime) && cname) {
     GST_RTP_BIN_LOCK (bin);
@@ -1915,6 +2043,8 @@ create_stream (GstRtpBinSession * session, guint32 ssrc)
   GstRtpBin *rtpbin;
   GstState target;
   GObjectClass *jb_class;
+  GstPad *pad;
+  guint i;
 
   rtpbin = session->bin;
 
@@ -1944,6 +2074,8 @@ create_stream (GstRtpBinSession * session, guint32 ssrc)
   stream->rtp_delta = 0;
   stream->percent = 100;
   stream->clock_base = -100 * GST_SECOND;
+  for (i = 0; i < STARTUP_LAST; i++)
+    stream->startup[i] = GST_CLOCK_TIME_NONE;
   session->streams = g_slist_prepend (session->streams, stream);
 
   jb_class = G_OBJECT_GET_CLASS (G_OBJECT (buffer));
@@ -1989,6 +2121,8 @@ create_stream (GstRtpBinSession * session, guint32 ssrc)
         rtpbin->max_ts_offset_adjustment, NULL);
   if (g_object_class_find_property (jb_class, "sync-interval"))
     g_object_set (buffer, "sync-interval", rtpbin->rtcp_sync_interval, NULL);
+  if (g_object_class_find_property (jb_class, "shared-timers"))
+    g_object_set (buffer, "shared-timers", rtpbin->shared_timers, NULL);
 
   g_signal_emit (rtpbin, gst_rtp_bin_signals[SIGNAL_NEW_JITTERBUFFER], 0,
       buffer, session->id, ssrc);
@@ -2001,6 +2135,14 @@ create_stream (GstRtpBinSession * session, guint32 ssrc)
     gst_element_link_pads_full (buffer, "src", demux, "sink",
         GST_PAD_LINK_CHECK_NOTHING);
 
+  pad = gst_element_get_static_pad (buffer, "src");
+  if (pad) {
+    stream->first_push_probe = gst_pad_add_probe (pad,
+        GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+        (GstPadProbeCallback) first_push_probe, stream, NULL);
+    gst_object_unref (pad);
+  }
+
   if (rtpbin->buffering) {
     guint64 last_out;
 
@@ -2051,6 +2193,7 @@ free_stream (GstRtpBinStream * stream, GstRtpBin * bin)
 {
   GstRtpBinSession *sess = stream->session;
   GSList *clients, *next_client;
+  gulong probe;
 
   GST_DEBUG_OBJECT (bin, "freeing stream %p", stream);
 
@@ -2062,6 +2205,17 @@ free_stream (GstRtpBinStream * stream, GstRtpBin * bin)
   if (stream->demux)
     gst_element_set_state (stream->demux, GST_STATE_NULL);
 
+  GST_OBJECT_LOCK (bin);
+  probe = stream->first_push_probe;
+  stream->first_push_probe = 0;
+  GST_OBJECT_UNLOCK (bin);
+  if (probe) {
+    GstPad *pad = gst_element_get_static_pad (stream->buffer, "src");
+
+    gst_pad_remove_probe (pad, probe);
+    gst_object_unref (pad);
+  }
+
   if (stream->demux) {
     g_signal_handler_disconnect (stream->demux, stream->demux_newpad_sig);
     g_signal_handler_disconnect (stream->demux, stream->demux_ptreq_sig);
@@ -3002,6 +3156,50 @@ gst_rtp_bin_class_init (GstRtpBinClass * klass)
           DEFAULT_UPDATE_NTP64_HEADER_EXT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpBin:shared-timers:
+   *
+   * Let the jitterbuffers handle their timers on a process-wide pool of
+   * threads instead of on one thread per jitterbuffer. This reduces the
+   * number of threads considerably when receiving many streams. Changes
+   * only take effect when a jitterbuffer goes from READY to PAUSED.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARED_TIMERS,
+      g_param_spec_boolean ("shared-timers", "Shared Timers",
+          "Handle the jitterbuffer timers on a process-wide thread pool",
+          DEFAULT_SHARED_TIMERS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpBin:stats:
+   *
+   * The startup timeline of the received streams, to measure how long it
+   * takes for media to flow. This property returns a #GstStructure with name
+   * `application/x-rtp-bin-stats` with the following fields:
+   *
+   * * #guint64 `start-time`: gst_util_get_timestamp() when the bin went to
+   *   PAUSED, the other times are relative to it.
+   * * #GstValueArray `streams`: a `application/x-rtp-bin-stream-stats`
+   *   structure for each received SSRC, with the following fields:
+   *   * #guint `session`: the session of the SSRC.
+   *   * #guint `ssrc`: the SSRC.
+   *   * #guint64 `first-rtp`: when the first RTP packet was received.
+   *   * #guint64 `first-rtcp-sr`: when the first RTCP SR was received.
+   *   * #guint64 `first-push`: when the jitterbuffer pushed its first packet.
+   *
+   * The times are in nanoseconds and only present once reached. Each time a
+   * milestone is reached, an element message named `GstRTPBinStartup` is
+   * posted with the `session`, the `ssrc`, the name of the `milestone` and
+   * its `time`.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Startup timeline of the streams", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_rtp_bin_change_state);
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_rtp_bin_request_new_pad);
@@ -3093,6 +3291,7 @@ gst_rtp_bin_init (GstRtpBin * rtpbin)
   rtpbin->min_ts_offset_is_set = FALSE;
   rtpbin->ts_offset_smoothing_factor = DEFAULT_TS_OFFSET_SMOOTHING_FACTOR;
   rtpbin->update_ntp64_header_ext = DEFAULT_UPDATE_NTP64_HEADER_EXT;
+  rtpbin->shared_timers = DEFAULT_SHARED_TIMERS;
 
   /* some default SDES entries */
   cname = g_strdup_printf ("user%u@host-%x", g_random_int (), g_random_int ());
@@ -3439,6 +3638,13 @@ gst_rtp_bin_set_property (GObject * object, guint prop_id,
       gst_rtp_bin_propagate_property_to_session (rtpbin,
           "update-ntp64-header-ext", value);
       break;
+    case PROP_SHARED_TIMERS:
+      GST_RTP_BIN_LOCK (rtpbin);
+      rtpbin->shared_timers = g_value_get_boolean (value);
+      GST_RTP_BIN_UNLOCK (rtpbin);
+      gst_rtp_bin_propagate_property_to_jitterbuffer (rtpbin,
+          "shared-timers", value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3551,6 +3757,12 @@ gst_rtp_bin_get_property (GObject * object, guint prop_id,
     case PROP_UPDATE_NTP64_HEADER_EXT:
       g_value_set_boolean (value, rtpbin->update_ntp64_header_ext);
       break;
+    case PROP_SHARED_TIMERS:
+      g_value_set_boolean (value, rtpbin->shared_timers);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_rtp_bin_create_stats (rtpbin));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3771,6 +3983,9 @@ gst_rtp_bin_change_state (GstElement * element, GstStateChange transition)
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       priv->last_ntpnstime = 0;
+      GST_OBJECT_LOCK (rtpbin);
+      priv->startup_time = gst_util_get_timestamp ();
+      GST_OBJECT_UNLOCK (rtpbin);
       GST_LOG_OBJECT (rtpbin, "clearing shutdown flag");
       g_atomic_int_set (&priv->shutdown, 0);
       break;
@@ -4230,6 +4445,8 @@ new_ssrc_pad_found (GstElement * element, guint ssrc, GstPad * pad,
     gst_object_unref (pad);
   }
 
+  gst_rtp_bin_stream_milestone (stream, STARTUP_FIRST_RTP);
+
   return;
 
   /* ERRORS */
@@ -100,6 +100,8 @@ struct _GstRtpBin {
 
   gboolean       update_ntp64_header_ext;
 
+  gboolean       shared_timers;
+
   /*< private >*/
   GstRtpBinPrivate *priv;
 };
@@ -157,11 +157,23 @@ enum
 #define DEFAULT_RFC7273_SYNC        FALSE
 #define DEFAULT_ADD_REFERENCE_TIMESTAMP_META FALSE
 #define DEFAULT_FASTSTART_MIN_PACKETS 0
+#define DEFAULT_FASTSTART_KEYFRAME FALSE
 #define DEFAULT_SYNC_INTERVAL 0
+#define DEFAULT_SHARED_TIMERS FALSE
 
 #define DEFAULT_AUTO_RTX_DELAY (20 * GST_MSECOND)
 #define DEFAULT_AUTO_RTX_TIMEOUT (40 * GST_MSECOND)
 
+/* Frame marking RTP header extension, draft-ietf-avtext-framemarking */
+#define RTP_HDREXT_FRAME_MARKING GST_RTP_HDREXT_BASE "framemarking"
+#define FRAME_MARKING_START       0x80
+#define FRAME_MARKING_END         0x40
+#define FRAME_MARKING_INDEPENDENT 0x20
+
+/* after a keyframe fast start, the output grows back to the configured
+ * latency by 1/FASTSTART_RAMP_DIVISOR of the media time pushed */
+#define FASTSTART_RAMP_DIVISOR 10
+
 enum
 {
   PROP_0,
@@ -193,6 +205,8 @@ enum
   PROP_ADD_REFERENCE_TIMESTAMP_META,
   PROP_FASTSTART_MIN_PACKETS,
   PROP_SYNC_INTERVAL,
+  PROP_SHARED_TIMERS,
+  PROP_FASTSTART_KEYFRAME,
 };
 
 #define JBUF_LOCK(priv)   G_STMT_START {			\
@@ -310,6 +324,10 @@ struct _GstRtpJitterBufferPrivate
 
   gboolean timer_running;
   GThread *timer_thread;
+  /* when running on the shared timer pool */
+  gboolean timer_shared;
+  gboolean timer_pending;
+  gboolean timer_rerun;
 
   /* properties */
   guint latency_ms;
@@ -335,14 +353,25 @@ struct _GstRtpJitterBufferPrivate
   guint32 max_dropout_time;
   guint32 max_misorder_time;
   guint faststart_min_packets;
+  gboolean faststart_keyframe;
   gboolean add_reference_timestamp_meta;
   guint sync_interval;
+  gboolean shared_timers;
 
   /* Reference for GstReferenceTimestampMeta */
   GstCaps *reference_timestamp_caps;
 
   /* RTP header extension ID for RFC6051 64-bit NTP timestamps */
   guint8 ntp64_ext_id;
+  /* RTP header extension ID for frame marking */
+  guint8 framemarking_ext_id;
+
+  /* keyframe fast start: how early we output compared to the latency, and
+   * how far we scanned the packets at the head of the queue */
+  GstClockTimeDiff faststart_offset;
+  guint32 faststart_scan_head;
+  guint32 faststart_scan_last;
+  gboolean faststart_scan_keyframe;
 
   /* Known CNAME / SSRC mappings */
   GList *cname_ssrc_mappings;
@@ -395,7 +424,7 @@ struct _GstRtpJitterBufferPrivate
   GstFlowReturn srcresult;
   gboolean blocked;
 
-  /* for sync */
+  /* for sync, owned by us when using the shared timer pool */
   GstSegment segment;
   GstClockID clock_id;
   GstClockTime timer_timeout;
@@ -580,6 +609,7 @@ static void do_handle_sync_inband (GstRtpJitterBuffer * jitterbuffer,
 static void unschedule_current_timer (GstRtpJitterBuffer * jitterbuffer);
 
 static void wait_next_timeout (GstRtpJitterBuffer * jitterbuffer);
+static void shared_timer_kick (GstRtpJitterBuffer * jitterbuffer);
 
 static GstStructure *gst_rtp_jitter_buffer_create_stats (GstRtpJitterBuffer *
     jitterbuffer);
@@ -983,6 +1013,29 @@ gst_rtp_jitter_buffer_class_init (GstRtpJitterBufferClass * klass)
           0, G_MAXUINT, DEFAULT_FASTSTART_MIN_PACKETS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpJitterBuffer:faststart-keyframe:
+   *
+   * Start as soon as the consecutive packets at the head of the queue
+   * contain a complete keyframe instead of waiting for the latency to
+   * elapse. Keyframes are recognised from the frame marking RTP header
+   * extension, which has to be announced in the caps, and a frame ends at
+   * its end flag or at the marker bit.
+   *
+   * The first buffers are then timestamped early so that they can be
+   * rendered right away, and the output smoothly grows back to the
+   * configured latency while data is pushed. This reduces the startup
+   * time of live streams while keeping the full latency for reordering
+   * and retransmission afterwards.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_FASTSTART_KEYFRAME,
+      g_param_spec_boolean ("faststart-keyframe", "Faststart on keyframe",
+          "Start as soon as a complete keyframe was received and grow to "
+          "the configured latency afterwards", DEFAULT_FASTSTART_KEYFRAME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstRtpJitterBuffer:sync-interval:
    *
@@ -997,6 +1050,24 @@ gst_rtp_jitter_buffer_class_init (GstRtpJitterBufferClass * klass)
           0, G_MAXUINT, DEFAULT_SYNC_INTERVAL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpJitterBuffer:shared-timers:
+   *
+   * Handle the timers on a pool of threads shared by all jitterbuffers of
+   * the process instead of on a dedicated thread per jitterbuffer. The
+   * pool has one thread per CPU core and waits on the clock
+   * asynchronously, which saves a lot of mostly sleeping threads when
+   * receiving many streams.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARED_TIMERS,
+      g_param_spec_boolean ("shared-timers", "Shared Timers",
+          "Handle timers on a process-wide thread pool instead of a "
+          "dedicated thread", DEFAULT_SHARED_TIMERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   /**
    * GstRtpJitterBuffer::request-pt-map:
    * @buffer: the object which received the signal
@@ -1126,10 +1197,14 @@ gst_rtp_jitter_buffer_init (GstRtpJitterBuffer * jitterbuffer)
   priv->max_dropout_time = DEFAULT_MAX_DROPOUT_TIME;
   priv->max_misorder_time = DEFAULT_MAX_MISORDER_TIME;
   priv->faststart_min_packets = DEFAULT_FASTSTART_MIN_PACKETS;
+  priv->faststart_keyframe = DEFAULT_FASTSTART_KEYFRAME;
   priv->add_reference_timestamp_meta = DEFAULT_ADD_REFERENCE_TIMESTAMP_META;
   priv->sync_interval = DEFAULT_SYNC_INTERVAL;
+  priv->shared_timers = DEFAULT_SHARED_TIMERS;
 
   priv->ts_offset_remainder = 0;
+  priv->faststart_offset = 0;
+  priv->faststart_scan_head = -1;
   priv->last_dts = -1;
   priv->last_pts = -1;
   priv->last_rtptime = -1;
@@ -1680,6 +1755,9 @@ gst_jitter_buffer_sink_parse_caps (GstRtpJitterBuffer * jitterbuffer,
   priv->ntp64_ext_id =
       gst_rtp_get_extmap_id_for_attribute (caps_struct,
       GST_RTP_HDREXT_BASE GST_RTP_HDREXT_NTP_64);
+  priv->framemarking_ext_id =
+      gst_rtp_get_extmap_id_for_attribute (caps_struct,
+      RTP_HDREXT_FRAME_MARKING);
 
   return TRUE;
 
@@ -1737,6 +1815,9 @@ gst_rtp_jitter_buffer_flush_stop (GstRtpJitterBuffer * jitterbuffer)
   priv->next_in_seqnum = -1;
   priv->clock_rate = -1;
   priv->ntp64_ext_id = 0;
+  priv->framemarking_ext_id = 0;
+  priv->faststart_offset = 0;
+  priv->faststart_scan_head = -1;
   priv->last_pt = -1;
   priv->last_ssrc = -1;
   priv->eos = FALSE;
@@ -1827,6 +1908,7 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       priv->last_pt = -1;
       priv->last_ssrc = -1;
       priv->ntp64_ext_id = 0;
+      priv->framemarking_ext_id = 0;
       g_list_free_full (priv->cname_ssrc_mappings,
           (GDestroyNotify) cname_ssrc_mapping_free);
       priv->cname_ssrc_mappings = NULL;
@@ -1834,8 +1916,11 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       priv->blocked = TRUE;
       priv->timer_running = TRUE;
       priv->srcresult = GST_FLOW_OK;
-      priv->timer_thread =
-          g_thread_new ("timer", (GThreadFunc) wait_next_timeout, jitterbuffer);
+      priv->timer_shared = priv->shared_timers;
+      if (!priv->timer_shared)
+        priv->timer_thread =
+            g_thread_new ("timer", (GThreadFunc) wait_next_timeout,
+            jitterbuffer);
       JBUF_UNLOCK (priv);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
@@ -1844,6 +1929,8 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       priv->blocked = FALSE;
       JBUF_SIGNAL_EVENT (priv);
       JBUF_SIGNAL_TIMER (priv);
+      if (priv->timer_shared)
+        shared_timer_kick (jitterbuffer);
       JBUF_UNLOCK (priv);
       break;
     default:
@@ -1877,9 +1964,16 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       JBUF_SIGNAL_TIMER (priv);
       JBUF_SIGNAL_QUERY (priv, FALSE);
       JBUF_SIGNAL_QUEUE (priv);
-      JBUF_UNLOCK (priv);
-      g_thread_join (priv->timer_thread);
-      priv->timer_thread = NULL;
+      if (priv->timer_shared) {
+        /* wait for the pool to finish with us */
+        while (priv->timer_pending)
+          JBUF_WAIT_TIMER (priv);
+        JBUF_UNLOCK (priv);
+      } else {
+        JBUF_UNLOCK (priv);
+        g_thread_join (priv->timer_thread);
+        priv->timer_thread = NULL;
+      }
       gst_clear_caps (&priv->reference_timestamp_caps);
       g_list_free_full (priv->cname_ssrc_mappings,
           (GDestroyNotify) cname_ssrc_mapping_free);
@@ -2223,7 +2317,8 @@ static inline GstClockTimeDiff
 timeout_offset (GstRtpJitterBuffer * jitterbuffer)
 {
   GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
-  return priv->ts_offset + priv->out_offset + priv->latency_ns;
+  return priv->ts_offset + priv->out_offset + priv->latency_ns +
+      priv->faststart_offset;
 }
 
 static inline GstClockTime
@@ -2309,6 +2404,30 @@ update_offset (GstRtpJitterBuffer * jitterbuffer)
   }
 }
 
+/* After a keyframe fast start we output early, slowly give that time back
+ * so that we end up buffering the configured latency again */
+static void
+update_faststart_offset (GstRtpJitterBuffer * jitterbuffer, GstClockTime pts)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+  GstClockTime step;
+
+  if (priv->faststart_offset == 0)
+    return;
+
+  if (!GST_CLOCK_TIME_IS_VALID (pts) ||
+      !GST_CLOCK_TIME_IS_VALID (priv->last_pts) || pts <= priv->last_pts)
+    return;
+
+  step = (pts - priv->last_pts) / FASTSTART_RAMP_DIVISOR;
+  priv->faststart_offset = MIN (priv->faststart_offset + (gint64) step, 0);
+
+  GST_DEBUG_OBJECT (jitterbuffer, "faststart offset now %" GST_STIME_FORMAT,
+      GST_STIME_ARGS (priv->faststart_offset));
+
+  update_timer_offsets (jitterbuffer);
+}
+
 static GstClockTime
 apply_offset (GstRtpJitterBuffer * jitterbuffer, GstClockTime timestamp)
 {
@@ -2322,6 +2441,9 @@ apply_offset (GstRtpJitterBuffer * jitterbuffer, GstClockTime timestamp)
   /* apply the timestamp offset, this is used for inter stream sync */
   if (!safe_add (&timestamp, timestamp, priv->ts_offset))
     timestamp = 0;
+  /* output early after a keyframe fast start */
+  if (!safe_add (&timestamp, timestamp, priv->faststart_offset))
+    timestamp = 0;
   /* add the offset, this is used when buffering */
   timestamp += priv->out_offset;
 
@@ -2333,6 +2455,11 @@ unschedule_current_timer (GstRtpJitterBuffer * jitterbuffer)
 {
   GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
 
+  if (priv->timer_shared) {
+    shared_timer_kick (jitterbuffer);
+    return;
+  }
+
   if (priv->clock_id) {
     GST_DEBUG_OBJECT (jitterbuffer, "unschedule current timer");
     gst_clock_id_unschedule (priv->clock_id);
@@ -2360,6 +2487,15 @@ update_current_timer (GstRtpJitterBuffer * jitterbuffer)
       " and earliest timeout is at %" GST_TIME_FORMAT,
       GST_TIME_ARGS (priv->timer_timeout), GST_TIME_ARGS (timer->timeout));
 
+  /* the pool only needs to run for us if we are not waiting for a timeout
+   * yet or if the new timeout is earlier */
+  if (priv->timer_shared) {
+    if (priv->clock_id == NULL || timer->timeout == -1
+        || timer->timeout < priv->timer_timeout)
+      shared_timer_kick (jitterbuffer);
+    return;
+  }
+
   /* wakeup the timer thread in case the timer queue was empty */
   JBUF_SIGNAL_TIMER (priv);
 
@@ -3033,8 +3169,78 @@ gst_rtp_jitter_buffer_reset (GstRtpJitterBuffer * jitterbuffer,
   return ret;
 }
 
+/* Checks if the consecutive packets at the head of the queue contain a
+ * complete keyframe. The packets already looked at are remembered so that
+ * each packet is only parsed once while we wait. */
 static gboolean
-gst_rtp_jitter_buffer_fast_start (GstRtpJitterBuffer * jitterbuffer)
+gst_rtp_jitter_buffer_has_keyframe (GstRtpJitterBuffer * jitterbuffer,
+    RTPJitterBufferItem * head)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+  RTPJitterBufferItem *item;
+
+  if (priv->framemarking_ext_id == 0)
+    return FALSE;
+
+  if (head->seqnum != priv->faststart_scan_head) {
+    priv->faststart_scan_head = head->seqnum;
+    priv->faststart_scan_last = -1;
+    priv->faststart_scan_keyframe = FALSE;
+  }
+
+  for (item = head; item; item = (RTPJitterBufferItem *) item->next) {
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    guint8 *data;
+    guint size;
+    guint8 flags = 0;
+    gboolean marker;
+
+    if (item->type != ITEM_TYPE_BUFFER)
+      continue;
+
+    if (priv->faststart_scan_last != -1) {
+      /* scanned on a previous call */
+      if (gst_rtp_buffer_compare_seqnum (item->seqnum,
+              priv->faststart_scan_last) >= 0)
+        continue;
+      /* wait for the missing packets */
+      if (item->seqnum != ((priv->faststart_scan_last + 1) & 0xffff))
+        return FALSE;
+    }
+
+    if (!gst_rtp_buffer_map (item->data, GST_MAP_READ, &rtp))
+      return FALSE;
+
+    marker = gst_rtp_buffer_get_marker (&rtp);
+    if ((gst_rtp_buffer_get_extension_onebyte_header (&rtp,
+                priv->framemarking_ext_id, 0, (gpointer *) & data, &size)
+            || gst_rtp_buffer_get_extension_twobytes_header (&rtp, NULL,
+                priv->framemarking_ext_id, 0, (gpointer *) & data, &size))
+        && size >= 1)
+      flags = data[0];
+    gst_rtp_buffer_unmap (&rtp);
+
+    priv->faststart_scan_last = item->seqnum;
+
+    if (flags & FRAME_MARKING_START)
+      priv->faststart_scan_keyframe = (flags & FRAME_MARKING_INDEPENDENT) != 0;
+
+    if ((flags & FRAME_MARKING_END) || marker) {
+      if (priv->faststart_scan_keyframe) {
+        GST_DEBUG_OBJECT (jitterbuffer, "keyframe complete at #%u",
+            item->seqnum);
+        return TRUE;
+      }
+      priv->faststart_scan_keyframe = FALSE;
+    }
+  }
+
+  return FALSE;
+}
+
+static gboolean
+gst_rtp_jitter_buffer_fast_start (GstRtpJitterBuffer * jitterbuffer,
+    GstClockTime now)
 {
   GstRtpJitterBufferPrivate *priv;
   RTPJitterBufferItem *item;
@@ -3042,7 +3248,7 @@ gst_rtp_jitter_buffer_fast_start (GstRtpJitterBuffer * jitterbuffer)
 
   priv = jitterbuffer->priv;
 
-  if (priv->faststart_min_packets == 0)
+  if (priv->faststart_min_packets == 0 && !priv->faststart_keyframe)
     return FALSE;
 
   item = rtp_jitter_buffer_peek (priv->jbuf);
@@ -3053,7 +3259,8 @@ gst_rtp_jitter_buffer_fast_start (GstRtpJitterBuffer * jitterbuffer)
   if (!timer || timer->type != RTP_TIMER_DEADLINE)
     return FALSE;
 
-  if (rtp_jitter_buffer_can_fast_start (priv->jbuf,
+  if (priv->faststart_min_packets > 0 &&
+      rtp_jitter_buffer_can_fast_start (priv->jbuf,
           priv->faststart_min_packets)) {
     GST_INFO_OBJECT (jitterbuffer, "We found %i consecutive packet, start now",
         priv->faststart_min_packets);
@@ -3062,6 +3269,24 @@ gst_rtp_jitter_buffer_fast_start (GstRtpJitterBuffer * jitterbuffer)
     return TRUE;
   }
 
+  if (priv->faststart_keyframe &&
+      gst_rtp_jitter_buffer_has_keyframe (jitterbuffer, item)) {
+    /* output as early as we start so that downstream can render the
+     * keyframe now, we grow back to the latency while pushing */
+    if (GST_CLOCK_TIME_IS_VALID (now) && timer->timeout > now) {
+      priv->faststart_offset -= timer->timeout - now;
+      priv->faststart_offset =
+          MAX (priv->faststart_offset, -(GstClockTimeDiff) priv->latency_ns);
+      update_timer_offsets (jitterbuffer);
+    }
+    GST_INFO_OBJECT (jitterbuffer, "We found a complete keyframe, start now "
+        "with offset %" GST_STIME_FORMAT,
+        GST_STIME_ARGS (priv->faststart_offset));
+    timer->timeout = -1;
+    rtp_timer_queue_reschedule (priv->timers, timer);
+    return TRUE;
+  }
+
   return FALSE;
 }
 
@@ -3542,7 +3767,7 @@ gst_rtp_jitter_buffer_chain (GstPad * pad, GstObject * parent,
   }
 
   /* Trigger fast start if needed */
-  if (gst_rtp_jitter_buffer_fast_start (jitterbuffer))
+  if (gst_rtp_jitter_buffer_fast_start (jitterbuffer, now))
     head = TRUE;
 
   /* update rtx timers */
@@ -3819,6 +4044,7 @@ pop_and_push_next (GstRtpJitterBuffer * jitterbuffer, guint seqnum)
       /* if this is a new frame, check if ts_offset needs to be updated */
       if (pts != priv->last_pts) {
         update_offset (jitterbuffer);
+        update_faststart_offset (jitterbuffer, pts);
       }
 
       /* apply timestamp with offset to buffer now */
@@ -4354,6 +4580,50 @@ push_rtx_events (GstRtpJitterBuffer * jitterbuffer, GQueue * events)
   JBUF_LOCK (priv);
 }
 
+/* called with JBUF lock
+ *
+ * Updates @now with the current running time and handles all timers that
+ * expired by then. Events to push upstream are added to @events.
+ *
+ * Returns: the earliest timer that is still pending
+ */
+static RtpTimer *
+handle_expired_timers (GstRtpJitterBuffer * jitterbuffer, GstClockTime * now,
+    GQueue * events)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+  RtpTimer *timer;
+
+  /* If we have a clock, update "now" now with the very
+   * latest running time we have. If timers are unscheduled we
+   * otherwise wouldn't update now (it's only updated when timers
+   * expire), and also for the very first loop iteration now would
+   * otherwise always be 0
+   */
+  GST_OBJECT_LOCK (jitterbuffer);
+  if (priv->eos) {
+    *now = GST_CLOCK_TIME_NONE;
+  } else if (GST_ELEMENT_CLOCK (jitterbuffer)) {
+    *now =
+        gst_clock_get_time (GST_ELEMENT_CLOCK (jitterbuffer)) -
+        GST_ELEMENT_CAST (jitterbuffer)->base_time;
+  }
+  GST_OBJECT_UNLOCK (jitterbuffer);
+
+  GST_DEBUG_OBJECT (jitterbuffer, "now %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (*now));
+
+  /* Clear expired rtx-stats timers */
+  if (priv->do_retransmission)
+    rtp_timer_queue_remove_until (priv->rtx_stats_timers, *now);
+
+  /* Iterate expired "normal" timers */
+  while ((timer = rtp_timer_queue_pop_until (priv->timers, *now)))
+    do_timeout (jitterbuffer, timer, *now, events);
+
+  return rtp_timer_queue_peek_earliest (priv->timers);
+}
+
 /* called when we need to wait for the next timeout.
  *
  * We loop over the array of recorded timeouts and wait for the earliest one.
@@ -4379,34 +4649,7 @@ wait_next_timeout (GstRtpJitterBuffer * jitterbuffer)
         goto stopping;
     }
 
-    /* If we have a clock, update "now" now with the very
-     * latest running time we have. If timers are unscheduled below we
-     * otherwise wouldn't update now (it's only updated when timers
-     * expire), and also for the very first loop iteration now would
-     * otherwise always be 0
-     */
-    GST_OBJECT_LOCK (jitterbuffer);
-    if (priv->eos) {
-      now = GST_CLOCK_TIME_NONE;
-    } else if (GST_ELEMENT_CLOCK (jitterbuffer)) {
-      now =
-          gst_clock_get_time (GST_ELEMENT_CLOCK (jitterbuffer)) -
-          GST_ELEMENT_CAST (jitterbuffer)->base_time;
-    }
-    GST_OBJECT_UNLOCK (jitterbuffer);
-
-    GST_DEBUG_OBJECT (jitterbuffer, "now %" GST_TIME_FORMAT,
-        GST_TIME_ARGS (now));
-
-    /* Clear expired rtx-stats timers */
-    if (priv->do_retransmission)
-      rtp_timer_queue_remove_until (priv->rtx_stats_timers, now);
-
-    /* Iterate expired "normal" timers */
-    while ((timer = rtp_timer_queue_pop_until (priv->timers, now)))
-      do_timeout (jitterbuffer, timer, now, &events);
-
-    timer = rtp_timer_queue_peek_earliest (priv->timers);
+    timer = handle_expired_timers (jitterbuffer, &now, &events);
     if (timer) {
       GstClock *clock;
       GstClockTime sync_time;
@@ -4492,6 +4735,128 @@ stopping:
   return;
 }
 
+/* Shared timers
+ *
+ * Instead of a dedicated thread sleeping on the clock, the earliest timer
+ * of each jitterbuffer is scheduled as an async clock id. When it expires,
+ * or when the timers change, the jitterbuffer is queued on a process-wide
+ * thread pool which handles the expired timers and schedules the next
+ * async wait. timer_pending is set while the jitterbuffer is queued on or
+ * handled by the pool, timer_rerun when it needs another pass.
+ */
+static GThreadPool *shared_timer_pool;
+G_LOCK_DEFINE_STATIC (shared_timer_pool);
+
+static gboolean
+shared_timer_cb (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstRtpJitterBuffer *jitterbuffer = user_data;
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+
+  JBUF_LOCK (priv);
+  /* ignore timeouts we replaced in the meantime */
+  if (priv->clock_id == id) {
+    GST_DEBUG_OBJECT (jitterbuffer, "timeout for #%d", priv->timer_seqnum);
+    shared_timer_kick (jitterbuffer);
+  }
+  JBUF_UNLOCK (priv);
+
+  return TRUE;
+}
+
+static void
+shared_timer_func (GstRtpJitterBuffer * jitterbuffer, gpointer user_data)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+  GstClockTime now = 0;
+
+  JBUF_LOCK (priv);
+  do {
+    RtpTimer *timer;
+    GQueue events = G_QUEUE_INIT;
+
+    priv->timer_rerun = FALSE;
+    if (!priv->timer_running || priv->blocked)
+      break;
+
+    timer = handle_expired_timers (jitterbuffer, &now, &events);
+    if (timer) {
+      GstClock *clock;
+      GstClockTime sync_time;
+
+      g_assert (GST_CLOCK_TIME_IS_VALID (timer->timeout));
+
+      GST_OBJECT_LOCK (jitterbuffer);
+      clock = GST_ELEMENT_CLOCK (jitterbuffer);
+      if (!clock) {
+        GST_OBJECT_UNLOCK (jitterbuffer);
+        /* let's just push if there is no clock */
+        GST_DEBUG_OBJECT (jitterbuffer, "No clock, timeout right away");
+        now = timer->timeout;
+        priv->timer_rerun = TRUE;
+      } else {
+        sync_time = timer->timeout + GST_ELEMENT_CAST (jitterbuffer)->base_time;
+        sync_time += priv->peer_latency;
+
+        GST_DEBUG_OBJECT (jitterbuffer, "timer #%i sync to timestamp %"
+            GST_TIME_FORMAT " with sync time %" GST_TIME_FORMAT,
+            timer->seqnum, GST_TIME_ARGS (get_pts_timeout (timer)),
+            GST_TIME_ARGS (sync_time));
+
+        priv->clock_id = gst_clock_new_single_shot_id (clock, sync_time);
+        priv->timer_timeout = timer->timeout;
+        priv->timer_seqnum = timer->seqnum;
+        GST_OBJECT_UNLOCK (jitterbuffer);
+
+        gst_clock_id_wait_async (priv->clock_id, shared_timer_cb,
+            gst_object_ref (jitterbuffer), gst_object_unref);
+      }
+    }
+
+    push_rtx_events (jitterbuffer, &events);
+  } while (priv->timer_rerun);
+
+  priv->timer_pending = FALSE;
+  /* wake up both the state change and an EOS drain waiting for us */
+  if (priv->waiting_timer)
+    g_cond_broadcast (&priv->jbuf_timer);
+  JBUF_UNLOCK (priv);
+
+  gst_object_unref (jitterbuffer);
+}
+
+/* called with JBUF lock */
+static void
+shared_timer_kick (GstRtpJitterBuffer * jitterbuffer)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+
+  if (priv->clock_id) {
+    GST_DEBUG_OBJECT (jitterbuffer, "unschedule current timer");
+    gst_clock_id_unschedule (priv->clock_id);
+    gst_clock_id_unref (priv->clock_id);
+    priv->clock_id = NULL;
+  }
+
+  if (!priv->timer_running || priv->blocked)
+    return;
+
+  if (priv->timer_pending) {
+    priv->timer_rerun = TRUE;
+    return;
+  }
+
+  G_LOCK (shared_timer_pool);
+  if (G_UNLIKELY (shared_timer_pool == NULL)) {
+    shared_timer_pool = g_thread_pool_new ((GFunc) shared_timer_func, NULL,
+        g_get_num_processors (), FALSE, NULL);
+  }
+  priv->timer_pending = TRUE;
+  g_thread_pool_push (shared_timer_pool, gst_object_ref (jitterbuffer), NULL);
+  G_UNLOCK (shared_timer_pool);
+}
+
 /*
  * This function implements the main pushing loop on the source pad.
  *
@@ -5200,6 +5565,11 @@ gst_rtp_jitter_buffer_set_property (GObject * object,
       priv->faststart_min_packets = g_value_get_uint (value);
       JBUF_UNLOCK (priv);
       break;
+    case PROP_FASTSTART_KEYFRAME:
+      JBUF_LOCK (priv);
+      priv->faststart_keyframe = g_value_get_boolean (value);
+      JBUF_UNLOCK (priv);
+      break;
     case PROP_ADD_REFERENCE_TIMESTAMP_META:
       JBUF_LOCK (priv);
       priv->add_reference_timestamp_meta = g_value_get_boolean (value);
@@ -5210,6 +5580,11 @@ gst_rtp_jitter_buffer_set_property (GObject * object,
       priv->sync_interval = g_value_get_uint (value);
       JBUF_UNLOCK (priv);
       break;
+    case PROP_SHARED_TIMERS:
+      JBUF_LOCK (priv);
+      priv->shared_timers = g_value_get_boolean (value);
+      JBUF_UNLOCK (priv);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -5366,6 +5741,11 @@ gst_rtp_jitter_buffer_get_property (GObject * object,
       g_value_set_uint (value, priv->faststart_min_packets);
       JBUF_UNLOCK (priv);
       break;
+    case PROP_FASTSTART_KEYFRAME:
+      JBUF_LOCK (priv);
+      g_value_set_boolean (value, priv->faststart_keyframe);
+      JBUF_UNLOCK (priv);
+      break;
     case PROP_ADD_REFERENCE_TIMESTAMP_META:
       JBUF_LOCK (priv);
       g_value_set_boolean (value, priv->add_reference_timestamp_meta);
@@ -5376,6 +5756,11 @@ gst_rtp_jitter_buffer_get_property (GObject * object,
       g_value_set_uint (value, priv->sync_interval);
       JBUF_UNLOCK (priv);
       break;
+    case PROP_SHARED_TIMERS:
+      JBUF_LOCK (priv);
+      g_value_set_boolean (value, priv->shared_timers);
+      JBUF_UNLOCK (priv);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -45,6 +45,7 @@
 #include <stdlib.h>
 
 #include "gstrtprtxsend.h"
+#include "rtppacketring.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_rtp_rtx_send_debug);
 #define GST_CAT_DEFAULT gst_rtp_rtx_send_debug
@@ -158,28 +159,14 @@ GST_ELEMENT_REGISTER_DEFINE (rtprtxsend, "rtprtxsend", GST_RANK_NONE,
 
 #define IS_RTX_ENABLED(rtx) (g_hash_table_size ((rtx)->rtx_pt_map) > 0)
 
-typedef struct
-{
-  guint16 seqnum;
-  guint32 timestamp;
-  GstBuffer *buffer;
-} BufferQueueItem;
-
-static void
-buffer_queue_item_free (BufferQueueItem * item)
-{
-  gst_buffer_unref (item->buffer);
-  g_slice_free (BufferQueueItem, item);
-}
-
 typedef struct
 {
   guint32 rtx_ssrc;
   guint16 seqnum_base, next_seqnum;
   gint clock_rate;
 
-  /* history of rtp packets */
-  GSequence *queue;
+  /* history of rtp packets, indexed by seqnum */
+  RtpPacketRing history;
 } SSRCRtxData;
 
 static SSRCRtxData *
@@ -189,7 +176,7 @@ ssrc_rtx_data_new (guint32 rtx_ssrc)
 
   data->rtx_ssrc = rtx_ssrc;
   data->next_seqnum = data->seqnum_base = g_random_int_range (0, G_MAXUINT16);
-  data->queue = g_sequence_new ((GDestroyNotify) buffer_queue_item_free);
+  rtp_packet_ring_init (&data->history);
 
   return data;
 }
@@ -197,7 +184,7 @@ ssrc_rtx_data_new (guint32 rtx_ssrc)
 static void
 ssrc_rtx_data_free (SSRCRtxData * data)
 {
-  g_sequence_free (data->queue);
+  rtp_packet_ring_clear (&data->history);
   g_slice_free (SSRCRtxData, data);
 }
 
@@ -740,16 +727,6 @@ gst_rtp_rtx_buffer_new (GstRtpRtxSend * rtx, GstBuffer * buffer)
   return new_buffer;
 }
 
-static gint
-buffer_queue_items_cmp (BufferQueueItem * a, BufferQueueItem * b,
-    gpointer user_data)
-{
-  /* gst_rtp_buffer_compare_seqnum returns the opposite of what we want,
-   * it returns negative when seqnum1 > seqnum2 and we want negative
-   * when b > a, i.e. a is smaller, so it comes first in the sequence */
-  return gst_rtp_buffer_compare_seqnum (b->seqnum, a->seqnum);
-}
-
 static gboolean
 gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -782,34 +759,26 @@ gst_rtp_rtx_send_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         /* check if request is for us */
         if (g_hash_table_contains (rtx->ssrc_data, GUINT_TO_POINTER (ssrc))) {
           SSRCRtxData *data;
-          GSequenceIter *iter;
-          BufferQueueItem search_item;
+          RtpPacketRingItem *item;
 
           /* update statistics */
           ++rtx->num_rtx_requests;
 
           data = gst_rtp_rtx_send_get_ssrc_data (rtx, ssrc);
 
-          search_item.seqnum = seqnum;
-          iter = g_sequence_lookup (data->queue, &search_item,
-              (GCompareDataFunc) buffer_queue_items_cmp, NULL);
-          if (iter) {
-            BufferQueueItem *item = g_sequence_get (iter);
-            GST_LOG_OBJECT (rtx, "found %u", item->seqnum);
+          item = rtp_packet_ring_lookup (&data->history, seqnum);
+          if (item) {
+            GST_LOG_OBJECT (rtx, "found %u", item->seq);
             rtx_buf = gst_rtp_rtx_buffer_new (rtx, item->buffer);
           }
 #ifndef GST_DISABLE_DEBUG
           else {
-            BufferQueueItem *item = NULL;
-
-            iter = g_sequence_get_begin_iter (data->queue);
-            if (!g_sequence_iter_is_end (iter))
-              item = g_sequence_get (iter);
+            item = rtp_packet_ring_peek_oldest (&data->history);
 
-            if (item && seqnum < item->seqnum) {
+            if (item && gst_rtp_buffer_compare_seqnum (seqnum, item->seq) < 0) {
               GST_DEBUG_OBJECT (rtx, "requested seqnum %u has already been "
                   "removed from the rtx queue; the first available is %u",
-                  seqnum, item->seqnum);
+                  seqnum, item->seq);
             } else {
               GST_WARNING_OBJECT (rtx, "requested seqnum %u has not been "
                   "transmitted yet in the original stream; either the remote end "
@@ -978,13 +947,11 @@ static guint32
 gst_rtp_rtx_send_get_ts_diff (SSRCRtxData * data)
 {
   guint64 high_ts, low_ts;
-  BufferQueueItem *high_buf, *low_buf;
+  RtpPacketRingItem *high_buf, *low_buf;
   guint32 result;
 
-  high_buf =
-      g_sequence_get (g_sequence_iter_prev (g_sequence_get_end_iter
-          (data->queue)));
-  low_buf = g_sequence_get (g_sequence_get_begin_iter (data->queue));
+  high_buf = rtp_packet_ring_peek_newest (&data->history);
+  low_buf = rtp_packet_ring_peek_oldest (&data->history);
 
   if (!high_buf || !low_buf || high_buf == low_buf)
     return 0;
@@ -1014,7 +981,6 @@ static void
 process_buffer (GstRtpRtxSend * rtx, GstBuffer * buffer)
 {
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
-  BufferQueueItem *item;
   SSRCRtxData *data;
   guint16 seqnum;
   guint8 payload_type;
@@ -1042,20 +1008,21 @@ process_buffer (GstRtpRtxSend * rtx, GstBuffer * buffer)
     }
 
     /* add current rtp buffer to queue history */
-    item = g_slice_new0 (BufferQueueItem);
-    item->seqnum = seqnum;
-    item->timestamp = rtptime;
-    item->buffer = gst_buffer_ref (buffer);
-    g_sequence_append (data->queue, item);
+    if (!rtp_packet_ring_insert (&data->history, gst_buffer_ref (buffer),
+            seqnum, payload_type, rtptime)) {
+      GST_DEBUG_OBJECT (rtx, "seqnum %u is too old to be kept in history",
+          seqnum);
+    }
 
     /* remove oldest packets from history if they are too many */
     if (rtx->max_size_packets) {
-      while (g_sequence_get_length (data->queue) > rtx->max_size_packets)
-        g_sequence_remove (g_sequence_get_begin_iter (data->queue));
+      while (rtp_packet_ring_get_length (&data->history) >
+          rtx->max_size_packets)
+        rtp_packet_ring_pop_oldest (&data->history);
     }
     if (rtx->max_size_time) {
       while (gst_rtp_rtx_send_get_ts_diff (data) > rtx->max_size_time)
-        g_sequence_remove (g_sequence_get_begin_iter (data->queue));
+        rtp_packet_ring_pop_oldest (&data->history);
     }
   }
 }
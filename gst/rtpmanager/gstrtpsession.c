@@ -243,6 +243,7 @@ enum
   PROP_MAX_MISORDER_TIME,
   PROP_STATS,
   PROP_TWCC_STATS,
+  PROP_TWCC_TARGET_BITRATE,
   PROP_RTP_PROFILE,
   PROP_NTP_TIME_SOURCE,
   PROP_RTCP_SYNC_SEND_TIME,
@@ -283,6 +284,7 @@ struct _GstRtpSessionPrivate
   guint sent_rtx_req_count;
 
   GstStructure *last_twcc_stats;
+  guint twcc_target_bitrate;
 
   /*
    * This is the list of processed packets in the receive path when upstream
@@ -786,6 +788,8 @@ gst_rtp_session_class_init (GstRtpSessionClass * klass)
    *      average of the difference in inter-packet spacing between
    *      sender and receiver. A sudden increase in this number can indicate
    *      network congestion.
+   *  "target-bitrate"   G_TYPE_UINT    The bitrate estimated to be available,
+   *      see #GstRtpSession:twcc-target-bitrate. (Since: 1.24)
    *
    * Since: 1.18
    */
@@ -794,6 +798,26 @@ gst_rtp_session_class_init (GstRtpSessionClass * klass)
           "Various statistics from TWCC", GST_TYPE_STRUCTURE,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpSession:twcc-target-bitrate:
+   *
+   * The bitrate, in bits per second, that the network is estimated to
+   * carry for the streams sent in this session. It is estimated from the
+   * TWCC feedback of the receiver, with a delay and loss based congestion
+   * controller, and is notified every time it changes, so that encoders can
+   * be adapted to it. It is 0 until the first feedback has been received.
+   *
+   * The estimation can be tuned with the twcc-start-bitrate,
+   * twcc-min-bitrate and twcc-max-bitrate properties of the
+   * #GstRtpSession:internal-session.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_TWCC_TARGET_BITRATE,
+      g_param_spec_uint ("twcc-target-bitrate", "TWCC Target Bitrate",
+          "The bitrate estimated from TWCC feedback (in bits/s)",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (gobject_class, PROP_RTP_PROFILE,
       g_param_spec_enum ("rtp-profile", "RTP Profile",
           "RTP profile to use", GST_TYPE_RTP_PROFILE, DEFAULT_RTP_PROFILE,
@@ -1074,6 +1098,11 @@ gst_rtp_session_get_property (GObject * object, guint prop_id,
       g_value_set_boxed (value, priv->last_twcc_stats);
       GST_RTP_SESSION_UNLOCK (rtpsession);
       break;
+    case PROP_TWCC_TARGET_BITRATE:
+      GST_RTP_SESSION_LOCK (rtpsession);
+      g_value_set_uint (value, priv->twcc_target_bitrate);
+      GST_RTP_SESSION_UNLOCK (rtpsession);
+      break;
     case PROP_RTP_PROFILE:
       g_object_get_property (G_OBJECT (priv->session), "rtp-profile", value);
       break;
@@ -2941,6 +2970,8 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
   GstRtpSession *rtpsession = GST_RTP_SESSION (user_data);
   GstEvent *event;
   GstPad *send_rtp_sink;
+  guint target_bitrate;
+  gboolean target_changed = FALSE;
 
   GST_RTP_SESSION_LOCK (rtpsession);
   if ((send_rtp_sink = rtpsession->send_rtp_sink))
@@ -2948,6 +2979,11 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
   if (rtpsession->priv->last_twcc_stats)
     gst_structure_free (rtpsession->priv->last_twcc_stats);
   rtpsession->priv->last_twcc_stats = twcc_stats;
+  if (gst_structure_get_uint (twcc_stats, "target-bitrate", &target_bitrate)
+      && target_bitrate != rtpsession->priv->twcc_target_bitrate) {
+    rtpsession->priv->twcc_target_bitrate = target_bitrate;
+    target_changed = TRUE;
+  }
   GST_RTP_SESSION_UNLOCK (rtpsession);
 
   if (send_rtp_sink) {
@@ -2957,6 +2993,8 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
   }
 
   g_object_notify (G_OBJECT (rtpsession), "twcc-stats");
+  if (target_changed)
+    g_object_notify (G_OBJECT (rtpsession), "twcc-target-bitrate");
 }
 
 static void
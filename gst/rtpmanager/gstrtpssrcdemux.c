@@ -30,6 +30,15 @@
  * For each SSRC that is detected, a new pad will be created and the
  * #GstRtpSsrcDemux::new-ssrc-pad signal will be emitted.
  *
+ * By default, all SSRCs are pushed from the upstream streaming thread, so a
+ * downstream branch that blocks, for example a sink waiting on a slow disk,
+ * stalls all the other SSRCs as well. When #GstRtpSsrcDemux:threaded is
+ * enabled, every source pad gets its own queue and streaming thread instead,
+ * like a queue element after each pad would give. The size of the queues and
+ * what happens when they are full is configured with
+ * #GstRtpSsrcDemux:max-size-buffers and #GstRtpSsrcDemux:leaky, and can be
+ * changed for each pad on the #GstRtpSsrcDemuxPad.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 udpsrc caps="application/x-rtp" ! rtpssrcdemux ! fakesink
@@ -94,10 +103,16 @@ typedef enum
 } PadType;
 
 #define DEFAULT_MAX_STREAMS G_MAXUINT
+#define DEFAULT_THREADED FALSE
+#define DEFAULT_MAX_SIZE_BUFFERS 200
+#define DEFAULT_LEAKY GST_RTP_SSRC_DEMUX_LEAKY_NO
 enum
 {
   PROP_0,
-  PROP_MAX_STREAMS
+  PROP_MAX_STREAMS,
+  PROP_THREADED,
+  PROP_MAX_SIZE_BUFFERS,
+  PROP_LEAKY
 };
 
 /* signals */
@@ -118,6 +133,419 @@ GST_ELEMENT_REGISTER_DEFINE (rtpssrcdemux, "rtpssrcdemux", GST_RANK_NONE,
 static void gst_rtp_ssrc_demux_dispose (GObject * object);
 static void gst_rtp_ssrc_demux_finalize (GObject * object);
 
+GType
+gst_rtp_ssrc_demux_leaky_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue values[] = {
+    {GST_RTP_SSRC_DEMUX_LEAKY_NO, "Not Leaky", "no"},
+    {GST_RTP_SSRC_DEMUX_LEAKY_UPSTREAM, "Leaky on upstream (new buffers)",
+        "upstream"},
+    {GST_RTP_SSRC_DEMUX_LEAKY_DOWNSTREAM, "Leaky on downstream (old buffers)",
+        "downstream"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstRtpSsrcDemuxLeaky", values);
+  }
+  return type;
+}
+
+/**************** GstRtpSsrcDemuxPad ****************/
+
+struct _GstRtpSsrcDemuxPadClass
+{
+  GstPadClass parent_class;
+};
+
+/* In threaded mode, buffers and serialized events are queued by the upstream
+ * streaming thread and pushed from the task of the pad. */
+struct _GstRtpSsrcDemuxPad
+{
+  GstPad parent;
+
+  gboolean threaded;
+
+  GMutex lock;
+  GCond cond;
+  gboolean active;
+  GstFlowReturn srcresult;
+  GQueue queue;
+  guint n_buffers;
+  guint max_size_buffers;
+  GstRtpSsrcDemuxLeaky leaky;
+  guint64 dropped;
+};
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_MAX_SIZE_BUFFERS,
+  PROP_PAD_LEAKY,
+  PROP_PAD_CURRENT_LEVEL_BUFFERS,
+  PROP_PAD_DROPPED
+};
+
+G_DEFINE_TYPE (GstRtpSsrcDemuxPad, gst_rtp_ssrc_demux_pad, GST_TYPE_PAD);
+
+/* with the pad lock */
+static void
+gst_rtp_ssrc_demux_pad_flush (GstRtpSsrcDemuxPad * dpad)
+{
+  GstMiniObject *item;
+
+  while ((item = g_queue_pop_head (&dpad->queue))) {
+    /* keep the sticky events so that they get pushed before the next buffer
+     * once the pad is running again */
+    if (GST_IS_EVENT (item) && GST_EVENT_IS_STICKY (item) &&
+        GST_EVENT_TYPE (item) != GST_EVENT_SEGMENT &&
+        GST_EVENT_TYPE (item) != GST_EVENT_EOS)
+      gst_pad_store_sticky_event (GST_PAD_CAST (dpad), GST_EVENT_CAST (item));
+    gst_mini_object_unref (item);
+  }
+  dpad->n_buffers = 0;
+}
+
+static void
+gst_rtp_ssrc_demux_pad_loop (GstPad * pad)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (pad);
+  GstMiniObject *item;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&dpad->lock);
+  while (dpad->srcresult == GST_FLOW_OK && g_queue_is_empty (&dpad->queue))
+    g_cond_wait (&dpad->cond, &dpad->lock);
+
+  if (dpad->srcresult != GST_FLOW_OK)
+    goto pause;
+
+  item = g_queue_pop_head (&dpad->queue);
+  if (GST_IS_BUFFER (item))
+    dpad->n_buffers--;
+  /* there is room again for the upstream thread */
+  g_cond_broadcast (&dpad->cond);
+  g_mutex_unlock (&dpad->lock);
+
+  if (GST_IS_BUFFER (item)) {
+    ret = gst_pad_push (pad, GST_BUFFER_CAST (item));
+  } else {
+    gboolean is_eos = GST_EVENT_TYPE (item) == GST_EVENT_EOS;
+
+    gst_pad_push_event (pad, GST_EVENT_CAST (item));
+    ret = is_eos ? GST_FLOW_EOS : GST_FLOW_OK;
+  }
+
+  /* an unlinked SSRC must not make upstream error out, the other SSRCs
+   * keep flowing */
+  if (ret == GST_FLOW_OK || ret == GST_FLOW_NOT_LINKED)
+    return;
+
+  g_mutex_lock (&dpad->lock);
+  /* don't override a flush that happened while we were pushing */
+  if (dpad->srcresult == GST_FLOW_OK)
+    dpad->srcresult = ret;
+  gst_rtp_ssrc_demux_pad_flush (dpad);
+  g_cond_broadcast (&dpad->cond);
+
+pause:
+  GST_DEBUG_OBJECT (pad, "pausing task, reason %s",
+      gst_flow_get_name (dpad->srcresult));
+  g_mutex_unlock (&dpad->lock);
+  gst_pad_pause_task (pad);
+}
+
+static gboolean
+gst_rtp_ssrc_demux_pad_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (pad);
+  gboolean res = TRUE;
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  if (!dpad->threaded)
+    return TRUE;
+
+  g_mutex_lock (&dpad->lock);
+  dpad->active = active;
+  if (active) {
+    dpad->srcresult = GST_FLOW_OK;
+    res = gst_pad_start_task (pad,
+        (GstTaskFunction) gst_rtp_ssrc_demux_pad_loop, pad, NULL);
+  } else {
+    dpad->srcresult = GST_FLOW_FLUSHING;
+    gst_rtp_ssrc_demux_pad_flush (dpad);
+    g_cond_broadcast (&dpad->cond);
+  }
+  g_mutex_unlock (&dpad->lock);
+
+  if (!active)
+    res = gst_pad_stop_task (pad);
+
+  return res;
+}
+
+/* Pushes @buf on @pad, or queues it for the task of @pad in threaded mode */
+static GstFlowReturn
+gst_rtp_ssrc_demux_pad_push (GstPad * pad, GstBuffer * buf)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (pad);
+  GstFlowReturn ret;
+
+  if (!dpad->threaded)
+    return gst_pad_push (pad, buf);
+
+  g_mutex_lock (&dpad->lock);
+  while (dpad->srcresult == GST_FLOW_OK && dpad->max_size_buffers > 0 &&
+      dpad->n_buffers >= dpad->max_size_buffers) {
+    if (dpad->leaky == GST_RTP_SSRC_DEMUX_LEAKY_UPSTREAM) {
+      GST_DEBUG_OBJECT (pad, "queue full, dropping new buffer");
+      dpad->dropped++;
+      g_mutex_unlock (&dpad->lock);
+      gst_buffer_unref (buf);
+      return GST_FLOW_OK;
+    } else if (dpad->leaky == GST_RTP_SSRC_DEMUX_LEAKY_DOWNSTREAM) {
+      GList *walk;
+
+      for (walk = dpad->queue.head; !GST_IS_BUFFER (walk->data);
+          walk = walk->next);
+
+      GST_DEBUG_OBJECT (pad, "queue full, dropping oldest buffer");
+      gst_buffer_unref (walk->data);
+      g_queue_delete_link (&dpad->queue, walk);
+      dpad->n_buffers--;
+      dpad->dropped++;
+    } else {
+      GST_LOG_OBJECT (pad, "queue full, waiting for room");
+      g_cond_wait (&dpad->cond, &dpad->lock);
+    }
+  }
+
+  ret = dpad->srcresult;
+  if (ret == GST_FLOW_OK) {
+    g_queue_push_tail (&dpad->queue, buf);
+    dpad->n_buffers++;
+    g_cond_broadcast (&dpad->cond);
+  } else {
+    gst_buffer_unref (buf);
+  }
+  g_mutex_unlock (&dpad->lock);
+
+  return ret;
+}
+
+/* Pushes @event on @pad, or queues it for the task of @pad in threaded mode
+ * if it is serialized */
+static gboolean
+gst_rtp_ssrc_demux_pad_push_event (GstPad * pad, GstEvent * event)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (pad);
+  gboolean res = TRUE;
+
+  if (!dpad->threaded)
+    return gst_pad_push_event (pad, event);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_FLUSH_START:
+      /* unblocks downstream first so that the task can be paused */
+      res = gst_pad_push_event (pad, event);
+
+      g_mutex_lock (&dpad->lock);
+      dpad->srcresult = GST_FLOW_FLUSHING;
+      gst_rtp_ssrc_demux_pad_flush (dpad);
+      g_cond_broadcast (&dpad->cond);
+      g_mutex_unlock (&dpad->lock);
+
+      gst_pad_pause_task (pad);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      g_mutex_lock (&dpad->lock);
+      gst_rtp_ssrc_demux_pad_flush (dpad);
+      g_mutex_unlock (&dpad->lock);
+
+      res = gst_pad_push_event (pad, event);
+
+      g_mutex_lock (&dpad->lock);
+      if (dpad->active) {
+        dpad->srcresult = GST_FLOW_OK;
+        gst_pad_start_task (pad, (GstTaskFunction) gst_rtp_ssrc_demux_pad_loop,
+            pad, NULL);
+      }
+      g_mutex_unlock (&dpad->lock);
+      break;
+    default:
+      if (!GST_EVENT_IS_SERIALIZED (event)) {
+        res = gst_pad_push_event (pad, event);
+        break;
+      }
+
+      g_mutex_lock (&dpad->lock);
+      if (dpad->srcresult == GST_FLOW_OK) {
+        g_queue_push_tail (&dpad->queue, event);
+        g_cond_broadcast (&dpad->cond);
+      } else {
+        GST_DEBUG_OBJECT (pad, "dropping %" GST_PTR_FORMAT ", reason %s", event,
+            gst_flow_get_name (dpad->srcresult));
+        res = FALSE;
+        gst_event_unref (event);
+      }
+      g_mutex_unlock (&dpad->lock);
+      break;
+  }
+
+  return res;
+}
+
+static void
+gst_rtp_ssrc_demux_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (object);
+
+  switch (prop_id) {
+    case PROP_PAD_MAX_SIZE_BUFFERS:
+      g_mutex_lock (&dpad->lock);
+      dpad->max_size_buffers = g_value_get_uint (value);
+      /* the upstream thread might be waiting for room */
+      g_cond_broadcast (&dpad->cond);
+      g_mutex_unlock (&dpad->lock);
+      break;
+    case PROP_PAD_LEAKY:
+      g_mutex_lock (&dpad->lock);
+      dpad->leaky = g_value_get_enum (value);
+      g_cond_broadcast (&dpad->cond);
+      g_mutex_unlock (&dpad->lock);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_ssrc_demux_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (object);
+
+  switch (prop_id) {
+    case PROP_PAD_MAX_SIZE_BUFFERS:
+      g_mutex_lock (&dpad->lock);
+      g_value_set_uint (value, dpad->max_size_buffers);
+      g_mutex_unlock (&dpad->lock);
+      break;
+    case PROP_PAD_LEAKY:
+      g_mutex_lock (&dpad->lock);
+      g_value_set_enum (value, dpad->leaky);
+      g_mutex_unlock (&dpad->lock);
+      break;
+    case PROP_PAD_CURRENT_LEVEL_BUFFERS:
+      g_mutex_lock (&dpad->lock);
+      g_value_set_uint (value, dpad->n_buffers);
+      g_mutex_unlock (&dpad->lock);
+      break;
+    case PROP_PAD_DROPPED:
+      g_mutex_lock (&dpad->lock);
+      g_value_set_uint64 (value, dpad->dropped);
+      g_mutex_unlock (&dpad->lock);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_rtp_ssrc_demux_pad_finalize (GObject * object)
+{
+  GstRtpSsrcDemuxPad *dpad = GST_RTP_SSRC_DEMUX_PAD_CAST (object);
+
+  g_queue_clear_full (&dpad->queue, (GDestroyNotify) gst_mini_object_unref);
+  g_mutex_clear (&dpad->lock);
+  g_cond_clear (&dpad->cond);
+
+  G_OBJECT_CLASS (gst_rtp_ssrc_demux_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_rtp_ssrc_demux_pad_class_init (GstRtpSsrcDemuxPadClass * klass)
+{
+  GObjectClass *gobject_klass = (GObjectClass *) klass;
+
+  gobject_klass->set_property = gst_rtp_ssrc_demux_pad_set_property;
+  gobject_klass->get_property = gst_rtp_ssrc_demux_pad_get_property;
+  gobject_klass->finalize = gst_rtp_ssrc_demux_pad_finalize;
+
+  /**
+   * GstRtpSsrcDemuxPad:max-size-buffers:
+   *
+   * Maximum number of buffers in the queue of the pad, in threaded mode. 0
+   * means no limit.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_PAD_MAX_SIZE_BUFFERS,
+      g_param_spec_uint ("max-size-buffers", "Max. size (buffers)",
+          "Max. number of buffers in the queue (0=disable)",
+          0, G_MAXUINT, DEFAULT_MAX_SIZE_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpSsrcDemuxPad:leaky:
+   *
+   * What to do with a new buffer when the queue of the pad is full, in
+   * threaded mode.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_PAD_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where the queue leaks, if at all",
+          GST_TYPE_RTP_SSRC_DEMUX_LEAKY, DEFAULT_LEAKY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpSsrcDemuxPad:current-level-buffers:
+   *
+   * Current number of buffers in the queue of the pad.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass,
+      PROP_PAD_CURRENT_LEVEL_BUFFERS,
+      g_param_spec_uint ("current-level-buffers", "Current level (buffers)",
+          "Current number of buffers in the queue", 0, G_MAXUINT, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpSsrcDemuxPad:dropped:
+   *
+   * Number of buffers dropped because the queue of the pad was full.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_PAD_DROPPED,
+      g_param_spec_uint64 ("dropped", "Dropped",
+          "Number of buffers dropped because the queue was full",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_rtp_ssrc_demux_pad_init (GstRtpSsrcDemuxPad * dpad)
+{
+  g_mutex_init (&dpad->lock);
+  g_cond_init (&dpad->cond);
+  g_queue_init (&dpad->queue);
+  dpad->srcresult = GST_FLOW_FLUSHING;
+  dpad->max_size_buffers = DEFAULT_MAX_SIZE_BUFFERS;
+  dpad->leaky = DEFAULT_LEAKY;
+}
+
+/**************** GstRtpSsrcDemux ****************/
+
 /* GstElement vmethods */
 static GstStateChangeReturn gst_rtp_ssrc_demux_change_state (GstElement *
     element, GstStateChange transition);
@@ -272,7 +700,7 @@ forward_sticky_events (GstPad * pad, GstEvent ** event, gpointer user_data)
   GstEvent *newevent;
 
   newevent = add_ssrc_and_ref (*event, data->ssrc);
-  gst_pad_push_event (data->pad, newevent);
+  gst_rtp_ssrc_demux_pad_push_event (data->pad, newevent);
 
   return TRUE;
 }
@@ -309,6 +737,9 @@ find_or_create_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc,
   GstRtpSsrcDemuxPads *dpads;
   GstPad *retpad;
   guint num_streams;
+  gboolean threaded;
+  guint max_size_buffers;
+  GstRtpSsrcDemuxLeaky leaky;
 
   INTERNAL_STREAM_LOCK (demux);
 
@@ -327,15 +758,27 @@ find_or_create_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc,
 
   GST_DEBUG_OBJECT (demux, "creating new pad for SSRC %08x", ssrc);
 
+  GST_OBJECT_LOCK (demux);
+  threaded = demux->threaded;
+  max_size_buffers = demux->max_size_buffers;
+  leaky = demux->leaky;
+  GST_OBJECT_UNLOCK (demux);
+
   klass = GST_ELEMENT_GET_CLASS (demux);
   templ = gst_element_class_get_pad_template (klass, "src_%u");
   padname = g_strdup_printf ("src_%u", ssrc);
-  rtp_pad = gst_pad_new_from_template (templ, padname);
+  rtp_pad = g_object_new (GST_TYPE_RTP_SSRC_DEMUX_PAD, "name", padname,
+      "direction", templ->direction, "template", templ,
+      "max-size-buffers", max_size_buffers, "leaky", leaky, NULL);
+  GST_RTP_SSRC_DEMUX_PAD_CAST (rtp_pad)->threaded = threaded;
   g_free (padname);
 
   templ = gst_element_class_get_pad_template (klass, "rtcp_src_%u");
   padname = g_strdup_printf ("rtcp_src_%u", ssrc);
-  rtcp_pad = gst_pad_new_from_template (templ, padname);
+  rtcp_pad = g_object_new (GST_TYPE_RTP_SSRC_DEMUX_PAD, "name", padname,
+      "direction", templ->direction, "template", templ,
+      "max-size-buffers", max_size_buffers, "leaky", leaky, NULL);
+  GST_RTP_SSRC_DEMUX_PAD_CAST (rtcp_pad)->threaded = threaded;
   g_free (padname);
 
   /* wrap in structure and add to list */
@@ -352,12 +795,16 @@ find_or_create_demux_pad_for_ssrc (GstRtpSsrcDemux * demux, guint32 ssrc,
   gst_pad_set_iterate_internal_links_function (rtp_pad,
       gst_rtp_ssrc_demux_iterate_internal_links_src);
   gst_pad_set_event_function (rtp_pad, gst_rtp_ssrc_demux_src_event);
+  gst_pad_set_activatemode_function (rtp_pad,
+      gst_rtp_ssrc_demux_pad_activate_mode);
   gst_pad_use_fixed_caps (rtp_pad);
   gst_pad_set_active (rtp_pad, TRUE);
 
   gst_pad_set_event_function (rtcp_pad, gst_rtp_ssrc_demux_src_event);
   gst_pad_set_iterate_internal_links_function (rtcp_pad,
       gst_rtp_ssrc_demux_iterate_internal_links_src);
+  gst_pad_set_activatemode_function (rtcp_pad,
+      gst_rtp_ssrc_demux_pad_activate_mode);
   gst_pad_use_fixed_caps (rtcp_pad);
   gst_pad_set_active (rtcp_pad, TRUE);
 
@@ -395,6 +842,21 @@ gst_rtp_ssrc_demux_set_property (GObject * object, guint prop_id,
     case PROP_MAX_STREAMS:
       demux->max_streams = g_value_get_uint (value);
       break;
+    case PROP_THREADED:
+      GST_OBJECT_LOCK (demux);
+      demux->threaded = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    case PROP_MAX_SIZE_BUFFERS:
+      GST_OBJECT_LOCK (demux);
+      demux->max_size_buffers = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    case PROP_LEAKY:
+      GST_OBJECT_LOCK (demux);
+      demux->leaky = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -412,6 +874,21 @@ gst_rtp_ssrc_demux_get_property (GObject * object, guint prop_id,
     case PROP_MAX_STREAMS:
       g_value_set_uint (value, demux->max_streams);
       break;
+    case PROP_THREADED:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_boolean (value, demux->threaded);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    case PROP_MAX_SIZE_BUFFERS:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_uint (value, demux->max_size_buffers);
+      GST_OBJECT_UNLOCK (demux);
+      break;
+    case PROP_LEAKY:
+      GST_OBJECT_LOCK (demux);
+      g_value_set_enum (value, demux->leaky);
+      GST_OBJECT_UNLOCK (demux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -440,6 +917,48 @@ gst_rtp_ssrc_demux_class_init (GstRtpSsrcDemuxClass * klass)
           0, G_MAXUINT, DEFAULT_MAX_STREAMS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpSsrcDemux:threaded:
+   *
+   * Push every source pad from its own streaming thread, through a queue
+   * configured with #GstRtpSsrcDemux:max-size-buffers and
+   * #GstRtpSsrcDemux:leaky, so that a blocked downstream branch doesn't
+   * hold back the other SSRCs.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_THREADED,
+      g_param_spec_boolean ("threaded", "Threaded",
+          "Push each source pad from its own streaming thread",
+          DEFAULT_THREADED, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstRtpSsrcDemux:max-size-buffers:
+   *
+   * The #GstRtpSsrcDemuxPad:max-size-buffers of new source pads.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_MAX_SIZE_BUFFERS,
+      g_param_spec_uint ("max-size-buffers", "Max. size (buffers)",
+          "Max. number of buffers in the queue of new pads (0=disable)",
+          0, G_MAXUINT, DEFAULT_MAX_SIZE_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRtpSsrcDemux:leaky:
+   *
+   * The #GstRtpSsrcDemuxPad:leaky policy of new source pads.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where the queue of new pads leaks, if at all",
+          GST_TYPE_RTP_SSRC_DEMUX_LEAKY, DEFAULT_LEAKY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstRtpSsrcDemux::new-ssrc-pad:
    * @demux: the object which received the signal
@@ -490,10 +1009,10 @@ gst_rtp_ssrc_demux_class_init (GstRtpSsrcDemuxClass * klass)
       &rtp_ssrc_demux_sink_template);
   gst_element_class_add_static_pad_template (gstelement_klass,
       &rtp_ssrc_demux_rtcp_sink_template);
-  gst_element_class_add_static_pad_template (gstelement_klass,
-      &rtp_ssrc_demux_src_template);
-  gst_element_class_add_static_pad_template (gstelement_klass,
-      &rtp_ssrc_demux_rtcp_src_template);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_klass,
+      &rtp_ssrc_demux_src_template, GST_TYPE_RTP_SSRC_DEMUX_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (gstelement_klass,
+      &rtp_ssrc_demux_rtcp_src_template, GST_TYPE_RTP_SSRC_DEMUX_PAD);
 
   gst_element_class_set_static_metadata (gstelement_klass, "RTP SSRC Demux",
       "Demux/Network/RTP",
@@ -505,6 +1024,11 @@ gst_rtp_ssrc_demux_class_init (GstRtpSsrcDemuxClass * klass)
 
   GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_chain);
   GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_rtcp_chain);
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_pad_activate_mode);
+  GST_DEBUG_REGISTER_FUNCPTR (gst_rtp_ssrc_demux_pad_loop);
+
+  gst_type_mark_as_plugin_api (GST_TYPE_RTP_SSRC_DEMUX_PAD, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_RTP_SSRC_DEMUX_LEAKY, 0);
 }
 
 static void
@@ -531,6 +1055,9 @@ gst_rtp_ssrc_demux_init (GstRtpSsrcDemux * demux)
   gst_element_add_pad (GST_ELEMENT_CAST (demux), demux->rtcp_sink);
 
   demux->max_streams = DEFAULT_MAX_STREAMS;
+  demux->threaded = DEFAULT_THREADED;
+  demux->max_size_buffers = DEFAULT_MAX_SIZE_BUFFERS;
+  demux->leaky = DEFAULT_LEAKY;
 
   g_rec_mutex_init (&demux->padlock);
 }
@@ -645,7 +1172,7 @@ forward_event (GstPad * pad, gpointer user_data)
   GST_OBJECT_UNLOCK (fdata->demux);
 
   if (newevent)
-    fdata->res &= gst_pad_push_event (pad, newevent);
+    fdata->res &= gst_rtp_ssrc_demux_pad_push_event (pad, newevent);
 
   return FALSE;
 }
@@ -701,7 +1228,7 @@ gst_rtp_ssrc_demux_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   }
 
   /* push to srcpad */
-  ret = gst_pad_push (srcpad, buf);
+  ret = gst_rtp_ssrc_demux_pad_push (srcpad, buf);
 
   if (ret != GST_FLOW_OK) {
     GstPad *active_pad;
@@ -796,7 +1323,7 @@ gst_rtp_ssrc_demux_rtcp_chain (GstPad * pad, GstObject * parent,
   }
 
   /* push to srcpad */
-  ret = gst_pad_push (srcpad, buf);
+  ret = gst_rtp_ssrc_demux_pad_push (srcpad, buf);
 
   if (ret != GST_FLOW_OK) {
     GstPad *active_pad;
@@ -28,8 +28,32 @@
 #define GST_IS_RTP_SSRC_DEMUX(obj)         (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_RTP_SSRC_DEMUX))
 #define GST_IS_RTP_SSRC_DEMUX_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_RTP_SSRC_DEMUX))
 
+#define GST_TYPE_RTP_SSRC_DEMUX_PAD        (gst_rtp_ssrc_demux_pad_get_type())
+#define GST_RTP_SSRC_DEMUX_PAD_CAST(obj)   ((GstRtpSsrcDemuxPad *)(obj))
+
+#define GST_TYPE_RTP_SSRC_DEMUX_LEAKY      (gst_rtp_ssrc_demux_leaky_get_type())
+
 typedef struct _GstRtpSsrcDemux GstRtpSsrcDemux;
 typedef struct _GstRtpSsrcDemuxClass GstRtpSsrcDemuxClass;
+typedef struct _GstRtpSsrcDemuxPad GstRtpSsrcDemuxPad;
+typedef struct _GstRtpSsrcDemuxPadClass GstRtpSsrcDemuxPadClass;
+
+/**
+ * GstRtpSsrcDemuxLeaky:
+ * @GST_RTP_SSRC_DEMUX_LEAKY_NO: Not Leaky
+ * @GST_RTP_SSRC_DEMUX_LEAKY_UPSTREAM: Leaky on upstream (new buffers)
+ * @GST_RTP_SSRC_DEMUX_LEAKY_DOWNSTREAM: Leaky on downstream (old buffers)
+ *
+ * What a threaded source pad does with a new buffer when its queue is full.
+ *
+ * Since: 1.24
+ */
+typedef enum
+{
+  GST_RTP_SSRC_DEMUX_LEAKY_NO,
+  GST_RTP_SSRC_DEMUX_LEAKY_UPSTREAM,
+  GST_RTP_SSRC_DEMUX_LEAKY_DOWNSTREAM
+} GstRtpSsrcDemuxLeaky;
 
 struct _GstRtpSsrcDemux
 {
@@ -41,6 +65,11 @@ struct _GstRtpSsrcDemux
   GRecMutex padlock;
   GSList *srcpads;
   guint max_streams;
+
+  /* defaults for new source pads */
+  gboolean threaded;
+  guint max_size_buffers;
+  GstRtpSsrcDemuxLeaky leaky;
 };
 
 struct _GstRtpSsrcDemuxClass
@@ -56,6 +85,8 @@ struct _GstRtpSsrcDemuxClass
 };
 
 GType gst_rtp_ssrc_demux_get_type (void);
+GType gst_rtp_ssrc_demux_pad_get_type (void);
+GType gst_rtp_ssrc_demux_leaky_get_type (void);
 
 GST_ELEMENT_REGISTER_DECLARE (rtpssrcdemux);
 
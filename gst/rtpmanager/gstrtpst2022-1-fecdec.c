@@ -87,15 +87,24 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtpst2022-1-fecdec.h"
+#include "gstrtputils.h"
+#include "rtpxor.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_rtpst_2022_1_fecdec_debug);
 #define GST_CAT_DEFAULT gst_rtpst_2022_1_fecdec_debug
 
 #define DEFAULT_SIZE_TIME (GST_SECOND)
 
+/* Media packets are stored in a window indexed by seqnum. The window never
+ * spans more than MEDIA_WINDOW_SIZE seqnums, so two stored packets can never
+ * map to the same slot and lookups are a single array access */
+#define MEDIA_WINDOW_SIZE 32768
+#define MEDIA_WINDOW_MASK (MEDIA_WINDOW_SIZE - 1)
+
 typedef struct
 {
   guint16 seq;
+  guint16 payload_len;
   GstBuffer *buffer;
 } Item;
 
@@ -136,7 +145,12 @@ struct _GstRTPST_2022_1_FecDec
   GList *fec_sinkpads;
 
   /* All the following field are protected by the OBJECT_LOCK */
-  GSequence *packets;
+  Item **packets;
+  guint n_packets;
+  guint16 packets_first;
+  guint16 packets_last;
+  /* FEC items indexed by each media seqnum they protect */
+  GHashTable *row_fec_packets;
   GHashTable *column_fec_packets;
   GSequence *fec_packets[2];
   /* N columns */
@@ -196,33 +210,102 @@ GST_ELEMENT_REGISTER_DEFINE (rtpst2022_1_fecdec, "rtpst2022-1-fecdec",
     GST_RANK_NONE, GST_TYPE_RTPST_2022_1_FECDEC);
 
 static void
-trim_items (GstRTPST_2022_1_FecDec * dec)
+remove_media_item (GstRTPST_2022_1_FecDec * dec, guint16 seq)
 {
-  GSequenceIter *tmp_iter, *iter = NULL;
+  Item **slot = &dec->packets[seq & MEDIA_WINDOW_MASK];
 
-  for (tmp_iter = g_sequence_get_begin_iter (dec->packets);
-      tmp_iter; tmp_iter = g_sequence_iter_next (tmp_iter)) {
-    Item *item;
+  if (*slot) {
+    free_item (*slot);
+    *slot = NULL;
+    dec->n_packets--;
+  }
+}
 
-    if (g_sequence_iter_is_end (tmp_iter))
-      break;
+/* Takes ownership of @item, returns FALSE if it was too old to be stored */
+static gboolean
+insert_media_item (GstRTPST_2022_1_FecDec * dec, Item * item)
+{
+  Item **slot;
+
+  if (dec->n_packets == 0) {
+    dec->packets_first = dec->packets_last = item->seq;
+  } else if (gst_rtp_buffer_compare_seqnum (dec->packets_last, item->seq) > 0) {
+    /* Slide the window forward, dropping whatever falls out of it */
+    while (dec->n_packets &&
+        (guint16) (item->seq - dec->packets_first) >= MEDIA_WINDOW_SIZE) {
+      remove_media_item (dec, dec->packets_first);
+      dec->packets_first++;
+    }
 
-    item = g_sequence_get (tmp_iter);
+    if (dec->n_packets == 0)
+      dec->packets_first = item->seq;
+    dec->packets_last = item->seq;
+  } else if (gst_rtp_buffer_compare_seqnum (dec->packets_first,
+          item->seq) < 0) {
+    if ((guint16) (dec->packets_last - item->seq) >= MEDIA_WINDOW_SIZE) {
+      GST_DEBUG_OBJECT (dec, "Not storing media packet %u, too old", item->seq);
+      free_item (item);
+      return FALSE;
+    }
 
-    if (dec->max_arrival_time - GST_BUFFER_DTS_OR_PTS (item->buffer) <
-        dec->size_time)
-      break;
+    dec->packets_first = item->seq;
+  }
 
-    iter = tmp_iter;
+  slot = &dec->packets[item->seq & MEDIA_WINDOW_MASK];
+  if (*slot)
+    free_item (*slot);
+  else
+    dec->n_packets++;
+  *slot = item;
+
+  return TRUE;
+}
+
+static void
+trim_items (GstRTPST_2022_1_FecDec * dec)
+{
+  guint n_trimmed = 0;
+
+  while (dec->n_packets) {
+    Item *item = dec->packets[dec->packets_first & MEDIA_WINDOW_MASK];
+
+    if (item) {
+      if (dec->max_arrival_time - GST_BUFFER_DTS_OR_PTS (item->buffer) <
+          dec->size_time)
+        break;
+
+      GST_TRACE_OBJECT (dec,
+          "Trimming packet %u (%" GST_TIME_FORMAT ")", item->seq,
+          GST_TIME_ARGS (GST_BUFFER_DTS_OR_PTS (item->buffer)));
+      remove_media_item (dec, dec->packets_first);
+      n_trimmed++;
+    }
+
+    dec->packets_first++;
   }
 
-  if (iter) {
-    Item *item = g_sequence_get (iter);
-    GST_TRACE_OBJECT (dec,
-        "Trimming packets up to %" GST_TIME_FORMAT " (seq: %u)",
-        GST_TIME_ARGS (GST_BUFFER_DTS_OR_PTS (item->buffer)), item->seq);
-    g_sequence_remove_range (g_sequence_get_begin_iter (dec->packets),
-        g_sequence_iter_next (iter));
+  if (n_trimmed)
+    GST_LOG_OBJECT (dec, "Trimmed %u media packets", n_trimmed);
+}
+
+/* Adds or removes @item from the row or column index, under each of the
+ * media seqnums it protects */
+static void
+index_fec_item (GstRTPST_2022_1_FecDec * dec, Item * item, guint D,
+    gboolean add)
+{
+  GHashTable *index = D ? dec->row_fec_packets : dec->column_fec_packets;
+  guint n = D ? dec->l : dec->d;
+  guint step = D ? 1 : dec->l;
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    guint16 seq = item->seq + i * step;
+
+    if (add)
+      g_hash_table_insert (index, GUINT_TO_POINTER (seq), item);
+    else if (g_hash_table_lookup (index, GUINT_TO_POINTER (seq)) == item)
+      g_hash_table_remove (index, GUINT_TO_POINTER (seq));
   }
 }
 
@@ -244,15 +327,7 @@ trim_fec_items (GstRTPST_2022_1_FecDec * dec, guint D)
         dec->size_time)
       break;
 
-    if (!D) {
-      guint i;
-      guint16 seq;
-
-      for (i = 0; i < dec->d; i++) {
-        seq = item->seq + i * dec->l;
-        g_hash_table_remove (dec->column_fec_packets, GUINT_TO_POINTER (seq));
-      }
-    }
+    index_fec_item (dec, item, D, FALSE);
 
     iter = tmp_iter;
   }
@@ -271,16 +346,10 @@ trim_fec_items (GstRTPST_2022_1_FecDec * dec, guint D)
 static Item *
 lookup_media_packet (GstRTPST_2022_1_FecDec * dec, guint16 seqnum)
 {
-  GSequenceIter *iter;
-  Item *ret = NULL;
-  Item dummy = { seqnum, NULL };
+  Item *ret = dec->packets[seqnum & MEDIA_WINDOW_MASK];
 
-  iter =
-      g_sequence_lookup (dec->packets, &dummy, (GCompareDataFunc) cmp_items,
-      NULL);
-
-  if (iter)
-    ret = g_sequence_get (iter);
+  if (ret && ret->seq != seqnum)
+    ret = NULL;
 
   return ret;
 }
@@ -326,30 +395,12 @@ done:
 static Item *
 get_row_fec (GstRTPST_2022_1_FecDec * dec, guint16 seqnum)
 {
-  GSequenceIter *iter;
   Item *ret = NULL;
-  Item dummy = { 0, };
 
   if (dec->l == G_MAXUINT)
     goto done;
 
-  /* Potential underflow is intended */
-  dummy.seq = seqnum - dec->l;
-
-  iter =
-      g_sequence_search (dec->fec_packets[1], &dummy,
-      (GCompareDataFunc) cmp_items, NULL);
-
-  if (!g_sequence_iter_is_end (iter)) {
-    gint seqdiff;
-    ret = g_sequence_get (iter);
-
-    seqdiff = gst_rtp_buffer_compare_seqnum (ret->seq, seqnum);
-
-    /* Now check whether the fec packet does apply */
-    if (seqdiff < 0 || seqdiff >= dec->l)
-      ret = NULL;
-  }
+  ret = g_hash_table_lookup (dec->row_fec_packets, GUINT_TO_POINTER (seqnum));
 
 done:
   return ret;
@@ -370,29 +421,9 @@ done:
   return ret;
 }
 
-static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
-{
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
-  }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
-}
-
 static GstFlowReturn
-xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
-    guint16 seqnum)
+xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, Item ** packets,
+    guint n_packets, guint16 seqnum)
 {
   guint8 *xored;
   guint32 xored_timestamp;
@@ -400,7 +431,7 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
   guint16 xored_payload_len;
   Item *item;
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
-  GList *tmp;
+  guint i;
   GstFlowReturn ret = GST_FLOW_OK;
   GstBuffer *buffer;
   gboolean xored_marker;
@@ -409,14 +440,8 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
 
   /* Figure out the recovered packet length first */
   xored_payload_len = fec->len;
-  for (tmp = packets; tmp; tmp = tmp->next) {
-    GstRTPBuffer media_rtp = GST_RTP_BUFFER_INIT;
-    Item *item = (Item *) tmp->data;
-
-    gst_rtp_buffer_map (item->buffer, GST_MAP_READ, &media_rtp);
-    xored_payload_len ^= gst_rtp_buffer_get_payload_len (&media_rtp);
-    gst_rtp_buffer_unmap (&media_rtp);
-  }
+  for (i = 0; i < n_packets; i++)
+    xored_payload_len ^= packets[i]->payload_len;
 
   if (xored_payload_len > fec->payload_len) {
     GST_WARNING_OBJECT (dec, "FEC payload len %u < length recovery %u",
@@ -426,6 +451,7 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
 
   item = g_malloc0 (sizeof (Item));
   item->seq = seqnum;
+  item->payload_len = xored_payload_len;
   item->buffer = gst_rtp_buffer_new_allocate (xored_payload_len, 0, 0);
   gst_rtp_buffer_map (item->buffer, GST_MAP_WRITE, &rtp);
 
@@ -437,13 +463,12 @@ xor_items (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec, GList * packets,
   xored_padding = fec->padding;
   xored_extension = fec->extension;
 
-  for (tmp = packets; tmp; tmp = tmp->next) {
+  for (i = 0; i < n_packets; i++) {
     GstRTPBuffer media_rtp = GST_RTP_BUFFER_INIT;
-    Item *item = (Item *) tmp->data;
 
-    gst_rtp_buffer_map (item->buffer, GST_MAP_READ, &media_rtp);
-    _xor_mem (xored, gst_rtp_buffer_get_payload (&media_rtp),
-        MIN (gst_rtp_buffer_get_payload_len (&media_rtp), xored_payload_len));
+    gst_rtp_buffer_map (packets[i]->buffer, GST_MAP_READ, &media_rtp);
+    rtp_xor_mem (xored, gst_rtp_buffer_get_payload (&media_rtp),
+        MIN (packets[i]->payload_len, xored_payload_len));
     xored_timestamp ^= gst_rtp_buffer_get_timestamp (&media_rtp);
     xored_pt ^= gst_rtp_buffer_get_payload_type (&media_rtp);
     xored_marker ^= gst_rtp_buffer_get_marker (&media_rtp);
@@ -498,7 +523,8 @@ done:
 static GstFlowReturn
 check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
 {
-  GList *packets = NULL;
+  /* Both L and D are transmitted as 8 bit values */
+  Item *packets[G_MAXUINT8];
   gint missing_seq = -1;
   guint n_packets = 0;
   guint required_n_packets;
@@ -513,7 +539,7 @@ check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
       Item *item = lookup_media_packet (dec, fec->seq + i);
 
       if (item) {
-        packets = g_list_prepend (packets, item);
+        packets[n_packets] = item;
         n_packets += 1;
       } else {
         missing_seq = fec->seq + i;
@@ -528,7 +554,7 @@ check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
       Item *item = lookup_media_packet (dec, fec->seq + i * dec->l);
 
       if (item) {
-        packets = g_list_prepend (packets, item);
+        packets[n_packets] = item;
         n_packets += 1;
       } else {
         missing_seq = fec->seq + i * dec->l;
@@ -542,13 +568,12 @@ check_fec (GstRTPST_2022_1_FecDec * dec, Rtp2DFecHeader * fec)
         "All media packets present, we can discard that FEC packet");
   } else if (n_packets + 1 == required_n_packets) {
     g_assert (missing_seq != -1);
-    ret = xor_items (dec, fec, packets, missing_seq);
+    ret = xor_items (dec, fec, packets, n_packets, missing_seq);
     GST_LOG_OBJECT (dec, "We have enough info to reconstruct %u", missing_seq);
   } else {
     ret = GST_FLOW_CUSTOM_SUCCESS;
     GST_LOG_OBJECT (dec, "Too many media packets missing, storing FEC packet");
   }
-  g_list_free (packets);
 
   return ret;
 }
@@ -580,8 +605,8 @@ store_media_item (GstRTPST_2022_1_FecDec * dec, GstRTPBuffer * rtp, Item * item)
 
   seq = gst_rtp_buffer_get_seq (rtp);
 
-  g_sequence_insert_sorted (dec->packets, item, (GCompareDataFunc) cmp_items,
-      NULL);
+  if (!insert_media_item (dec, item))
+    goto done;
 
   if ((fec_item = get_row_fec (dec, seq))) {
     ret = check_fec_item (dec, fec_item);
@@ -595,6 +620,7 @@ store_media_item (GstRTPST_2022_1_FecDec * dec, GstRTPBuffer * rtp, Item * item)
       ret = GST_FLOW_OK;
   }
 
+done:
   return ret;
 }
 
@@ -609,6 +635,7 @@ store_media (GstRTPST_2022_1_FecDec * dec, GstRTPBuffer * rtp,
   item = g_malloc0 (sizeof (Item));
   item->buffer = gst_buffer_ref (buffer);
   item->seq = seq;
+  item->payload_len = gst_rtp_buffer_get_payload_len (rtp);
 
   return store_media_item (dec, rtp, item);
 }
@@ -685,16 +712,7 @@ gst_rtpst_2022_1_fecdec_sink_chain_fec (GstPad * pad, GstObject * parent,
     item->buffer = buffer;
     item->seq = fec.seq;
 
-    if (!fec.D) {
-      guint i;
-      guint16 seq;
-
-      for (i = 0; i < dec->d; i++) {
-        seq = fec.seq + i * dec->l;
-        g_hash_table_insert (dec->column_fec_packets, GUINT_TO_POINTER (seq),
-            item);
-      }
-    }
+    index_fec_item (dec, item, fec.D, TRUE);
     g_sequence_insert_sorted (dec->fec_packets[fec.D], item,
         (GCompareDataFunc) cmp_items, NULL);
     ret = GST_FLOW_OK;
@@ -773,8 +791,16 @@ gst_rtpst_2022_1_fecdec_reset (GstRTPST_2022_1_FecDec * dec, gboolean allocate)
   GST_OBJECT_LOCK (dec);
 
   if (dec->packets) {
-    g_sequence_free (dec->packets);
+    for (i = 0; dec->n_packets && i < MEDIA_WINDOW_SIZE; i++)
+      remove_media_item (dec, i);
+    g_free (dec->packets);
     dec->packets = NULL;
+    dec->n_packets = 0;
+  }
+
+  if (dec->row_fec_packets) {
+    g_hash_table_unref (dec->row_fec_packets);
+    dec->row_fec_packets = NULL;
   }
 
   if (dec->column_fec_packets) {
@@ -783,7 +809,8 @@ gst_rtpst_2022_1_fecdec_reset (GstRTPST_2022_1_FecDec * dec, gboolean allocate)
   }
 
   if (allocate) {
-    dec->packets = g_sequence_new ((GDestroyNotify) free_item);
+    dec->packets = g_new0 (Item *, MEDIA_WINDOW_SIZE);
+    dec->row_fec_packets = g_hash_table_new (g_direct_hash, g_direct_equal);
     dec->column_fec_packets = g_hash_table_new (g_direct_hash, g_direct_equal);
   }
 
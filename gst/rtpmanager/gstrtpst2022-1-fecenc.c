@@ -69,6 +69,8 @@
 #include <gst/rtp/gstrtpbuffer.h>
 
 #include "gstrtpst2022-1-fecenc.h"
+#include "gstrtputils.h"
+#include "rtpxor.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_rtpst_2022_1_fecenc_debug);
 #define GST_CAT_DEFAULT gst_rtpst_2022_1_fecenc_debug
@@ -220,26 +222,6 @@ free_fec_packet (FecPacket * packet)
   g_free (packet);
 }
 
-static void
-_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
-{
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
-  }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
-    dst[i] ^= src[i];
-}
-
 static void
 fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
 {
@@ -272,7 +254,7 @@ fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
     fec->xored_marker ^= gst_rtp_buffer_get_marker (rtp);
     fec->xored_padding ^= gst_rtp_buffer_get_padding (rtp);
     fec->xored_extension ^= gst_rtp_buffer_get_extension (rtp);
-    _xor_mem (fec->xored_payload, gst_rtp_buffer_get_payload (rtp), plen);
+    rtp_xor_mem (fec->xored_payload, gst_rtp_buffer_get_payload (rtp), plen);
   }
 
   fec->n_packets += 1;
@@ -0,0 +1,411 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "rtpbwe.h"
+#include "rtptwcc.h"
+
+GST_DEBUG_CATEGORY_EXTERN (rtp_session_debug);
+#define GST_CAT_DEFAULT rtp_session_debug
+
+/* packets sent within this time of each other form one group */
+#define BURST_TIME (5 * GST_MSECOND)
+
+/* trendline filter */
+#define SMOOTHING_COEF 0.9
+#define THRESHOLD_GAIN 4.0
+#define MIN_NUM_DELTAS 60
+
+/* overuse detector, thresholds in ms */
+#define INITIAL_THRESHOLD 12.5
+#define MIN_THRESHOLD 6.0
+#define MAX_THRESHOLD 600.0
+#define MAX_ADAPT_OFFSET 15.0
+#define K_UP 0.0087
+#define K_DOWN 0.039
+#define OVERUSE_TIME (10 * GST_MSECOND)
+
+/* rate controllers */
+#define BETA 0.85
+#define INCREASE_FACTOR 1.08
+#define MAX_ACKED_FACTOR 1.5
+#define LOSS_LOW 0.02
+#define LOSS_HIGH 0.1
+#define LOSS_INCREASE_FACTOR 1.05
+#define LOSS_MIN_PACKETS 20
+
+#define NS_TO_MS(t) ((gdouble) (t) / GST_MSECOND)
+
+static void
+rtp_bwe_reset_groups (RTPBWE * bwe)
+{
+  bwe->group_first_local_ts = GST_CLOCK_TIME_NONE;
+  bwe->group_local_ts = GST_CLOCK_TIME_NONE;
+  bwe->group_remote_ts = GST_CLOCK_TIME_NONE;
+  bwe->prev_group_local_ts = GST_CLOCK_TIME_NONE;
+  bwe->prev_group_remote_ts = GST_CLOCK_TIME_NONE;
+}
+
+/* forgets everything estimated so far and starts over from @start_bitrate,
+ * only the configured bitrate limits are kept */
+static void
+rtp_bwe_reset (RTPBWE * bwe, guint start_bitrate)
+{
+  guint min_bitrate = bwe->min_bitrate;
+  guint max_bitrate = bwe->max_bitrate;
+
+  memset (bwe, 0, sizeof (RTPBWE));
+  bwe->min_bitrate = min_bitrate;
+  bwe->max_bitrate = max_bitrate;
+
+  rtp_bwe_reset_groups (bwe);
+  bwe->first_remote_ts = GST_CLOCK_TIME_NONE;
+
+  bwe->threshold = INITIAL_THRESHOLD;
+  bwe->last_threshold_update = GST_CLOCK_TIME_NONE;
+  bwe->time_over_using = -1;
+  bwe->usage = RTP_BWE_USAGE_NORMAL;
+  bwe->state = RTP_BWE_STATE_HOLD;
+
+  bwe->start_bitrate = start_bitrate;
+  bwe->delay_bitrate = start_bitrate;
+  bwe->loss_bitrate = start_bitrate;
+  bwe->last_update = GST_CLOCK_TIME_NONE;
+  bwe->last_loss_update = GST_CLOCK_TIME_NONE;
+  bwe->target_bitrate = start_bitrate;
+}
+
+RTPBWE *
+rtp_bwe_new (guint start_bitrate)
+{
+  RTPBWE *bwe = g_new0 (RTPBWE, 1);
+
+  bwe->max_bitrate = G_MAXUINT;
+  rtp_bwe_reset (bwe, start_bitrate);
+
+  return bwe;
+}
+
+void
+rtp_bwe_free (RTPBWE * bwe)
+{
+  g_free (bwe);
+}
+
+static void
+rtp_bwe_clamp (RTPBWE * bwe)
+{
+  bwe->delay_bitrate =
+      CLAMP (bwe->delay_bitrate, bwe->min_bitrate, bwe->max_bitrate);
+  bwe->loss_bitrate =
+      CLAMP (bwe->loss_bitrate, bwe->min_bitrate, bwe->max_bitrate);
+  bwe->target_bitrate = MIN (bwe->delay_bitrate, bwe->loss_bitrate);
+}
+
+void
+rtp_bwe_set_bitrates (RTPBWE * bwe, guint min_bitrate, guint max_bitrate)
+{
+  bwe->min_bitrate = min_bitrate;
+  bwe->max_bitrate = MAX (min_bitrate, max_bitrate);
+  rtp_bwe_clamp (bwe);
+}
+
+/* restarts the estimation from @start_bitrate */
+void
+rtp_bwe_set_start_bitrate (RTPBWE * bwe, guint start_bitrate)
+{
+  rtp_bwe_reset (bwe, start_bitrate);
+  rtp_bwe_clamp (bwe);
+}
+
+static void
+rtp_bwe_update_threshold (RTPBWE * bwe, gdouble trend, GstClockTime now)
+{
+  gdouble abs_trend = fabs (trend);
+  gdouble k, dt;
+
+  if (!GST_CLOCK_TIME_IS_VALID (bwe->last_threshold_update))
+    bwe->last_threshold_update = now;
+
+  /* don't let sudden spikes, like a route change, raise the threshold */
+  if (abs_trend > bwe->threshold + MAX_ADAPT_OFFSET) {
+    bwe->last_threshold_update = now;
+    return;
+  }
+
+  k = abs_trend < bwe->threshold ? K_DOWN : K_UP;
+  dt = MIN (NS_TO_MS (GST_CLOCK_DIFF (bwe->last_threshold_update, now)), 100);
+  bwe->threshold += k * (abs_trend - bwe->threshold) * dt;
+  bwe->threshold = CLAMP (bwe->threshold, MIN_THRESHOLD, MAX_THRESHOLD);
+  bwe->last_threshold_update = now;
+}
+
+static void
+rtp_bwe_detect (RTPBWE * bwe, gdouble trend, GstClockTimeDiff send_delta,
+    GstClockTime now)
+{
+  if (bwe->num_deltas < 2)
+    return;
+
+  if (trend > bwe->threshold) {
+    if (bwe->time_over_using == -1)
+      bwe->time_over_using = send_delta / 2;
+    else
+      bwe->time_over_using += send_delta;
+    bwe->overuse_count++;
+
+    if (bwe->time_over_using > OVERUSE_TIME && bwe->overuse_count > 1 &&
+        trend >= bwe->prev_trend) {
+      bwe->time_over_using = 0;
+      bwe->overuse_count = 0;
+      bwe->usage = RTP_BWE_USAGE_OVERUSE;
+    }
+  } else if (trend < -bwe->threshold) {
+    bwe->time_over_using = -1;
+    bwe->overuse_count = 0;
+    bwe->usage = RTP_BWE_USAGE_UNDERUSE;
+  } else {
+    bwe->time_over_using = -1;
+    bwe->overuse_count = 0;
+    bwe->usage = RTP_BWE_USAGE_NORMAL;
+  }
+
+  bwe->prev_trend = trend;
+  rtp_bwe_update_threshold (bwe, trend, now);
+}
+
+/* slope of the linear regression of the smoothed delays over the window */
+static gdouble
+rtp_bwe_get_trend (RTPBWE * bwe)
+{
+  gdouble sum_x = 0, sum_y = 0, avg_x, avg_y;
+  gdouble num = 0, den = 0;
+  guint i;
+
+  for (i = 0; i < bwe->window_len; i++) {
+    sum_x += bwe->window_x[i];
+    sum_y += bwe->window_y[i];
+  }
+  avg_x = sum_x / bwe->window_len;
+  avg_y = sum_y / bwe->window_len;
+
+  for (i = 0; i < bwe->window_len; i++) {
+    gdouble dx = bwe->window_x[i] - avg_x;
+
+    num += dx * (bwe->window_y[i] - avg_y);
+    den += dx * dx;
+  }
+
+  return den != 0 ? num / den : bwe->prev_trend;
+}
+
+static void
+rtp_bwe_add_delay_variation (RTPBWE * bwe, GstClockTimeDiff send_delta,
+    GstClockTimeDiff recv_delta, GstClockTime remote_ts, GstClockTime now)
+{
+  gdouble trend = bwe->prev_trend;
+
+  bwe->num_deltas = MIN (bwe->num_deltas + 1, 1000);
+  bwe->accumulated_delay += NS_TO_MS (recv_delta - send_delta);
+  bwe->smoothed_delay = SMOOTHING_COEF * bwe->smoothed_delay +
+      (1 - SMOOTHING_COEF) * bwe->accumulated_delay;
+
+  if (!GST_CLOCK_TIME_IS_VALID (bwe->first_remote_ts))
+    bwe->first_remote_ts = remote_ts;
+
+  bwe->window_x[bwe->window_pos] =
+      NS_TO_MS (GST_CLOCK_DIFF (bwe->first_remote_ts, remote_ts));
+  bwe->window_y[bwe->window_pos] = bwe->smoothed_delay;
+  bwe->window_pos = (bwe->window_pos + 1) % RTP_BWE_TRENDLINE_WINDOW;
+  if (bwe->window_len < RTP_BWE_TRENDLINE_WINDOW)
+    bwe->window_len++;
+
+  if (bwe->window_len == RTP_BWE_TRENDLINE_WINDOW)
+    trend = rtp_bwe_get_trend (bwe);
+
+  rtp_bwe_detect (bwe, MIN (bwe->num_deltas, MIN_NUM_DELTAS) * trend *
+      THRESHOLD_GAIN, send_delta, now);
+}
+
+static void
+rtp_bwe_add_packet (RTPBWE * bwe, GstClockTime local_ts,
+    GstClockTime remote_ts)
+{
+  if (GST_CLOCK_TIME_IS_VALID (bwe->group_first_local_ts) &&
+      GST_CLOCK_DIFF (bwe->group_first_local_ts, local_ts) <= BURST_TIME) {
+    bwe->group_local_ts = MAX (bwe->group_local_ts, local_ts);
+    bwe->group_remote_ts = MAX (bwe->group_remote_ts, remote_ts);
+    return;
+  }
+
+  /* the current group is complete, compare it with the previous one */
+  if (GST_CLOCK_TIME_IS_VALID (bwe->prev_group_local_ts)) {
+    GstClockTimeDiff send_delta =
+        GST_CLOCK_DIFF (bwe->prev_group_local_ts, bwe->group_local_ts);
+    GstClockTimeDiff recv_delta =
+        GST_CLOCK_DIFF (bwe->prev_group_remote_ts, bwe->group_remote_ts);
+
+    rtp_bwe_add_delay_variation (bwe, send_delta, recv_delta,
+        bwe->group_remote_ts, local_ts);
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (bwe->group_first_local_ts)) {
+    bwe->prev_group_local_ts = bwe->group_local_ts;
+    bwe->prev_group_remote_ts = bwe->group_remote_ts;
+  }
+
+  bwe->group_first_local_ts = local_ts;
+  bwe->group_local_ts = local_ts;
+  bwe->group_remote_ts = remote_ts;
+}
+
+static void
+rtp_bwe_update_delay_bitrate (RTPBWE * bwe, GstClockTime now,
+    guint acked_bitrate)
+{
+  GstClockTimeDiff dt = 0;
+
+  if (GST_CLOCK_TIME_IS_VALID (bwe->last_update))
+    dt = GST_CLOCK_DIFF (bwe->last_update, now);
+  bwe->last_update = now;
+
+  switch (bwe->usage) {
+    case RTP_BWE_USAGE_OVERUSE:
+      bwe->state = RTP_BWE_STATE_DECREASE;
+      break;
+    case RTP_BWE_USAGE_UNDERUSE:
+      bwe->state = RTP_BWE_STATE_HOLD;
+      break;
+    case RTP_BWE_USAGE_NORMAL:
+      if (bwe->state == RTP_BWE_STATE_DECREASE)
+        bwe->state = RTP_BWE_STATE_HOLD;
+      else
+        bwe->state = RTP_BWE_STATE_INCREASE;
+      break;
+  }
+
+  switch (bwe->state) {
+    case RTP_BWE_STATE_DECREASE:{
+      gdouble bitrate =
+          BETA * (acked_bitrate > 0 ? acked_bitrate : bwe->delay_bitrate);
+
+      bwe->delay_bitrate = MIN (bwe->delay_bitrate, bitrate);
+      break;
+    }
+    case RTP_BWE_STATE_INCREASE:
+      if (dt > 0) {
+        bwe->delay_bitrate *=
+            pow (INCREASE_FACTOR, MIN ((gdouble) dt / GST_SECOND, 1.0));
+      }
+      /* don't run away from what actually gets through */
+      if (acked_bitrate > 0) {
+        bwe->delay_bitrate = MIN (bwe->delay_bitrate,
+            MAX_ACKED_FACTOR * acked_bitrate + 10000);
+      }
+      break;
+    case RTP_BWE_STATE_HOLD:
+      break;
+  }
+}
+
+static void
+rtp_bwe_update_loss_bitrate (RTPBWE * bwe, GstClockTime now,
+    guint packets_lost, guint packets_sent)
+{
+  GstClockTimeDiff dt = 0;
+  gdouble loss;
+
+  /* a single feedback may only report a handful of packets, measure the
+   * loss over enough of them */
+  bwe->loss_packets_lost += packets_lost;
+  bwe->loss_packets_sent += packets_sent;
+  if (bwe->loss_packets_sent < LOSS_MIN_PACKETS)
+    return;
+
+  loss = (gdouble) bwe->loss_packets_lost / bwe->loss_packets_sent;
+  bwe->loss_packets_lost = 0;
+  bwe->loss_packets_sent = 0;
+
+  if (GST_CLOCK_TIME_IS_VALID (now)) {
+    if (GST_CLOCK_TIME_IS_VALID (bwe->last_loss_update))
+      dt = GST_CLOCK_DIFF (bwe->last_loss_update, now);
+    bwe->last_loss_update = now;
+  }
+
+  if (loss > LOSS_HIGH) {
+    bwe->loss_bitrate *= 1 - 0.5 * loss;
+  } else if (loss < LOSS_LOW && dt > 0) {
+    /* the increase is per second, however often feedback arrives */
+    bwe->loss_bitrate *=
+        pow (LOSS_INCREASE_FACTOR, MIN ((gdouble) dt / GST_SECOND, 1.0));
+  }
+}
+
+/**
+ * rtp_bwe_process_packets:
+ * @bwe: a #RTPBWE
+ * @twcc_packets: (element-type RTPTWCCPacket): packets of a TWCC feedback
+ * @acked_bitrate: the bitrate the remote end received lately, or 0 if unknown
+ *
+ * Updates the estimation with the packets reported by a TWCC feedback.
+ *
+ * Returns: the target bitrate in bits per second
+ */
+guint
+rtp_bwe_process_packets (RTPBWE * bwe, GArray * twcc_packets,
+    guint acked_bitrate)
+{
+  GstClockTime now = GST_CLOCK_TIME_NONE;
+  guint packets_lost = 0;
+  guint packets_sent = 0;
+  guint i;
+
+  for (i = 0; i < twcc_packets->len; i++) {
+    RTPTWCCPacket *pkt = &g_array_index (twcc_packets, RTPTWCCPacket, i);
+
+    /* packets we don't know about, from before we started sending */
+    if (!GST_CLOCK_TIME_IS_VALID (pkt->local_ts))
+      continue;
+
+    packets_sent++;
+    if (pkt->status == RTP_TWCC_PACKET_STATUS_NOT_RECV) {
+      packets_lost++;
+      continue;
+    }
+
+    if (!GST_CLOCK_TIME_IS_VALID (now) || pkt->local_ts > now)
+      now = pkt->local_ts;
+
+    if (GST_CLOCK_TIME_IS_VALID (pkt->remote_ts))
+      rtp_bwe_add_packet (bwe, pkt->local_ts, pkt->remote_ts);
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (now))
+    rtp_bwe_update_delay_bitrate (bwe, now, acked_bitrate);
+  rtp_bwe_update_loss_bitrate (bwe, now, packets_lost, packets_sent);
+  rtp_bwe_clamp (bwe);
+
+  GST_DEBUG ("usage: %d, trend threshold: %f, delay-based: %.0f, "
+      "loss-based: %.0f, acked: %u, lost %u/%u, target: %u", bwe->usage,
+      bwe->threshold, bwe->delay_bitrate, bwe->loss_bitrate, acked_bitrate,
+      packets_lost, packets_sent, bwe->target_bitrate);
+
+  return bwe->target_bitrate;
+}
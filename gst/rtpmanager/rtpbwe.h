@@ -0,0 +1,99 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RTP_BWE_H__
+#define __RTP_BWE_H__
+
+#include <gst/gst.h>
+
+#define RTP_BWE_TRENDLINE_WINDOW 20
+
+typedef enum
+{
+  RTP_BWE_USAGE_NORMAL,
+  RTP_BWE_USAGE_OVERUSE,
+  RTP_BWE_USAGE_UNDERUSE,
+} RTPBWEUsage;
+
+typedef enum
+{
+  RTP_BWE_STATE_HOLD,
+  RTP_BWE_STATE_INCREASE,
+  RTP_BWE_STATE_DECREASE,
+} RTPBWEState;
+
+/**
+ * RTPBWE:
+ *
+ * Sender side bandwidth estimator driven by TWCC feedback, following the
+ * Google Congestion Control algorithm: a delay-based controller reacting to
+ * the trend of the one way delay variation, capped by a loss-based one.
+ */
+typedef struct {
+  guint start_bitrate;
+  guint min_bitrate;
+  guint max_bitrate;
+
+  /* packet groups */
+  GstClockTime group_first_local_ts;
+  GstClockTime group_local_ts;
+  GstClockTime group_remote_ts;
+  GstClockTime prev_group_local_ts;
+  GstClockTime prev_group_remote_ts;
+
+  /* trendline filter, delays in ms */
+  gdouble accumulated_delay;
+  gdouble smoothed_delay;
+  GstClockTime first_remote_ts;
+  gdouble window_x[RTP_BWE_TRENDLINE_WINDOW];
+  gdouble window_y[RTP_BWE_TRENDLINE_WINDOW];
+  guint window_pos;
+  guint window_len;
+  guint num_deltas;
+
+  /* overuse detector */
+  gdouble threshold;
+  gdouble prev_trend;
+  GstClockTime last_threshold_update;
+  GstClockTimeDiff time_over_using;
+  guint overuse_count;
+  RTPBWEUsage usage;
+
+  /* rate controllers */
+  RTPBWEState state;
+  gdouble delay_bitrate;
+  gdouble loss_bitrate;
+  GstClockTime last_update;
+  guint loss_packets_lost;
+  guint loss_packets_sent;
+  GstClockTime last_loss_update;
+
+  guint target_bitrate;
+} RTPBWE;
+
+RTPBWE * rtp_bwe_new          (guint start_bitrate);
+void     rtp_bwe_free         (RTPBWE * bwe);
+
+void     rtp_bwe_set_bitrates (RTPBWE * bwe, guint min_bitrate,
+                               guint max_bitrate);
+void     rtp_bwe_set_start_bitrate (RTPBWE * bwe, guint start_bitrate);
+
+guint    rtp_bwe_process_packets (RTPBWE * bwe, GArray * twcc_packets,
+                                  guint acked_bitrate);
+
+#endif /* __RTP_BWE_H__ */
@@ -44,6 +44,15 @@ enum
 /* GObject vmethods */
 static void rtp_jitter_buffer_finalize (GObject * object);
 
+/* Packets are indexed by seqnum in a ring that grows up to the maximum size
+ * as long as the packets in the queue span less seqnums than it has slots.
+ * Beyond that the index is dropped and the queue is walked instead, until
+ * the span got small enough again. */
+#define RTP_JITTER_BUFFER_RING_MIN_SIZE 256
+#define RTP_JITTER_BUFFER_RING_MAX_SIZE 4096
+
+static guint16 rtp_jitter_buffer_get_seqnum_diff (RTPJitterBuffer * jbuf);
+
 GType
 rtp_jitter_buffer_mode_get_type (void)
 {
@@ -88,6 +97,8 @@ rtp_jitter_buffer_init (RTPJitterBuffer * jbuf)
   g_mutex_init (&jbuf->clock_lock);
 
   g_queue_init (&jbuf->packets);
+  jbuf->ring_size = RTP_JITTER_BUFFER_RING_MIN_SIZE;
+  jbuf->ring = g_new0 (RTPJitterBufferItem *, jbuf->ring_size);
   jbuf->mode = RTP_JITTER_BUFFER_MODE_SLAVE;
 
   rtp_jitter_buffer_reset_skew (jbuf);
@@ -116,6 +127,7 @@ rtp_jitter_buffer_finalize (GObject * object)
    * g_slice_free() which may lead to data corruption in the slice allocator.
    */
   rtp_jitter_buffer_flush (jbuf, NULL, NULL);
+  g_free (jbuf->ring);
 
   g_mutex_clear (&jbuf->clock_lock);
 
@@ -700,6 +712,217 @@ queue_do_insert (RTPJitterBuffer * jbuf, GList * list, GList * item)
   queue->length++;
 }
 
+static inline RTPJitterBufferItem *
+ring_lookup (RTPJitterBuffer * jbuf, guint16 seqnum)
+{
+  RTPJitterBufferItem *item = jbuf->ring[seqnum & (jbuf->ring_size - 1)];
+
+  if (item && item->seqnum == seqnum)
+    return item;
+
+  return NULL;
+}
+
+/* Indexes all packets of the queue in a ring of @size slots */
+static void
+ring_rebuild (RTPJitterBuffer * jbuf, guint size)
+{
+  GList *list;
+
+  if (jbuf->ring_size != size) {
+    g_free (jbuf->ring);
+    jbuf->ring = g_new0 (RTPJitterBufferItem *, size);
+    jbuf->ring_size = size;
+  } else {
+    memset (jbuf->ring, 0, size * sizeof (RTPJitterBufferItem *));
+  }
+  jbuf->ring_count = 0;
+
+  for (list = jbuf->packets.head; list; list = list->next) {
+    RTPJitterBufferItem *item = (RTPJitterBufferItem *) list;
+
+    if (item->seqnum == -1)
+      continue;
+
+    jbuf->ring[item->seqnum & (size - 1)] = item;
+    if (jbuf->ring_count == 0)
+      jbuf->ring_low = item->seqnum;
+    jbuf->ring_high = item->seqnum;
+    jbuf->ring_count++;
+  }
+}
+
+/* Makes the ring big enough to index packets spanning @span seqnums or
+ * drops the index if that is not possible */
+static void
+ring_resize (RTPJitterBuffer * jbuf, guint span)
+{
+  guint size = jbuf->ring_size ? jbuf->ring_size :
+      RTP_JITTER_BUFFER_RING_MIN_SIZE;
+
+  while (size <= span && size < RTP_JITTER_BUFFER_RING_MAX_SIZE)
+    size <<= 1;
+
+  if (size <= span) {
+    GST_DEBUG ("packets span %u seqnums, dropping index", span);
+    g_free (jbuf->ring);
+    jbuf->ring = NULL;
+    jbuf->ring_size = 0;
+    jbuf->ring_count = 0;
+    return;
+  }
+
+  GST_DEBUG ("packets span %u seqnums, indexing in %u slots", span, size);
+  ring_rebuild (jbuf, size);
+}
+
+static void
+ring_add (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  guint16 seqnum = item->seqnum;
+
+  if (jbuf->ring_count == 0) {
+    jbuf->ring_low = jbuf->ring_high = seqnum;
+  } else if (gst_rtp_buffer_compare_seqnum (jbuf->ring_high, seqnum) > 0) {
+    jbuf->ring_high = seqnum;
+  } else if (gst_rtp_buffer_compare_seqnum (jbuf->ring_low, seqnum) < 0) {
+    jbuf->ring_low = seqnum;
+  }
+
+  if ((guint16) (jbuf->ring_high - jbuf->ring_low) >= jbuf->ring_size) {
+    /* the item is already queued, so it gets indexed by the resize */
+    ring_resize (jbuf, (guint16) (jbuf->ring_high - jbuf->ring_low));
+    return;
+  }
+
+  jbuf->ring[seqnum & (jbuf->ring_size - 1)] = item;
+  jbuf->ring_count++;
+}
+
+static void
+ring_remove_head (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  guint slot = item->seqnum & (jbuf->ring_size - 1);
+  GList *list;
+
+  if (G_UNLIKELY (jbuf->ring[slot] != item))
+    return;
+
+  jbuf->ring[slot] = NULL;
+  jbuf->ring_count--;
+
+  if (jbuf->ring_count == 0)
+    return;
+
+  /* the head packet has the lowest seqnum, find the next one */
+  for (list = jbuf->packets.head; list; list = list->next) {
+    if (((RTPJitterBufferItem *) list)->seqnum != -1) {
+      jbuf->ring_low = ((RTPJitterBufferItem *) list)->seqnum;
+      break;
+    }
+  }
+}
+
+/* Same as queue_find_position() but using the seqnum index. The packet goes
+ * right before the next packet with a higher seqnum, after any events that
+ * precede that packet, or at the tail if there is no such packet. */
+static gboolean
+ring_find_position (RTPJitterBuffer * jbuf, guint16 seqnum, GList ** plist)
+{
+  RTPJitterBufferItem *item;
+  GList *next;
+  guint16 d, dist;
+
+  /* no packets or newer than all, append */
+  if (jbuf->ring_count == 0
+      || gst_rtp_buffer_compare_seqnum (jbuf->ring_high, seqnum) > 0) {
+    *plist = jbuf->packets.tail;
+    return TRUE;
+  }
+
+  if (G_UNLIKELY (ring_lookup (jbuf, seqnum)))
+    return FALSE;
+
+  /* older than all, insert before the oldest packet */
+  if (gst_rtp_buffer_compare_seqnum (jbuf->ring_low, seqnum) < 0) {
+    item = ring_lookup (jbuf, jbuf->ring_low);
+    *plist = ((GList *) item)->prev;
+    return TRUE;
+  }
+
+  /* in between, look for the closest packet on either side. This ends at the
+   * latest with the packet with the highest seqnum */
+  dist = jbuf->ring_high - seqnum;
+  for (d = 1; d <= dist; d++) {
+    if ((item = ring_lookup (jbuf, seqnum + d))) {
+      *plist = ((GList *) item)->prev;
+      return TRUE;
+    }
+
+    if ((item = ring_lookup (jbuf, seqnum - d))) {
+      next = ((GList *) item)->next;
+      while (next && ((RTPJitterBufferItem *) next)->seqnum == -1)
+        next = next->next;
+      *plist = next ? next->prev : jbuf->packets.tail;
+      return TRUE;
+    }
+  }
+
+  g_assert_not_reached ();
+  return FALSE;
+}
+
+/* Finds the item after which a packet with @seqnum has to be inserted by
+ * walking the queue from the tail. Returns %FALSE if there already is a
+ * packet with @seqnum */
+static gboolean
+queue_find_position (RTPJitterBuffer * jbuf, guint16 seqnum, GList ** plist)
+{
+  GList *list, *event = NULL;
+
+  /* loop the list to skip strictly larger seqnum buffers */
+  for (list = jbuf->packets.tail; list; list = g_list_previous (list)) {
+    guint16 qseq;
+    gint gap;
+    RTPJitterBufferItem *qitem = (RTPJitterBufferItem *) list;
+
+    if (qitem->seqnum == -1) {
+      /* keep a pointer to the first consecutive event if not already
+       * set. we will insert the packet after the event if we can't find
+       * a packet with lower sequence number before the event. */
+      if (event == NULL)
+        event = list;
+      continue;
+    }
+
+    qseq = qitem->seqnum;
+
+    /* compare the new seqnum to the one in the buffer */
+    gap = gst_rtp_buffer_compare_seqnum (seqnum, qseq);
+
+    /* we hit a packet with the same seqnum, notify a duplicate */
+    if (G_UNLIKELY (gap == 0))
+      return FALSE;
+
+    /* seqnum > qseq, we can stop looking */
+    if (G_LIKELY (gap < 0))
+      break;
+
+    /* if we've found a packet with greater sequence number, cleanup the
+     * event pointer as the packet will be inserted before the event */
+    event = NULL;
+  }
+
+  /* if event is set it means that packets before the event had smaller
+   * sequence number, so we will insert our packet after the event */
+  if (event)
+    list = event;
+
+  *plist = list;
+
+  return TRUE;
+}
+
 GstClockTime
 rtp_jitter_buffer_calculate_pts (RTPJitterBuffer * jbuf, GstClockTime dts,
     gboolean estimated_dts, guint32 rtptime, GstClockTime base_time,
@@ -1069,14 +1292,19 @@ done:
  * will be available with the next call to rtp_jitter_buffer_pop() and
  * rtp_jitter_buffer_peek().
  *
+ * Packets are indexed by seqnum, so duplicates are found in o(1) and the
+ * insertion point in the distance to the closest queued seqnum, unless the
+ * queued packets span too many seqnums.
+ *
  * Returns: %FALSE if a packet with the same number already existed.
  */
 static gboolean
 rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
     gboolean * head, gint * percent)
 {
-  GList *list, *event = NULL;
+  GList *list;
   guint16 seqnum;
+  gboolean found;
 
   g_return_val_if_fail (jbuf != NULL, FALSE);
   g_return_val_if_fail (item != NULL, FALSE);
@@ -1089,47 +1317,20 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
   seqnum = item->seqnum;
 
-  /* loop the list to skip strictly larger seqnum buffers */
-  for (; list; list = g_list_previous (list)) {
-    guint16 qseq;
-    gint gap;
-    RTPJitterBufferItem *qitem = (RTPJitterBufferItem *) list;
-
-    if (qitem->seqnum == -1) {
-      /* keep a pointer to the first consecutive event if not already
-       * set. we will insert the packet after the event if we can't find
-       * a packet with lower sequence number before the event. */
-      if (event == NULL)
-        event = list;
-      continue;
-    }
-
-    qseq = qitem->seqnum;
-
-    /* compare the new seqnum to the one in the buffer */
-    gap = gst_rtp_buffer_compare_seqnum (seqnum, qseq);
-
-    /* we hit a packet with the same seqnum, notify a duplicate */
-    if (G_UNLIKELY (gap == 0))
-      goto duplicate;
-
-    /* seqnum > qseq, we can stop looking */
-    if (G_LIKELY (gap < 0))
-      break;
-
-    /* if we've found a packet with greater sequence number, cleanup the
-     * event pointer as the packet will be inserted before the event */
-    event = NULL;
-  }
+  if (G_LIKELY (jbuf->ring_size > 0))
+    found = ring_find_position (jbuf, seqnum, &list);
+  else
+    found = queue_find_position (jbuf, seqnum, &list);
 
-  /* if event is set it means that packets before the event had smaller
-   * sequence number, so we will insert our packet after the event */
-  if (event)
-    list = event;
+  if (G_UNLIKELY (!found))
+    goto duplicate;
 
 append:
   queue_do_insert (jbuf, list, (GList *) item);
 
+  if (item->seqnum != -1 && G_LIKELY (jbuf->ring_size > 0))
+    ring_add (jbuf, item);
+
   /* buffering mode, update buffer stats */
   if (jbuf->mode == RTP_JITTER_BUFFER_MODE_BUFFER)
     update_buffer_level (jbuf, percent);
@@ -1328,6 +1529,16 @@ rtp_jitter_buffer_pop (RTPJitterBuffer * jbuf, gint * percent)
     else
       queue->tail = NULL;
     queue->length--;
+
+    if (((RTPJitterBufferItem *) item)->seqnum != -1) {
+      if (G_LIKELY (jbuf->ring_size > 0)) {
+        ring_remove_head (jbuf, (RTPJitterBufferItem *) item);
+      } else if (rtp_jitter_buffer_get_seqnum_diff (jbuf) <
+          RTP_JITTER_BUFFER_RING_MAX_SIZE / 2) {
+        /* index again once the packets are close enough together */
+        ring_resize (jbuf, rtp_jitter_buffer_get_seqnum_diff (jbuf));
+      }
+    }
   }
 
   /* buffering mode, update buffer stats */
@@ -1384,6 +1595,11 @@ rtp_jitter_buffer_flush (RTPJitterBuffer * jbuf, GFunc free_func,
 
   while ((item = g_queue_pop_head_link (&jbuf->packets)))
     free_func ((RTPJitterBufferItem *) item, user_data);
+
+  if (jbuf->ring_size > 0)
+    ring_rebuild (jbuf, jbuf->ring_size);
+  else
+    ring_resize (jbuf, 0);
 }
 
 /**
@@ -75,6 +75,14 @@ struct _RTPJitterBuffer {
 
   GQueue         packets;
 
+  /* the items of packets with a seqnum, indexed by seqnum modulo ring_size.
+   * ring_size is 0 when the packets span too many seqnums to be indexed */
+  RTPJitterBufferItem **ring;
+  guint          ring_size;
+  guint          ring_count;
+  guint16        ring_low;
+  guint16        ring_high;
+
   RTPJitterBufferMode mode;
 
   GstClockTime   delay;
@@ -0,0 +1,253 @@
+/* GStreamer RTP Manager
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/rtp/gstrtpbuffer.h>
+
+#include "rtppacketring.h"
+
+#define RTP_PACKET_RING_MIN_SIZE 64
+
+/* As long as the span of stored seqnums doesn't exceed the size, no two
+ * stored packets share a slot */
+#define RING_SLOT(ring, seq) (&(ring)->items[(seq) & ((ring)->size - 1)])
+
+/* Makes sure @ring has a power of two number of slots >= @span */
+static void
+rtp_packet_ring_reserve (RtpPacketRing * ring, guint span)
+{
+  RtpPacketRingItem *items;
+  guint size, i;
+
+  size = ring->size ? ring->size : RTP_PACKET_RING_MIN_SIZE;
+  while (size < span)
+    size <<= 1;
+
+  if (size == ring->size)
+    return;
+
+  items = g_new0 (RtpPacketRingItem, size);
+  for (i = 0; i < ring->size; i++) {
+    RtpPacketRingItem *item = &ring->items[i];
+
+    if (item->buffer)
+      items[item->seq & (size - 1)] = *item;
+  }
+
+  g_free (ring->items);
+  ring->items = items;
+  ring->size = size;
+}
+
+/**
+ * rtp_packet_ring_init:
+ * @ring: a #RtpPacketRing
+ *
+ * Initializes an empty @ring. Slots are only allocated once packets are
+ * inserted.
+ */
+void
+rtp_packet_ring_init (RtpPacketRing * ring)
+{
+  memset (ring, 0, sizeof (RtpPacketRing));
+}
+
+/**
+ * rtp_packet_ring_clear:
+ * @ring: a #RtpPacketRing
+ *
+ * Drops all packets of @ring and frees its slots.
+ */
+void
+rtp_packet_ring_clear (RtpPacketRing * ring)
+{
+  guint i;
+
+  for (i = 0; ring->length && i < ring->size; i++) {
+    if (ring->items[i].buffer) {
+      gst_buffer_unref (ring->items[i].buffer);
+      ring->length--;
+    }
+  }
+
+  g_free (ring->items);
+  rtp_packet_ring_init (ring);
+}
+
+/**
+ * rtp_packet_ring_insert:
+ * @ring: a #RtpPacketRing
+ * @buffer: (transfer full): the packet to store
+ * @seq: seqnum of @buffer
+ * @pt: payload type of @buffer
+ * @timestamp: RTP timestamp of @buffer
+ *
+ * Stores @buffer in @ring, replacing any packet with the same seqnum. When
+ * @seq is newer than the newest packet and too far from the oldest one, the
+ * oldest packets are dropped to make room. A packet that is too old for the
+ * ring to hold is dropped instead.
+ *
+ * When @seq is more than %RTP_PACKET_RING_MAX_DROPOUT ahead of the newest
+ * packet or more than %RTP_PACKET_RING_MAX_MISORDER behind the oldest one,
+ * the sender is assumed to have restarted its seqnums: all packets are
+ * dropped and the ring starts over from @seq. Otherwise the new packets
+ * would be considered older than the stored ones and be trimmed first.
+ *
+ * Returns: %TRUE if @buffer was stored
+ */
+gboolean
+rtp_packet_ring_insert (RtpPacketRing * ring, GstBuffer * buffer, guint16 seq,
+    guint8 pt, guint32 timestamp)
+{
+  RtpPacketRingItem *item;
+
+  if (ring->length > 0) {
+    gint gap = gst_rtp_buffer_compare_seqnum (ring->last, seq);
+
+    if (gap > RTP_PACKET_RING_MAX_DROPOUT || (gap < 0 &&
+            gst_rtp_buffer_compare_seqnum (seq, ring->first) >
+            RTP_PACKET_RING_MAX_MISORDER))
+      rtp_packet_ring_clear (ring);
+  }
+
+  if (ring->length == 0) {
+    rtp_packet_ring_reserve (ring, 1);
+    ring->first = ring->last = seq;
+  } else if (gst_rtp_buffer_compare_seqnum (ring->last, seq) > 0) {
+    while (ring->length &&
+        (guint16) (seq - ring->first) >= RTP_PACKET_RING_MAX_SPAN)
+      rtp_packet_ring_pop_oldest (ring);
+
+    if (ring->length == 0)
+      ring->first = seq;
+    else
+      rtp_packet_ring_reserve (ring, (guint16) (seq - ring->first) + 1);
+    ring->last = seq;
+  } else if (gst_rtp_buffer_compare_seqnum (ring->first, seq) < 0) {
+    guint span = (guint16) (ring->last - seq) + 1;
+
+    if (span > RTP_PACKET_RING_MAX_SPAN) {
+      gst_buffer_unref (buffer);
+      return FALSE;
+    }
+
+    rtp_packet_ring_reserve (ring, span);
+    ring->first = seq;
+  }
+
+  item = RING_SLOT (ring, seq);
+  if (item->buffer)
+    gst_buffer_unref (item->buffer);
+  else
+    ring->length++;
+
+  item->buffer = buffer;
+  item->timestamp = timestamp;
+  item->seq = seq;
+  item->pt = pt;
+
+  return TRUE;
+}
+
+/**
+ * rtp_packet_ring_lookup:
+ * @ring: a #RtpPacketRing
+ * @seq: a seqnum
+ *
+ * Returns: (transfer none) (nullable): the packet with @seq in @ring
+ */
+RtpPacketRingItem *
+rtp_packet_ring_lookup (RtpPacketRing * ring, guint16 seq)
+{
+  RtpPacketRingItem *item;
+
+  if (ring->length == 0)
+    return NULL;
+
+  item = RING_SLOT (ring, seq);
+  if (item->buffer == NULL || item->seq != seq)
+    return NULL;
+
+  return item;
+}
+
+/**
+ * rtp_packet_ring_peek_oldest:
+ * @ring: a #RtpPacketRing
+ *
+ * Returns: (transfer none) (nullable): the packet with the lowest seqnum in
+ * @ring
+ */
+RtpPacketRingItem *
+rtp_packet_ring_peek_oldest (RtpPacketRing * ring)
+{
+  if (ring->length == 0)
+    return NULL;
+
+  return RING_SLOT (ring, ring->first);
+}
+
+/**
+ * rtp_packet_ring_peek_newest:
+ * @ring: a #RtpPacketRing
+ *
+ * Returns: (transfer none) (nullable): the packet with the highest seqnum in
+ * @ring
+ */
+RtpPacketRingItem *
+rtp_packet_ring_peek_newest (RtpPacketRing * ring)
+{
+  if (ring->length == 0)
+    return NULL;
+
+  return RING_SLOT (ring, ring->last);
+}
+
+/**
+ * rtp_packet_ring_pop_oldest:
+ * @ring: a #RtpPacketRing
+ *
+ * Drops the packet with the lowest seqnum from @ring.
+ */
+void
+rtp_packet_ring_pop_oldest (RtpPacketRing * ring)
+{
+  RtpPacketRingItem *item;
+
+  if (ring->length == 0)
+    return;
+
+  item = RING_SLOT (ring, ring->first);
+  g_assert (item->buffer != NULL);
+
+  gst_buffer_unref (item->buffer);
+  item->buffer = NULL;
+
+  if (--ring->length == 0)
+    return;
+
+  /* Skip over the seqnums we never got */
+  do {
+    ring->first++;
+  } while (RING_SLOT (ring, ring->first)->buffer == NULL);
+}
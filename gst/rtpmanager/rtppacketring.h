@@ -0,0 +1,97 @@
+/* GStreamer RTP Manager
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RTP_PACKET_RING_H__
+#define __RTP_PACKET_RING_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* The ring never spans more seqnums than this, so that seqnums inside it can
+ * always be ordered with gst_rtp_buffer_compare_seqnum() */
+#define RTP_PACKET_RING_MAX_SPAN 32768
+
+/* A seqnum further than this ahead of the newest packet, or behind the oldest
+ * one, means the sender restarted its seqnums. Same as RTP_DEF_DROPOUT and
+ * RTP_DEF_MISORDER in rtpstats.h */
+#define RTP_PACKET_RING_MAX_DROPOUT  3000
+#define RTP_PACKET_RING_MAX_MISORDER 100
+
+/**
+ * RtpPacketRingItem:
+ * @buffer: the stored packet
+ * @timestamp: RTP timestamp of the packet
+ * @seq: seqnum of the packet
+ * @pt: payload type of the packet
+ *
+ * A packet stored in a #RtpPacketRing. A slot without packet has a %NULL
+ * @buffer.
+ */
+typedef struct
+{
+  GstBuffer *buffer;
+  guint32 timestamp;
+  guint16 seq;
+  guint8 pt;
+} RtpPacketRingItem;
+
+/**
+ * RtpPacketRing:
+ *
+ * History of RTP packets of one stream, stored in slots indexed by seqnum so
+ * that a packet is found with a single array access. The ring grows with the
+ * span of seqnums it holds, up to %RTP_PACKET_RING_MAX_SPAN, and is trimmed
+ * from its oldest end by its users, by packet count or by age.
+ *
+ * It is not thread safe, users have to protect it with their own lock.
+ */
+typedef struct
+{
+  RtpPacketRingItem *items;
+  guint size;
+  guint length;
+  guint16 first;
+  guint16 last;
+} RtpPacketRing;
+
+void                rtp_packet_ring_init        (RtpPacketRing * ring);
+void                rtp_packet_ring_clear       (RtpPacketRing * ring);
+
+gboolean            rtp_packet_ring_insert      (RtpPacketRing * ring,
+                                                 GstBuffer * buffer,
+                                                 guint16 seq,
+                                                 guint8 pt,
+                                                 guint32 timestamp);
+RtpPacketRingItem * rtp_packet_ring_lookup      (RtpPacketRing * ring,
+                                                 guint16 seq);
+RtpPacketRingItem * rtp_packet_ring_peek_oldest (RtpPacketRing * ring);
+RtpPacketRingItem * rtp_packet_ring_peek_newest (RtpPacketRing * ring);
+void                rtp_packet_ring_pop_oldest  (RtpPacketRing * ring);
+
+/**
+ * rtp_packet_ring_get_length:
+ * @ring: a #RtpPacketRing
+ *
+ * Returns: the number of packets in @ring
+ */
+#define rtp_packet_ring_get_length(ring) ((ring)->length)
+
+G_END_DECLS
+
+#endif /* __RTP_PACKET_RING_H__ */
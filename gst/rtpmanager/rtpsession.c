@@ -82,6 +82,9 @@ enum
 #define DEFAULT_FAVOR_NEW            FALSE
 #define DEFAULT_TWCC_FEEDBACK_INTERVAL GST_CLOCK_TIME_NONE
 #define DEFAULT_UPDATE_NTP64_HEADER_EXT TRUE
+#define DEFAULT_TWCC_START_BITRATE   300000
+#define DEFAULT_TWCC_MIN_BITRATE     30000
+#define DEFAULT_TWCC_MAX_BITRATE     G_MAXUINT
 
 enum
 {
@@ -110,6 +113,9 @@ enum
   PROP_RTCP_DISABLE_SR_TIMESTAMP,
   PROP_TWCC_FEEDBACK_INTERVAL,
   PROP_UPDATE_NTP64_HEADER_EXT,
+  PROP_TWCC_START_BITRATE,
+  PROP_TWCC_MIN_BITRATE,
+  PROP_TWCC_MAX_BITRATE,
   PROP_LAST,
 };
 
@@ -660,6 +666,48 @@ rtp_session_class_init (RTPSessionClass * klass)
       DEFAULT_UPDATE_NTP64_HEADER_EXT,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * RTPSession:twcc-start-bitrate:
+   *
+   * The bitrate the TWCC bandwidth estimation starts from, in bits per
+   * second. Setting it restarts the estimation.
+   *
+   * Since: 1.24
+   */
+  properties[PROP_TWCC_START_BITRATE] =
+      g_param_spec_uint ("twcc-start-bitrate", "TWCC Start Bitrate",
+      "The bitrate the TWCC bandwidth estimation starts from (in bits/s)",
+      0, G_MAXUINT, DEFAULT_TWCC_START_BITRATE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * RTPSession:twcc-min-bitrate:
+   *
+   * The lowest bitrate the TWCC bandwidth estimation can go to, in bits per
+   * second.
+   *
+   * Since: 1.24
+   */
+  properties[PROP_TWCC_MIN_BITRATE] =
+      g_param_spec_uint ("twcc-min-bitrate", "TWCC Minimum Bitrate",
+      "The lowest bitrate the TWCC bandwidth estimation can go to (in bits/s)",
+      0, G_MAXUINT, DEFAULT_TWCC_MIN_BITRATE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * RTPSession:twcc-max-bitrate:
+   *
+   * The highest bitrate the TWCC bandwidth estimation can go to, in bits per
+   * second.
+   *
+   * Since: 1.24
+   */
+  properties[PROP_TWCC_MAX_BITRATE] =
+      g_param_spec_uint ("twcc-max-bitrate", "TWCC Maximum Bitrate",
+      "The highest bitrate the TWCC bandwidth estimation can go to (in bits/s)",
+      0, G_MAXUINT, DEFAULT_TWCC_MAX_BITRATE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, properties);
 
   klass->get_source_by_ssrc =
@@ -676,6 +724,7 @@ rtp_session_init (RTPSession * sess)
   gchar *str;
 
   g_mutex_init (&sess->lock);
+  g_rw_lock_init (&sess->ssrcs_lock);
   sess->key = g_random_int ();
   sess->mask_idx = 0;
   sess->mask = 0;
@@ -751,6 +800,9 @@ rtp_session_init (RTPSession * sess)
 
   sess->twcc = rtp_twcc_manager_new (sess->mtu);
   sess->twcc_stats = rtp_twcc_stats_new ();
+  sess->bwe = rtp_bwe_new (DEFAULT_TWCC_START_BITRATE);
+  rtp_bwe_set_bitrates (sess->bwe, DEFAULT_TWCC_MIN_BITRATE,
+      DEFAULT_TWCC_MAX_BITRATE);
 }
 
 static void
@@ -774,7 +826,9 @@ rtp_session_finalize (GObject * object)
 
   g_object_unref (sess->twcc);
   rtp_twcc_stats_free (sess->twcc_stats);
+  rtp_bwe_free (sess->bwe);
 
+  g_rw_lock_clear (&sess->ssrcs_lock);
   g_mutex_clear (&sess->lock);
 
   G_OBJECT_CLASS (rtp_session_parent_class)->finalize (object);
@@ -950,6 +1004,23 @@ rtp_session_set_property (GObject * object, guint prop_id,
     case PROP_UPDATE_NTP64_HEADER_EXT:
       sess->update_ntp64_header_ext = g_value_get_boolean (value);
       break;
+    case PROP_TWCC_START_BITRATE:
+      RTP_SESSION_LOCK (sess);
+      rtp_bwe_set_start_bitrate (sess->bwe, g_value_get_uint (value));
+      RTP_SESSION_UNLOCK (sess);
+      break;
+    case PROP_TWCC_MIN_BITRATE:
+      RTP_SESSION_LOCK (sess);
+      rtp_bwe_set_bitrates (sess->bwe, g_value_get_uint (value),
+          sess->bwe->max_bitrate);
+      RTP_SESSION_UNLOCK (sess);
+      break;
+    case PROP_TWCC_MAX_BITRATE:
+      RTP_SESSION_LOCK (sess);
+      rtp_bwe_set_bitrates (sess->bwe, sess->bwe->min_bitrate,
+          g_value_get_uint (value));
+      RTP_SESSION_UNLOCK (sess);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1039,6 +1110,21 @@ rtp_session_get_property (GObject * object, guint prop_id,
     case PROP_UPDATE_NTP64_HEADER_EXT:
       g_value_set_boolean (value, sess->update_ntp64_header_ext);
       break;
+    case PROP_TWCC_START_BITRATE:
+      RTP_SESSION_LOCK (sess);
+      g_value_set_uint (value, sess->bwe->start_bitrate);
+      RTP_SESSION_UNLOCK (sess);
+      break;
+    case PROP_TWCC_MIN_BITRATE:
+      RTP_SESSION_LOCK (sess);
+      g_value_set_uint (value, sess->bwe->min_bitrate);
+      RTP_SESSION_UNLOCK (sess);
+      break;
+    case PROP_TWCC_MAX_BITRATE:
+      RTP_SESSION_LOCK (sess);
+      g_value_set_uint (value, sess->bwe->max_bitrate);
+      RTP_SESSION_UNLOCK (sess);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1191,7 +1277,9 @@ rtp_session_reset (RTPSession * sess)
 
   RTP_SESSION_LOCK (sess);
   /* remove all sources */
+  g_rw_lock_writer_lock (&sess->ssrcs_lock);
   g_hash_table_remove_all (sess->ssrcs[sess->mask_idx]);
+  g_rw_lock_writer_unlock (&sess->ssrcs_lock);
   sess->total_sources = 0;
   sess->stats.sender_sources = 0;
   sess->stats.internal_sender_sources = 0;
@@ -1846,8 +1934,10 @@ session_update_ptp (RTPSession * sess)
 static void
 add_source (RTPSession * sess, RTPSource * src)
 {
+  g_rw_lock_writer_lock (&sess->ssrcs_lock);
   g_hash_table_insert (sess->ssrcs[sess->mask_idx],
       GINT_TO_POINTER (src->ssrc), src);
+  g_rw_lock_writer_unlock (&sess->ssrcs_lock);
   /* report the new source ASAP */
   src->generation = sess->generation;
   /* we have one more source now */
@@ -1922,9 +2012,11 @@ obtain_source (RTPSession * sess, guint32 ssrc, gboolean * created,
       g_object_set (source, "probation", 0, NULL);
   }
   /* update last activity */
+  RTP_SOURCE_LOCK (source);
   source->last_activity = pinfo->current_time;
   if (rtp)
     source->last_rtp_activity = pinfo->current_time;
+  RTP_SOURCE_UNLOCK (source);
   g_object_ref (source);
 
   return source;
@@ -2189,7 +2281,8 @@ invalid_packet:
 /* update the RTPPacketInfo structure with the current time and other bits
  * about the current buffer we are handling.
  * This function is typically called when a validated packet is received.
- * This function should be called with the RTP_SESSION_LOCK
+ * This function should be called with the RTP_SESSION_LOCK, except on the
+ * RTP receive path as it then only reads the constant header length.
  */
 static gboolean
 update_packet_info (RTPSession * sess, RTPPacketInfo * pinfo,
@@ -2304,6 +2397,68 @@ source_update_sender (RTPSession * sess, RTPSource * source,
   return TRUE;
 }
 
+/* Handle an RTP packet of a known remote sender without the session lock.
+ * Only the source lock is taken to update its statistics, the session lock
+ * is only needed when the bitrate estimation changed or for TWCC.
+ *
+ * Returns: %FALSE when the packet needs to be handled with the session lock.
+ */
+static gboolean
+process_rtp_unlocked (RTPSession * sess, RTPPacketInfo * pinfo,
+    GstFlowReturn * result)
+{
+  RTPSource *source;
+  gboolean bitrate_changed = FALSE;
+  gboolean handled = FALSE;
+
+  *result = GST_FLOW_OK;
+
+  g_rw_lock_reader_lock (&sess->ssrcs_lock);
+  source = find_source (sess, pinfo->ssrc);
+  if (source)
+    g_object_ref (source);
+  g_rw_lock_reader_unlock (&sess->ssrcs_lock);
+
+  if (source == NULL)
+    return FALSE;
+
+  /* the address can only change on this thread, a different one needs the
+   * collision checks */
+  if (pinfo->address && (source->rtp_from == NULL
+          || !__g_socket_address_equal (source->rtp_from, pinfo->address)))
+    goto done;
+
+  if (!rtp_source_receive_rtp (source, pinfo, &bitrate_changed))
+    goto done;
+
+  handled = TRUE;
+
+  if (pinfo->data) {
+    GstBuffer *buffer = GST_BUFFER_CAST (pinfo->data);
+
+    pinfo->data = NULL;
+    GST_LOG ("source %08x pushed receiver RTP packet", source->ssrc);
+    if (sess->callbacks.process_rtp)
+      *result = sess->callbacks.process_rtp (sess, source, buffer,
+          sess->process_rtp_user_data);
+    else
+      gst_buffer_unref (buffer);
+  }
+
+  if (bitrate_changed || rtp_twcc_manager_has_recv_ext_id (sess->twcc)) {
+    RTP_SESSION_LOCK (sess);
+    if (bitrate_changed)
+      sess->recalc_bandwidth = TRUE;
+    process_twcc_packet (sess, pinfo);
+    RTP_SESSION_UNLOCK (sess);
+  }
+
+done:
+  g_object_unref (source);
+
+  return handled;
+}
+
 /**
  * rtp_session_process_rtp:
  * @sess: and #RTPSession
@@ -2331,17 +2486,23 @@ rtp_session_process_rtp (RTPSession * sess, GstBuffer * buffer,
   g_return_val_if_fail (RTP_IS_SESSION (sess), GST_FLOW_ERROR);
   g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
 
-  RTP_SESSION_LOCK (sess);
-
-  /* update pinfo stats */
+  /* update pinfo stats, this only reads the header length from the session */
   if (!update_packet_info (sess, &pinfo, FALSE, TRUE, FALSE, buffer,
           current_time, running_time, ntpnstime)) {
     GST_DEBUG ("invalid RTP packet received");
-    RTP_SESSION_UNLOCK (sess);
     return rtp_session_process_rtcp (sess, buffer, current_time, running_time,
         ntpnstime);
   }
 
+  /* most packets are from known senders and don't need the session lock */
+  if (pinfo.csrc_count == 0
+      && process_rtp_unlocked (sess, &pinfo, &result)) {
+    clean_packet_info (&pinfo);
+    return result;
+  }
+
+  RTP_SESSION_LOCK (sess);
+
   ssrc = pinfo.ssrc;
 
   source = obtain_source (sess, ssrc, &created, &pinfo, TRUE);
@@ -2957,6 +3118,7 @@ rtp_session_process_twcc (RTPSession * sess, guint32 sender_ssrc,
   GArray *twcc_packets;
   GstStructure *twcc_packets_s;
   GstStructure *twcc_stats_s;
+  guint target_bitrate;
 
   twcc_packets = rtp_twcc_manager_parse_fci (sess->twcc,
       fci_data, fci_length * sizeof (guint32));
@@ -2967,6 +3129,11 @@ rtp_session_process_twcc (RTPSession * sess, guint32 sender_ssrc,
   twcc_stats_s =
       rtp_twcc_stats_process_packets (sess->twcc_stats, twcc_packets);
 
+  target_bitrate = rtp_bwe_process_packets (sess->bwe, twcc_packets,
+      sess->twcc_stats->bitrate_recv);
+  gst_structure_set (twcc_stats_s, "target-bitrate", G_TYPE_UINT,
+      target_bitrate, NULL);
+
   GST_DEBUG_OBJECT (sess, "Parsed TWCC: %" GST_PTR_FORMAT, twcc_packets_s);
   GST_INFO_OBJECT (sess, "Current TWCC stats %" GST_PTR_FORMAT, twcc_stats_s);
 
@@ -3524,7 +3691,9 @@ collision:
 static void
 add_bitrates (gpointer key, RTPSource * source, gdouble * bandwidth)
 {
+  RTP_SOURCE_LOCK (source);
   *bandwidth += source->bitrate;
+  RTP_SOURCE_UNLOCK (source);
 }
 
 /* must be called with session lock */
@@ -4130,6 +4299,7 @@ session_cleanup (const gchar * key, RTPSource * source, ReportData * data)
   RTPSession *sess = data->sess;
   GstClockTime interval, binterval;
   GstClockTime btime;
+  GstClockTime last_activity, last_rtp_activity;
 
   GST_DEBUG ("look at %08x, generation %u", source->ssrc, source->generation);
 
@@ -4186,10 +4356,16 @@ session_cleanup (const gchar * key, RTPSource * source, ReportData * data)
     remove = TRUE;
   }
 
+  /* the RTP receive path updates the activity without the session lock */
+  RTP_SOURCE_LOCK (source);
+  last_activity = source->last_activity;
+  last_rtp_activity = source->last_rtp_activity;
+  RTP_SOURCE_UNLOCK (source);
+
   /* sources that were inactive for more than 5 times the deterministic reporting
    * interval get timed out. the min timeout is 5 seconds. */
   /* mind old time that might pre-date last time going to PLAYING */
-  btime = MAX (source->last_activity, sess->start_time);
+  btime = MAX (last_activity, sess->start_time);
   if (data->current_time > btime) {
     interval = MAX (binterval * 5, 5 * GST_SECOND);
     if (data->current_time - btime > interval) {
@@ -4215,7 +4391,7 @@ session_cleanup (const gchar * key, RTPSource * source, ReportData * data)
    * holds for our own sources. */
   if (is_sender) {
     /* mind old time that might pre-date last time going to PLAYING */
-    btime = MAX (source->last_rtp_activity, sess->start_time);
+    btime = MAX (last_rtp_activity, sess->start_time);
     if (data->current_time > btime) {
       interval = MAX (binterval * 2, 5 * GST_SECOND);
       if (data->current_time - btime > interval) {
@@ -4699,8 +4875,10 @@ rtp_session_on_timeout (RTPSession * sess, GstClockTime current_time,
   g_hash_table_destroy (table_copy);
 
   /* Now remove the marked sources */
+  g_rw_lock_writer_lock (&sess->ssrcs_lock);
   g_hash_table_foreach_remove (sess->ssrcs[sess->mask_idx],
       (GHRFunc) remove_closing_sources, &data);
+  g_rw_lock_writer_unlock (&sess->ssrcs_lock);
 
   /* update point-to-point status */
   session_update_ptp (sess);
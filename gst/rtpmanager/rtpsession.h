@@ -24,6 +24,7 @@
 
 #include "rtpsource.h"
 #include "rtptwcc.h"
+#include "rtpbwe.h"
 
 typedef struct _RTPSession RTPSession;
 typedef struct _RTPSessionClass RTPSessionClass;
@@ -267,6 +268,9 @@ struct _RTPSession {
   guint32       mask_idx;
   guint32       mask;
   GHashTable   *ssrcs[32];
+  /* taken for writing when changing ssrcs, in addition to the session lock,
+   * so that the RTP receive path can look up sources without the latter */
+  GRWLock       ssrcs_lock;
   guint         total_sources;
 
   guint16       generation;
@@ -318,6 +322,7 @@ struct _RTPSession {
   /* Transport-wide cc-extension */
   RTPTWCCManager *twcc;
   RTPTWCCStats *twcc_stats;
+  RTPBWE *bwe;
 };
 
 /**
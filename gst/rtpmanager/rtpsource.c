@@ -319,6 +319,8 @@ rtp_source_init (RTPSource * src)
 
   src->last_keyframe_request = GST_CLOCK_TIME_NONE;
 
+  g_mutex_init (&src->lock);
+
   rtp_source_reset (src);
 
   src->pt_set = FALSE;
@@ -362,6 +364,8 @@ rtp_source_finalize (GObject * object)
 
   g_hash_table_unref (src->reported_in_sr_of);
 
+  g_mutex_clear (&src->lock);
+
   G_OBJECT_CLASS (rtp_source_parent_class)->finalize (object);
 }
 
@@ -412,6 +416,7 @@ rtp_source_create_stats (RTPSource * src)
     g_free (address_str);
   }
 
+  RTP_SOURCE_LOCK (src);
   gst_structure_set (s,
       "octets-sent", G_TYPE_UINT64, src->stats.octets_sent,
       "packets-sent", G_TYPE_UINT64, src->stats.packets_sent,
@@ -430,6 +435,7 @@ rtp_source_create_stats (RTPSource * src)
       "recv-nack-count", G_TYPE_UINT, src->stats.recv_nack_count,
       "recv-packet-rate", G_TYPE_UINT,
       gst_rtp_packet_rate_ctx_get (&src->packet_rate_ctx), NULL);
+  RTP_SOURCE_UNLOCK (src);
 
   /* get the last SR. */
   have_sr = rtp_source_get_last_sr (src, &time, &ntptime, &rtptime,
@@ -1328,8 +1334,11 @@ rtp_source_process_rtp (RTPSource * src, RTPPacketInfo * pinfo)
 
   fetch_caps_for_payload (src, pinfo->pt);
 
-  if (!update_receiver_stats (src, pinfo, TRUE))
+  RTP_SOURCE_LOCK (src);
+  if (!update_receiver_stats (src, pinfo, TRUE)) {
+    RTP_SOURCE_UNLOCK (src);
     return GST_FLOW_OK;
+  }
 
   /* the source that sent the packet must be a sender */
   src->is_sender = TRUE;
@@ -1339,6 +1348,7 @@ rtp_source_process_rtp (RTPSource * src, RTPPacketInfo * pinfo)
 
   /* calculate jitter for the stats */
   calculate_jitter (src, pinfo);
+  RTP_SOURCE_UNLOCK (src);
 
   /* we're ready to push the RTP packet now */
   result = push_packet (src, pinfo->data);
@@ -1347,6 +1357,55 @@ rtp_source_process_rtp (RTPSource * src, RTPPacketInfo * pinfo)
   return result;
 }
 
+/**
+ * rtp_source_receive_rtp:
+ * @src: an #RTPSource
+ * @pinfo: an #RTPPacketInfo
+ * @bitrate_changed: (out): set when the bitrate estimation changed
+ *
+ * Update the receive statistics of @src with the RTP packet described in
+ * @pinfo. Unlike rtp_source_process_rtp() this only needs the lock of @src
+ * and not the session lock, so it only handles packets of validated senders
+ * for which the payload is known and no packets are queued. For all other
+ * packets nothing is done and %FALSE is returned.
+ *
+ * The packet in @pinfo is taken when it is queued because of a sequence
+ * number jump, otherwise the caller should push it.
+ *
+ * Returns: %TRUE when the packet was handled.
+ */
+gboolean
+rtp_source_receive_rtp (RTPSource * src, RTPPacketInfo * pinfo,
+    gboolean * bitrate_changed)
+{
+  guint64 oldrate;
+
+  g_return_val_if_fail (RTP_IS_SOURCE (src), FALSE);
+  g_return_val_if_fail (pinfo != NULL, FALSE);
+
+  RTP_SOURCE_LOCK (src);
+  if (src->internal || !src->validated || !src->is_sender
+      || src->marked_bye || src->curr_probation != 0
+      || src->payload != pinfo->pt || src->clock_rate == -1
+      || src->caps == NULL || !g_queue_is_empty (src->packets)) {
+    RTP_SOURCE_UNLOCK (src);
+    return FALSE;
+  }
+
+  src->last_activity = pinfo->current_time;
+  src->last_rtp_activity = pinfo->current_time;
+
+  oldrate = src->bitrate;
+  if (update_receiver_stats (src, pinfo, TRUE)) {
+    do_bitrate_estimation (src, pinfo->running_time, &src->bytes_received);
+    calculate_jitter (src, pinfo);
+  }
+  *bitrate_changed = oldrate != src->bitrate;
+  RTP_SOURCE_UNLOCK (src);
+
+  return TRUE;
+}
+
 /**
  * rtp_source_mark_bye:
  * @src: an #RTPSource
@@ -1690,11 +1749,12 @@ rtp_source_get_new_rb (RTPSource * src, GstClockTime time,
   guint64 extended_max, expected;
   guint64 expected_interval, received_interval, ntptime;
   gint64 lost, lost_interval;
-  guint32 fraction, LSR, DLSR;
+  guint32 fraction, LSR, DLSR, scaled_jitter;
   GstClockTime sr_time;
 
   stats = &src->stats;
 
+  RTP_SOURCE_LOCK (src);
   extended_max = stats->cycles + stats->max_seq;
   expected = extended_max - stats->base_seq + 1;
 
@@ -1711,6 +1771,8 @@ rtp_source_get_new_rb (RTPSource * src, GstClockTime time,
   stats->prev_received = stats->packets_received;
 
   lost_interval = expected_interval - received_interval;
+  scaled_jitter = stats->jitter;
+  RTP_SOURCE_UNLOCK (src);
 
   if (expected_interval == 0 || lost_interval <= 0)
     fraction = 0;
@@ -1721,7 +1783,7 @@ rtp_source_get_new_rb (RTPSource * src, GstClockTime time,
   /* we scaled the jitter up for additional precision */
   GST_DEBUG ("fraction %" G_GUINT32_FORMAT ", lost %" G_GINT64_FORMAT
       ", extseq %" G_GUINT64_FORMAT ", jitter %d", fraction, lost,
-      extended_max, stats->jitter >> 4);
+      extended_max, scaled_jitter >> 4);
 
   if (rtp_source_get_last_sr (src, &sr_time, &ntptime, NULL, NULL, NULL)) {
     GstClockTime diff;
@@ -1748,7 +1810,7 @@ rtp_source_get_new_rb (RTPSource * src, GstClockTime time,
   if (exthighestseq)
     *exthighestseq = extended_max;
   if (jitter)
-    *jitter = stats->jitter >> 4;
+    *jitter = scaled_jitter >> 4;
   if (lsr)
     *lsr = LSR;
   if (dlsr)
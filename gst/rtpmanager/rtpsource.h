@@ -46,6 +46,9 @@ typedef struct _RTPSourceClass RTPSourceClass;
 #define RTP_IS_SOURCE_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE((klass),RTP_TYPE_SOURCE))
 #define RTP_SOURCE_CAST(src)        ((RTPSource *)(src))
 
+#define RTP_SOURCE_LOCK(src)        (g_mutex_lock (&(src)->lock))
+#define RTP_SOURCE_UNLOCK(src)      (g_mutex_unlock (&(src)->lock))
+
 /**
  * RTP_SOURCE_IS_ACTIVE:
  * @src: an #RTPSource
@@ -186,6 +189,9 @@ struct _RTPSource {
   RTPSourceCallbacks callbacks;
   gpointer           user_data;
 
+  /* protects the receive statistics, which are updated without the session
+   * lock by rtp_source_receive_rtp() */
+  GMutex         lock;
   RTPSourceStats stats;
   RTPReceiverReport last_rr;
 
@@ -246,6 +252,8 @@ void            rtp_source_set_rtcp_from       (RTPSource *src, GSocketAddress *
 
 /* handling RTP */
 GstFlowReturn   rtp_source_process_rtp         (RTPSource *src, RTPPacketInfo *pinfo);
+gboolean        rtp_source_receive_rtp         (RTPSource *src, RTPPacketInfo *pinfo,
+                                                gboolean *bitrate_changed);
 
 GstFlowReturn   rtp_source_send_rtp            (RTPSource *src, RTPPacketInfo *pinfo);
 
@@ -24,12 +24,22 @@
 
 #include "rtptimerqueue.h"
 
+/* Once the queue holds more timers than this, a balanced tree index is kept
+ * next to the sorted list so that timers can be placed in o(log n) instead of
+ * walking the list. It is dropped again when the queue has shrunk well below
+ * that, as walking a short list is cheaper than maintaining the index. */
+#define RTP_TIMER_QUEUE_INDEX_MIN_LENGTH 128
+#define RTP_TIMER_QUEUE_INDEX_DROP_LENGTH (RTP_TIMER_QUEUE_INDEX_MIN_LENGTH / 4)
+
 struct _RtpTimerQueue
 {
   GObject parent;
 
   GQueue timers;
   GHashTable *hashtable;
+
+  /* the timers in the same order as @timers, or %NULL */
+  GSequence *index;
 };
 
 G_DEFINE_TYPE (RtpTimerQueue, rtp_timer_queue, G_TYPE_OBJECT);
@@ -98,6 +108,25 @@ rtp_timer_is_sooner (RtpTimer * timer, RtpTimer * prev)
   return FALSE;
 }
 
+/* The order of the queue: timers without timeout first, then earliest timeout
+ * first and smaller seqnum first for identical timeouts */
+static gint
+rtp_timer_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const RtpTimer *timer_a = a;
+  const RtpTimer *timer_b = b;
+
+  if (timer_a->timeout != timer_b->timeout) {
+    if (!GST_CLOCK_TIME_IS_VALID (timer_a->timeout))
+      return -1;
+    if (!GST_CLOCK_TIME_IS_VALID (timer_b->timeout))
+      return 1;
+    return timer_a->timeout < timer_b->timeout ? -1 : 1;
+  }
+
+  return gst_rtp_buffer_compare_seqnum (timer_b->seqnum, timer_a->seqnum);
+}
+
 static inline gboolean
 rtp_timer_is_closer_to_head (RtpTimer * timer, RtpTimer * head)
 {
@@ -288,6 +317,47 @@ rtp_timer_queue_insert_head (RtpTimerQueue * queue, RtpTimer * timer)
     rtp_timer_queue_insert_before (queue, it, timer);
 }
 
+/* Links @timer into the list next to the timer that precedes it in the
+ * index */
+static void
+rtp_timer_queue_link_indexed (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  if (g_sequence_iter_is_begin (timer->index_iter)) {
+    g_queue_push_head_link (&queue->timers, (GList *) timer);
+  } else {
+    GSequenceIter *prev = g_sequence_iter_prev (timer->index_iter);
+    rtp_timer_queue_insert_after (queue, g_sequence_get (prev), timer);
+  }
+}
+
+static void
+rtp_timer_queue_build_index (RtpTimerQueue * queue)
+{
+  RtpTimer *timer;
+
+  GST_DEBUG ("Building index for %u timers", queue->timers.length);
+
+  /* the list is already sorted, appending keeps both in the same order */
+  queue->index = g_sequence_new (NULL);
+  for (timer = rtp_timer_queue_get_head (queue); timer;
+      timer = rtp_timer_get_next (timer))
+    timer->index_iter = g_sequence_append (queue->index, timer);
+}
+
+static void
+rtp_timer_queue_drop_index (RtpTimerQueue * queue)
+{
+  RtpTimer *timer;
+
+  GST_DEBUG ("Dropping index, %u timers left", queue->timers.length);
+
+  for (timer = rtp_timer_queue_get_head (queue); timer;
+      timer = rtp_timer_get_next (timer))
+    timer->index_iter = NULL;
+  g_sequence_free (queue->index);
+  queue->index = NULL;
+}
+
 static void
 rtp_timer_queue_init (RtpTimerQueue * queue)
 {
@@ -304,6 +374,7 @@ rtp_timer_queue_finalize (GObject * object)
     rtp_timer_free (timer);
   g_hash_table_unref (queue->hashtable);
   g_assert (queue->timers.length == 0);
+  g_assert (queue->index == NULL);
 
   G_OBJECT_CLASS (rtp_timer_queue_parent_class)->finalize (object);
 }
@@ -328,6 +399,7 @@ rtp_timer_free (RtpTimer * timer)
   g_return_if_fail (timer->queued == FALSE);
   g_return_if_fail (timer->list.next == NULL);
   g_return_if_fail (timer->list.prev == NULL);
+  g_return_if_fail (timer->index_iter == NULL);
 
   g_slice_free (RtpTimer, timer);
 }
@@ -347,6 +419,7 @@ rtp_timer_dup (const RtpTimer * timer)
   memcpy (copy, timer, sizeof (RtpTimer));
   memset (&copy->list, 0, sizeof (GList));
   copy->queued = FALSE;
+  copy->index_iter = NULL;
   return copy;
 }
 
@@ -397,8 +470,9 @@ rtp_timer_queue_new (void)
  *
  * Insert a timer into the queue. Earliest timer are at the head and then
  * timer are sorted by seqnum (smaller seqnum first). This function is o(n)
- * but it is expected that most timers added are schedule later, in which case
- * the insertion will be faster.
+ * for short queues but it is expected that most timers added are schedule
+ * later, in which case the insertion will be faster. Long queues are indexed
+ * and insertion is o(log n).
  *
  * Returns: %FALSE if a timer with the same seqnum already existed
  */
@@ -413,15 +487,23 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
     return FALSE;
   }
 
-  if (timer->timeout == -1)
+  if (queue->index) {
+    timer->index_iter = g_sequence_insert_sorted (queue->index, timer,
+        rtp_timer_compare, NULL);
+    rtp_timer_queue_link_indexed (queue, timer);
+  } else if (timer->timeout == -1) {
     rtp_timer_queue_insert_head (queue, timer);
-  else
+  } else {
     rtp_timer_queue_insert_tail (queue, timer);
+  }
 
   g_hash_table_insert (queue->hashtable,
       GINT_TO_POINTER (timer->seqnum), timer);
   timer->queued = TRUE;
 
+  if (!queue->index && queue->timers.length > RTP_TIMER_QUEUE_INDEX_MIN_LENGTH)
+    rtp_timer_queue_build_index (queue);
+
   return TRUE;
 }
 
@@ -431,8 +513,9 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
  * @timer: the #RtpTimer to reschedule
  *
  * This function moves @timer inside the queue to put it back to it's new
- * location. This function is o(n) but it is assumed that nearby modification
- * of the timeout will occure.
+ * location. This function is o(n) for short queues but it is assumed that
+ * nearby modification of the timeout will occure. Long queues are indexed
+ * and rescheduling is o(log n).
  *
  * Returns: %TRUE if the timer was moved
  */
@@ -443,6 +526,20 @@ rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
 
   g_return_val_if_fail (timer->queued == TRUE, FALSE);
 
+  if (queue->index) {
+    RtpTimer *prev = rtp_timer_get_prev (timer);
+    RtpTimer *next = rtp_timer_get_next (timer);
+
+    if ((prev == NULL || rtp_timer_compare (prev, timer, NULL) < 0) &&
+        (next == NULL || rtp_timer_compare (timer, next, NULL) < 0))
+      return FALSE;
+
+    g_queue_unlink (&queue->timers, (GList *) timer);
+    g_sequence_sort_changed (timer->index_iter, rtp_timer_compare, NULL);
+    rtp_timer_queue_link_indexed (queue, timer);
+    return TRUE;
+  }
+
   if (rtp_timer_is_closer_to_head (timer, rtp_timer_queue_get_head (queue))) {
     g_queue_unlink (&queue->timers, (GList *) timer);
     rtp_timer_queue_insert_head (queue, timer);
@@ -482,7 +579,8 @@ rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
  * @timer: the #RtpTimer to unschedule
  *
  * This removes a timer from the queue. The timer structure can be reused,
- * or freed using rtp_timer_free(). This function is o(1).
+ * or freed using rtp_timer_free(). This function is o(1), or o(log n) if
+ * the queue is indexed.
  */
 void
 rtp_timer_queue_unschedule (RtpTimerQueue * queue, RtpTimer * timer)
@@ -492,6 +590,14 @@ rtp_timer_queue_unschedule (RtpTimerQueue * queue, RtpTimer * timer)
   g_queue_unlink (&queue->timers, (GList *) timer);
   g_hash_table_remove (queue->hashtable, GINT_TO_POINTER (timer->seqnum));
   timer->queued = FALSE;
+
+  if (timer->index_iter) {
+    g_sequence_remove (timer->index_iter);
+    timer->index_iter = NULL;
+
+    if (queue->timers.length < RTP_TIMER_QUEUE_INDEX_DROP_LENGTH)
+      rtp_timer_queue_drop_index (queue);
+  }
 }
 
 /**
@@ -501,7 +607,8 @@ rtp_timer_queue_unschedule (RtpTimerQueue * queue, RtpTimer * timer)
  *
  * Unschdedule and return the earliest packet that has a timeout smaller or
  * equal to @timeout. The returns #RtpTimer must be freed with
- * rtp_timer_free(). This function is o(1).
+ * rtp_timer_free(). This function is o(1), or o(log n) if the queue is
+ * indexed.
  *
  * Returns: an expired timer according to @timeout, or %NULL.
  */
@@ -58,6 +58,7 @@ typedef struct
 {
   GList list;
   gboolean queued;
+  GSequenceIter *index_iter;
 
   guint16 seqnum;
   RtpTimerType type;
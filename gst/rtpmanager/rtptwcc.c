@@ -50,6 +50,14 @@ typedef struct
   guint8 fb_pkt_count[1];
 } RTPTWCCHeader;
 
+/* An entry of the arrival log, with the arrival time relative to the one of
+ * the first packet logged since the last feedback */
+typedef struct
+{
+  gint32 arrival_delta;
+  guint16 seqnum;
+} RecvArrival;
+
 typedef struct
 {
   GstClockTime ts;
@@ -82,7 +90,16 @@ struct _RTPTWCCManager
 
   guint mtu;
   guint max_packets_per_rtcp;
+
+  /* packets received since the last feedback, sorted by seqnum */
+  RecvArrival *recv_log;
+  guint recv_log_len;
+  guint recv_log_size;
+  GstClockTime recv_log_base_ts;
+
+  /* scratch space for building feedback, reused across feedbacks */
   GArray *recv_packets;
+  GArray *packet_chunks;
 
   guint64 fb_pkt_count;
   gint32 last_seqnum;
@@ -111,6 +128,7 @@ static void
 rtp_twcc_manager_init (RTPTWCCManager * twcc)
 {
   twcc->recv_packets = g_array_new (FALSE, FALSE, sizeof (RecvPacket));
+  twcc->packet_chunks = g_array_new (FALSE, FALSE, 2);
   twcc->sent_packets = g_array_new (FALSE, FALSE, sizeof (SentPacket));
   twcc->parsed_packets = g_array_new (FALSE, FALSE, sizeof (RecvPacket));
 
@@ -131,7 +149,9 @@ rtp_twcc_manager_finalize (GObject * object)
 {
   RTPTWCCManager *twcc = RTP_TWCC_MANAGER_CAST (object);
 
+  g_free (twcc->recv_log);
   g_array_unref (twcc->recv_packets);
+  g_array_unref (twcc->packet_chunks);
   g_array_unref (twcc->sent_packets);
   g_array_unref (twcc->parsed_packets);
   g_queue_free_full (twcc->rtcp_buffers, (GDestroyNotify) gst_buffer_unref);
@@ -156,16 +176,13 @@ rtp_twcc_manager_new (guint mtu)
   return twcc;
 }
 
-static void
-recv_packet_init (RecvPacket * packet, guint16 seqnum, RTPPacketInfo * pinfo)
+static GstClockTime
+_get_arrival_time (RTPPacketInfo * pinfo)
 {
-  memset (packet, 0, sizeof (RecvPacket));
-  packet->seqnum = seqnum;
-
   if (GST_CLOCK_TIME_IS_VALID (pinfo->arrival_time))
-    packet->ts = pinfo->arrival_time;
-  else
-    packet->ts = pinfo->current_time;
+    return pinfo->arrival_time;
+
+  return pinfo->current_time;
 }
 
 void
@@ -180,6 +197,12 @@ rtp_twcc_manager_parse_recv_ext_id (RTPTWCCManager * twcc,
   }
 }
 
+gboolean
+rtp_twcc_manager_has_recv_ext_id (RTPTWCCManager * twcc)
+{
+  return twcc->recv_ext_id != 0;
+}
+
 void
 rtp_twcc_manager_parse_send_ext_id (RTPTWCCManager * twcc,
     const GstStructure * s)
@@ -201,7 +224,18 @@ rtp_twcc_manager_set_mtu (RTPTWCCManager * twcc, guint mtu)
      header (4 * 4 * 4) 32 bytes) and 
      packet_chunk 2 bytes +  
      recv_deltas (2 * 7) 14 bytes */
-  twcc->max_packets_per_rtcp = ((twcc->mtu - 32) * 7) / (2 + 14);
+  twcc->max_packets_per_rtcp =
+      MAX (1, ((MAX (twcc->mtu, 32) - 32) * 7) / (2 + 14));
+
+  /* a feedback is created before the log overflows, so it never has to
+     grow while receiving */
+  if (twcc->max_packets_per_rtcp > twcc->recv_log_size) {
+    twcc->recv_log_size = twcc->max_packets_per_rtcp;
+    twcc->recv_log = g_renew (RecvArrival, twcc->recv_log,
+        twcc->recv_log_size);
+    g_array_set_size (twcc->recv_packets, twcc->recv_log_size);
+    g_array_set_size (twcc->recv_packets, 0);
+  }
 }
 
 void
@@ -313,11 +347,9 @@ rtp_twcc_manager_get_recv_twcc_seqnum (RTPTWCCManager * twcc,
 }
 
 static gint
-_twcc_seqnum_sort (gconstpointer a, gconstpointer b)
+_twcc_seqnum_cmp (guint16 seqa, guint16 seqb)
 {
-  gint32 seqa = ((RecvPacket *) a)->seqnum;
-  gint32 seqb = ((RecvPacket *) b)->seqnum;
-  gint res = seqa - seqb;
+  gint res = (gint) seqa - (gint) seqb;
   if (res < -65000)
     res = 1;
   if (res > 65000)
@@ -325,6 +357,36 @@ _twcc_seqnum_sort (gconstpointer a, gconstpointer b)
   return res;
 }
 
+/* Packets mostly arrive in order, so inserting from the end is usually
+   a plain append. Of duplicates only the first arrival is kept. */
+static void
+rtp_twcc_manager_log_arrival (RTPTWCCManager * twcc, guint16 seqnum,
+    GstClockTime ts)
+{
+  RecvArrival *arrival;
+  guint i = twcc->recv_log_len;
+
+  if (twcc->recv_log_len == 0)
+    twcc->recv_log_base_ts = ts;
+
+  while (i > 0 && _twcc_seqnum_cmp (twcc->recv_log[i - 1].seqnum, seqnum) > 0)
+    i--;
+
+  if (i > 0 && twcc->recv_log[i - 1].seqnum == seqnum) {
+    GST_DEBUG ("Ignoring duplicate packet #%u", seqnum);
+    return;
+  }
+
+  g_assert (twcc->recv_log_len < twcc->recv_log_size);
+
+  arrival = &twcc->recv_log[i];
+  memmove (arrival + 1, arrival,
+      (twcc->recv_log_len - i) * sizeof (RecvArrival));
+  arrival->seqnum = seqnum;
+  arrival->arrival_delta = GST_CLOCK_DIFF (twcc->recv_log_base_ts, ts);
+  twcc->recv_log_len++;
+}
+
 static void
 rtp_twcc_write_recv_deltas (guint8 * fci_data, GArray * twcc_packets)
 {
@@ -576,12 +638,13 @@ rtp_twcc_write_chunks (GArray * packet_chunks,
 static void
 rtp_twcc_manager_add_fci (RTPTWCCManager * twcc, GstRTCPPacket * packet)
 {
-  RecvPacket *first, *last, *prev;
+  RecvArrival *first, *last;
+  RecvPacket *prev;
   guint16 packet_count;
   GstClockTime base_time;
   GstClockTime ts_rounded;
   guint i;
-  GArray *packet_chunks = g_array_new (FALSE, FALSE, 2);
+  GArray *packet_chunks = twcc->packet_chunks;
   RTPTWCCHeader header;
   guint header_size = sizeof (RTPTWCCHeader);
   guint packet_chunks_size;
@@ -596,30 +659,15 @@ rtp_twcc_manager_add_fci (RTPTWCCManager * twcc, GstRTCPPacket * packet)
   gint64 delta_ts_rounded;
   guint8 fb_pkt_count;
 
-  g_array_sort (twcc->recv_packets, _twcc_seqnum_sort);
-
-  /* Quick scan to remove duplicates */
-  prev = &g_array_index (twcc->recv_packets, RecvPacket, 0);
-  for (i = 1; i < twcc->recv_packets->len;) {
-    RecvPacket *cur = &g_array_index (twcc->recv_packets, RecvPacket, i);
-
-    if (prev->seqnum == cur->seqnum) {
-      GST_DEBUG ("Removing duplicate packet #%u", cur->seqnum);
-      g_array_remove_index (twcc->recv_packets, i);
-    } else {
-      prev = cur;
-      i += 1;
-    }
-  }
+  g_array_set_size (packet_chunks, 0);
+  g_array_set_size (twcc->recv_packets, twcc->recv_log_len);
 
   /* get first and last packet */
-  first = &g_array_index (twcc->recv_packets, RecvPacket, 0);
-  last =
-      &g_array_index (twcc->recv_packets, RecvPacket,
-      twcc->recv_packets->len - 1);
+  first = &twcc->recv_log[0];
+  last = &twcc->recv_log[twcc->recv_log_len - 1];
 
   packet_count = last->seqnum - first->seqnum + 1;
-  base_time = first->ts / REF_TIME_UNIT;
+  base_time = (twcc->recv_log_base_ts + first->arrival_delta) / REF_TIME_UNIT;
   fb_pkt_count = (guint8) (twcc->fb_pkt_count % G_MAXUINT8);
 
   GST_WRITE_UINT16_BE (header.base_seqnum, first->seqnum);
@@ -638,12 +686,15 @@ rtp_twcc_manager_add_fci (RTPTWCCManager * twcc, GstRTCPPacket * packet)
   twcc->expected_recv_seqnum = first->seqnum + packet_count;
 
   /* calculate all deltas and check for gaps etc */
-  prev = first;
-  for (i = 0; i < twcc->recv_packets->len; i++) {
+  prev = NULL;
+  for (i = 0; i < twcc->recv_log_len; i++) {
+    RecvArrival *arrival = &twcc->recv_log[i];
     RecvPacket *pkt = &g_array_index (twcc->recv_packets, RecvPacket, i);
-    if (i != 0) {
-      pkt->missing_run = pkt->seqnum - prev->seqnum - 1;
-    }
+
+    pkt->seqnum = arrival->seqnum;
+    pkt->ts = twcc->recv_log_base_ts + arrival->arrival_delta;
+    pkt->missing_run = prev ? pkt->seqnum - prev->seqnum - 1 : 0;
+    pkt->equal_run = 0;
 
     delta_ts = GST_CLOCK_DIFF (ts_rounded, pkt->ts);
     pkt->delta = delta_ts / DELTA_UNIT;
@@ -698,8 +749,8 @@ rtp_twcc_manager_add_fci (RTPTWCCManager * twcc, GstRTCPPacket * packet)
       packet_chunks_size);
   GST_MEMDUMP ("full fci:", fci_data, fci_length);
 
-  g_array_unref (packet_chunks);
   g_array_set_size (twcc->recv_packets, 0);
+  twcc->recv_log_len = 0;
 }
 
 static void
@@ -732,26 +783,40 @@ rtp_twcc_manager_create_feedback (RTPTWCCManager * twcc)
 static gboolean
 _exceeds_max_packets (RTPTWCCManager * twcc, guint16 seqnum)
 {
-  if (twcc->recv_packets->len + 1 > twcc->max_packets_per_rtcp)
+  if (twcc->recv_log_len + 1 > twcc->max_packets_per_rtcp)
     return TRUE;
 
   return FALSE;
 }
 
+/* the arrival log stores times relative to its first packet in 32 bits,
+   which covers a bit more than 2 seconds either way */
+static gboolean
+_exceeds_arrival_log_span (RTPTWCCManager * twcc, GstClockTime ts)
+{
+  GstClockTimeDiff diff;
+
+  if (twcc->recv_log_len == 0)
+    return FALSE;
+
+  diff = GST_CLOCK_DIFF (twcc->recv_log_base_ts, ts);
+  return diff < G_MININT32 || diff > G_MAXINT32;
+}
+
 /* in this case we could have lost the packet with the marker bit,
    so with a large (30) amount of packets, lost packets and still no marker,
    we send a feedback anyway */
 static gboolean
 _many_packets_some_lost (RTPTWCCManager * twcc, guint16 seqnum)
 {
-  RecvPacket *first;
+  RecvArrival *first;
   guint16 packet_count;
-  guint received_packets = twcc->recv_packets->len;
+  guint received_packets = twcc->recv_log_len;
   guint lost_packets;
   if (received_packets == 0)
     return FALSE;
 
-  first = &g_array_index (twcc->recv_packets, RecvPacket, 0);
+  first = &twcc->recv_log[0];
   packet_count = seqnum - first->seqnum + 1;
 
   /* If there are a high number of duplicates, we can't use the following
@@ -775,7 +840,7 @@ gboolean
 rtp_twcc_manager_recv_packet (RTPTWCCManager * twcc, RTPPacketInfo * pinfo)
 {
   gboolean send_feedback = FALSE;
-  RecvPacket packet;
+  GstClockTime ts;
   gint32 seqnum;
   gint diff;
 
@@ -783,6 +848,8 @@ rtp_twcc_manager_recv_packet (RTPTWCCManager * twcc, RTPPacketInfo * pinfo)
   if (seqnum == -1)
     return FALSE;
 
+  ts = _get_arrival_time (pinfo);
+
   /* if this packet would exceed the capacity of our MTU, we create a feedback
      with the current packets, and start over with this one */
   if (_exceeds_max_packets (twcc, seqnum)) {
@@ -790,6 +857,11 @@ rtp_twcc_manager_recv_packet (RTPTWCCManager * twcc, RTPPacketInfo * pinfo)
         " with current packets", seqnum, twcc->max_packets_per_rtcp);
     rtp_twcc_manager_create_feedback (twcc);
     send_feedback = TRUE;
+  } else if (_exceeds_arrival_log_span (twcc, ts)) {
+    GST_INFO ("twcc-seqnum: %u arrived too far apart from the current packets,"
+        " create feedback with current packets", seqnum);
+    rtp_twcc_manager_create_feedback (twcc);
+    send_feedback = TRUE;
   }
 
   /* we can have multiple ssrcs here, so just pick the first one */
@@ -807,8 +879,7 @@ rtp_twcc_manager_recv_packet (RTPTWCCManager * twcc, RTPPacketInfo * pinfo)
   }
 
   /* store the packet for Transport-wide RTCP feedback message */
-  recv_packet_init (&packet, seqnum, pinfo);
-  g_array_append_val (twcc->recv_packets, packet);
+  rtp_twcc_manager_log_arrival (twcc, seqnum, ts);
   twcc->last_seqnum = seqnum;
 
   GST_LOG ("Receive: twcc-seqnum: %u, pt: %u, marker: %d, ts: %"
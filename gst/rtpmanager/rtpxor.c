@@ -0,0 +1,84 @@
+/* GStreamer RTP Manager
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "rtpxor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_XOR_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define HAVE_XOR_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_XOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* XORs @length bytes of @src into @dst, as used by the ULPFEC and
+ * ST 2022-1 FEC elements.
+ *
+ * The widest vector unit the compiler targets is used for the bulk of the
+ * data, followed by 64 bit words and finally single bytes for the tail.
+ * Neither pointer needs to be aligned. */
+void
+rtp_xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
+{
+  gsize i = 0;
+
+#if defined(HAVE_XOR_AVX2)
+  for (; i + 32 <= length; i += 32) {
+    __m256i d = _mm256_loadu_si256 ((const __m256i *) (dst + i));
+    __m256i s = _mm256_loadu_si256 ((const __m256i *) (src + i));
+
+    _mm256_storeu_si256 ((__m256i *) (dst + i), _mm256_xor_si256 (d, s));
+  }
+#endif
+
+#if defined(HAVE_XOR_SSE2)
+  for (; i + 16 <= length; i += 16) {
+    __m128i d = _mm_loadu_si128 ((const __m128i *) (dst + i));
+    __m128i s = _mm_loadu_si128 ((const __m128i *) (src + i));
+
+    _mm_storeu_si128 ((__m128i *) (dst + i), _mm_xor_si128 (d, s));
+  }
+#elif defined(HAVE_XOR_NEON)
+  for (; i + 16 <= length; i += 16)
+    vst1q_u8 (dst + i, veorq_u8 (vld1q_u8 (dst + i), vld1q_u8 (src + i)));
+#endif
+
+  for (; i + sizeof (guint64) <= length; i += sizeof (guint64)) {
+    guint64 d, s;
+
+    memcpy (&d, dst + i, sizeof (guint64));
+    memcpy (&s, src + i, sizeof (guint64));
+    d ^= s;
+    memcpy (dst + i, &d, sizeof (guint64));
+  }
+
+  for (; i < length; i++)
+    dst[i] ^= src[i];
+}
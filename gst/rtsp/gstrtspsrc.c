@@ -107,6 +107,10 @@
 #include <stdio.h>
 #include <stdarg.h>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 #include <gst/net/gstnet.h>
 #include <gst/sdp/gstsdpmessage.h>
 #include <gst/sdp/gstmikey.h>
@@ -312,6 +316,8 @@ gst_rtsp_backchannel_get_type (void)
 #define DEFAULT_ONVIF_RATE_CONTROL TRUE
 #define DEFAULT_IS_LIVE TRUE
 #define DEFAULT_IGNORE_X_SERVER_REPLY FALSE
+#define DEFAULT_PIPELINED_SETUP FALSE
+#define DEFAULT_SHARE_AUTH FALSE
 
 enum
 {
@@ -361,7 +367,10 @@ enum
   PROP_ONVIF_MODE,
   PROP_ONVIF_RATE_CONTROL,
   PROP_IS_LIVE,
-  PROP_IGNORE_X_SERVER_REPLY
+  PROP_IGNORE_X_SERVER_REPLY,
+  PROP_PIPELINED_SETUP,
+  PROP_SHARE_AUTH,
+  PROP_STATS
 };
 
 #define GST_TYPE_RTSP_NAT_METHOD (gst_rtsp_nat_method_get_type())
@@ -420,6 +429,7 @@ static void gst_rtspsrc_handle_message (GstBin * bin, GstMessage * message);
 
 static gboolean gst_rtspsrc_setup_auth (GstRTSPSrc * src,
     GstRTSPMessage * response);
+static void gst_rtspsrc_auth_cache_clear_pending (GstRTSPSrc * src);
 
 static gboolean gst_rtspsrc_loop_send_cmd (GstRTSPSrc * src, gint cmd,
     gint mask);
@@ -1093,6 +1103,74 @@ gst_rtspsrc_class_init (GstRTSPSrcClass * klass)
           DEFAULT_IGNORE_X_SERVER_REPLY,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPSrc:pipelined-setup:
+   *
+   * With RTSP 1.0, send the SETUP requests of all the streams but the first
+   * one back-to-back and only then collect the responses, instead of waiting
+   * for each response before sending the next request. The first SETUP is
+   * still done on its own so that the session and the transport are known
+   * for the other ones.
+   *
+   * This only applies when all the streams are set up over the aggregate
+   * connection. The streams the server did not accept this way are set up
+   * again one by one, and pipelining is not tried again for this element.
+   *
+   * RTSP 2.0 always pipelines SETUP requests.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PIPELINED_SETUP,
+      g_param_spec_boolean ("pipelined-setup", "Pipelined SETUP",
+          "Send the SETUP requests of the streams without waiting for the "
+          "previous responses", DEFAULT_PIPELINED_SETUP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPSrc:share-auth:
+   *
+   * Remember the authentication negotiated with a server, and use it for the
+   * first request of the other rtspsrc instances connecting to the same
+   * server with the same user, which then don't need to wait for a challenge
+   * from the server. When the server rejects it, the authentication is
+   * negotiated again as usual.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARE_AUTH,
+      g_param_spec_boolean ("share-auth", "Share authentication",
+          "Share the authentication with other instances connecting to the "
+          "same server", DEFAULT_SHARE_AUTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPSrc:stats:
+   *
+   * The startup timeline, to measure where the time until media flows goes.
+   * This property returns a #GstStructure with name
+   * `application/x-rtspsrc-stats` with the following fields:
+   *
+   * * #guint64 `start-time`: gst_util_get_timestamp() when the element went
+   *   to PAUSED, the other times are relative to it.
+   * * #guint64 `connect`: when the connection to the server was made.
+   * * #guint64 `describe`: when the DESCRIBE response was received.
+   * * #guint64 `setup`: when all the streams were set up.
+   * * #guint64 `play`: when the PLAY response was received.
+   * * #GstValueArray `streams`: the startup milestones of the received
+   *   streams, as in #GstRtpBin:stats, when the manager provides them.
+   *
+   * The times are in nanoseconds and only present once reached. Each time
+   * one of the above milestones is reached, an element message named
+   * `GstRTSPSrcStartup` is posted with the name of the `milestone` and its
+   * `time`.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Startup timeline", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstRTSPSrc::handle-request:
    * @rtspsrc: a #GstRTSPSrc
@@ -1520,6 +1598,10 @@ gst_rtspsrc_init (GstRTSPSrc * src)
   src->onvif_mode = DEFAULT_ONVIF_MODE;
   src->onvif_rate_control = DEFAULT_ONVIF_RATE_CONTROL;
   src->is_live = DEFAULT_IS_LIVE;
+  src->pipelined_setup = DEFAULT_PIPELINED_SETUP;
+  src->share_auth = DEFAULT_SHARE_AUTH;
+  src->startup = gst_structure_new ("application/x-rtspsrc-stats",
+      "start-time", G_TYPE_UINT64, G_GUINT64_CONSTANT (0), NULL);
   src->seek_seqnum = GST_SEQNUM_INVALID;
   src->group_id = GST_GROUP_ID_INVALID;
 
@@ -1545,6 +1627,8 @@ gst_rtspsrc_init (GstRTSPSrc * src)
   g_mutex_init (&src->conninfo.recv_lock);
   g_cond_init (&src->cmd_cond);
 
+  src->interleaved_cancellable = g_cancellable_new ();
+
   g_mutex_init (&src->group_lock);
 
   GST_OBJECT_FLAG_SET (src, GST_ELEMENT_FLAG_SOURCE);
@@ -1575,6 +1659,7 @@ gst_rtspsrc_finalize (GObject * object)
   g_free (rtspsrc->conninfo.url_str);
   g_free (rtspsrc->user_id);
   g_free (rtspsrc->user_pw);
+  gst_rtspsrc_auth_cache_clear_pending (rtspsrc);
   g_free (rtspsrc->multi_iface);
   g_free (rtspsrc->user_agent);
 
@@ -1588,6 +1673,8 @@ gst_rtspsrc_finalize (GObject * object)
   if (rtspsrc->sdes)
     gst_structure_free (rtspsrc->sdes);
 
+  gst_structure_free (rtspsrc->startup);
+
   if (rtspsrc->tls_database)
     g_object_unref (rtspsrc->tls_database);
 
@@ -1605,6 +1692,8 @@ gst_rtspsrc_finalize (GObject * object)
   g_mutex_clear (&rtspsrc->conninfo.recv_lock);
   g_cond_clear (&rtspsrc->cmd_cond);
 
+  g_object_unref (rtspsrc->interleaved_cancellable);
+
   g_mutex_clear (&rtspsrc->group_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -1622,6 +1711,116 @@ gst_rtspsrc_provide_clock (GstElement * element)
   return GST_ELEMENT_CLASS (parent_class)->provide_clock (element);
 }
 
+static void
+gst_rtspsrc_startup_reset (GstRTSPSrc * src)
+{
+  GST_OBJECT_LOCK (src);
+  src->startup_time = gst_util_get_timestamp ();
+  gst_structure_remove_all_fields (src->startup);
+  gst_structure_set (src->startup, "start-time", G_TYPE_UINT64,
+      src->startup_time, NULL);
+  GST_OBJECT_UNLOCK (src);
+}
+
+/* Records that the startup reached @milestone, if it did not before, and
+ * posts it on the bus */
+static void
+gst_rtspsrc_startup_milestone (GstRTSPSrc * src, const gchar * milestone)
+{
+  GstClockTime elapsed;
+
+  GST_OBJECT_LOCK (src);
+  if (gst_structure_has_field (src->startup, milestone)) {
+    GST_OBJECT_UNLOCK (src);
+    return;
+  }
+  elapsed = gst_util_get_timestamp () - src->startup_time;
+  gst_structure_set (src->startup, milestone, G_TYPE_UINT64, elapsed, NULL);
+  GST_OBJECT_UNLOCK (src);
+
+  GST_DEBUG_OBJECT (src, "reached %s after %" GST_TIME_FORMAT, milestone,
+      GST_TIME_ARGS (elapsed));
+
+  gst_element_post_message (GST_ELEMENT_CAST (src),
+      gst_message_new_element (GST_OBJECT_CAST (src),
+          gst_structure_new ("GstRTSPSrcStartup",
+              "milestone", G_TYPE_STRING, milestone,
+              "time", G_TYPE_UINT64, elapsed, NULL)));
+}
+
+static gboolean
+rebase_stream_time (GQuark field_id, GValue * value, gpointer user_data)
+{
+  gint64 offset = *(gint64 *) user_data;
+
+  if (G_VALUE_HOLDS_UINT64 (value))
+    g_value_set_uint64 (value,
+        MAX ((gint64) g_value_get_uint64 (value) + offset, 0));
+
+  return TRUE;
+}
+
+static GstStructure *
+gst_rtspsrc_create_stats (GstRTSPSrc * src)
+{
+  GstStructure *s, *manager_stats = NULL;
+  GstElement *manager;
+  GValue streams = G_VALUE_INIT;
+  GstClockTime start_time;
+  const GValue *manager_streams;
+  guint64 manager_start_time;
+
+  GST_OBJECT_LOCK (src);
+  s = gst_structure_copy (src->startup);
+  start_time = src->startup_time;
+  GST_OBJECT_UNLOCK (src);
+
+  manager = gst_bin_get_by_name (GST_BIN_CAST (src), "manager");
+  if (manager) {
+    GParamSpec *pspec;
+
+    pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (manager),
+        "stats");
+    if (pspec && pspec->value_type == GST_TYPE_STRUCTURE)
+      g_object_get (manager, "stats", &manager_stats, NULL);
+    gst_object_unref (manager);
+  }
+
+  g_value_init (&streams, GST_TYPE_ARRAY);
+
+  /* put the stream milestones of the manager on our timeline */
+  if (manager_stats
+      && gst_structure_get_uint64 (manager_stats, "start-time",
+          &manager_start_time)
+      && (manager_streams = gst_structure_get_value (manager_stats, "streams"))
+      && GST_VALUE_HOLDS_ARRAY (manager_streams)) {
+    gint64 offset = (gint64) (manager_start_time - start_time);
+    guint i;
+
+    for (i = 0; i < gst_value_array_get_size (manager_streams); i++) {
+      const GValue *v = gst_value_array_get_value (manager_streams, i);
+      GValue value = G_VALUE_INIT;
+      GstStructure *stream_stats;
+
+      if (!GST_VALUE_HOLDS_STRUCTURE (v))
+        continue;
+
+      stream_stats = gst_structure_copy (gst_value_get_structure (v));
+      gst_structure_map_in_place (stream_stats, rebase_stream_time, &offset);
+
+      g_value_init (&value, GST_TYPE_STRUCTURE);
+      g_value_take_boxed (&value, stream_stats);
+      gst_value_array_append_and_take_value (&streams, &value);
+    }
+  }
+  if (manager_stats)
+    gst_structure_free (manager_stats);
+
+  gst_structure_take_value (s, "streams", &streams);
+
+  return s;
+}
+
 /* a proxy string of the format [user:passwd@]host[:port] */
 static gboolean
 gst_rtspsrc_set_proxy (GstRTSPSrc * rtsp, const gchar * proxy)
@@ -1867,6 +2066,12 @@ gst_rtspsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_IGNORE_X_SERVER_REPLY:
       rtspsrc->ignore_x_server_reply = g_value_get_boolean (value);
       break;
+    case PROP_PIPELINED_SETUP:
+      rtspsrc->pipelined_setup = g_value_get_boolean (value);
+      break;
+    case PROP_SHARE_AUTH:
+      rtspsrc->share_auth = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2040,6 +2245,15 @@ gst_rtspsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_IGNORE_X_SERVER_REPLY:
       g_value_set_boolean (value, rtspsrc->ignore_x_server_reply);
       break;
+    case PROP_PIPELINED_SETUP:
+      g_value_set_boolean (value, rtspsrc->pipelined_setup);
+      break;
+    case PROP_SHARE_AUTH:
+      g_value_set_boolean (value, rtspsrc->share_auth);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_rtspsrc_create_stats (rtspsrc));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -5284,6 +5498,177 @@ accept_certificate_cb (GTlsConnection * conn, GTlsCertificate * peer_cert,
   return accept;
 }
 
+/* Authentication shared between the instances with the share-auth property,
+ * indexed by "user@host:port". Only the most recently used servers are kept */
+#define AUTH_CACHE_MAX_ENTRIES 64
+
+typedef struct
+{
+  gchar *key;
+  GstRTSPAuthMethod method;
+  GPtrArray *params;
+} GstRTSPAuthCacheEntry;
+
+static GMutex auth_cache_lock;
+/* key -> link of the entry in auth_cache_lru */
+static GHashTable *auth_cache;
+/* most recently used first */
+static GQueue auth_cache_lru = G_QUEUE_INIT;
+
+static void
+auth_cache_entry_free (GstRTSPAuthCacheEntry * entry)
+{
+  g_free (entry->key);
+  g_ptr_array_unref (entry->params);
+  g_free (entry);
+}
+
+/* call with auth_cache_lock */
+static void
+auth_cache_remove_link (GList * link)
+{
+  GstRTSPAuthCacheEntry *entry = link->data;
+
+  g_hash_table_remove (auth_cache, entry->key);
+  g_queue_delete_link (&auth_cache_lru, link);
+  auth_cache_entry_free (entry);
+}
+
+static gchar *
+auth_cache_make_key (GstRTSPUrl * url, const gchar * user)
+{
+  guint16 port = 0;
+
+  gst_rtsp_url_get_port (url, &port);
+
+  return g_strdup_printf ("%s@%s:%u", user, url->host, port);
+}
+
+/* Creates the entry for @user authenticating on the server of @url with
+ * @method and, for digest, the challenge in @response */
+static GstRTSPAuthCacheEntry *
+auth_cache_entry_new (GstRTSPUrl * url, const gchar * user,
+    GstRTSPAuthMethod method, GstRTSPMessage * response)
+{
+  GstRTSPAuthCredential **credentials, **credential;
+  GstRTSPAuthCacheEntry *entry;
+
+  entry = g_new0 (GstRTSPAuthCacheEntry, 1);
+  entry->key = auth_cache_make_key (url, user);
+  entry->method = method;
+  entry->params = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_rtsp_auth_param_free);
+
+  credentials =
+      gst_rtsp_message_parse_auth_credentials (response,
+      GST_RTSP_HDR_WWW_AUTHENTICATE);
+  for (credential = credentials; credential && *credential; credential++) {
+    GstRTSPAuthParam **param;
+
+    if (method != GST_RTSP_AUTH_DIGEST
+        || (*credential)->scheme != GST_RTSP_AUTH_DIGEST)
+      continue;
+
+    /* like gst_rtspsrc_parse_auth_hdr(), the last challenge wins */
+    g_ptr_array_set_size (entry->params, 0);
+    for (param = (*credential)->params; *param; param++)
+      g_ptr_array_add (entry->params, gst_rtsp_auth_param_copy (*param));
+  }
+  if (credentials)
+    gst_rtsp_auth_credentials_free (credentials);
+
+  return entry;
+}
+
+/* Shares @entry with the other instances, takes ownership of it */
+static void
+gst_rtspsrc_auth_cache_store (GstRTSPAuthCacheEntry * entry)
+{
+  GList *link;
+
+  g_mutex_lock (&auth_cache_lock);
+  if (auth_cache == NULL)
+    auth_cache = g_hash_table_new (g_str_hash, g_str_equal);
+  if ((link = g_hash_table_lookup (auth_cache, entry->key)))
+    auth_cache_remove_link (link);
+  g_queue_push_head (&auth_cache_lru, entry);
+  g_hash_table_insert (auth_cache, entry->key, auth_cache_lru.head);
+  if (auth_cache_lru.length > AUTH_CACHE_MAX_ENTRIES)
+    auth_cache_remove_link (auth_cache_lru.tail);
+  g_mutex_unlock (&auth_cache_lock);
+}
+
+static void
+gst_rtspsrc_auth_cache_remove (GstRTSPUrl * url, const gchar * user)
+{
+  gchar *key = auth_cache_make_key (url, user);
+  GList *link;
+
+  g_mutex_lock (&auth_cache_lock);
+  if (auth_cache && (link = g_hash_table_lookup (auth_cache, key)))
+    auth_cache_remove_link (link);
+  g_mutex_unlock (&auth_cache_lock);
+
+  g_free (key);
+}
+
+static void
+gst_rtspsrc_auth_cache_clear_pending (GstRTSPSrc * src)
+{
+  if (src->auth_cache_pending) {
+    auth_cache_entry_free (src->auth_cache_pending);
+    src->auth_cache_pending = NULL;
+  }
+}
+
+/* Configure the new connection of @info with the authentication other
+ * instances used for the same server and user, so that the first request
+ * does not have to be rejected by the server first */
+static void
+gst_rtspsrc_auth_cache_apply (GstRTSPSrc * src, GstRTSPConnInfo * info)
+{
+  GstRTSPAuthCacheEntry *entry = NULL;
+  const gchar *user, *pass;
+  GList *link;
+  gchar *key;
+  guint i;
+
+  /* same credentials as gst_rtspsrc_setup_auth() tries first */
+  if (info->url->user != NULL && info->url->passwd != NULL) {
+    user = info->url->user;
+    pass = info->url->passwd;
+  } else {
+    user = src->user_id;
+    pass = src->user_pw;
+  }
+
+  if (user == NULL || pass == NULL)
+    return;
+
+  key = auth_cache_make_key (info->url, user);
+
+  g_mutex_lock (&auth_cache_lock);
+  if (auth_cache && (link = g_hash_table_lookup (auth_cache, key))) {
+    g_queue_unlink (&auth_cache_lru, link);
+    g_queue_push_head_link (&auth_cache_lru, link);
+    entry = link->data;
+  }
+  if (entry) {
+    GST_DEBUG_OBJECT (src, "using shared authentication of %s", key);
+
+    for (i = 0; i < entry->params->len; i++) {
+      GstRTSPAuthParam *param = g_ptr_array_index (entry->params, i);
+
+      gst_rtsp_connection_set_auth_param (info->connection, param->name,
+          param->value);
+    }
+    gst_rtsp_connection_set_auth (info->connection, entry->method, user, pass);
+  }
+  g_mutex_unlock (&auth_cache_lock);
+
+  g_free (key);
+}
+
 static GstRTSPResult
 gst_rtsp_conninfo_connect (GstRTSPSrc * src, GstRTSPConnInfo * info,
     gboolean async)
@@ -5342,6 +5727,9 @@ gst_rtsp_conninfo_connect (GstRTSPSrc * src, GstRTSPConnInfo * info,
         gst_rtsp_connection_set_proxy (info->connection, src->proxy_host,
             src->proxy_port);
       }
+
+      if (src->share_auth && !retry)
+        gst_rtspsrc_auth_cache_apply (src, info);
     }
 
     if (!info->connected) {
@@ -5371,6 +5759,8 @@ gst_rtsp_conninfo_connect (GstRTSPSrc * src, GstRTSPConnInfo * info,
     }
   } while (!info->connected && retry);
 
+  gst_rtspsrc_startup_milestone (src, "connect");
+
   gst_rtsp_message_unset (&response);
   return GST_RTSP_OK;
 
@@ -5443,6 +5833,12 @@ gst_rtspsrc_connection_flush (GstRTSPSrc * src, gboolean flush)
   if (src->conninfo.connection && src->conninfo.flushing != flush) {
     GST_DEBUG_OBJECT (src, "connection flush");
     gst_rtsp_connection_flush (src->conninfo.connection, flush);
+    /* also interrupt or re-enable reading interleaved data directly from
+     * the socket */
+    if (flush)
+      g_cancellable_cancel (src->interleaved_cancellable);
+    else
+      g_cancellable_reset (src->interleaved_cancellable);
     src->conninfo.flushing = flush;
   }
   for (walk = src->streams; walk; walk = g_list_next (walk)) {
@@ -5580,10 +5976,40 @@ send_error:
   }
 }
 
+/* Returns the pad for @data received on @channel of @stream, or %NULL */
+static GstPad *
+gst_rtspsrc_get_data_pad (GstRTSPStream * stream, gint channel,
+    const guint8 * data, gboolean * is_rtcp)
+{
+  GstPad *outpad = NULL;
+
+  if (channel == stream->channel[0]) {
+    outpad = stream->channelpad[0];
+    *is_rtcp = FALSE;
+  } else if (channel == stream->channel[1]) {
+    outpad = stream->channelpad[1];
+    *is_rtcp = TRUE;
+  } else {
+    *is_rtcp = FALSE;
+  }
+
+  /* channels are not correct on some servers, do extra check */
+  if (data[1] >= 200 && data[1] <= 204) {
+    /* hmm RTCP message switch to the RTCP pad of the same stream. */
+    outpad = stream->channelpad[1];
+    *is_rtcp = TRUE;
+  }
+
+  return outpad;
+}
+
+static GstFlowReturn gst_rtspsrc_push_data (GstRTSPSrc * src,
+    GstRTSPStream * stream, GstPad * outpad, gboolean is_rtcp,
+    GstBuffer * buf, GstBufferList * list);
+
 static GstFlowReturn
 gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
 {
-  GstFlowReturn ret = GST_FLOW_OK;
   gint channel;
   GstRTSPStream *stream;
   GstPad *outpad = NULL;
@@ -5598,27 +6024,12 @@ gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
   if (!stream)
     goto unknown_stream;
 
-  if (channel == stream->channel[0]) {
-    outpad = stream->channelpad[0];
-    is_rtcp = FALSE;
-  } else if (channel == stream->channel[1]) {
-    outpad = stream->channelpad[1];
-    is_rtcp = TRUE;
-  } else {
-    is_rtcp = FALSE;
-  }
-
   /* take a look at the body to figure out what we have */
   gst_rtsp_message_get_body (message, &data, &size);
   if (size < 2)
     goto invalid_length;
 
-  /* channels are not correct on some servers, do extra check */
-  if (data[1] >= 200 && data[1] <= 204) {
-    /* hmm RTCP message switch to the RTCP pad of the same stream. */
-    outpad = stream->channelpad[1];
-    is_rtcp = TRUE;
-  }
+  outpad = gst_rtspsrc_get_data_pad (stream, channel, data, &is_rtcp);
 
   /* we have no clue what this is, just ignore then. */
   if (outpad == NULL)
@@ -5640,6 +6051,31 @@ gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
   GST_DEBUG_OBJECT (src, "pushing data of size %d on channel %d", size,
       channel);
 
+  return gst_rtspsrc_push_data (src, stream, outpad, is_rtcp, buf, NULL);
+
+  /* ERRORS */
+unknown_stream:
+  {
+    GST_DEBUG_OBJECT (src, "unknown stream on channel %d, ignored", channel);
+    gst_rtsp_message_unset (message);
+    return GST_FLOW_OK;
+  }
+invalid_length:
+  {
+    GST_ELEMENT_WARNING (src, RESOURCE, READ, (NULL),
+        ("Short message received, ignoring."));
+    gst_rtsp_message_unset (message);
+    return GST_FLOW_OK;
+  }
+}
+
+/* Pushes @buf, or all buffers of @list, on @outpad of @stream */
+static GstFlowReturn
+gst_rtspsrc_push_data (GstRTSPSrc * src, GstRTSPStream * stream,
+    GstPad * outpad, gboolean is_rtcp, GstBuffer * buf, GstBufferList * list)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
   if (src->need_activate) {
     gchar *stream_id;
     GstEvent *event;
@@ -5777,45 +6213,265 @@ gst_rtspsrc_handle_data (GstRTSPSrc * src, GstRTSPMessage * message)
   }
 
   if (stream->discont && !is_rtcp) {
+    GstBuffer *first = list ? gst_buffer_list_get_writable (list, 0) : buf;
+
     /* mark first RTP buffer as discont */
-    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
+    GST_BUFFER_FLAG_SET (first, GST_BUFFER_FLAG_DISCONT);
     stream->discont = FALSE;
     /* first buffer gets the timestamp, other buffers are not timestamped and
      * their presentation time will be interpollated from the rtp timestamps. */
     GST_DEBUG_OBJECT (src, "setting timestamp %" GST_TIME_FORMAT,
         GST_TIME_ARGS (src->base_time));
 
-    GST_BUFFER_TIMESTAMP (buf) = src->base_time;
+    GST_BUFFER_TIMESTAMP (first) = src->base_time;
   }
 
   /* chain to the peer pad */
-  if (GST_PAD_IS_SINK (outpad))
-    ret = gst_pad_chain (outpad, buf);
-  else
-    ret = gst_pad_push (outpad, buf);
+  if (list) {
+    if (GST_PAD_IS_SINK (outpad))
+      ret = gst_pad_chain_list (outpad, list);
+    else
+      ret = gst_pad_push_list (outpad, list);
+  } else {
+    if (GST_PAD_IS_SINK (outpad))
+      ret = gst_pad_chain (outpad, buf);
+    else
+      ret = gst_pad_push (outpad, buf);
+  }
 
   if (!is_rtcp) {
     /* combine all stream flows for the data transport */
     ret = gst_rtspsrc_combine_flows (src, stream, ret);
   }
   return ret;
+}
+
+/* Size of the chunks in which interleaved data is read, large enough for
+ * the biggest data packet */
+#define INTERLEAVED_READ_SIZE (128 * 1024)
+
+/* Linux can drop already peeked data from a TCP socket without copying it
+ * again, elsewhere it is read a second time in place */
+#ifdef __linux__
+#define INTERLEAVED_CONSUME_FLAGS MSG_TRUNC
+#else
+#define INTERLEAVED_CONSUME_FLAGS 0
+#endif
+
+/* Reads the data packets at the head of the connection straight from its
+ * socket, in one go, into @memory. The data is peeked into @memory first,
+ * so that only complete data packets are consumed and anything else is left
+ * for gst_rtsp_connection_receive(). @memory is set to %NULL when there is
+ * no complete data packet to read or the connection can't be read directly,
+ * because of TLS or tunneling.
+ *
+ * Must be called with the receive lock. */
+static GstRTSPResult
+gst_rtspsrc_read_interleaved (GstRTSPSrc * src, GstMemory ** memory,
+    gint64 timeout)
+{
+  GstRTSPConnection *conn = src->conninfo.connection;
+  GSocket *socket;
+  GInputVector vec;
+  gint flags = G_SOCKET_MSG_PEEK;
+  GError *err = NULL;
+  GstMapInfo map;
+  gssize avail, len;
+  gsize size = 0, offset = 0;
+
+  *memory = NULL;
+
+  if (gst_rtsp_connection_is_tunneled (conn) ||
+      (src->conninfo.url->transports & GST_RTSP_LOWER_TRANS_TLS))
+    return GST_RTSP_OK;
+
+  socket = gst_rtsp_connection_get_read_socket (conn);
+  if (socket == NULL)
+    return GST_RTSP_OK;
+
+  /* a timeout of 0 means no timeout for the connection */
+  if (!g_socket_condition_timed_wait (socket, G_IO_IN,
+          timeout > 0 ? timeout : -1, src->interleaved_cancellable, &err))
+    goto wait_failed;
+
+  /* on EOF or errors, let the connection find out */
+  avail = g_socket_get_available_bytes (socket);
+  if (avail <= 0)
+    return GST_RTSP_OK;
+
+  *memory = gst_allocator_alloc (NULL, MIN (avail, INTERLEAVED_READ_SIZE),
+      NULL);
+  gst_memory_map (*memory, &map, GST_MAP_WRITE);
+
+  vec.buffer = map.data;
+  vec.size = map.size;
+  len = g_socket_receive_message (socket, NULL, &vec, 1, NULL, NULL, &flags,
+      src->interleaved_cancellable, &err);
+
+  /* find the complete data packets */
+  while (len > 0 && size + 4 <= (gsize) len && map.data[size] == '$') {
+    gsize packet_size = 4 + GST_READ_UINT16_BE (map.data + size + 2);
+
+    if (size + packet_size > (gsize) len)
+      break;
+    size += packet_size;
+  }
+
+  /* and consume them, they are already in place */
+  while (offset < size) {
+    vec.buffer = map.data + offset;
+    vec.size = size - offset;
+    flags = INTERLEAVED_CONSUME_FLAGS;
+    len = g_socket_receive_message (socket, NULL, &vec, 1, NULL, NULL,
+        &flags, src->interleaved_cancellable, &err);
+    if (len <= 0)
+      break;
+    offset += len;
+  }
+  gst_memory_unmap (*memory, &map);
+
+  if (size == 0 || offset < size) {
+    gst_memory_unref (*memory);
+    *memory = NULL;
+    if (len < 0 || offset < size)
+      goto read_failed;
+    return GST_RTSP_OK;
+  }
+
+  gst_memory_resize (*memory, 0, size);
+
+  return GST_RTSP_OK;
 
   /* ERRORS */
-unknown_stream:
+wait_failed:
   {
-    GST_DEBUG_OBJECT (src, "unknown stream on channel %d, ignored", channel);
-    gst_rtsp_message_unset (message);
-    return GST_FLOW_OK;
+    GstRTSPResult res;
+
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT))
+      res = GST_RTSP_ETIMEOUT;
+    else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      res = GST_RTSP_EINTR;
+    else
+      res = GST_RTSP_ESYS;
+
+    GST_DEBUG_OBJECT (src, "waiting for data failed: %s", err->message);
+    g_clear_error (&err);
+    return res;
   }
-invalid_length:
+read_failed:
   {
-    GST_ELEMENT_WARNING (src, RESOURCE, READ, (NULL),
-        ("Short message received, ignoring."));
-    gst_rtsp_message_unset (message);
-    return GST_FLOW_OK;
+    GstRTSPResult res;
+
+    if (err == NULL)
+      res = GST_RTSP_EEOF;
+    else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      res = GST_RTSP_EINTR;
+    else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+      /* spurious wakeup, let the connection wait */
+      res = GST_RTSP_OK;
+    else
+      res = GST_RTSP_ESYS;
+
+    GST_DEBUG_OBJECT (src, "reading data failed: %s",
+        err ? err->message : "EOF");
+    g_clear_error (&err);
+    return res;
   }
 }
 
+typedef struct
+{
+  GstRTSPStream *stream;
+  GstPad *outpad;
+  gboolean is_rtcp;
+  GstBufferList *list;
+} InterleavedGroup;
+
+/* Pushes the data packets in @memory as sub-buffers, grouped in one buffer
+ * list per pad */
+static GstFlowReturn
+gst_rtspsrc_handle_interleaved (GstRTSPSrc * src, GstMemory * memory)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  InterleavedGroup groups[16];
+  guint n_groups = 0, i;
+  GstMapInfo map;
+  gsize offset = 0;
+
+  gst_memory_map (memory, &map, GST_MAP_READ);
+
+  while (offset < map.size) {
+    gint channel = map.data[offset + 1];
+    guint size = GST_READ_UINT16_BE (map.data + offset + 2);
+    const guint8 *data = map.data + offset + 4;
+    GstRTSPStream *stream;
+    GstPad *outpad;
+    gboolean is_rtcp;
+    GstBuffer *buf;
+
+    offset += 4 + size;
+
+    if (size < 2) {
+      GST_ELEMENT_WARNING (src, RESOURCE, READ, (NULL),
+          ("Short message received, ignoring."));
+      continue;
+    }
+
+    stream = find_stream (src, &channel, (gpointer) find_stream_by_channel);
+    if (stream == NULL ||
+        (outpad = gst_rtspsrc_get_data_pad (stream, channel, data,
+                &is_rtcp)) == NULL) {
+      GST_DEBUG_OBJECT (src, "unknown stream on channel %d, ignored", channel);
+      continue;
+    }
+
+    for (i = 0; i < n_groups; i++) {
+      if (groups[i].outpad == outpad)
+        break;
+    }
+    if (i == n_groups) {
+      /* more pads than we can group, push what we have so far */
+      if (n_groups == G_N_ELEMENTS (groups)) {
+        ret = gst_rtspsrc_push_data (src, groups[0].stream, groups[0].outpad,
+            groups[0].is_rtcp, NULL, groups[0].list);
+        memmove (groups, groups + 1, --n_groups * sizeof (InterleavedGroup));
+        if (ret != GST_FLOW_OK) {
+          i = 0;
+          goto done;
+        }
+        i = n_groups;
+      }
+      groups[i].stream = stream;
+      groups[i].outpad = outpad;
+      groups[i].is_rtcp = is_rtcp;
+      groups[i].list = gst_buffer_list_new ();
+      n_groups++;
+    }
+
+    buf = gst_buffer_new ();
+    gst_buffer_append_memory (buf,
+        gst_memory_share (memory, data - map.data, size));
+    gst_buffer_list_add (groups[i].list, buf);
+  }
+
+  for (i = 0; i < n_groups && ret == GST_FLOW_OK; i++) {
+    GST_DEBUG_OBJECT (src, "pushing %u packets on channel %d",
+        gst_buffer_list_length (groups[i].list),
+        groups[i].stream->channel[groups[i].is_rtcp ? 1 : 0]);
+    ret = gst_rtspsrc_push_data (src, groups[i].stream, groups[i].outpad,
+        groups[i].is_rtcp, NULL, groups[i].list);
+  }
+
+done:
+  /* drop what we could not push anymore */
+  for (; i < n_groups; i++)
+    gst_buffer_list_unref (groups[i].list);
+
+  gst_memory_unmap (memory, &map);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtspsrc_loop_interleaved (GstRTSPSrc * src)
 {
@@ -5824,6 +6480,8 @@ gst_rtspsrc_loop_interleaved (GstRTSPSrc * src)
   GstFlowReturn ret = GST_FLOW_OK;
 
   while (TRUE) {
+    GstMemory *memory = NULL;
+
     gst_rtsp_message_unset (&message);
 
     if (src->conninfo.flushing) {
@@ -5832,12 +6490,30 @@ gst_rtspsrc_loop_interleaved (GstRTSPSrc * src)
     } else {
       /* protect the connection with the connection lock so that we can see when
        * we are finished doing server communication */
-      res = gst_rtspsrc_connection_receive (src, &src->conninfo, &message,
-          src->tcp_timeout);
+      g_mutex_lock (&src->conninfo.recv_lock);
+      if (src->conninfo.connection) {
+        /* read data packets in bulk when we can */
+        res = gst_rtspsrc_read_interleaved (src, &memory, src->tcp_timeout);
+      } else {
+        res = GST_RTSP_ERROR;
+      }
+      g_mutex_unlock (&src->conninfo.recv_lock);
+
+      /* and anything else as a message */
+      if (res == GST_RTSP_OK && memory == NULL)
+        res = gst_rtspsrc_connection_receive (src, &src->conninfo, &message,
+            src->tcp_timeout);
     }
 
     switch (res) {
       case GST_RTSP_OK:
+        if (memory) {
+          ret = gst_rtspsrc_handle_interleaved (src, memory);
+          gst_memory_unref (memory);
+          if (ret != GST_FLOW_OK)
+            goto handle_data_failed;
+          continue;
+        }
         GST_DEBUG_OBJECT (src, "we received a server message");
         break;
       case GST_RTSP_EINTR:
@@ -6561,6 +7237,10 @@ gst_rtspsrc_setup_auth (GstRTSPSrc * src, GstRTSPMessage * response)
   if (user == NULL || pass == NULL)
     goto propagate_error;
 
+  /* The server rejected what the other instances may use for it */
+  if (src->share_auth && url != NULL)
+    gst_rtspsrc_auth_cache_remove (url, user);
+
   /* Try to configure for each available authentication method, strongest to
    * weakest */
   for (method = GST_RTSP_AUTH_MAX; method != GST_RTSP_AUTH_NONE; method >>= 1) {
@@ -6582,6 +7262,13 @@ gst_rtspsrc_setup_auth (GstRTSPSrc * src, GstRTSPMessage * response)
   if (method == GST_RTSP_AUTH_NONE)
     goto no_auth_available;
 
+  /* only shared once a request was accepted with it, see gst_rtspsrc_send() */
+  if (src->share_auth && url != NULL) {
+    gst_rtspsrc_auth_cache_clear_pending (src);
+    src->auth_cache_pending = auth_cache_entry_new (url, user, method,
+        response);
+  }
+
   return TRUE;
 
 no_auth_available:
@@ -6601,9 +7288,12 @@ propagate_error:
   }
 }
 
+/* Like gst_rtsp_src_receive_response() but only posts an error for a failed
+ * receive when @post_error is %TRUE */
 static GstRTSPResult
-gst_rtsp_src_receive_response (GstRTSPSrc * src, GstRTSPConnInfo * conninfo,
-    GstRTSPMessage * response, GstRTSPStatusCode * code)
+gst_rtsp_src_receive_response_full (GstRTSPSrc * src,
+    GstRTSPConnInfo * conninfo, GstRTSPMessage * response,
+    GstRTSPStatusCode * code, gboolean post_error)
 {
   GstRTSPStatusCode thecode;
   gchar *content_base = NULL;
@@ -6684,11 +7374,13 @@ receive_error:
       {
         gchar *str = gst_rtsp_strresult (res);
 
-        if (res != GST_RTSP_EINTR) {
+        if (res == GST_RTSP_EINTR) {
+          GST_WARNING_OBJECT (src, "receive interrupted");
+        } else if (post_error) {
           GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
               ("Could not receive message. (%s)", str));
         } else {
-          GST_WARNING_OBJECT (src, "receive interrupted");
+          GST_WARNING_OBJECT (src, "could not receive message (%s)", str);
         }
         g_free (str);
         break;
@@ -6712,6 +7404,14 @@ server_eof:
   }
 }
 
+static GstRTSPResult
+gst_rtsp_src_receive_response (GstRTSPSrc * src, GstRTSPConnInfo * conninfo,
+    GstRTSPMessage * response, GstRTSPStatusCode * code)
+{
+  return gst_rtsp_src_receive_response_full (src, conninfo, response, code,
+      TRUE);
+}
+
 
 static GstRTSPResult
 gst_rtspsrc_try_send (GstRTSPSrc * src, GstRTSPConnInfo * conninfo,
@@ -6877,6 +7577,11 @@ gst_rtspsrc_send (GstRTSPSrc * src, GstRTSPConnInfo * conninfo,
     }
   } while (retry == TRUE);
 
+  if (src->auth_cache_pending && int_code != GST_RTSP_STS_UNAUTHORIZED) {
+    gst_rtspsrc_auth_cache_store (src->auth_cache_pending);
+    src->auth_cache_pending = NULL;
+  }
+
   /* If the user requested the code, let them handle errors, otherwise
    * post an error below */
   if (code != NULL)
@@ -7468,6 +8173,103 @@ gst_rtspsrc_setup_streams_end (GstRTSPSrc * src, gboolean async)
   return GST_RTSP_OK;
 }
 
+/* Receive the responses of the SETUP requests that were pipelined with
+ * RTSP 1.0, in the order the requests were sent. The streams the server did
+ * not set up this way are returned in @failed, to be set up again one by
+ * one. When the responses can't be received, because the server closed the
+ * connection or did not answer in time, all the streams still waiting for a
+ * response are returned in @failed and the connection is reopened, as late
+ * responses would otherwise be taken for the ones of the next requests. */
+static GstRTSPResult
+gst_rtspsrc_setup_streams_collect (GstRTSPSrc * src,
+    GstRTSPLowerTrans * protocols, GList ** failed)
+{
+  GList *walk;
+  GstRTSPResult res = GST_RTSP_OK;
+  GstRTSPResult rres = GST_RTSP_OK;
+
+  for (walk = src->streams; walk; walk = g_list_next (walk)) {
+    GstRTSPStream *stream = (GstRTSPStream *) walk->data;
+    GstRTSPMessage response = { 0, };
+    GstRTSPStatusCode code = GST_RTSP_STS_OK;
+    GstRTSPResult sres;
+
+    if (!stream->waiting_setup_response)
+      continue;
+
+    if (res < 0 || rres == GST_RTSP_EINTR) {
+      stream->waiting_setup_response = FALSE;
+      continue;
+    }
+
+    if (rres == GST_RTSP_OK)
+      rres = gst_rtsp_src_receive_response_full (src, &src->conninfo,
+          &response, &code, FALSE);
+    if (rres == GST_RTSP_EINTR) {
+      res = rres;
+      stream->waiting_setup_response = FALSE;
+      continue;
+    }
+
+    if (rres == GST_RTSP_OK && code == GST_RTSP_STS_OK) {
+      sres = gst_rtsp_src_setup_stream_from_response (src, stream,
+          &response, protocols, 0, NULL, NULL);
+      if (sres == GST_RTSP_ERROR)
+        res = sres;
+      if (sres != GST_RTSP_ELAST)
+        continue;
+    }
+    gst_rtsp_message_unset (&response);
+
+    GST_DEBUG_OBJECT (src, "pipelined SETUP of stream %p failed (%d, %d)",
+        stream, rres, code);
+    gst_rtspsrc_stream_free_udp (stream);
+    stream->waiting_setup_response = FALSE;
+    *failed = g_list_append (*failed, stream);
+  }
+
+  if (res < 0)
+    return res;
+
+  if (*failed) {
+    GST_INFO_OBJECT (src, "server does not handle pipelined SETUP requests");
+    src->pipelined_setup_failed = TRUE;
+  }
+
+  if (rres < 0) {
+    /* the streams already set up with interleaved transport would go away
+     * with the connection */
+    if (src->interleaved)
+      goto receive_error;
+
+    GST_DEBUG_OBJECT (src, "reconnecting to set up the streams one by one");
+    if ((res = gst_rtsp_conninfo_reconnect (src, &src->conninfo, FALSE)) < 0)
+      goto reconnect_failed;
+  }
+
+  return res;
+
+  /* ERRORS */
+receive_error:
+  {
+    gchar *str = gst_rtsp_strresult (rres);
+
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("Could not receive message. (%s)", str));
+    g_free (str);
+    return rres;
+  }
+reconnect_failed:
+  {
+    gchar *str = gst_rtsp_strresult (res);
+
+    GST_ELEMENT_ERROR (src, RESOURCE, OPEN_READ_WRITE, (NULL),
+        ("Could not connect to server. (%s)", str));
+    g_free (str);
+    return res;
+  }
+}
+
 /* Perform the SETUP request for all the streams.
  *
  * We ask the server for a specific transport, which initially includes all the
@@ -7498,6 +8300,8 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
   GstRTSPUrl *url;
   gchar *hval;
   gchar *pipelined_request_id = NULL;
+  gboolean pipelined = FALSE;
+  GList *redo_streams = NULL;
 
   if (src->conninfo.connection) {
     url = gst_rtsp_connection_get_url (src->conninfo.connection);
@@ -7527,17 +8331,25 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
   if (G_UNLIKELY (src->streams == NULL))
     goto no_streams;
 
-  for (walk = src->streams; walk; walk = g_list_next (walk)) {
+  walk = src->streams;
+
+setup_streams:
+  for (; walk; walk = g_list_next (walk)) {
     GstRTSPConnInfo *conninfo;
     gchar *transports;
     gint retry = 0;
     gboolean tried_non_compliant_url = FALSE;
     guint mask = 0;
     gboolean selected;
+    gboolean pipeline;
     GstCaps *caps;
 
     stream = (GstRTSPStream *) walk->data;
 
+    /* streams set up again after a pipelined SETUP were already selected */
+    if (redo_streams)
+      goto do_setup;
+
     caps = stream_get_caps_for_pt (stream, stream->default_pt);
     if (caps == NULL) {
       GST_WARNING_OBJECT (src, "skipping stream %p, no caps", stream);
@@ -7589,6 +8401,7 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
       continue;
     }
 
+  do_setup:
     if (src->conninfo.connection == NULL) {
       if (!gst_rtsp_conninfo_connect (src, &stream->conninfo, async)) {
         GST_WARNING_OBJECT (src, "skipping stream %p, failed to connect",
@@ -7687,10 +8500,21 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
       GST_ELEMENT_PROGRESS (src, CONTINUE, "request", ("SETUP stream %d",
               stream->id));
 
+    /* with RTSP 1.0, once a first stream is set up and the session and the
+     * transport are known, we can send the other SETUP requests without
+     * waiting for their responses */
+    pipeline = pipelined_request_id != NULL;
+    if (src->pipelined_setup && !src->pipelined_setup_failed
+        && src->version < GST_RTSP_VERSION_2_0 && src->conninfo.connection
+        && src->need_activate && !retry && !tried_non_compliant_url) {
+      GST_DEBUG_OBJECT (src, "pipelining SETUP of stream %p", stream);
+      pipeline = pipelined = TRUE;
+    }
+
     /* handle the code ourselves */
     res =
         gst_rtspsrc_send (src, conninfo, &request,
-        pipelined_request_id ? NULL : &response, &code, NULL);
+        pipeline ? NULL : &response, &code, NULL);
     if (res < 0)
       goto send_error;
 
@@ -7774,7 +8598,7 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
     }
 
 
-    if (!pipelined_request_id) {
+    if (!pipeline) {
       /* parse response transport */
       res = gst_rtsp_src_setup_stream_from_response (src, stream,
           &response, &protocols, retry, &rtpport, &rtcpport);
@@ -7819,6 +8643,20 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
     gst_rtspsrc_setup_streams_end (src, TRUE);
   }
 
+  if (pipelined) {
+    pipelined = FALSE;
+
+    res = gst_rtspsrc_setup_streams_collect (src, &protocols, &redo_streams);
+    if (res < 0)
+      goto cleanup_error;
+
+    if (redo_streams) {
+      walk = redo_streams;
+      goto setup_streams;
+    }
+  }
+  g_list_free (redo_streams);
+
   /* store the transport protocol that was configured */
   src->cur_protocols = protocols;
 
@@ -7831,6 +8669,8 @@ gst_rtspsrc_setup_streams_start (GstRTSPSrc * src, gboolean async)
   if (!src->need_activate)
     goto nothing_to_activate;
 
+  gst_rtspsrc_startup_milestone (src, "setup");
+
   return res;
 
   /* ERRORS */
@@ -7839,6 +8679,7 @@ no_protocols:
     /* no transport possible, post an error and stop */
     GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
         ("Could not connect to server, no protocols left"));
+    g_list_free (redo_streams);
     return GST_RTSP_ERROR;
   }
 no_streams:
@@ -7905,6 +8746,7 @@ cleanup_error:
   {
     if (pipelined_request_id)
       g_free (pipelined_request_id);
+    g_list_free (redo_streams);
     gst_rtsp_message_unset (&request);
     gst_rtsp_message_unset (&response);
     return res;
@@ -8279,6 +9121,8 @@ restart:
     goto restart;
   }
 
+  gst_rtspsrc_startup_milestone (src, "describe");
+
   /* it could be that the DESCRIBE method was not implemented */
   if (!(src->methods & GST_RTSP_DESCRIBE))
     goto no_describe;
@@ -9067,6 +9911,8 @@ restart:
   src->base_time = -1;
   src->state = GST_RTSP_STATE_PLAYING;
 
+  gst_rtspsrc_startup_milestone (src, "play");
+
   /* mark discont */
   GST_DEBUG_OBJECT (src, "mark DISCONT, we did a seek to another position");
   for (walk = src->streams; walk; walk = g_list_next (walk)) {
@@ -9503,6 +10349,7 @@ gst_rtspsrc_change_state (GstElement * element, GstStateChange transition)
       /* first attempt, don't ignore timeouts */
       rtspsrc->ignore_timeout = FALSE;
       rtspsrc->open_error = FALSE;
+      gst_rtspsrc_startup_reset (rtspsrc);
       if (rtspsrc->is_live)
         gst_rtspsrc_loop_send_cmd (rtspsrc, CMD_OPEN, 0);
       else
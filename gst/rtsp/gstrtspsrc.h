@@ -280,12 +280,21 @@ struct _GstRTSPSrc {
   gboolean          onvif_rate_control;
   gboolean          is_live;
   gboolean          ignore_x_server_reply;
+  gboolean          pipelined_setup;
+  gboolean          share_auth;
 
   /* state */
   GstRTSPState       state;
   gchar             *content_base;
   GstRTSPLowerTrans  cur_protocols;
   gboolean           tried_url_auth;
+  /* authentication to share with share-auth once the server accepted it */
+  gpointer           auth_cache_pending;
+  gboolean           pipelined_setup_failed;
+
+  /* startup timeline, protected by the object lock */
+  GstClockTime       startup_time;
+  GstStructure      *startup;
   gchar             *addr;
   gboolean           need_redirect;
   GstRTSPTimeRange  *range;
@@ -316,6 +325,9 @@ struct _GstRTSPSrc {
 
   GstRTSPConnInfo  conninfo;
 
+  /* reading of interleaved data straight from the socket */
+  GCancellable    *interleaved_cancellable;
+
   /* SET/GET PARAMETER requests queue */
   GQueue set_get_param_q;
 
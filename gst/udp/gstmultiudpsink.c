@@ -28,6 +28,12 @@
  * multiudpsink is a network sink that sends UDP packets to multiple
  * clients.
  * It can be combined with rtp payload encoders to implement RTP streaming.
+ *
+ * When the #GstMultiUDPSink:segmentation-offload property is enabled and the
+ * kernel supports it (UDP_SEGMENT on Linux), consecutive packets of equal size
+ * from a #GstBufferList are handed to the kernel as one message per client
+ * and only split into individual datagrams by the kernel or the network
+ * device.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -44,6 +50,17 @@
 
 #include <gio/gnetworking.h>
 
+#ifdef __linux__
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#define HAVE_UDP_SEGMENT 1
+#endif
+
 #include "gst/net/net.h"
 #include "gst/glib-compat-private.h"
 
@@ -52,6 +69,9 @@ GST_DEBUG_CATEGORY_STATIC (multiudpsink_debug);
 
 #define UDP_MAX_SIZE 65507
 
+/* maximum number of datagrams the kernel splits a single message into */
+#define UDP_MAX_SEGMENTS 64
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -92,6 +112,7 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_SEGMENTATION_OFFLOAD FALSE
 
 enum
 {
@@ -114,7 +135,8 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_SEGMENTATION_OFFLOAD
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -141,6 +163,96 @@ static void gst_multiudpsink_clear_internal (GstMultiUDPSink * sink,
 
 static guint gst_multiudpsink_signals[LAST_SIGNAL] = { 0 };
 
+#ifdef HAVE_UDP_SEGMENT
+/* Control message for sending a message as multiple datagrams of
+ * segment_size bytes each */
+GType gst_udp_segment_message_get_type (void);
+
+#define GST_TYPE_UDP_SEGMENT_MESSAGE         (gst_udp_segment_message_get_type ())
+#define GST_UDP_SEGMENT_MESSAGE(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessage))
+
+typedef struct _GstUDPSegmentMessage GstUDPSegmentMessage;
+typedef struct _GstUDPSegmentMessageClass GstUDPSegmentMessageClass;
+
+struct _GstUDPSegmentMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+struct _GstUDPSegmentMessage
+{
+  GSocketControlMessage parent;
+
+  guint16 segment_size;
+};
+
+G_DEFINE_TYPE (GstUDPSegmentMessage, gst_udp_segment_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_segment_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (guint16);
+}
+
+static int
+gst_udp_segment_message_get_level (GSocketControlMessage * message)
+{
+  return SOL_UDP;
+}
+
+static int
+gst_udp_segment_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_SEGMENT;
+}
+
+static void
+gst_udp_segment_message_serialize (GSocketControlMessage * message,
+    gpointer data)
+{
+  GstUDPSegmentMessage *msg = GST_UDP_SEGMENT_MESSAGE (message);
+
+  memcpy (data, &msg->segment_size, sizeof (guint16));
+}
+
+static GSocketControlMessage *
+gst_udp_segment_message_deserialize (gint level, gint type, gsize size,
+    gpointer data)
+{
+  GstUDPSegmentMessage *message;
+
+  if (level != SOL_UDP || type != UDP_SEGMENT)
+    return NULL;
+
+  if (size < sizeof (guint16))
+    return NULL;
+
+  message = g_object_new (GST_TYPE_UDP_SEGMENT_MESSAGE, NULL);
+  memcpy (&message->segment_size, data, sizeof (guint16));
+
+  return G_SOCKET_CONTROL_MESSAGE (message);
+}
+
+static void
+gst_udp_segment_message_init (GstUDPSegmentMessage * message)
+{
+}
+
+static void
+gst_udp_segment_message_class_init (GstUDPSegmentMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_segment_message_get_size;
+  scm_class->get_level = gst_udp_segment_message_get_level;
+  scm_class->get_type = gst_udp_segment_message_get_msg_type;
+  scm_class->serialize = gst_udp_segment_message_serialize;
+  scm_class->deserialize = gst_udp_segment_message_deserialize;
+}
+#endif
+
 #define gst_multiudpsink_parent_class parent_class
 G_DEFINE_TYPE (GstMultiUDPSink, gst_multiudpsink, GST_TYPE_BASE_SINK);
 GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (multiudpsink, "multiudpsink",
@@ -351,6 +463,25 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:segmentation-offload:
+   *
+   * Coalesce consecutive packets of the same size of a buffer list into a
+   * single message per client and let the kernel or the network device split
+   * it into individual datagrams (UDP_SEGMENT). This considerably reduces the
+   * per-packet cost of sending. If the kernel does not support or rejects
+   * this, the packets are sent individually instead.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SEGMENTATION_OFFLOAD,
+      g_param_spec_boolean ("segmentation-offload", "Segmentation Offload",
+          "Send consecutive packets of the same size as one message and let "
+          "the kernel split them into datagrams (UDP GSO)",
+          DEFAULT_SEGMENTATION_OFFLOAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -399,6 +530,7 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   guint max_mem;
 
   g_mutex_init (&sink->client_lock);
+  g_mutex_init (&sink->stats_lock);
   sink->clients = NULL;
   sink->num_v4_unique = 0;
   sink->num_v4_all = 0;
@@ -419,6 +551,7 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->segmentation_offload = DEFAULT_SEGMENTATION_OFFLOAD;
 
   gst_multiudpsink_create_cancellable (sink);
 
@@ -492,25 +625,160 @@ name_resolve:
   }
 }
 
-/* call with client lock held */
 static void
 gst_udp_client_unref (GstUDPClient * client)
 {
-  if (--client->ref_count == 0) {
+  if (g_atomic_int_dec_and_test (&client->ref_count)) {
     g_object_unref (client->addr);
     g_free (client->host);
     g_slice_free (GstUDPClient, client);
   }
 }
 
-/* call with client lock held */
 static inline GstUDPClient *
 gst_udp_client_ref (GstUDPClient * client)
 {
-  ++client->ref_count;
+  g_atomic_int_inc (&client->ref_count);
   return client;
 }
 
+/* Snapshot of the client list. all_clients contains every client add_count
+ * times, unique_clients every client once, both with the IPv4 clients
+ * first. The snapshot holds a reference to each client. */
+struct _GstMultiUDPSinkClients
+{
+  gint ref_count;
+
+  guint num_v4_unique;
+  guint num_v4_all;
+  guint num_v6_unique;
+  guint num_v6_all;
+
+  GstUDPClient **all_clients;
+  GstUDPClient **unique_clients;
+};
+
+/* call with client lock held */
+static GstMultiUDPSinkClients *
+gst_multiudpsink_clients_new (GstMultiUDPSink * sink)
+{
+  GstMultiUDPSinkClients *snapshot;
+  guint num_all, num_unique, i, j, k;
+  GList *l;
+
+  num_all = sink->num_v4_all + sink->num_v6_all;
+  num_unique = sink->num_v4_unique + sink->num_v6_unique;
+
+  snapshot = g_malloc (sizeof (GstMultiUDPSinkClients) +
+      (num_all + num_unique) * sizeof (GstUDPClient *));
+  snapshot->ref_count = 1;
+  snapshot->num_v4_unique = sink->num_v4_unique;
+  snapshot->num_v4_all = sink->num_v4_all;
+  snapshot->num_v6_unique = sink->num_v6_unique;
+  snapshot->num_v6_all = sink->num_v6_all;
+  snapshot->all_clients = (GstUDPClient **) (snapshot + 1);
+  snapshot->unique_clients = snapshot->all_clients + num_all;
+
+  for (l = sink->clients, i = 0, j = 0; l != NULL; l = l->next) {
+    GstUDPClient *client = l->data;
+
+    snapshot->unique_clients[i++] = gst_udp_client_ref (client);
+    for (k = 0; k < client->add_count; ++k)
+      snapshot->all_clients[j++] = client;
+  }
+  g_assert_cmpuint (i, ==, num_unique);
+  g_assert_cmpuint (j, ==, num_all);
+
+  return snapshot;
+}
+
+static void
+gst_multiudpsink_clients_unref (GstMultiUDPSinkClients * snapshot)
+{
+  guint i;
+
+  if (!g_atomic_int_dec_and_test (&snapshot->ref_count))
+    return;
+
+  for (i = 0; i < snapshot->num_v4_unique + snapshot->num_v6_unique; ++i)
+    gst_udp_client_unref (snapshot->unique_clients[i]);
+  g_free (snapshot);
+}
+
+/* Returns a reference to the current client snapshot or NULL, without
+ * blocking on changes of the client list */
+static GstMultiUDPSinkClients *
+gst_multiudpsink_get_clients (GstMultiUDPSink * sink)
+{
+  GstMultiUDPSinkClients *snapshot;
+
+  /* announce ourselves so that a concurrent update does not free the
+   * snapshot between reading the pointer and taking the reference */
+  g_atomic_int_inc (&sink->clients_snapshot_readers);
+  snapshot = g_atomic_pointer_get (&sink->clients_snapshot);
+  if (snapshot)
+    g_atomic_int_inc (&snapshot->ref_count);
+  g_atomic_int_add (&sink->clients_snapshot_readers, -1);
+
+  return snapshot;
+}
+
+/* The send stats are written by the streaming thread and read from any
+ * thread. They are updated atomically so that sending never waits for
+ * client_lock, and only fall back to a lock of their own on platforms
+ * without 64 bit atomic operations */
+static inline void
+gst_multiudpsink_stats_add (GstMultiUDPSink * sink, guint64 * counter,
+    guint64 value)
+{
+#if GLIB_SIZEOF_VOID_P == 8
+  g_atomic_pointer_add ((gsize *) counter, value);
+#else
+  g_mutex_lock (&sink->stats_lock);
+  *counter += value;
+  g_mutex_unlock (&sink->stats_lock);
+#endif
+}
+
+static inline guint64
+gst_multiudpsink_stats_get (GstMultiUDPSink * sink, guint64 * counter)
+{
+#if GLIB_SIZEOF_VOID_P == 8
+  return (gsize) g_atomic_pointer_get ((gsize *) counter);
+#else
+  guint64 value;
+
+  g_mutex_lock (&sink->stats_lock);
+  value = *counter;
+  g_mutex_unlock (&sink->stats_lock);
+
+  return value;
+#endif
+}
+
+/* Publishes a new snapshot after the client list was changed.
+ * call with client lock held */
+static void
+gst_multiudpsink_update_clients (GstMultiUDPSink * sink)
+{
+  GstMultiUDPSinkClients *old_snapshot, *snapshot = NULL;
+
+  if (sink->clients)
+    snapshot = gst_multiudpsink_clients_new (sink);
+
+  old_snapshot = sink->clients_snapshot;
+  g_atomic_pointer_set (&sink->clients_snapshot, snapshot);
+
+  if (old_snapshot) {
+    /* readers that might still have seen the old pointer are done after
+     * a few instructions, wait for them before dropping our reference */
+    while (g_atomic_int_get (&sink->clients_snapshot_readers) > 0)
+      g_thread_yield ();
+
+    gst_multiudpsink_clients_unref (old_snapshot);
+  }
+}
+
 static gint
 client_compare (GstUDPClient * a, GstUDPClient * b)
 {
@@ -524,12 +792,17 @@ static void
 gst_multiudpsink_finalize (GObject * object)
 {
   GstMultiUDPSink *sink;
+  guint i;
 
   sink = GST_MULTIUDPSINK (object);
 
   g_list_foreach (sink->clients, (GFunc) gst_udp_client_unref, NULL);
   g_list_free (sink->clients);
 
+  if (sink->clients_snapshot)
+    gst_multiudpsink_clients_unref (sink->clients_snapshot);
+  sink->clients_snapshot = NULL;
+
   if (sink->socket)
     g_object_unref (sink->socket);
   sink->socket = NULL;
@@ -558,10 +831,22 @@ gst_multiudpsink_finalize (GObject * object)
   g_free (sink->messages);
   sink->messages = NULL;
 
+  for (i = 0; i < sink->n_seg_messages; i++) {
+    if (sink->seg_control_messages[i])
+      g_object_unref (sink->seg_control_messages[i]);
+  }
+  g_free (sink->seg_control_messages);
+  sink->seg_control_messages = NULL;
+  g_free (sink->seg_messages);
+  sink->seg_messages = NULL;
+  g_free (sink->seg_first_buffer);
+  sink->seg_first_buffer = NULL;
+
   g_free (sink->bind_address);
   sink->bind_address = NULL;
 
   g_mutex_clear (&sink->client_lock);
+  g_mutex_clear (&sink->stats_lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -634,6 +919,17 @@ gst_udp_address_get_string (GSocketAddress * addr, gchar * s, gsize size)
   return s;
 }
 
+/* Errors the kernel returns when it can't segment a message: EINVAL for
+ * segment sizes or counts it doesn't accept, EIO when the device can't
+ * checksum the segments and ENOPROTOOPT without UDP_SEGMENT support */
+static gboolean
+gst_multiudpsink_is_segmentation_error (GError * err)
+{
+  return g_error_matches (err, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT) ||
+      g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED) ||
+      g_error_matches (err, G_IO_ERROR, G_IO_ERROR_FAILED);
+}
+
 /* Wrapper around g_socket_send_messages() plus error handling (ignoring).
  * Returns FALSE if we got cancelled, otherwise TRUE. */
 static GstFlowReturn
@@ -679,7 +975,20 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
           err->message);
 
       skip = 1;
-      if (msg_size > UDP_MAX_SIZE) {
+      if (msg->num_control_messages > 0 &&
+          gst_multiudpsink_is_segmentation_error (err)) {
+        /* the kernel refused to segment the message, the caller will send
+         * the datagrams of all segmented messages separately afterwards */
+        sink->segmentation_offload_failed = TRUE;
+
+        for (i = err_idx + 1; i < num_messages; ++i, ++skip) {
+          if (messages[i].num_control_messages == 0 ||
+              messages[i].address != msg->address)
+            break;
+        }
+        GST_DEBUG_OBJECT (sink, "skipping %d segmented message(s) to same "
+            "client", skip);
+      } else if (msg->num_control_messages == 0 && msg_size > UDP_MAX_SIZE) {
         if (!sent_max_size_warning) {
           GST_ELEMENT_WARNING (sink, RESOURCE, WRITE,
               ("Attempting to send a UDP packets larger than maximum size "
@@ -714,49 +1023,185 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
   return GST_FLOW_OK;
 }
 
+#ifdef HAVE_UDP_SEGMENT
+/* Merges runs of consecutive messages of the same size into single messages
+ * that are split into the original datagrams again by the kernel. Only the
+ * last datagram of a run may be shorter than the others. The resulting
+ * messages are stored in seg_messages, the number of them is returned. */
+static guint
+gst_multiudpsink_coalesce_messages (GstMultiUDPSink * sink,
+    GstOutputMessage * msgs, guint num_msgs)
+{
+  guint i, n;
+
+  if (sink->n_seg_messages < num_msgs) {
+    guint old_n = sink->n_seg_messages;
+
+    sink->n_seg_messages = GST_ROUND_UP_16 (num_msgs);
+    sink->seg_messages = g_renew (GstOutputMessage, sink->seg_messages,
+        sink->n_seg_messages);
+    sink->seg_first_buffer = g_renew (guint, sink->seg_first_buffer,
+        sink->n_seg_messages + 1);
+    sink->seg_control_messages = g_renew (GSocketControlMessage *,
+        sink->seg_control_messages, sink->n_seg_messages);
+    for (i = old_n; i < sink->n_seg_messages; i++)
+      sink->seg_control_messages[i] = NULL;
+  }
+
+  for (i = 0, n = 0; i < num_msgs; n++) {
+    GstOutputMessage *seg = &sink->seg_messages[n];
+    gsize seg_size, total;
+    guint count = 1;
+
+    seg_size = gst_udp_calc_message_size (&msgs[i]);
+    total = seg_size;
+
+    *seg = msgs[i];
+    sink->seg_first_buffer[n] = i;
+
+    while (seg_size > 0 && i + count < num_msgs && count < UDP_MAX_SEGMENTS) {
+      gsize size = gst_udp_calc_message_size (&msgs[i + count]);
+
+      if (size == 0 || size > seg_size || total + size > UDP_MAX_SIZE)
+        break;
+
+      /* the vectors of consecutive messages are consecutive as well */
+      seg->num_vectors += msgs[i + count].num_vectors;
+      total += size;
+      count++;
+
+      /* a shorter datagram can only be the last one */
+      if (size < seg_size)
+        break;
+    }
+
+    if (count > 1) {
+      GstUDPSegmentMessage *cmsg;
+
+      if (sink->seg_control_messages[n] == NULL)
+        sink->seg_control_messages[n] =
+            g_object_new (GST_TYPE_UDP_SEGMENT_MESSAGE, NULL);
+
+      cmsg = GST_UDP_SEGMENT_MESSAGE (sink->seg_control_messages[n]);
+      cmsg->segment_size = seg_size;
+
+      seg->control_messages = &sink->seg_control_messages[n];
+      seg->num_control_messages = 1;
+    }
+
+    i += count;
+  }
+  sink->seg_first_buffer[n] = num_msgs;
+
+  return n;
+}
+
+/* Sends the datagrams of all segmented messages that were not sent because
+ * the kernel refused to segment them separately, and stops using
+ * segmentation offload from now on */
+static GstFlowReturn
+gst_multiudpsink_send_unsegmented (GstMultiUDPSink * sink,
+    GstOutputMessage * msgs, guint num_seg_msgs, guint num_addr_v4,
+    guint num_addr, guint8 * mem_nums)
+{
+  GstOutputMessage plain_msgs[UDP_MAX_SEGMENTS];
+  GstFlowReturn flow_ret = GST_FLOW_OK;
+  gboolean resent = FALSE;
+  guint i, j, k;
+
+  sink->segmentation_offload_failed = FALSE;
+
+  for (i = 0; i < num_addr && flow_ret == GST_FLOW_OK; ++i) {
+    GSocket *socket;
+
+    /* see gst_multiudpsink_render_buffers() */
+    if (sink->used_socket == NULL || i >= num_addr_v4)
+      socket = sink->used_socket_v6;
+    else
+      socket = sink->used_socket;
+
+    for (j = 0; j < num_seg_msgs && flow_ret == GST_FLOW_OK; ++j) {
+      GstOutputMessage *msg = &msgs[i * num_seg_msgs + j];
+      GOutputVector *vecs = msg->vectors;
+      guint first = sink->seg_first_buffer[j];
+      guint count = sink->seg_first_buffer[j + 1] - first;
+
+      if (msg->num_control_messages == 0 || msg->bytes_sent > 0)
+        continue;
+
+      for (k = 0; k < count; ++k) {
+        plain_msgs[k].address = msg->address;
+        plain_msgs[k].vectors = vecs;
+        plain_msgs[k].num_vectors = mem_nums[first + k];
+        plain_msgs[k].bytes_sent = 0;
+        plain_msgs[k].control_messages = NULL;
+        plain_msgs[k].num_control_messages = 0;
+        vecs += mem_nums[first + k];
+      }
+
+      flow_ret = gst_multiudpsink_send_messages (sink, socket, plain_msgs,
+          count);
+
+      for (k = 0; k < count; ++k) {
+        msg->bytes_sent += plain_msgs[k].bytes_sent;
+        if (plain_msgs[k].bytes_sent > 0)
+          resent = TRUE;
+      }
+    }
+  }
+
+  /* if the datagrams can't be sent separately either, the error was not
+   * caused by the segmentation (e.g. EINVAL for port 0) */
+  if (resent) {
+    GST_WARNING_OBJECT (sink, "UDP segmentation offload failed, disabling it");
+    sink->use_segmentation_offload = FALSE;
+  } else {
+    GST_DEBUG_OBJECT (sink, "sending unsegmented failed too, keeping "
+        "segmentation offload");
+  }
+
+  return flow_ret;
+}
+#endif
+
 static GstFlowReturn
 gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     guint num_buffers, guint8 * mem_nums, guint total_mem_num)
 {
-  GstOutputMessage *msgs;
-  gboolean send_duplicates;
+  GstOutputMessage *msgs, *tmpl_msgs;
+  gboolean send_duplicates, segmented;
+  GstMultiUDPSinkClients *snapshot;
   GstUDPClient **clients;
   GOutputVector *vecs;
   GstMapInfo *map_infos;
   GstFlowReturn flow_ret;
   guint num_addr_v4, num_addr_v6;
-  guint num_addr, num_msgs;
+  guint num_addr, num_msgs, num_tmpl_msgs;
+  guint64 bytes_served;
   guint i, j, mem;
   gsize size = 0;
-  GList *l;
 
   send_duplicates = sink->send_duplicates;
 
-  g_mutex_lock (&sink->client_lock);
+  snapshot = gst_multiudpsink_get_clients (sink);
+  if (snapshot == NULL)
+    goto no_clients;
 
   if (send_duplicates) {
-    num_addr_v4 = sink->num_v4_all;
-    num_addr_v6 = sink->num_v6_all;
+    num_addr_v4 = snapshot->num_v4_all;
+    num_addr_v6 = snapshot->num_v6_all;
+    clients = snapshot->all_clients;
   } else {
-    num_addr_v4 = sink->num_v4_unique;
-    num_addr_v6 = sink->num_v6_unique;
+    num_addr_v4 = snapshot->num_v4_unique;
+    num_addr_v6 = snapshot->num_v6_unique;
+    clients = snapshot->unique_clients;
   }
   num_addr = num_addr_v4 + num_addr_v6;
 
-  if (num_addr == 0)
+  if (num_addr == 0) {
+    gst_multiudpsink_clients_unref (snapshot);
     goto no_clients;
-
-  clients = g_newa (GstUDPClient *, num_addr);
-  for (l = sink->clients, i = 0; l != NULL; l = l->next) {
-    GstUDPClient *client = l->data;
-
-    clients[i++] = gst_udp_client_ref (client);
-    for (j = 1; send_duplicates && j < client->add_count; ++j)
-      clients[i++] = gst_udp_client_ref (client);
   }
-  g_assert_cmpuint (i, ==, num_addr);
-
-  g_mutex_unlock (&sink->client_lock);
 
   GST_LOG_OBJECT (sink, "%u buffers, %u memories -> to be sent to %u clients",
       num_buffers, total_mem_num, num_addr);
@@ -799,14 +1244,35 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   /* FIXME: how about some locking? (there wasn't any before either, but..) */
   sink->bytes_to_serve += size;
 
-  /* now copy the pre-filled num_buffer messages over to the next num_buffer
-   * messages for the next client, where we also change the target address */
-  for (i = 1; i < num_addr; ++i) {
-    for (j = 0; j < num_buffers; ++j) {
-      msgs[i * num_buffers + j] = msgs[j];
-      msgs[i * num_buffers + j].address = clients[i]->addr;
+  /* the messages that are sent to every client, either one per buffer or
+   * one per run of equally sized buffers if they get segmented */
+  tmpl_msgs = msgs;
+  num_tmpl_msgs = num_buffers;
+#ifdef HAVE_UDP_SEGMENT
+  if (sink->use_segmentation_offload && num_buffers > 1) {
+    guint num_seg_msgs;
+
+    num_seg_msgs = gst_multiudpsink_coalesce_messages (sink, msgs,
+        num_buffers);
+    if (num_seg_msgs < num_buffers) {
+      tmpl_msgs = sink->seg_messages;
+      num_tmpl_msgs = num_seg_msgs;
+      GST_LOG_OBJECT (sink, "coalesced %u buffers into %u messages",
+          num_buffers, num_seg_msgs);
+    }
+  }
+#endif
+  segmented = (tmpl_msgs != msgs);
+
+  /* now copy the pre-filled messages over to the next messages for the next
+   * client, where we also change the target address */
+  for (i = segmented ? 0 : 1; i < num_addr; ++i) {
+    for (j = 0; j < num_tmpl_msgs; ++j) {
+      msgs[i * num_tmpl_msgs + j] = tmpl_msgs[j];
+      msgs[i * num_tmpl_msgs + j].address = clients[i]->addr;
     }
   }
+  num_msgs = num_addr * num_tmpl_msgs;
 
   /* now send it! */
 
@@ -815,8 +1281,8 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
         msgs, num_msgs);
   } else {
-    guint num_msgs_v4 = num_buffers * num_addr_v4;
-    guint num_msgs_v6 = num_buffers * num_addr_v6;
+    guint num_msgs_v4 = num_tmpl_msgs * num_addr_v4;
+    guint num_msgs_v6 = num_tmpl_msgs * num_addr_v6;
 
     /* our client list is sorted with IPv4 clients first and IPv6 ones last */
     flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket,
@@ -832,25 +1298,32 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
   if (flow_ret != GST_FLOW_OK)
     goto cancelled;
 
-  /* now update stats */
-  g_mutex_lock (&sink->client_lock);
+#ifdef HAVE_UDP_SEGMENT
+  if (G_UNLIKELY (segmented && sink->segmentation_offload_failed)) {
+    flow_ret = gst_multiudpsink_send_unsegmented (sink, msgs, num_tmpl_msgs,
+        num_addr_v4, num_addr, mem_nums);
 
+    if (flow_ret != GST_FLOW_OK)
+      goto cancelled;
+  }
+#endif
+
+  /* now update stats */
+  bytes_served = 0;
   for (i = 0; i < num_addr; ++i) {
     GstUDPClient *client = clients[i];
+    guint64 bytes_sent = 0;
 
-    for (j = 0; j < num_buffers; ++j) {
-      gsize bytes_sent;
-
-      bytes_sent = msgs[i * num_buffers + j].bytes_sent;
+    for (j = 0; j < num_tmpl_msgs; ++j)
+      bytes_sent += msgs[i * num_tmpl_msgs + j].bytes_sent;
 
-      client->bytes_sent += bytes_sent;
-      client->packets_sent++;
-      sink->bytes_served += bytes_sent;
-    }
-    gst_udp_client_unref (client);
+    gst_multiudpsink_stats_add (sink, &client->bytes_sent, bytes_sent);
+    gst_multiudpsink_stats_add (sink, &client->packets_sent, num_buffers);
+    bytes_served += bytes_sent;
   }
+  gst_multiudpsink_stats_add (sink, &sink->bytes_served, bytes_served);
 
-  g_mutex_unlock (&sink->client_lock);
+  gst_multiudpsink_clients_unref (snapshot);
 
 out:
 
@@ -861,7 +1334,6 @@ out:
 
 no_clients:
   {
-    g_mutex_unlock (&sink->client_lock);
     GST_LOG_OBJECT (sink, "no clients");
     return GST_FLOW_OK;
   }
@@ -869,10 +1341,7 @@ cancelled:
   {
     GST_INFO_OBJECT (sink, "cancelled");
 
-    g_mutex_lock (&sink->client_lock);
-    for (i = 0; i < num_addr; ++i)
-      gst_udp_client_unref (clients[i]);
-    g_mutex_unlock (&sink->client_lock);
+    gst_multiudpsink_clients_unref (snapshot);
     goto out;
   }
 }
@@ -1094,6 +1563,9 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_SEGMENTATION_OFFLOAD:
+      udpsink->segmentation_offload = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1113,7 +1585,8 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_uint64 (value, udpsink->bytes_to_serve);
       break;
     case PROP_BYTES_SERVED:
-      g_value_set_uint64 (value, udpsink->bytes_served);
+      g_value_set_uint64 (value,
+          gst_multiudpsink_stats_get (udpsink, &udpsink->bytes_served));
       break;
     case PROP_SOCKET:
       g_value_set_object (value, udpsink->socket);
@@ -1167,6 +1640,9 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_SEGMENTATION_OFFLOAD:
+      g_value_set_boolean (value, udpsink->segmentation_offload);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1231,6 +1707,29 @@ invalid_family:
   }
 }
 
+#ifdef HAVE_UDP_SEGMENT
+static gboolean
+gst_multiudpsink_check_segmentation_offload (GstMultiUDPSink * sink,
+    GSocket * socket)
+{
+  GError *err = NULL;
+  gint val;
+
+  if (socket == NULL)
+    return TRUE;
+
+  /* only kernels that know about UDP_SEGMENT allow querying it */
+  if (!g_socket_get_option (socket, SOL_UDP, UDP_SEGMENT, &val, &err)) {
+    GST_WARNING_OBJECT (sink, "UDP segmentation offload not supported: %s",
+        err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+#endif
+
 /* create a socket for sending to remote machine */
 static gboolean
 gst_multiudpsink_start (GstBaseSink * bsink)
@@ -1440,6 +1939,19 @@ gst_multiudpsink_start (GstBaseSink * bsink)
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
 
+  sink->segmentation_offload_failed = FALSE;
+#ifdef HAVE_UDP_SEGMENT
+  sink->use_segmentation_offload = sink->segmentation_offload
+      && gst_multiudpsink_check_segmentation_offload (sink, sink->used_socket)
+      && gst_multiudpsink_check_segmentation_offload (sink,
+      sink->used_socket_v6);
+#else
+  if (sink->segmentation_offload)
+    GST_WARNING_OBJECT (sink, "UDP segmentation offload is not supported on "
+        "this platform");
+  sink->use_segmentation_offload = FALSE;
+#endif
+
   /* look for multicast clients and join multicast groups appropriately
      set also ttl and multicast loopback delivery appropriately  */
   for (clients = sink->clients; clients; clients = g_list_next (clients)) {
@@ -1596,6 +2108,8 @@ gst_multiudpsink_add_internal (GstMultiUDPSink * sink, const gchar * host,
   else
     ++sink->num_v6_all;
 
+  gst_multiudpsink_update_clients (sink);
+
   if (lock)
     g_mutex_unlock (&sink->client_lock);
 
@@ -1688,6 +2202,7 @@ gst_multiudpsink_remove (GstMultiUDPSink * sink, const gchar * host, gint port)
      * but keep it around until after the signal has been emitted, in case a
      * callback wants to get stats for that client or so */
     sink->clients = g_list_delete_link (sink->clients, find);
+    gst_multiudpsink_update_clients (sink);
 
     sink->clients_to_be_removed =
         g_list_prepend (sink->clients_to_be_removed, client);
@@ -1702,6 +2217,8 @@ gst_multiudpsink_remove (GstMultiUDPSink * sink, const gchar * host, gint port)
         g_list_remove (sink->clients_to_be_removed, client);
 
     gst_udp_client_unref (client);
+  } else {
+    gst_multiudpsink_update_clients (sink);
   }
   g_mutex_unlock (&sink->client_lock);
 
@@ -1732,6 +2249,7 @@ gst_multiudpsink_clear_internal (GstMultiUDPSink * sink, gboolean lock)
   sink->num_v4_all = 0;
   sink->num_v6_unique = 0;
   sink->num_v6_all = 0;
+  gst_multiudpsink_update_clients (sink);
   if (lock)
     g_mutex_unlock (&sink->client_lock);
 }
@@ -1773,8 +2291,10 @@ gst_multiudpsink_get_stats (GstMultiUDPSink * sink, const gchar * host,
   result = gst_structure_new_empty ("multiudpsink-stats");
 
   gst_structure_set (result,
-      "bytes-sent", G_TYPE_UINT64, client->bytes_sent,
-      "packets-sent", G_TYPE_UINT64, client->packets_sent,
+      "bytes-sent", G_TYPE_UINT64,
+      gst_multiudpsink_stats_get (sink, &client->bytes_sent),
+      "packets-sent", G_TYPE_UINT64,
+      gst_multiudpsink_stats_get (sink, &client->packets_sent),
       "connect-time", G_TYPE_UINT64, client->connect_time,
       "disconnect-time", G_TYPE_UINT64, client->disconnect_time, NULL);
 
@@ -37,6 +37,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstMultiUDPSink GstMultiUDPSink;
 typedef struct _GstMultiUDPSinkClass GstMultiUDPSinkClass;
+typedef struct _GstMultiUDPSinkClients GstMultiUDPSinkClients;
 
 typedef GOutputMessage GstOutputMessage;
 
@@ -48,7 +49,7 @@ typedef struct {
   gchar *host;
   gint port;
 
-  /* Per-client stats */
+  /* Per-client stats, see gst_multiudpsink_stats_add() */
   guint64 bytes_sent;
   guint64 packets_sent;
   guint64 connect_time;
@@ -67,6 +68,8 @@ struct _GstMultiUDPSink {
 
   /* client management */
   GMutex         client_lock;
+  /* for the stats where 64 bit atomic operations are not available */
+  GMutex         stats_lock;
   GList         *clients;
   guint          num_v4_unique;  /* number IPv4 clients (excluding duplicates) */
   guint          num_v4_all;     /* number IPv4 clients (including duplicates) */
@@ -74,6 +77,11 @@ struct _GstMultiUDPSink {
   guint          num_v6_all;     /* number IPv6 clients (including duplicates) */
   GList         *clients_to_be_removed;
 
+  /* immutable copy of the client list used by the streaming thread, replaced
+   * whenever the list changes so that sending never takes client_lock */
+  GstMultiUDPSinkClients *clients_snapshot;
+  gint           clients_snapshot_readers;
+
   /* pre-allocated scrap space for render function */
   GOutputVector    *vecs;
   guint             n_vecs;
@@ -82,6 +90,14 @@ struct _GstMultiUDPSink {
   GstOutputMessage *messages;
   guint             n_messages;
 
+  /* pre-allocated scrap space for UDP segmentation offload: coalesced
+   * messages, the index of the first buffer of each of them (plus one
+   * terminating entry) and the per-message segment size control messages */
+  GstOutputMessage *seg_messages;
+  guint            *seg_first_buffer;
+  GSocketControlMessage **seg_control_messages;
+  guint             n_seg_messages;
+
   /* properties */
   guint64        bytes_to_serve;
   guint64        bytes_served;
@@ -102,6 +118,11 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+  gboolean       segmentation_offload;
+
+  /* segmentation offload is usable, cleared if the kernel rejects it */
+  gboolean       use_segmentation_offload;
+  gboolean       segmentation_offload_failed;
 };
 
 struct _GstMultiUDPSinkClass {
@@ -57,6 +57,22 @@
  * number of bytes from the start of the raw udp packet and can be used to strip
  * off proprietary header, for example.
  *
+ * For high packet rates the #GstUDPSrc:batch-size property can be set to a
+ * value bigger than 1. udpsrc will then read up to that many datagrams per
+ * wakeup with a single system call where supported (recvmmsg() on Linux) and
+ * push them downstream together in a #GstBufferList.
+ *
+ * Setting the #GstUDPSrc:kernel-rx-info property makes udpsrc request the
+ * kernel receive timestamps (SO_TIMESTAMPING) and the socket receive queue
+ * drop counter (SO_RXQ_OVFL) together with each packet on Linux. The receive
+ * timestamps are attached to the buffers as #GstReferenceTimestampMeta with
+ * `timestamp/x-unix` caps for the software timestamp and
+ * `timestamp/x-unix-hw` caps for the raw hardware timestamp, if the network
+ * interface has hardware timestamping enabled. The number of packets dropped
+ * by the kernel is available in the #GstUDPSrc:stats property, which allows
+ * to distinguish drops caused by the socket buffer overflowing from
+ * downstream backpressure.
+ *
  * The udpsrc is always a live source. It does however not provide a #GstClock,
  * this is left for downstream elements such as an RTP session manager or demuxer
  * (such as an MPEG demuxer). As with all live sources, the captured buffers
@@ -127,6 +143,11 @@
 #include <netinet/ip.h>
 #endif
 
+#if defined(__linux__) && defined(SO_TIMESTAMPING)
+#include <linux/net_tstamp.h>
+#define HAVE_SO_TIMESTAMPING 1
+#endif
+
 /* Control messages for getting the destination address */
 #ifdef IP_PKTINFO
 GType gst_ip_pktinfo_message_get_type (void);
@@ -507,6 +528,179 @@ gst_socket_timestamp_message_class_init (GstSocketTimestampMessageClass * class)
 }
 #endif
 
+#ifdef HAVE_SO_TIMESTAMPING
+GType gst_socket_timestamping_message_get_type (void);
+
+#define GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE          (gst_socket_timestamping_message_get_type ())
+#define GST_SOCKET_TIMESTAMPING_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE, GstSocketTimestampingMessage))
+#define GST_SOCKET_TIMESTAMPING_MESSAGE_CLASS(c)      (G_TYPE_CHECK_CLASS_CAST ((c), GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE, GstSocketTimestampingMessageClass))
+#define GST_IS_SOCKET_TIMESTAMPING_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE))
+#define GST_IS_SOCKET_TIMESTAMPING_MESSAGE_CLASS(c)   (G_TYPE_CHECK_CLASS_TYPE ((c), GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE))
+#define GST_SOCKET_TIMESTAMPING_MESSAGE_GET_CLASS(o)  (G_TYPE_INSTANCE_GET_CLASS ((o), GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE, GstSocketTimestampingMessageClass))
+
+typedef struct _GstSocketTimestampingMessage GstSocketTimestampingMessage;
+typedef struct _GstSocketTimestampingMessageClass GstSocketTimestampingMessageClass;
+
+struct _GstSocketTimestampingMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+/* Layout of struct scm_timestamping: ts[0] is the software timestamp, ts[1]
+ * is unused and ts[2] is the raw hardware timestamp */
+struct _GstSocketTimestampingMessage
+{
+  GSocketControlMessage parent;
+  struct timespec ts[3];
+};
+
+G_DEFINE_TYPE (GstSocketTimestampingMessage, gst_socket_timestamping_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_socket_timestamping_message_get_size (GSocketControlMessage * message)
+{
+  return 3 * sizeof (struct timespec);
+}
+
+static int
+gst_socket_timestamping_message_get_level (GSocketControlMessage * message)
+{
+  return SOL_SOCKET;
+}
+
+static int
+gst_socket_timestamping_message_get_msg_type (GSocketControlMessage * message)
+{
+  return SCM_TIMESTAMPING;
+}
+
+static GSocketControlMessage *
+gst_socket_timestamping_message_deserialize (gint level,
+    gint type, gsize size, gpointer data)
+{
+  GstSocketTimestampingMessage *message;
+
+  if (level != SOL_SOCKET
+      || type != gst_socket_timestamping_message_get_msg_type (NULL))
+    return NULL;
+
+  if (size < 3 * sizeof (struct timespec))
+    return NULL;
+
+  message = g_object_new (GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE, NULL);
+  memcpy (&message->ts, data, 3 * sizeof (struct timespec));
+
+  return G_SOCKET_CONTROL_MESSAGE (message);
+}
+
+static void
+gst_socket_timestamping_message_init (GstSocketTimestampingMessage * message)
+{
+}
+
+static void
+gst_socket_timestamping_message_class_init (GstSocketTimestampingMessageClass
+    * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_socket_timestamping_message_get_size;
+  scm_class->get_level = gst_socket_timestamping_message_get_level;
+  scm_class->get_type = gst_socket_timestamping_message_get_msg_type;
+  scm_class->deserialize = gst_socket_timestamping_message_deserialize;
+}
+
+static GstStaticCaps kernel_rx_timestamp_caps =
+GST_STATIC_CAPS ("timestamp/x-unix");
+static GstStaticCaps kernel_rx_hw_timestamp_caps =
+GST_STATIC_CAPS ("timestamp/x-unix-hw");
+#endif
+
+#ifdef SO_RXQ_OVFL
+GType gst_socket_rxq_ovfl_message_get_type (void);
+
+#define GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE          (gst_socket_rxq_ovfl_message_get_type ())
+#define GST_SOCKET_RXQ_OVFL_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE, GstSocketRxqOvflMessage))
+#define GST_SOCKET_RXQ_OVFL_MESSAGE_CLASS(c)      (G_TYPE_CHECK_CLASS_CAST ((c), GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE, GstSocketRxqOvflMessageClass))
+#define GST_IS_SOCKET_RXQ_OVFL_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE))
+#define GST_IS_SOCKET_RXQ_OVFL_MESSAGE_CLASS(c)   (G_TYPE_CHECK_CLASS_TYPE ((c), GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE))
+#define GST_SOCKET_RXQ_OVFL_MESSAGE_GET_CLASS(o)  (G_TYPE_INSTANCE_GET_CLASS ((o), GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE, GstSocketRxqOvflMessageClass))
+
+typedef struct _GstSocketRxqOvflMessage GstSocketRxqOvflMessage;
+typedef struct _GstSocketRxqOvflMessageClass GstSocketRxqOvflMessageClass;
+
+struct _GstSocketRxqOvflMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+/* Number of packets dropped by the kernel on this socket so far */
+struct _GstSocketRxqOvflMessage
+{
+  GSocketControlMessage parent;
+  guint32 drops;
+};
+
+G_DEFINE_TYPE (GstSocketRxqOvflMessage, gst_socket_rxq_ovfl_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_socket_rxq_ovfl_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (guint32);
+}
+
+static int
+gst_socket_rxq_ovfl_message_get_level (GSocketControlMessage * message)
+{
+  return SOL_SOCKET;
+}
+
+static int
+gst_socket_rxq_ovfl_message_get_msg_type (GSocketControlMessage * message)
+{
+  return SO_RXQ_OVFL;
+}
+
+static GSocketControlMessage *
+gst_socket_rxq_ovfl_message_deserialize (gint level,
+    gint type, gsize size, gpointer data)
+{
+  GstSocketRxqOvflMessage *message;
+
+  if (level != SOL_SOCKET
+      || type != gst_socket_rxq_ovfl_message_get_msg_type (NULL))
+    return NULL;
+
+  if (size < sizeof (guint32))
+    return NULL;
+
+  message = g_object_new (GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE, NULL);
+  memcpy (&message->drops, data, sizeof (guint32));
+
+  return G_SOCKET_CONTROL_MESSAGE (message);
+}
+
+static void
+gst_socket_rxq_ovfl_message_init (GstSocketRxqOvflMessage * message)
+{
+}
+
+static void
+gst_socket_rxq_ovfl_message_class_init (GstSocketRxqOvflMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_socket_rxq_ovfl_message_get_size;
+  scm_class->get_level = gst_socket_rxq_ovfl_message_get_level;
+  scm_class->get_type = gst_socket_rxq_ovfl_message_get_msg_type;
+  scm_class->deserialize = gst_socket_rxq_ovfl_message_deserialize;
+}
+#endif
+
 static gboolean
 gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
 {
@@ -515,6 +709,7 @@ gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
   gboolean update;
   GstStructure *config;
   GstCaps *caps = NULL;
+  guint min_buffers;
 
   udpsrc = GST_UDPSRC (bsrc);
 
@@ -530,14 +725,20 @@ gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
 
   gst_query_parse_allocation (query, &caps, NULL);
 
-  gst_buffer_pool_config_set_params (config, caps, udpsrc->mtu, 0, 0);
+  /* In batched mode keep enough buffers around for a whole batch so that
+   * steady-state reception does not need to allocate */
+  min_buffers = udpsrc->batch_size > 1 ? udpsrc->batch_size : 0;
+
+  gst_buffer_pool_config_set_params (config, caps, udpsrc->mtu, min_buffers,
+      0);
 
   gst_buffer_pool_set_config (pool, config);
 
   if (update)
-    gst_query_set_nth_allocation_pool (query, 0, pool, udpsrc->mtu, 0, 0);
+    gst_query_set_nth_allocation_pool (query, 0, pool, udpsrc->mtu,
+        min_buffers, 0);
   else
-    gst_query_add_allocation_pool (query, pool, udpsrc->mtu, 0, 0);
+    gst_query_add_allocation_pool (query, pool, udpsrc->mtu, min_buffers, 0);
 
   gst_object_unref (pool);
 
@@ -547,6 +748,27 @@ gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
 /* not 100% correct, but a good upper bound for memory allocation purposes */
 #define MAX_IPV4_UDP_PACKET_SIZE (65536 - 8)
 
+/* Receive state of one datagram in batched mode. The buffer is acquired
+ * from the pool and mapped when the slot gets prepared. Slots that did not
+ * receive a datagram stay prepared for the next batch. The second vector
+ * points to the extra memory that all slots share for packets bigger than
+ * the mtu */
+struct _GstUDPSrcBatchSlot
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GInputVector ivec[2];
+  GSocketAddress *saddr;
+  GSocketControlMessage **msgs;
+  guint n_msgs;
+};
+
+#ifdef MSG_DONTWAIT
+#define UDP_BATCH_RECEIVE_FLAGS MSG_DONTWAIT
+#else
+#define UDP_BATCH_RECEIVE_FLAGS G_SOCKET_MSG_NONE
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (udpsrc_debug);
 #define GST_CAT_DEFAULT (udpsrc_debug)
 
@@ -571,6 +793,8 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_LOOP               TRUE
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
+#define UDP_DEFAULT_BATCH_SIZE         1
+#define UDP_DEFAULT_KERNEL_RX_INFO     FALSE
 
 enum
 {
@@ -594,6 +818,9 @@ enum
   PROP_RETRIEVE_SENDER_ADDRESS,
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
+  PROP_BATCH_SIZE,
+  PROP_KERNEL_RX_INFO,
+  PROP_STATS,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -602,9 +829,13 @@ static GstCaps *gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset,
+    guint length, GstBuffer ** buf);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
 
 static void gst_udpsrc_finalize (GObject * object);
+static void gst_udpsrc_free_batch_slots (GstUDPSrc * src);
+static void gst_udpsrc_release_batch (GstUDPSrc * udpsrc);
 
 static void gst_udpsrc_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -647,6 +878,12 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
 #ifdef SO_TIMESTAMPNS
   GST_TYPE_SOCKET_TIMESTAMP_MESSAGE;
 #endif
+#ifdef HAVE_SO_TIMESTAMPING
+  GST_TYPE_SOCKET_TIMESTAMPING_MESSAGE;
+#endif
+#ifdef SO_RXQ_OVFL
+  GST_TYPE_SOCKET_RXQ_OVFL_MESSAGE;
+#endif
 
   gobject_class->set_property = gst_udpsrc_set_property;
   gobject_class->get_property = gst_udpsrc_get_property;
@@ -780,6 +1017,66 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           GST_SOCKET_TIMESTAMP_MODE, GST_SOCKET_TIMESTAMP_MODE_REALTIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of datagrams to read per wakeup. With a value bigger
+   * than 1, all datagrams that are available at once (up to this number)
+   * are read with a single system call where supported and pushed
+   * downstream as a #GstBufferList.
+   *
+   * The datagrams of a batch share one extra memory for the part beyond
+   * #GstUDPSrc:mtu, so only one datagram bigger than the mtu can be received
+   * per batch and the others are dropped. The mtu should be set to the
+   * biggest expected datagram size when batching.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch Size",
+          "Maximum number of datagrams to read and push downstream at once "
+          "(1 = push each datagram separately)", 1, 1024,
+          UDP_DEFAULT_BATCH_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstUDPSrc:kernel-rx-info:
+   *
+   * Request the kernel receive timestamps and the socket drop counter with
+   * each packet. The timestamps are attached to the buffers as
+   * #GstReferenceTimestampMeta and the drops are counted in
+   * #GstUDPSrc:stats. Only supported on Linux.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_KERNEL_RX_INFO,
+      g_param_spec_boolean ("kernel-rx-info", "Kernel RX Info",
+          "Attach kernel receive timestamps to buffers and count kernel "
+          "socket drops (SO_TIMESTAMPING / SO_RXQ_OVFL)",
+          UDP_DEFAULT_KERNEL_RX_INFO, G_PARAM_READWRITE |
+          G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstUDPSrc:stats:
+   *
+   * Various receive statistics. This property returns a #GstStructure
+   * with name `application/x-udpsrc-stats` with the following fields:
+   *
+   * * #guint64 `packets-received`: the number of packets pushed downstream
+   * * #guint64 `packets-filtered`: the number of packets dropped because
+   *   they were sent to a different multicast group
+   * * #guint64 `kernel-drops`: the number of packets the kernel dropped
+   *   because the socket receive buffer was full. Only counted when
+   *   #GstUDPSrc:kernel-rx-info is enabled.
+   *
+   * The counters are reset whenever the socket is opened.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics", "Various statistics",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -794,6 +1091,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->unlock_stop = gst_udpsrc_unlock_stop;
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
+  gstbasesrc_class->create = gst_udpsrc_create;
 
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
@@ -822,6 +1120,9 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
+  udpsrc->kernel_rx_info = UDP_DEFAULT_KERNEL_RX_INFO;
+  g_mutex_init (&udpsrc->stats_lock);
 
   /* configure basesrc to be a live source */
   gst_base_src_set_live (GST_BASE_SRC (udpsrc), TRUE);
@@ -864,6 +1165,10 @@ gst_udpsrc_finalize (GObject * object)
     gst_memory_unref (udpsrc->extra_mem);
   udpsrc->extra_mem = NULL;
 
+  gst_udpsrc_free_batch_slots (udpsrc);
+
+  g_mutex_clear (&udpsrc->stats_lock);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -913,81 +1218,275 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
-static GstFlowReturn
-gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
+static void
+gst_udpsrc_free_batch_slots (GstUDPSrc * src)
 {
-  GstUDPSrc *udpsrc;
-  GSocketAddress *saddr = NULL;
-  GSocketAddress **p_saddr;
-  gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
-  GError *err = NULL;
-  gssize res;
-  gsize offset;
-  GSocketControlMessage **msgs = NULL;
-  GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
-  GstMapInfo info;
-  GstMapInfo extra_info;
-  GInputVector ivec[2];
+  gst_udpsrc_release_batch (src);
 
-  udpsrc = GST_UDPSRC_CAST (psrc);
+  g_free (src->batch_slots);
+  src->batch_slots = NULL;
+  g_free (src->batch_msgs);
+  src->batch_msgs = NULL;
+  src->n_batch_slots = 0;
+}
+
+static void
+gst_udpsrc_ensure_batch_slots (GstUDPSrc * src)
+{
+  if (src->n_batch_slots == src->batch_size)
+    return;
+
+  gst_udpsrc_free_batch_slots (src);
+
+  src->batch_slots = g_new0 (GstUDPSrcBatchSlot, src->batch_size);
+  src->batch_msgs = g_new0 (GInputMessage, src->batch_size);
+  src->n_batch_slots = src->batch_size;
+}
+
+/* Memory used in case the data size exceeds mtu */
+static GstMemory *
+gst_udpsrc_alloc_extra_mem (GstUDPSrc * udpsrc, GstBufferPool * pool)
+{
+  GstStructure *config;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstMemory *mem;
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_allocator (config, &allocator, &params);
+
+  mem = gst_allocator_alloc (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
+
+  gst_structure_free (config);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  return mem;
+}
+
+/* Whether socket control messages need to be retrieved with each packet */
+static inline void
+gst_udpsrc_stats_add (GstUDPSrc * udpsrc, guint64 * counter, guint64 value)
+{
+#if GLIB_SIZEOF_VOID_P == 8
+  g_atomic_pointer_add ((gsize *) counter, value);
+#else
+  g_mutex_lock (&udpsrc->stats_lock);
+  *counter += value;
+  g_mutex_unlock (&udpsrc->stats_lock);
+#endif
+}
+
+static inline guint64
+gst_udpsrc_stats_get (GstUDPSrc * udpsrc, guint64 * counter)
+{
+#if GLIB_SIZEOF_VOID_P == 8
+  return (gsize) g_atomic_pointer_get ((gsize *) counter);
+#else
+  guint64 value;
+
+  g_mutex_lock (&udpsrc->stats_lock);
+  value = *counter;
+  g_mutex_unlock (&udpsrc->stats_lock);
+
+  return value;
+#endif
+}
+
+static void
+gst_udpsrc_stats_reset (GstUDPSrc * udpsrc)
+{
+#if GLIB_SIZEOF_VOID_P == 8
+  g_atomic_pointer_set ((gsize *) & udpsrc->packets_received, 0);
+  g_atomic_pointer_set ((gsize *) & udpsrc->packets_filtered, 0);
+  g_atomic_pointer_set ((gsize *) & udpsrc->kernel_drops, 0);
+#else
+  g_mutex_lock (&udpsrc->stats_lock);
+  udpsrc->packets_received = 0;
+  udpsrc->packets_filtered = 0;
+  udpsrc->kernel_drops = 0;
+  g_mutex_unlock (&udpsrc->stats_lock);
+#endif
+}
+
+static gboolean
+gst_udpsrc_needs_control_messages (GstUDPSrc * udpsrc)
+{
+  gboolean needs_msgs;
 
   /* optimization: use messages only in multicast mode and
    * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
+  needs_msgs =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
 #ifdef IP_MULTICAST_ALL
   if (g_inet_address_get_family (g_inet_socket_address_get_address
           (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
+    needs_msgs = FALSE;
 #endif
 #ifdef SO_TIMESTAMPNS
   if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
+    needs_msgs = TRUE;
 #endif
+  if (udpsrc->kernel_rx_info)
+    needs_msgs = TRUE;
 
-  /* Retrieve sender address unless we've been configured not to do so */
-  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
-
-  if (!gst_buffer_map (outbuf, &info, GST_MAP_READWRITE))
-    goto buffer_map_error;
+  return needs_msgs;
+}
 
-  ivec[0].buffer = info.data;
-  ivec[0].size = info.size;
+/* Applies the control messages received together with a packet to @outbuf.
+ * Returns %TRUE if the packet is not for us and should be dropped */
+static gboolean
+gst_udpsrc_handle_control_messages (GstUDPSrc * udpsrc, GstBuffer * outbuf,
+    GSocketControlMessage ** msgs, gint n_msgs)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
 
-  /* Prepare memory in case the data size exceeds mtu */
-  if (udpsrc->extra_mem == NULL) {
-    GstBufferPool *pool;
-    GstStructure *config;
-    GstAllocator *allocator = NULL;
-    GstAllocationParams params;
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
+#ifdef IP_PKTINFO
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
 
-    pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (psrc));
-    config = gst_buffer_pool_get_config (pool);
-    gst_buffer_pool_config_get_allocator (config, &allocator, &params);
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IPV6_PKTINFO
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
 
-    udpsrc->extra_mem =
-        gst_allocator_alloc (allocator, MAX_IPV4_UDP_PACKET_SIZE, &params);
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IP_RECVDSTADDR
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
 
-    gst_object_unref (pool);
-    gst_structure_free (config);
-    if (allocator)
-      gst_object_unref (allocator);
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
+            GST_LOG_OBJECT (udpsrc,
+                "Current system time much ahead in time, setting DTS to pipeline clock");
+            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+          } else {
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
+          }
+        }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
+      }
+    }
+#endif
+#ifdef HAVE_SO_TIMESTAMPING
+    if (GST_IS_SOCKET_TIMESTAMPING_MESSAGE (msgs[i])) {
+      GstSocketTimestampingMessage *msg =
+          GST_SOCKET_TIMESTAMPING_MESSAGE (msgs[i]);
+      GstCaps *caps;
+
+      /* Timestamps that were not generated are all zero */
+      if (msg->ts[0].tv_sec != 0 || msg->ts[0].tv_nsec != 0) {
+        caps = gst_static_caps_get (&kernel_rx_timestamp_caps);
+        gst_buffer_add_reference_timestamp_meta (outbuf, caps,
+            GST_TIMESPEC_TO_TIME (msg->ts[0]), GST_CLOCK_TIME_NONE);
+        gst_caps_unref (caps);
+      }
+      if (msg->ts[2].tv_sec != 0 || msg->ts[2].tv_nsec != 0) {
+        caps = gst_static_caps_get (&kernel_rx_hw_timestamp_caps);
+        gst_buffer_add_reference_timestamp_meta (outbuf, caps,
+            GST_TIMESPEC_TO_TIME (msg->ts[2]), GST_CLOCK_TIME_NONE);
+        gst_caps_unref (caps);
+      }
+    }
+#endif
+#ifdef SO_RXQ_OVFL
+    if (GST_IS_SOCKET_RXQ_OVFL_MESSAGE (msgs[i])) {
+      GstSocketRxqOvflMessage *msg = GST_SOCKET_RXQ_OVFL_MESSAGE (msgs[i]);
+      guint32 new_drops = 0;
+
+      /* This is the 32 bit drop counter of the socket, only keep track
+       * of the difference to the previous one. The drops a socket we were
+       * given had before we used it are not ours to count. */
+      if (udpsrc->have_rxq_ovfl)
+        new_drops = msg->drops - udpsrc->last_rxq_ovfl;
+      udpsrc->last_rxq_ovfl = msg->drops;
+      udpsrc->have_rxq_ovfl = TRUE;
+      gst_udpsrc_stats_add (udpsrc, &udpsrc->kernel_drops, new_drops);
+
+      if (G_UNLIKELY (new_drops > 0))
+        GST_DEBUG_OBJECT (udpsrc, "kernel dropped %u packets", new_drops);
+    }
+#endif
   }
 
-  if (!gst_memory_map (udpsrc->extra_mem, &extra_info, GST_MAP_READWRITE))
-    goto memory_map_error;
-
-  ivec[1].buffer = extra_info.data;
-  ivec[1].size = extra_info.size;
+  return skip_packet;
+}
 
-retry:
-  if (saddr != NULL) {
-    g_object_unref (saddr);
-    saddr = NULL;
-  }
+/* Waits until the socket is readable, posting timeout messages while
+ * waiting if configured to do so */
+static GstFlowReturn
+gst_udpsrc_wait (GstUDPSrc * udpsrc)
+{
+  GError *err = NULL;
+  gboolean try_again;
 
   do {
     gint64 timeout;
@@ -1021,9 +1520,83 @@ retry:
     }
   } while (G_UNLIKELY (try_again));
 
-  res =
-      g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
-      p_msgs, &n_msgs, &flags, udpsrc->cancellable, &err);
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
+{
+  GstUDPSrc *udpsrc;
+  GSocketAddress *saddr = NULL;
+  GSocketAddress **p_saddr;
+  gint flags = G_SOCKET_MSG_NONE;
+  GError *err = NULL;
+  GstFlowReturn ret;
+  gssize res;
+  gsize offset;
+  GSocketControlMessage **msgs = NULL;
+  GSocketControlMessage ***p_msgs;
+  gint n_msgs = 0, i;
+  GstMapInfo info;
+  GstMapInfo extra_info;
+  GInputVector ivec[2];
+
+  udpsrc = GST_UDPSRC_CAST (psrc);
+
+  p_msgs = gst_udpsrc_needs_control_messages (udpsrc) ? &msgs : NULL;
+
+  /* Retrieve sender address unless we've been configured not to do so */
+  p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
+
+  if (!gst_buffer_map (outbuf, &info, GST_MAP_READWRITE))
+    goto buffer_map_error;
+
+  ivec[0].buffer = info.data;
+  ivec[0].size = info.size;
+
+  /* Prepare memory in case the data size exceeds mtu */
+  if (udpsrc->extra_mem == NULL) {
+    GstBufferPool *pool;
+
+    pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (psrc));
+    udpsrc->extra_mem = gst_udpsrc_alloc_extra_mem (udpsrc, pool);
+    gst_object_unref (pool);
+  }
+
+  if (!gst_memory_map (udpsrc->extra_mem, &extra_info, GST_MAP_READWRITE))
+    goto memory_map_error;
+
+  ivec[1].buffer = extra_info.data;
+  ivec[1].size = extra_info.size;
+
+retry:
+  if (saddr != NULL) {
+    g_object_unref (saddr);
+    saddr = NULL;
+  }
+
+  ret = gst_udpsrc_wait (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto wait_failed;
+
+  res =
+      g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
+      p_msgs, &n_msgs, &flags, udpsrc->cancellable, &err);
 
   if (G_UNLIKELY (res < 0)) {
     /* G_IO_ERROR_HOST_UNREACHABLE for a UDP socket means that a packet sent
@@ -1041,102 +1614,10 @@ retry:
   /* Retry if multicast and the destination address is not ours. We don't want
    * to receive arbitrary packets */
   if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+    gboolean skip_packet;
 
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
-#ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
-
-          /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
-           */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
-            GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
-            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-          } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
-          }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
-        }
-      }
-#endif
-    }
+    skip_packet =
+        gst_udpsrc_handle_control_messages (udpsrc, outbuf, msgs, n_msgs);
 
     for (i = 0; i < n_msgs; i++) {
       g_object_unref (msgs[i]);
@@ -1146,6 +1627,7 @@ retry:
     if (skip_packet) {
       GST_DEBUG_OBJECT (udpsrc,
           "Dropping packet for a different multicast address");
+      gst_udpsrc_stats_add (udpsrc, &udpsrc->packets_filtered, 1);
       goto retry;
     }
   }
@@ -1175,6 +1657,8 @@ retry:
     saddr = NULL;
   }
 
+  gst_udpsrc_stats_add (udpsrc, &udpsrc->packets_received, 1);
+
   GST_LOG_OBJECT (udpsrc, "read packet of %d bytes", (int) res);
 
   return GST_FLOW_OK;
@@ -1193,22 +1677,11 @@ memory_map_error:
         ("Failed to map memory"));
     return GST_FLOW_ERROR;
   }
-select_error:
+wait_failed:
   {
     gst_buffer_unmap (outbuf, &info);
     gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
-        ("select error: %s", err->message));
-    g_clear_error (&err);
-    return GST_FLOW_ERROR;
-  }
-stopped:
-  {
-    gst_buffer_unmap (outbuf, &info);
-    gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_DEBUG ("stop called");
-    g_clear_error (&err);
-    return GST_FLOW_FLUSHING;
+    return ret;
   }
 receive_error:
   {
@@ -1235,6 +1708,320 @@ skip_error:
   }
 }
 
+/* Prepares the batch slots that were used by the previous batch for
+ * reception, acquiring and mapping one buffer from the pool per slot, and
+ * the extra memory if the previous batch used it */
+static GstFlowReturn
+gst_udpsrc_prepare_batch (GstUDPSrc * udpsrc, gboolean use_msgs)
+{
+  GstBufferPool *pool;
+  GstFlowReturn ret;
+  guint i;
+
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  if (G_UNLIKELY (pool == NULL))
+    goto no_pool;
+
+  if (udpsrc->batch_extra_mem == NULL) {
+    udpsrc->batch_extra_mem = gst_udpsrc_alloc_extra_mem (udpsrc, pool);
+    if (!gst_memory_map (udpsrc->batch_extra_mem, &udpsrc->batch_extra_map,
+            GST_MAP_READWRITE))
+      goto memory_map_error;
+  }
+
+  for (i = 0; i < udpsrc->n_batch_slots; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    GInputMessage *msg = &udpsrc->batch_msgs[i];
+
+    if (slot->buffer == NULL) {
+      ret = gst_buffer_pool_acquire_buffer (pool, &slot->buffer, NULL);
+      if (G_UNLIKELY (ret != GST_FLOW_OK))
+        goto acquire_failed;
+
+      if (!gst_buffer_map (slot->buffer, &slot->map, GST_MAP_READWRITE))
+        goto buffer_map_error;
+
+      slot->ivec[0].buffer = slot->map.data;
+      slot->ivec[0].size = slot->map.size;
+    }
+    slot->ivec[1].buffer = udpsrc->batch_extra_map.data;
+    slot->ivec[1].size = udpsrc->batch_extra_map.size;
+
+    msg->address = udpsrc->retrieve_sender_address ? &slot->saddr : NULL;
+    msg->vectors = slot->ivec;
+    msg->num_vectors = 2;
+    msg->bytes_received = 0;
+    msg->flags = G_SOCKET_MSG_NONE;
+    msg->control_messages = use_msgs ? &slot->msgs : NULL;
+    msg->num_control_messages = use_msgs ? &slot->n_msgs : NULL;
+  }
+
+  gst_object_unref (pool);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("No buffer pool configured"));
+    return GST_FLOW_ERROR;
+  }
+acquire_failed:
+  {
+    gst_object_unref (pool);
+    return ret;
+  }
+memory_map_error:
+  {
+    gst_memory_unref (udpsrc->batch_extra_mem);
+    udpsrc->batch_extra_mem = NULL;
+    gst_object_unref (pool);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    return GST_FLOW_ERROR;
+  }
+buffer_map_error:
+  {
+    gst_buffer_unref (udpsrc->batch_slots[i].buffer);
+    udpsrc->batch_slots[i].buffer = NULL;
+    gst_object_unref (pool);
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* Gives the buffers of all prepared batch slots back to the pool and frees
+ * the extra memory */
+static void
+gst_udpsrc_release_batch (GstUDPSrc * udpsrc)
+{
+  guint i;
+
+  for (i = 0; i < udpsrc->n_batch_slots; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+
+    if (slot->buffer == NULL)
+      continue;
+
+    gst_buffer_unmap (slot->buffer, &slot->map);
+    gst_buffer_unref (slot->buffer);
+    slot->buffer = NULL;
+  }
+
+  if (udpsrc->batch_extra_mem) {
+    gst_memory_unmap (udpsrc->batch_extra_mem, &udpsrc->batch_extra_map);
+    gst_memory_unref (udpsrc->batch_extra_mem);
+    udpsrc->batch_extra_mem = NULL;
+  }
+}
+
+/* Reads all datagrams that are available, up to batch-size, and adds them
+ * to @list. @list might stay empty if all packets were filtered out */
+static GstFlowReturn
+gst_udpsrc_receive_batch (GstUDPSrc * udpsrc, GstBufferList * list)
+{
+  GstClock *clock;
+  GstClockTime running_time = GST_CLOCK_TIME_NONE;
+  GstFlowReturn ret;
+  GError *err = NULL;
+  gboolean use_msgs;
+  guint n_received, n_filtered = 0, n_overflowed = 0, i;
+  guint last_oversized = G_MAXUINT;
+  gint res;
+
+  gst_udpsrc_ensure_batch_slots (udpsrc);
+
+  use_msgs = gst_udpsrc_needs_control_messages (udpsrc);
+
+  /* only the slots filled by the previous batch need new buffers */
+  ret = gst_udpsrc_prepare_batch (udpsrc, use_msgs);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto release;
+
+retry:
+  ret = gst_udpsrc_wait (udpsrc);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto release;
+
+  /* We already know that data is available, so don't block for the
+   * remaining datagrams of the batch */
+  res = g_socket_receive_messages (udpsrc->used_socket, udpsrc->batch_msgs,
+      udpsrc->n_batch_slots, UDP_BATCH_RECEIVE_FLAGS, udpsrc->cancellable,
+      &err);
+
+  if (G_UNLIKELY (res < 0)) {
+    /* See gst_udpsrc_fill() for why unreachable errors are ignored */
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+      g_clear_error (&err);
+      goto retry;
+    }
+    goto receive_error;
+  }
+
+  n_received = res;
+
+  /* All datagrams of the batch were ready at the same time, so they all get
+   * the same capture time. basesrc would only timestamp the first buffer of
+   * the list */
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+  if (clock != NULL) {
+    GstClockTime now, base_time;
+
+    now = gst_clock_get_time (clock);
+    base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+    if (now > base_time)
+      running_time = now - base_time;
+    else
+      running_time = 0;
+    gst_object_unref (clock);
+  }
+
+  /* All datagrams bigger than the mtu continued into the same extra memory,
+   * only the last one of them is complete */
+  for (i = 0; i < n_received; i++) {
+    if (udpsrc->batch_msgs[i].bytes_received > udpsrc->mtu)
+      last_oversized = i;
+  }
+
+  for (i = 0; i < n_received; i++) {
+    GstUDPSrcBatchSlot *slot = &udpsrc->batch_slots[i];
+    GstBuffer *outbuf = slot->buffer;
+    gsize size = udpsrc->batch_msgs[i].bytes_received;
+    gsize offset = udpsrc->skip_first_bytes;
+    gboolean skip_packet = FALSE;
+    guint j;
+
+    gst_buffer_unmap (outbuf, &slot->map);
+    slot->buffer = NULL;
+
+    if (slot->msgs) {
+      skip_packet = gst_udpsrc_handle_control_messages (udpsrc, outbuf,
+          slot->msgs, slot->n_msgs);
+
+      for (j = 0; j < slot->n_msgs; j++)
+        g_object_unref (slot->msgs[j]);
+      g_free (slot->msgs);
+      slot->msgs = NULL;
+      slot->n_msgs = 0;
+    }
+
+    if (G_UNLIKELY (skip_packet)) {
+      GST_DEBUG_OBJECT (udpsrc,
+          "Dropping packet for a different multicast address");
+      g_clear_object (&slot->saddr);
+      gst_buffer_unref (outbuf);
+      n_filtered++;
+      continue;
+    }
+
+    if (G_UNLIKELY (ret != GST_FLOW_OK || (offset > 0 && size < offset))) {
+      if (ret == GST_FLOW_OK) {
+        GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+            ("UDP buffer to small to skip header"));
+        ret = GST_FLOW_ERROR;
+      }
+      g_clear_object (&slot->saddr);
+      gst_buffer_unref (outbuf);
+      continue;
+    }
+
+    /* See gst_udpsrc_fill() */
+    if (size > udpsrc->mtu) {
+      if (i != last_oversized) {
+        GST_DEBUG_OBJECT (udpsrc, "Dropping overwritten packet of %"
+            G_GSIZE_FORMAT " bytes", size);
+        g_clear_object (&slot->saddr);
+        gst_buffer_unref (outbuf);
+        n_overflowed++;
+        continue;
+      }
+      gst_memory_unmap (udpsrc->batch_extra_mem, &udpsrc->batch_extra_map);
+      gst_buffer_append_memory (outbuf, udpsrc->batch_extra_mem);
+      udpsrc->batch_extra_mem = NULL;
+    }
+
+    gst_buffer_resize (outbuf, offset, size - offset);
+
+    if (slot->saddr) {
+      gst_buffer_add_net_address_meta (outbuf, slot->saddr);
+      g_object_unref (slot->saddr);
+      slot->saddr = NULL;
+    }
+
+    if (!GST_BUFFER_DTS_IS_VALID (outbuf))
+      GST_BUFFER_DTS (outbuf) = running_time;
+
+    gst_buffer_list_add (list, outbuf);
+  }
+
+  gst_udpsrc_stats_add (udpsrc, &udpsrc->packets_received,
+      gst_buffer_list_length (list));
+  if (n_filtered > 0)
+    gst_udpsrc_stats_add (udpsrc, &udpsrc->packets_filtered, n_filtered);
+
+  if (G_UNLIKELY (n_overflowed > 0))
+    GST_ELEMENT_WARNING (udpsrc, STREAM, DECODE, (NULL),
+        ("Dropped %u packets bigger than the mtu of %u bytes, only one of "
+            "them can be received per batch", n_overflowed, udpsrc->mtu));
+
+  GST_LOG_OBJECT (udpsrc, "read %u packets", n_received);
+
+  return ret;
+
+  /* ERRORS */
+receive_error:
+  {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      ret = GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error %d: %s", res, err->message));
+      ret = GST_FLOW_ERROR;
+    }
+    g_clear_error (&err);
+    /* fall through */
+  }
+release:
+  {
+    gst_udpsrc_release_batch (udpsrc);
+    return ret;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (bsrc);
+  GstBufferList *list;
+  GstFlowReturn ret;
+
+  if (udpsrc->batch_size <= 1)
+    return GST_BASE_SRC_CLASS (parent_class)->create (bsrc, offset, length,
+        buf);
+
+  list = gst_buffer_list_new_sized (udpsrc->batch_size);
+
+  do {
+    ret = gst_udpsrc_receive_batch (udpsrc, list);
+  } while (ret == GST_FLOW_OK && gst_buffer_list_length (list) == 0);
+
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_buffer_list_unref (list);
+    return ret;
+  }
+
+  gst_base_src_submit_buffer_list (bsrc, list);
+  *buf = NULL;
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 gst_udpsrc_set_uri (GstUDPSrc * src, const gchar * uri, GError ** error)
 {
@@ -1375,11 +2162,33 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       udpsrc->socket_timestamp_mode = g_value_get_enum (value);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
+    case PROP_KERNEL_RX_INFO:
+      udpsrc->kernel_rx_info = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
 }
 
+static GstStructure *
+gst_udpsrc_create_stats (GstUDPSrc * udpsrc)
+{
+  GstStructure *s;
+
+  s = gst_structure_new ("application/x-udpsrc-stats",
+      "packets-received", G_TYPE_UINT64,
+      gst_udpsrc_stats_get (udpsrc, &udpsrc->packets_received),
+      "packets-filtered", G_TYPE_UINT64,
+      gst_udpsrc_stats_get (udpsrc, &udpsrc->packets_filtered),
+      "kernel-drops", G_TYPE_UINT64,
+      gst_udpsrc_stats_get (udpsrc, &udpsrc->kernel_drops), NULL);
+
+  return s;
+}
+
 static void
 gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
     GParamSpec * pspec)
@@ -1441,6 +2250,15 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       g_value_set_enum (value, udpsrc->socket_timestamp_mode);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
+    case PROP_KERNEL_RX_INFO:
+      g_value_set_boolean (value, udpsrc->kernel_rx_info);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_udpsrc_create_stats (udpsrc));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1754,6 +2572,39 @@ gst_udpsrc_open (GstUDPSrc * src)
   }
 #endif
 
+  if (src->kernel_rx_info) {
+#ifdef HAVE_SO_TIMESTAMPING
+    /* Hardware timestamps are only reported if they were enabled on the
+     * network interface, e.g. by a PTP daemon */
+    if (!g_socket_set_option (src->used_socket, SOL_SOCKET, SO_TIMESTAMPING,
+            SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+            SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE,
+            &err)) {
+      GST_WARNING_OBJECT (src, "Failed to enable SO_TIMESTAMPING: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+#else
+    GST_WARNING_OBJECT (src, "kernel receive timestamps are not supported");
+#endif
+#ifdef SO_RXQ_OVFL
+    if (!g_socket_set_option (src->used_socket, SOL_SOCKET, SO_RXQ_OVFL,
+            TRUE, &err)) {
+      GST_WARNING_OBJECT (src, "Failed to enable SO_RXQ_OVFL: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+#else
+    GST_WARNING_OBJECT (src, "kernel drop counters are not supported");
+#endif
+  }
+
+  gst_udpsrc_stats_reset (src);
+  /* the drop counter of a socket we created starts at 0, that of a socket we
+   * were given is only known with the first packet */
+  src->last_rxq_ovfl = 0;
+  src->have_rxq_ovfl = !src->external_socket;
+
   /* NOTE: sockaddr_in.sin_port works for ipv4 and ipv6 because sin_port
    * follows ss_family on both */
   {
@@ -1930,6 +2781,9 @@ gst_udpsrc_change_state (GstElement * element, GstStateChange transition)
     goto failure;
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_udpsrc_release_batch (src);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_udpsrc_close (src);
       break;
@@ -43,6 +43,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstUDPSrc GstUDPSrc;
 typedef struct _GstUDPSrcClass GstUDPSrcClass;
+typedef struct _GstUDPSrcBatchSlot GstUDPSrcBatchSlot;
 
 
 /**
@@ -83,10 +84,23 @@ struct _GstUDPSrc {
   gboolean   reuse;
   gboolean   loop;
   GstSocketTimestampMode socket_timestamp_mode;
+  guint      batch_size;
+  gboolean   kernel_rx_info;
 
   /* stats */
   guint      max_size;
 
+  /* updated atomically, or under stats_lock where 64 bit atomic operations
+   * are not available */
+  guint64    packets_received;
+  guint64    packets_filtered;
+  guint64    kernel_drops;
+  GMutex     stats_lock;
+
+  /* streaming thread only */
+  guint32    last_rxq_ovfl;
+  gboolean   have_rxq_ovfl;
+
   gboolean   external_socket;
   gboolean   made_cancel_fd;
 
@@ -96,6 +110,14 @@ struct _GstUDPSrc {
   /* Extra memory for buffers with a size superior to max_packet_size */
   GstMemory *extra_mem;
 
+  /* Per-datagram receive state for batched reception, batch_size entries */
+  GstUDPSrcBatchSlot *batch_slots;
+  GInputMessage *batch_msgs;
+  guint      n_batch_slots;
+  /* Extra memory shared by the batch slots, kept mapped between batches */
+  GstMemory *batch_extra_mem;
+  GstMapInfo batch_extra_map;
+
   gchar     *uri;
 };
 
@@ -22,6 +22,7 @@
 
 #include "qtdemux.h"
 #include <glib/gprintf.h>
+#include <string.h>
 
 #include <gio/gio.h>
 
@@ -906,13 +907,14 @@ GST_START_TEST (test_qtdemux_pad_names)
 
 GST_END_TEST;
 
-GST_START_TEST (test_qtdemux_editlist)
+#define EDITLIST_MP4_SIZE 5322593
+
+/* editlists.mp4 has its mdat before the moov */
+static guint8 *
+load_editlist_mp4 (void)
 {
-  const gsize editlist_mp4_size = 5322593;
+  const gsize editlist_mp4_size = EDITLIST_MP4_SIZE;
   guint8 *editlist_mp4 = NULL;
-  GstElement *src, *sink, *pipe;
-  GstSample *sample;
-  guint frame_count = 0;
 
   {
     GZlibDecompressor *decompress;
@@ -952,6 +954,19 @@ GST_START_TEST (test_qtdemux_editlist)
   fail_unless_equals_int (editlist_mp4[28 + 6], 'a');
   fail_unless_equals_int (editlist_mp4[28 + 7], 't');
 
+  return editlist_mp4;
+}
+
+GST_START_TEST (test_qtdemux_editlist)
+{
+  const gsize editlist_mp4_size = EDITLIST_MP4_SIZE;
+  guint8 *editlist_mp4;
+  GstElement *src, *sink, *pipe;
+  GstSample *sample;
+  guint frame_count = 0;
+
+  editlist_mp4 = load_editlist_mp4 ();
+
   pipe = gst_parse_launch ("dataurisrc name=src ! qtdemux name=d "
       "d.video_0 ! appsink name=sink", NULL);
 
@@ -1027,6 +1042,645 @@ GST_START_TEST (test_qtdemux_editlist)
 
 GST_END_TEST;
 
+typedef struct
+{
+  guint num_buffers;
+  guint32 checksum;
+} MdatSpillTestData;
+
+static GstPadProbeReturn
+qtdemux_mdat_spill_probe (GstPad * pad, GstPadProbeInfo * info,
+    MdatSpillTestData * data)
+{
+  if (GST_IS_BUFFER (GST_PAD_PROBE_INFO_DATA (info))) {
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER (info);
+    GstMapInfo map;
+    gsize i;
+
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    for (i = 0; i < map.size; i++)
+      data->checksum = data->checksum * 31 + map.data[i];
+    gst_buffer_unmap (buf, &map);
+    data->num_buffers++;
+  }
+
+  return GST_PAD_PROBE_DROP;
+}
+
+static void
+qtdemux_mdat_spill_pad_added_cb (GstElement * element, GstPad * pad,
+    MdatSpillTestData * data)
+{
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM,
+      (GstPadProbeCallback) qtdemux_mdat_spill_probe, data, NULL);
+}
+
+/* Pushes @mp4 to a qtdemux that can't seek upstream, so that everything
+ * before the moov has to be buffered */
+static GstFlowReturn
+qtdemux_push_unseekable (const guint8 * mp4, gsize size,
+    guint64 max_mdat_buffer_size, guint64 max_mdat_spill_size,
+    MdatSpillTestData * data)
+{
+  GstElement *qtdemux;
+  GstPad *sinkpad;
+  GstSegment segment;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gsize offset;
+
+  qtdemux = gst_element_factory_make ("qtdemux", NULL);
+  g_object_set (qtdemux, "max-mdat-buffer-size", max_mdat_buffer_size,
+      "max-mdat-spill-size", max_mdat_spill_size, NULL);
+  g_signal_connect (qtdemux, "pad-added", (GCallback)
+      qtdemux_mdat_spill_pad_added_cb, data);
+  gst_element_set_state (qtdemux, GST_STATE_PLAYING);
+  sinkpad = gst_element_get_static_pad (qtdemux, "sink");
+
+  fail_unless (gst_pad_send_event (sinkpad,
+          gst_event_new_stream_start ("TEST")));
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_send_event (sinkpad, gst_event_new_segment (&segment)));
+
+  for (offset = 0; offset < size && ret == GST_FLOW_OK; offset += 65536) {
+    gsize len = MIN (size - offset, 65536);
+    GstBuffer *inbuf;
+
+    inbuf = gst_buffer_new_memdup (mp4 + offset, len);
+    GST_BUFFER_OFFSET (inbuf) = offset;
+    ret = gst_pad_chain (sinkpad, inbuf);
+  }
+  if (ret == GST_FLOW_OK)
+    fail_unless (gst_pad_send_event (sinkpad, gst_event_new_eos ()));
+
+  gst_object_unref (sinkpad);
+  gst_element_set_state (qtdemux, GST_STATE_NULL);
+  gst_object_unref (qtdemux);
+
+  return ret;
+}
+
+GST_START_TEST (test_qtdemux_mdat_spill)
+{
+  MdatSpillTestData in_memory = { 0, }, spilled = { 0, }, refused = { 0, };
+  guint8 *editlist_mp4;
+
+  editlist_mp4 = load_editlist_mp4 ();
+
+  /* the whole mdat fits in memory */
+  fail_unless_equals_int (qtdemux_push_unseekable (editlist_mp4,
+          EDITLIST_MP4_SIZE, 10 * 1024 * 1024, 0, &in_memory), GST_FLOW_OK);
+  fail_unless (in_memory.num_buffers > 0);
+
+  /* the mdat is spilled to a temporary file and read back */
+  fail_unless_equals_int (qtdemux_push_unseekable (editlist_mp4,
+          EDITLIST_MP4_SIZE, 1024 * 1024, 8 * 1024 * 1024, &spilled),
+      GST_FLOW_OK);
+  fail_unless_equals_int (spilled.num_buffers, in_memory.num_buffers);
+  fail_unless_equals_int (spilled.checksum, in_memory.checksum);
+
+  /* the mdat fits neither in memory nor in the temporary file */
+  fail_unless_equals_int (qtdemux_push_unseekable (editlist_mp4,
+          EDITLIST_MP4_SIZE, 1024 * 1024, 1024 * 1024, &refused),
+      GST_FLOW_ERROR);
+  fail_unless_equals_int (refused.num_buffers, 0);
+
+  g_free (editlist_mp4);
+}
+
+GST_END_TEST;
+
+/* init_mp4 followed by @num_fragments copies of seg_1_m4f with consecutive
+ * decode times, without mfra */
+static guint8 *
+create_fragmented_mp4 (guint num_fragments, gsize * size)
+{
+  guint64 fragment_duration =
+      G_N_ELEMENTS (seg_1_sample_sizes) * seg_1_sample_duration;
+  guint8 *data;
+  guint i;
+
+  *size = init_mp4_len + num_fragments * seg_1_m4f_len;
+  data = g_malloc (*size);
+  memcpy (data, init_mp4, init_mp4_len);
+
+  for (i = 0; i < num_fragments; i++) {
+    guint8 *fragment = data + init_mp4_len + i * seg_1_m4f_len;
+
+    memcpy (fragment, seg_1_m4f, seg_1_m4f_len);
+    /* mfhd sequence number */
+    GST_WRITE_UINT32_BE (fragment + 20, i + 1);
+    /* tfdt (version 1) base media decode time */
+    GST_WRITE_UINT64_BE (fragment + 60, i * fragment_duration);
+  }
+
+  return data;
+}
+
+/* dataurisrc ! qtdemux with an appsink on @pad_name */
+static GstElement *
+build_qtdemux_pipeline (const guint8 * data, gsize size,
+    const gchar * pad_name, GstElement ** sink)
+{
+  GstElement *src, *pipe;
+  gchar *base64, *uri, *desc;
+
+  base64 = g_base64_encode (data, size);
+  uri = g_strconcat ("data:video/quicktime;base64,", base64, NULL);
+  g_free (base64);
+
+  desc = g_strdup_printf ("dataurisrc name=src ! qtdemux name=d "
+      "d.%s ! appsink name=sink sync=false", pad_name);
+  pipe = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipe != NULL);
+
+  src = gst_bin_get_by_name (GST_BIN (pipe), "src");
+  fail_unless (src != NULL);
+  g_object_set (src, "uri", uri, NULL);
+  gst_object_unref (src);
+  g_free (uri);
+
+  *sink = gst_bin_get_by_name (GST_BIN (pipe), "sink");
+  fail_unless (*sink != NULL);
+
+  return pipe;
+}
+
+/* same as build_qtdemux_pipeline(), prerolled */
+static GstElement *
+create_qtdemux_pipeline (const guint8 * data, gsize size,
+    const gchar * pad_name, GstElement ** sink)
+{
+  GstElement *pipe;
+
+  pipe = build_qtdemux_pipeline (data, size, pad_name, sink);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipe, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  return pipe;
+}
+
+static GstClockTime
+qtdemux_seek_and_pull (GstElement * pipe, GstElement * sink,
+    GstSeekFlags flags, GstClockTime position)
+{
+  GstSample *sample;
+  GstClockTime pts;
+
+  fail_unless (gst_element_seek_simple (pipe, GST_FORMAT_TIME,
+          GST_SEEK_FLAG_FLUSH | flags, position));
+  fail_unless_equals_int (gst_element_get_state (pipe, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  sample = gst_app_sink_pull_preroll (GST_APP_SINK (sink));
+  fail_unless (sample != NULL);
+  pts = GST_BUFFER_PTS (gst_sample_get_buffer (sample));
+  gst_sample_unref (sample);
+
+  return pts;
+}
+
+GST_START_TEST (test_qtdemux_fragmented_seek_without_mfra)
+{
+  GstClockTime sample_duration, fragment_duration, position, pts;
+  GstElement *sink, *pipe;
+  guint8 *mp4;
+  gsize size;
+
+  sample_duration = gst_util_uint64_scale (seg_1_sample_duration, GST_SECOND,
+      seg_1_timescale);
+  fragment_duration = gst_util_uint64_scale (G_N_ELEMENTS
+      (seg_1_sample_sizes) * seg_1_sample_duration, GST_SECOND,
+      seg_1_timescale);
+
+  mp4 = create_fragmented_mp4 (5, &size);
+  pipe = create_qtdemux_pipeline (mp4, size, "audio_0", &sink);
+  g_free (mp4);
+
+  /* forward into a fragment that was not parsed yet, which indexes the
+   * fragments on the way */
+  position = 3 * fragment_duration + 10 * sample_duration;
+  pts = qtdemux_seek_and_pull (pipe, sink, 0, position);
+  fail_unless (pts <= position);
+  fail_unless (position - pts < sample_duration);
+
+  /* back into an indexed fragment, with the keyframe in its first trun */
+  position = fragment_duration + 20 * sample_duration;
+  pts = qtdemux_seek_and_pull (pipe, sink, 0, position);
+  fail_unless (pts <= position);
+  fail_unless (position - pts < sample_duration);
+
+  /* to the start of an indexed fragment */
+  position = 2 * fragment_duration;
+  pts = qtdemux_seek_and_pull (pipe, sink, 0, position);
+  fail_unless (pts <= position);
+  fail_unless (position - pts < sample_duration);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+
+  gst_object_unref (sink);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+#define TEST_MP4_N_SAMPLES 10
+#define TEST_MP4_SAMPLE_DURATION (GST_SECOND / 10)
+
+static GByteArray *
+atom_new (const gchar * fourcc)
+{
+  GByteArray *atom = g_byte_array_new ();
+  guint8 header[8] = { 0, };
+
+  memcpy (header + 4, fourcc, 4);
+  g_byte_array_append (atom, header, sizeof (header));
+
+  return atom;
+}
+
+static void
+atom_add_uint32 (GByteArray * atom, guint32 value)
+{
+  guint8 data[4];
+
+  GST_WRITE_UINT32_BE (data, value);
+  g_byte_array_append (atom, data, sizeof (data));
+}
+
+static void
+atom_add_zeros (GByteArray * atom, guint n)
+{
+  guint old_len = atom->len;
+
+  g_byte_array_set_size (atom, old_len + n);
+  memset (atom->data + old_len, 0, n);
+}
+
+static void
+atom_add_matrix (GByteArray * atom)
+{
+  atom_add_uint32 (atom, 0x00010000);
+  atom_add_zeros (atom, 12);
+  atom_add_uint32 (atom, 0x00010000);
+  atom_add_zeros (atom, 12);
+  atom_add_uint32 (atom, 0x40000000);
+}
+
+/* writes the size of @child and appends it to @atom */
+static void
+atom_add_child (GByteArray * atom, GByteArray * child)
+{
+  GST_WRITE_UINT32_BE (child->data, child->len);
+  g_byte_array_append (atom, child->data, child->len);
+  g_byte_array_unref (child);
+}
+
+/* A non-fragmented file with one track of @n_samples JPEG frames, whose
+ * keyframes are given by the @n_stss entries of @stss. With @durations, the
+ * stts has one entry per sample, else all samples last 1. Each sample holds
+ * its index as 32 bit big endian value */
+static guint8 *
+create_mp4_full (guint n_samples, const guint32 * durations,
+    const guint32 * stss, guint n_stss, gsize * size)
+{
+  GByteArray *file, *atom, *moov, *trak, *mdia, *minf, *stbl;
+  guint32 duration = 0;
+  guint i;
+
+  file = g_byte_array_new ();
+
+  atom = atom_new ("ftyp");
+  g_byte_array_append (atom, (const guint8 *) "isom", 4);
+  atom_add_uint32 (atom, 0x200);
+  g_byte_array_append (atom, (const guint8 *) "isom", 4);
+  atom_add_child (file, atom);
+
+  /* the data of the samples starts right after the mdat header */
+  atom = atom_new ("mdat");
+  for (i = 0; i < n_samples; i++)
+    atom_add_uint32 (atom, i);
+  atom_add_child (file, atom);
+
+  stbl = atom_new ("stbl");
+  atom = atom_new ("stsd");
+  atom_add_uint32 (atom, 0);
+  atom_add_uint32 (atom, 1);
+  {
+    GByteArray *entry = atom_new ("jpeg");
+
+    atom_add_zeros (entry, 6);
+    /* data reference index, version, revision, vendor and qualities */
+    atom_add_uint32 (entry, 1 << 16);
+    atom_add_zeros (entry, 14);
+    /* width and height, resolutions */
+    atom_add_uint32 (entry, (16 << 16) | 16);
+    atom_add_uint32 (entry, 0x00480000);
+    atom_add_uint32 (entry, 0x00480000);
+    /* data size, frame count, compressor name */
+    atom_add_uint32 (entry, 0);
+    atom_add_uint32 (entry, 1 << 16);
+    atom_add_zeros (entry, 30);
+    /* depth and color table id */
+    atom_add_uint32 (entry, (24 << 16) | 0xffff);
+    atom_add_child (atom, entry);
+  }
+  atom_add_child (stbl, atom);
+
+  atom = atom_new ("stts");
+  atom_add_uint32 (atom, 0);
+  if (durations) {
+    atom_add_uint32 (atom, n_samples);
+    for (i = 0; i < n_samples; i++) {
+      atom_add_uint32 (atom, 1);
+      atom_add_uint32 (atom, durations[i]);
+      duration += durations[i];
+    }
+  } else {
+    atom_add_uint32 (atom, 1);
+    atom_add_uint32 (atom, n_samples);
+    atom_add_uint32 (atom, 1);
+    duration = n_samples;
+  }
+  atom_add_child (stbl, atom);
+
+  atom = atom_new ("stss");
+  atom_add_uint32 (atom, 0);
+  atom_add_uint32 (atom, n_stss);
+  for (i = 0; i < n_stss; i++)
+    atom_add_uint32 (atom, stss[i]);
+  atom_add_child (stbl, atom);
+
+  atom = atom_new ("stsc");
+  atom_add_uint32 (atom, 0);
+  atom_add_uint32 (atom, 1);
+  atom_add_uint32 (atom, 1);
+  atom_add_uint32 (atom, n_samples);
+  atom_add_uint32 (atom, 1);
+  atom_add_child (stbl, atom);
+
+  atom = atom_new ("stsz");
+  atom_add_uint32 (atom, 0);
+  atom_add_uint32 (atom, 4);
+  atom_add_uint32 (atom, n_samples);
+  atom_add_child (stbl, atom);
+
+  atom = atom_new ("stco");
+  atom_add_uint32 (atom, 0);
+  atom_add_uint32 (atom, 1);
+  atom_add_uint32 (atom, file->len - n_samples * 4);
+  atom_add_child (stbl, atom);
+
+  minf = atom_new ("minf");
+  atom = atom_new ("vmhd");
+  atom_add_uint32 (atom, 1);
+  atom_add_zeros (atom, 8);
+  atom_add_child (minf, atom);
+  atom_add_child (minf, stbl);
+
+  /* a timescale of 10, each sample lasts 1 */
+  mdia = atom_new ("mdia");
+  atom = atom_new ("mdhd");
+  atom_add_zeros (atom, 12);
+  atom_add_uint32 (atom, 10);
+  atom_add_uint32 (atom, duration);
+  atom_add_uint32 (atom, 0x55c40000);
+  atom_add_child (mdia, atom);
+  atom = atom_new ("hdlr");
+  atom_add_zeros (atom, 8);
+  g_byte_array_append (atom, (const guint8 *) "vide", 4);
+  atom_add_zeros (atom, 13);
+  atom_add_child (mdia, atom);
+  atom_add_child (mdia, minf);
+
+  trak = atom_new ("trak");
+  atom = atom_new ("tkhd");
+  atom_add_uint32 (atom, 7);
+  atom_add_zeros (atom, 8);
+  /* track id, reserved, duration */
+  atom_add_uint32 (atom, 1);
+  atom_add_zeros (atom, 4);
+  atom_add_uint32 (atom, duration);
+  atom_add_zeros (atom, 16);
+  atom_add_matrix (atom);
+  atom_add_uint32 (atom, 16 << 16);
+  atom_add_uint32 (atom, 16 << 16);
+  atom_add_child (trak, atom);
+  atom_add_child (trak, mdia);
+
+  moov = atom_new ("moov");
+  atom = atom_new ("mvhd");
+  atom_add_zeros (atom, 12);
+  atom_add_uint32 (atom, 10);
+  atom_add_uint32 (atom, duration);
+  atom_add_uint32 (atom, 0x00010000);
+  atom_add_uint32 (atom, 0x01000000);
+  atom_add_zeros (atom, 8);
+  atom_add_matrix (atom);
+  atom_add_zeros (atom, 24);
+  atom_add_uint32 (atom, 2);
+  atom_add_child (moov, atom);
+  atom_add_child (moov, trak);
+  atom_add_child (file, moov);
+
+  *size = file->len;
+  return g_byte_array_free (file, FALSE);
+}
+
+static guint8 *
+create_mp4_with_stss (const guint32 * stss, guint n_stss, gsize * size)
+{
+  return create_mp4_full (TEST_MP4_N_SAMPLES, NULL, stss, n_stss, size);
+}
+
+GST_START_TEST (test_qtdemux_keyframe_lookup)
+{
+  /* sample numbers start at 1, keyframes are samples 1 (not for the zero
+   * entry), 5 and 9 */
+  static const guint32 sorted[] = { 1, 5, 9 };
+  static const guint32 zero_entry[] = { 5, 0, 9 };
+  static const guint32 unsorted[] = { 1, 9, 5 };
+  static const struct
+  {
+    const guint32 *stss;
+    guint n_stss;
+  } tables[] = {
+    {sorted, G_N_ELEMENTS (sorted)},
+    {zero_entry, G_N_ELEMENTS (zero_entry)},
+    {unsorted, G_N_ELEMENTS (unsorted)},
+  };
+  GstSeekFlags flags = GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_AFTER;
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (tables); i++) {
+    GstElement *sink, *pipe;
+    GstClockTime pts;
+    guint8 *mp4;
+    gsize size;
+
+    mp4 = create_mp4_with_stss (tables[i].stss, tables[i].n_stss, &size);
+    pipe = create_qtdemux_pipeline (mp4, size, "video_0", &sink);
+    g_free (mp4);
+
+    /* the next keyframe after sample 2 is sample 4 */
+    pts = qtdemux_seek_and_pull (pipe, sink, flags,
+        2 * TEST_MP4_SAMPLE_DURATION);
+    fail_unless_equals_uint64 (pts, 4 * TEST_MP4_SAMPLE_DURATION);
+
+    /* the next keyframe after sample 5 is sample 8 */
+    pts = qtdemux_seek_and_pull (pipe, sink, flags,
+        5 * TEST_MP4_SAMPLE_DURATION);
+    fail_unless_equals_uint64 (pts, 8 * TEST_MP4_SAMPLE_DURATION);
+
+    gst_element_set_state (pipe, GST_STATE_NULL);
+    gst_object_unref (sink);
+    gst_object_unref (pipe);
+  }
+}
+
+GST_END_TEST;
+
+/* a time within sample @index, whose durations alternate between 1 and 2
+ * in a timescale of 10 */
+#define STTS_TEST_SAMPLE_TIME(index) \
+  (((index) + (index) / 2) * GST_SECOND / 10)
+
+GST_START_TEST (test_qtdemux_stts_lookup)
+{
+  /* more stts entries than QTDEMUX_STTS_INDEX_INTERVAL, several times */
+  static const guint n_samples = 300;
+  /* forward beyond the parsed samples, back into them, across the last
+   * index entry and to the last sample */
+  static const guint seeks[] = { 150, 70, 71, 200, 130, 256, 299 };
+  guint32 durations[300];
+  GstElement *sink, *pipe;
+  guint8 *mp4;
+  gsize size;
+  guint i;
+
+  for (i = 0; i < n_samples; i++)
+    durations[i] = 1 + i % 2;
+
+  mp4 = create_mp4_full (n_samples, durations, NULL, 0, &size);
+  pipe = create_qtdemux_pipeline (mp4, size, "video_0", &sink);
+  g_free (mp4);
+
+  for (i = 0; i < G_N_ELEMENTS (seeks); i++) {
+    GstClockTime position = STTS_TEST_SAMPLE_TIME (seeks[i]);
+    GstClockTime pts;
+
+    /* in the middle of the samples lasting 2 */
+    if (seeks[i] % 2)
+      position += GST_SECOND / 10;
+
+    pts = qtdemux_seek_and_pull (pipe, sink, 0, position);
+    fail_unless_equals_uint64 (pts, STTS_TEST_SAMPLE_TIME (seeks[i]));
+  }
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  guint64 data_start;
+  guint64 data_end;
+  guint n_reads;
+} SampleReads;
+
+static GstPadProbeReturn
+count_sample_reads (GstPad * pad, GstPadProbeInfo * info, SampleReads * reads)
+{
+  if (info->offset >= reads->data_start && info->offset < reads->data_end)
+    reads->n_reads++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_qtdemux_readahead)
+{
+  /* all samples fit in the read-ahead time and size, so a single read
+   * covers them */
+  static const struct
+  {
+    guint readahead_size;
+    guint n_reads;
+  } runs[] = {
+    {0, TEST_MP4_N_SAMPLES},
+    {1024, 1},
+    /* each read ends with the last of the next 4 samples */
+    {16, 3},
+    /* smaller than a sample, read-ahead is not used */
+    {4, TEST_MP4_N_SAMPLES},
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (runs); i++) {
+    GstElement *sink, *pipe, *demux;
+    SampleReads reads;
+    GstPad *pad;
+    guint8 *mp4;
+    gsize size;
+    guint n;
+
+    mp4 = create_mp4_with_stss (NULL, 0, &size);
+    pipe = build_qtdemux_pipeline (mp4, size, "video_0", &sink);
+    g_free (mp4);
+
+    /* the sample data follows the ftyp atom and the mdat header */
+    reads.data_start = 20 + 8;
+    reads.data_end = reads.data_start + TEST_MP4_N_SAMPLES * 4;
+    reads.n_reads = 0;
+
+    demux = gst_bin_get_by_name (GST_BIN (pipe), "d");
+    fail_unless (demux != NULL);
+    g_object_set (demux, "readahead-size", runs[i].readahead_size, NULL);
+    pad = gst_element_get_static_pad (demux, "sink");
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_PULL |
+        GST_PAD_PROBE_TYPE_BUFFER, (GstPadProbeCallback) count_sample_reads,
+        &reads, NULL);
+    gst_object_unref (pad);
+    gst_object_unref (demux);
+
+    fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+        GST_STATE_CHANGE_ASYNC);
+
+    /* the output does not depend on the read-ahead */
+    for (n = 0; n < TEST_MP4_N_SAMPLES; n++) {
+      GstSample *sample;
+      GstBuffer *buf;
+      GstMapInfo map;
+
+      sample = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+      fail_unless (sample != NULL);
+      buf = gst_sample_get_buffer (sample);
+      fail_unless_equals_uint64 (GST_BUFFER_PTS (buf),
+          n * TEST_MP4_SAMPLE_DURATION);
+      fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+      fail_unless_equals_int (map.size, 4);
+      fail_unless_equals_int (GST_READ_UINT32_BE (map.data), n);
+      gst_buffer_unmap (buf, &map);
+      gst_sample_unref (sample);
+    }
+    fail_unless (gst_app_sink_pull_sample (GST_APP_SINK (sink)) == NULL);
+    fail_unless (gst_app_sink_is_eos (GST_APP_SINK (sink)));
+
+    fail_unless_equals_int (reads.n_reads, runs[i].n_reads);
+
+    gst_element_set_state (pipe, GST_STATE_NULL);
+    gst_object_unref (sink);
+    gst_object_unref (pipe);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 qtdemux_suite (void)
 {
@@ -1041,6 +1695,11 @@ qtdemux_suite (void)
   tcase_add_test (tc_chain, test_qtdemux_stream_change);
   tcase_add_test (tc_chain, test_qtdemux_pad_names);
   tcase_add_test (tc_chain, test_qtdemux_editlist);
+  tcase_add_test (tc_chain, test_qtdemux_mdat_spill);
+  tcase_add_test (tc_chain, test_qtdemux_fragmented_seek_without_mfra);
+  tcase_add_test (tc_chain, test_qtdemux_keyframe_lookup);
+  tcase_add_test (tc_chain, test_qtdemux_stts_lookup);
+  tcase_add_test (tc_chain, test_qtdemux_readahead);
 
   return s;
 }
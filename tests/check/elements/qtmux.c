@@ -797,6 +797,172 @@ GST_START_TEST (test_reuse)
 
 GST_END_TEST;
 
+/* The sink pad acts as a seekable file: BYTES segments move the position the
+ * following buffers are written at, like the mdat size update does */
+static GByteArray *muxed_data;
+static gsize muxed_pos;
+
+static GstFlowReturn
+muxed_data_sinkpad_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  gsize size = gst_buffer_get_size (buffer);
+
+  if (muxed_pos + size > muxed_data->len)
+    g_byte_array_set_size (muxed_data, muxed_pos + size);
+  gst_buffer_extract (buffer, 0, muxed_data->data + muxed_pos, size);
+  muxed_pos += size;
+  gst_buffer_unref (buffer);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+muxed_data_sinkpad_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEGMENT) {
+    const GstSegment *segment;
+
+    gst_event_parse_segment (event, &segment);
+    if (segment->format == GST_FORMAT_BYTES)
+      muxed_pos = segment->start;
+  }
+
+  return qtmux_sinkpad_event (pad, parent, event);
+}
+
+static GByteArray *
+mux_test_data (gboolean faststart, guint n_buffers, gsize buffer_size)
+{
+  GstElement *qtmux;
+  GstCaps *caps;
+  GstSegment segment;
+  guint i;
+
+  muxed_data = g_byte_array_new ();
+  muxed_pos = 0;
+
+  qtmux = setup_qtmux (&srcvideotemplate, "video_%u", TRUE);
+  gst_pad_set_chain_function (mysinkpad, muxed_data_sinkpad_chain);
+  gst_pad_set_event_function (mysinkpad, muxed_data_sinkpad_event);
+  g_object_set (qtmux, "faststart", faststart, NULL);
+  fail_unless (gst_element_set_state (qtmux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+
+  caps = gst_pad_get_pad_template_caps (mysrcpad);
+  gst_pad_set_caps (mysrcpad, caps);
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *inbuffer;
+    GstMapInfo map;
+    gsize j;
+
+    inbuffer = gst_buffer_new_and_alloc (buffer_size);
+    gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+    for (j = 0; j < buffer_size; j++)
+      map.data[j] = (i * 7 + j) & 0xff;
+    gst_buffer_unmap (inbuffer, &map);
+    GST_BUFFER_PTS (inbuffer) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DTS (inbuffer) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (inbuffer) = 40 * GST_MSECOND;
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()) == TRUE);
+  wait_for_eos ();
+
+  cleanup_qtmux (qtmux, "video_%u");
+
+  return g_steal_pointer (&muxed_data);
+}
+
+/* Returns the offset of the top-level atom @fourcc in @data, and the offset
+ * and size of its payload in @payload and @payload_size */
+static gsize
+find_top_level_atom (GByteArray * data, guint32 fourcc, gsize * payload,
+    gsize * payload_size)
+{
+  gsize pos = 0;
+
+  while (pos + 8 <= data->len) {
+    guint64 size = GST_READ_UINT32_BE (data->data + pos);
+    gsize header_size = 8;
+
+    if (size == 1) {
+      fail_unless (pos + 16 <= data->len);
+      size = GST_READ_UINT64_BE (data->data + pos + 8);
+      header_size = 16;
+    }
+    fail_unless (size >= header_size && pos + size <= data->len,
+        "invalid atom size %" G_GUINT64_FORMAT " at %" G_GSIZE_FORMAT, size,
+        pos);
+
+    if (GST_READ_UINT32_LE (data->data + pos + 4) == fourcc) {
+      *payload = pos + header_size;
+      *payload_size = size - header_size;
+      return pos;
+    }
+    pos += size;
+  }
+
+  fail ("no %" GST_FOURCC_FORMAT " atom", GST_FOURCC_ARGS (fourcc));
+  return 0;
+}
+
+static void
+check_faststart (guint n_buffers, gsize buffer_size)
+{
+  GByteArray *plain, *fast;
+  gsize plain_moov, plain_mdat, fast_moov, fast_mdat;
+  gsize plain_payload, plain_size, fast_payload, fast_size, unused;
+
+  plain = mux_test_data (FALSE, n_buffers, buffer_size);
+  fast = mux_test_data (TRUE, n_buffers, buffer_size);
+
+  plain_moov = find_top_level_atom (plain, GST_MAKE_FOURCC ('m', 'o', 'o',
+          'v'), &unused, &unused);
+  plain_mdat = find_top_level_atom (plain, GST_MAKE_FOURCC ('m', 'd', 'a',
+          't'), &plain_payload, &plain_size);
+  fast_moov = find_top_level_atom (fast, GST_MAKE_FOURCC ('m', 'o', 'o',
+          'v'), &unused, &unused);
+  fast_mdat = find_top_level_atom (fast, GST_MAKE_FOURCC ('m', 'd', 'a',
+          't'), &fast_payload, &fast_size);
+
+  fail_unless (plain_mdat < plain_moov);
+  fail_unless (fast_moov < fast_mdat);
+
+  /* the media data is the same, only moved behind the moov */
+  fail_unless_equals_uint64 (plain_size, n_buffers * buffer_size);
+  fail_unless_equals_uint64 (fast_size, plain_size);
+  fail_unless (memcmp (fast->data + fast_payload, plain->data + plain_payload,
+          plain_size) == 0);
+
+  g_byte_array_unref (plain);
+  g_byte_array_unref (fast);
+}
+
+GST_START_TEST (test_faststart)
+{
+  /* less than one chunk of media data is read back from the temporary file */
+  check_faststart (10, 1024);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_faststart_mapped)
+{
+  /* several chunks, sent from the mapped temporary file where supported */
+  check_faststart (24, 256 * 1024);
+}
+
+GST_END_TEST;
+
 static GstEncodingContainerProfile *
 create_qtmux_profile (const gchar * variant)
 {
@@ -1890,6 +2056,8 @@ qtmux_suite (void)
   tcase_add_test (tc_chain, test_average_bitrate);
 
   tcase_add_test (tc_chain, test_reuse);
+  tcase_add_test (tc_chain, test_faststart);
+  tcase_add_test (tc_chain, test_faststart_mapped);
   tcase_add_test (tc_chain, test_encodebin_qtmux);
   tcase_add_test (tc_chain, test_encodebin_mp4mux);
 
@@ -403,6 +403,103 @@ GST_START_TEST (test_cleanup_recv2)
 
 GST_END_TEST;
 
+GST_START_TEST (test_startup_stats)
+{
+  GstElement *rtpbin;
+  GstPad *rtp_sink;
+  CleanupData data;
+  GstStateChangeReturn ret;
+  GstFlowReturn res;
+  GstBus *bus;
+  GstMessage *msg;
+  GstStructure *stats;
+  const GstStructure *stream_stats;
+  const GValue *streams;
+  guint64 first_rtp, first_push;
+  guint ssrc;
+  gboolean found = FALSE;
+
+  init_data (&data);
+
+  rtpbin = gst_element_factory_make ("rtpbin", "rtpbin");
+  bus = gst_bus_new ();
+  gst_element_set_bus (rtpbin, bus);
+
+  g_signal_connect (rtpbin, "pad-added", (GCallback) pad_added_cb, &data);
+
+  ret = gst_element_set_state (rtpbin, GST_STATE_PLAYING);
+  fail_unless (ret == GST_STATE_CHANGE_SUCCESS);
+
+  /* no streams yet */
+  g_object_get (rtpbin, "stats", &stats, NULL);
+  streams = gst_structure_get_value (stats, "streams");
+  fail_unless (streams != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (streams), 0);
+  gst_structure_free (stats);
+
+  rtp_sink = gst_element_request_pad_simple (rtpbin, "recv_rtp_sink_0");
+  fail_unless (rtp_sink != NULL);
+
+  res = chain_rtp_packet (rtp_sink, &data);
+  fail_unless (res == GST_FLOW_OK);
+  res = chain_rtp_packet (rtp_sink, &data);
+  fail_unless (res == GST_FLOW_OK);
+
+  /* the pad appears when the jitterbuffer pushed its first packet */
+  g_mutex_lock (&data.lock);
+  while (!data.pad_added)
+    g_cond_wait (&data.cond, &data.lock);
+  g_mutex_unlock (&data.lock);
+
+  g_object_get (rtpbin, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_field_typed (stats, "start-time",
+          G_TYPE_UINT64));
+  streams = gst_structure_get_value (stats, "streams");
+  fail_unless_equals_int (gst_value_array_get_size (streams), 1);
+  stream_stats =
+      gst_value_get_structure (gst_value_array_get_value (streams, 0));
+  fail_unless (gst_structure_get_uint (stream_stats, "ssrc", &ssrc));
+  fail_unless_equals_int (ssrc, 0x44a8f37c);
+  fail_unless (gst_structure_get_uint64 (stream_stats, "first-rtp",
+          &first_rtp));
+  fail_unless (gst_structure_get_uint64 (stream_stats, "first-push",
+          &first_push));
+  fail_unless (first_push >= first_rtp);
+  /* no RTCP was received */
+  fail_if (gst_structure_has_field (stream_stats, "first-rtcp-sr"));
+  gst_structure_free (stats);
+
+  /* and the milestones were posted */
+  while ((msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT))) {
+    const GstStructure *s = gst_message_get_structure (msg);
+
+    if (gst_structure_has_name (s, "GstRTPBinStartup") &&
+        !g_strcmp0 (gst_structure_get_string (s, "milestone"), "first-push")) {
+      guint64 time;
+
+      fail_unless (gst_structure_get_uint64 (s, "time", &time));
+      fail_unless_equals_uint64 (time, first_push);
+      found = TRUE;
+    }
+    gst_message_unref (msg);
+  }
+  fail_unless (found);
+
+  gst_element_release_request_pad (rtpbin, rtp_sink);
+  gst_object_unref (rtp_sink);
+
+  ret = gst_element_set_state (rtpbin, GST_STATE_NULL);
+  fail_unless (ret == GST_STATE_CHANGE_SUCCESS);
+
+  gst_element_set_bus (rtpbin, NULL);
+  gst_object_unref (bus);
+  gst_object_unref (rtpbin);
+
+  clean_data (&data);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_request_pad_by_template_name)
 {
   GstElement *rtpbin;
@@ -980,6 +1077,7 @@ rtpbin_suite (void)
   tcase_add_test (tc_chain, test_cleanup_send);
   tcase_add_test (tc_chain, test_cleanup_recv);
   tcase_add_test (tc_chain, test_cleanup_recv2);
+  tcase_add_test (tc_chain, test_startup_stats);
   tcase_add_test (tc_chain, test_request_pad_by_template_name);
   tcase_add_test (tc_chain, test_encoder);
   tcase_add_test (tc_chain, test_decoder);
@@ -542,6 +542,61 @@ GST_START_TEST (test_rtph264depay_fu_a)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtph264depay_fu_a_zero_copy)
+{
+  GstHarness *h = gst_harness_new_parse ("rtph264depay zero-copy=true");
+  GstBuffer *buffer;
+  GstMemory *mem;
+  GstMapInfo map;
+  GstFlowReturn ret;
+  guint8 expected[64] = { 0x00, 0x00, 0x00, 0x01, 0x65 };
+  gsize offset;
+
+  gst_harness_set_caps_str (h,
+      "application/x-rtp,media=video,clock-rate=90000,encoding-name=H264",
+      "video/x-h264,alignment=au,stream-format=byte-stream");
+
+  ret = gst_harness_push (h, wrap_static_buffer (rtp_h264_idr_fu_start,
+          sizeof (rtp_h264_idr_fu_start)));
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+  ret = gst_harness_push (h, wrap_static_buffer (rtp_h264_idr_fu_middle,
+          sizeof (rtp_h264_idr_fu_middle)));
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+  ret = gst_harness_push (h, wrap_static_buffer (rtp_h264_idr_fu_end,
+          sizeof (rtp_h264_idr_fu_end)));
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 1);
+
+  /* start code, reconstructed NAL header and the three FU-A payloads */
+  offset = 5;
+  memcpy (expected + offset, rtp_h264_idr_fu_start + 14,
+      sizeof (rtp_h264_idr_fu_start) - 14);
+  offset += sizeof (rtp_h264_idr_fu_start) - 14;
+  memcpy (expected + offset, rtp_h264_idr_fu_middle + 14,
+      sizeof (rtp_h264_idr_fu_middle) - 14);
+  offset += sizeof (rtp_h264_idr_fu_middle) - 14;
+  memcpy (expected + offset, rtp_h264_idr_fu_end + 14,
+      sizeof (rtp_h264_idr_fu_end) - 14);
+  offset += sizeof (rtp_h264_idr_fu_end) - 14;
+
+  buffer = gst_harness_pull (h);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), offset);
+  fail_unless (gst_buffer_memcmp (buffer, 0, expected, offset) == 0);
+
+  /* the fragments reference the RTP packets */
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 4);
+  mem = gst_buffer_peek_memory (buffer, 1);
+  fail_unless (gst_memory_map (mem, &map, GST_MAP_READ));
+  fail_unless (map.data == rtp_h264_idr_fu_start + 14);
+  gst_memory_unmap (mem, &map);
+  gst_buffer_unref (buffer);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtph264depay_fu_a_missing_start)
 {
   GstHarness *h = gst_harness_new ("rtph264depay");
@@ -978,6 +1033,81 @@ GST_START_TEST (test_rtph264pay_marker_for_fragmented_au)
 
 GST_END_TEST;
 
+static GstPadProbeReturn
+count_pushes_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  guint *counts = user_data;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    counts[1]++;
+  else
+    counts[0]++;
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_rtph264pay_buffer_list)
+{
+  GstHarness *h =
+      gst_harness_new_parse ("rtph264pay timestamp-offset=123 mtu=40"
+      " aggregate-mode=none buffer-list=true");
+  GstElement *pay;
+  GstPad *srcpad;
+  GstFlowReturn ret;
+  GstBuffer *slice1, *slice2, *buffer;
+  GstMemory *mem;
+  GstMapInfo map;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint counts[2] = { 0, 0 };
+  gint i;
+
+  pay = gst_harness_find_element (h, "rtph264pay");
+  srcpad = gst_element_get_static_pad (pay, "src");
+  gst_pad_add_probe (srcpad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      count_pushes_probe, counts, NULL);
+  gst_object_unref (srcpad);
+  gst_object_unref (pay);
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-h264,alignment=au,stream-format=byte-stream");
+
+  slice1 = wrap_static_buffer_with_pts (h264_idr_slice_1,
+      sizeof (h264_idr_slice_1), 0);
+  slice2 = wrap_static_buffer (h264_idr_slice_2, sizeof (h264_idr_slice_2));
+  buffer = gst_buffer_append (slice1, slice2);
+
+  ret = gst_harness_push (h, buffer);
+  fail_unless_equals_int (ret, GST_FLOW_OK);
+
+  /* two FU-A fragments per slice, all pushed in a single list */
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 4);
+  fail_unless_equals_int (counts[0], 0);
+  fail_unless_equals_int (counts[1], 1);
+
+  /* the first fragment references the input memory right after the NAL
+   * header */
+  buffer = gst_harness_pull (h);
+  mem = gst_buffer_peek_memory (buffer, gst_buffer_n_memory (buffer) - 1);
+  fail_unless (gst_memory_map (mem, &map, GST_MAP_READ));
+  fail_unless (map.data == h264_idr_slice_1 + 5);
+  gst_memory_unmap (mem, &map);
+  gst_buffer_unref (buffer);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_harness_pull (h);
+    fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+    fail_unless_equals_int (gst_rtp_buffer_get_marker (&rtp), i == 2);
+    fail_unless_equals_uint64 (gst_rtp_buffer_get_timestamp (&rtp), 123);
+    gst_rtp_buffer_unmap (&rtp);
+    gst_buffer_unref (buffer);
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtph264pay_aggregate_two_slices_per_buffer)
 {
   GstHarness *h = gst_harness_new_parse ("rtph264pay timestamp-offset=123"
@@ -1468,6 +1598,7 @@ rtph264_suite (void)
   tcase_add_test (tc_chain, test_rtph264depay_marker_to_flag);
   tcase_add_test (tc_chain, test_rtph264depay_stap_a_marker);
   tcase_add_test (tc_chain, test_rtph264depay_fu_a);
+  tcase_add_test (tc_chain, test_rtph264depay_fu_a_zero_copy);
   tcase_add_test (tc_chain, test_rtph264depay_fu_a_missing_start);
 
   tc_chain = tcase_create ("rtph264pay");
@@ -1477,6 +1608,7 @@ rtph264_suite (void)
   tcase_add_test (tc_chain, test_rtph264pay_marker_for_flag);
   tcase_add_test (tc_chain, test_rtph264pay_marker_for_au);
   tcase_add_test (tc_chain, test_rtph264pay_marker_for_fragmented_au);
+  tcase_add_test (tc_chain, test_rtph264pay_buffer_list);
   tcase_add_test (tc_chain, test_rtph264pay_aggregate_two_slices_per_buffer);
   tcase_add_test (tc_chain, test_rtph264pay_aggregate_with_aud);
   tcase_add_test (tc_chain, test_rtph264pay_aggregate_with_ts_change);
@@ -717,7 +717,8 @@ GST_START_TEST (test_lost_event)
   guint next_seqnum;
   guint missing_seqnum;
 
-  g_object_set (h->element, "do-lost", TRUE, NULL);
+  g_object_set (h->element, "do-lost", TRUE, "shared-timers", __i__ != 0,
+      NULL);
   next_seqnum = construct_deterministic_initial_state (h, latency_ms);
 
   /* We will now create a gap in the stream, by skipping one sequence-number,
@@ -1493,6 +1494,7 @@ GST_START_TEST (test_rtx_expected_next)
   g_object_set (h->element, "do-lost", TRUE, NULL);
   g_object_set (h->element, "do-retransmission", TRUE, NULL);
   g_object_set (h->element, "rtx-retry-period", 120, NULL);
+  g_object_set (h->element, "shared-timers", __i__ != 0, NULL);
   next_seqnum = construct_deterministic_initial_state (h, latency_ms);
 
   /* At this point there is already existing a rtx-timer for @next_seqnum,
@@ -2739,6 +2741,73 @@ GST_START_TEST (test_deadline_ts_offset_overflow)
 
 GST_END_TEST;
 
+#define FRAME_MARKING_EXT_ID 5
+
+static GstBuffer *
+generate_framemarking_buffer (GstClockTime dts, guint seq_num, guint32 rtp_ts,
+    guint8 flags, gboolean marker)
+{
+  GstBuffer *buf = generate_test_buffer_full (dts, seq_num, rtp_ts);
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+  gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp);
+  gst_rtp_buffer_set_marker (&rtp, marker);
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp,
+          FRAME_MARKING_EXT_ID, &flags, 1));
+  gst_rtp_buffer_unmap (&rtp);
+
+  return buf;
+}
+
+GST_START_TEST (test_faststart_keyframe)
+{
+  GstHarness *h = gst_harness_new ("rtpjitterbuffer");
+  GstCaps *caps;
+  GstBuffer *out_buf;
+  GstClockTime start = 10 * GST_SECOND;
+  GstClockTime first_pts;
+  const gint jb_latency_ms = 200;
+
+  caps = generate_caps ();
+  gst_caps_set_simple (caps, "extmap-5", G_TYPE_STRING,
+      "urn:ietf:params:rtp-hdrext:framemarking", NULL);
+  gst_harness_set_src_caps (h, caps);
+  g_object_set (h->element, "latency", jb_latency_ms,
+      "faststart-keyframe", TRUE, NULL);
+  gst_harness_set_time (h, start);
+
+  /* a keyframe over two packets, start (S) and independent (I) first, then
+   * end (E) with the marker bit */
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          generate_framemarking_buffer (start, 0, 0, 0xa0, FALSE)));
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          generate_framemarking_buffer (start, 1, 0, 0x60, TRUE)));
+
+  /* both are pushed without waiting for the latency, and timestamped to
+   * be rendered now */
+  out_buf = gst_harness_pull (h);
+  first_pts = GST_BUFFER_PTS (out_buf);
+  fail_unless_equals_uint64 (start - jb_latency_ms * GST_MSECOND, first_pts);
+  gst_buffer_unref (out_buf);
+  out_buf = gst_harness_pull (h);
+  fail_unless_equals_uint64 (first_pts, GST_BUFFER_PTS (out_buf));
+  gst_buffer_unref (out_buf);
+
+  /* the next frame gives back a tenth of its duration to the latency */
+  gst_harness_set_time (h, start + TEST_BUF_DURATION);
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          generate_framemarking_buffer (start + TEST_BUF_DURATION, 2,
+              TEST_RTP_TS_DURATION, 0xc0, TRUE)));
+  out_buf = gst_harness_pull (h);
+  fail_unless_equals_uint64 (first_pts + TEST_BUF_DURATION +
+      TEST_BUF_DURATION / 10, GST_BUFFER_PTS (out_buf));
+  gst_buffer_unref (out_buf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_big_gap_seqnum)
 {
   GstHarness *h = gst_harness_new ("rtpjitterbuffer");
@@ -2969,6 +3038,67 @@ GST_START_TEST (test_fill_queue)
 
 GST_END_TEST;
 
+GST_START_TEST (test_reorder_large_window)
+{
+  GstHarness *h = gst_harness_new_parse
+      ("rtpjitterbuffer latency=0 do-retransmission=1");
+  const guint num_packets = 5000;
+  GRand *rand = g_rand_new_with_seed (42);
+  GstStructure *stats;
+  guint64 duplicates;
+  guint *seqnums;
+  guint i;
+
+  gst_harness_use_testclock (h);
+  gst_harness_set_src_caps (h, generate_caps ());
+
+  /* every packet after #1 is queued until #1 gets retransmitted at the end,
+   * so the queue has to handle a lot of packets spanning a lot of seqnums.
+   * Reorder them a bit and push some duplicates on the way */
+  seqnums = g_new (guint, num_packets);
+  for (i = 0; i < num_packets; i++)
+    seqnums[i] = i;
+  for (i = 2; i + 8 <= num_packets; i += 8) {
+    guint j, k;
+
+    for (j = 7; j > 0; j--) {
+      guint tmp = seqnums[i + j];
+
+      k = g_rand_int_range (rand, 0, j + 1);
+      seqnums[i + j] = seqnums[i + k];
+      seqnums[i + k] = tmp;
+    }
+  }
+
+  gst_harness_push (h, generate_test_buffer (0));
+  gst_buffer_unref (gst_harness_pull (h));
+
+  for (i = 2; i < num_packets; i++) {
+    gst_harness_push (h, generate_test_buffer (seqnums[i]));
+    if (i % 100 == 0)
+      gst_harness_push (h, generate_test_buffer (seqnums[i - 1]));
+  }
+  gst_harness_push (h, generate_test_buffer_rtx (TEST_BUF_DURATION, 1));
+
+  for (i = 1; i < num_packets; i++) {
+    GstBuffer *buf = gst_harness_pull (h);
+    fail_unless_equals_int (i, get_rtp_seq_num (buf));
+    gst_buffer_unref (buf);
+  }
+
+  g_object_get (h->element, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "num-duplicates",
+          &duplicates));
+  fail_unless_equals_uint64 (duplicates, (num_packets - 1) / 100);
+  gst_structure_free (stats);
+
+  g_free (seqnums);
+  g_rand_free (rand);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   gint64 dts_skew;
@@ -3513,7 +3643,7 @@ rtpjitterbuffer_suite (void)
   tcase_add_test (tc_chain, test_basetime);
   tcase_add_test (tc_chain, test_clear_pt_map);
 
-  tcase_add_test (tc_chain, test_lost_event);
+  tcase_add_loop_test (tc_chain, test_lost_event, 0, 2);
   tcase_add_test (tc_chain, test_only_one_lost_event_on_large_gaps);
   tcase_add_test (tc_chain, test_two_lost_one_arrives_in_time);
   tcase_add_test (tc_chain, test_out_of_order_loss_not_reported);
@@ -3531,7 +3661,7 @@ rtpjitterbuffer_suite (void)
       G_N_ELEMENTS (no_fractional_lost_event_durations_input));
   tcase_add_test (tc_chain, test_late_lost_with_same_pts);
 
-  tcase_add_test (tc_chain, test_rtx_expected_next);
+  tcase_add_loop_test (tc_chain, test_rtx_expected_next, 0, 2);
   tcase_add_test (tc_chain, test_rtx_not_bursting_requests);
 
   tcase_add_test (tc_chain, test_rtx_next_seqnum_disabled);
@@ -3558,9 +3688,11 @@ rtpjitterbuffer_suite (void)
 
   tcase_add_test (tc_chain, test_deadline_ts_offset);
   tcase_add_test (tc_chain, test_deadline_ts_offset_overflow);
+  tcase_add_test (tc_chain, test_faststart_keyframe);
   tcase_add_test (tc_chain, test_big_gap_seqnum);
   tcase_add_test (tc_chain, test_big_gap_arrival_time);
   tcase_add_test (tc_chain, test_fill_queue);
+  tcase_add_test (tc_chain, test_reorder_large_window);
 
   tcase_add_loop_test (tc_chain,
       test_considered_lost_packet_in_large_gap_arrives, 0,
@@ -214,6 +214,103 @@ GST_START_TEST (test_rtxsend_basic)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtxsend_seqnum_wraparound)
+{
+  const guint32 main_ssrc = 1234567;
+  const guint main_pt = 96;
+  const guint32 rtx_ssrc = 7654321;
+  const guint rtx_pt = 106;
+  guint16 seqnum;
+
+  GstHarness *h = gst_harness_new ("rtprtxsend");
+  GstStructure *ssrc_map =
+      create_rtx_map ("application/x-rtp-ssrc-map", main_ssrc, rtx_ssrc);
+  GstStructure *pt_map =
+      create_rtx_map ("application/x-rtp-pt-map", main_pt, rtx_pt);
+
+  g_object_set (h->element, "ssrc-map", ssrc_map, NULL);
+  g_object_set (h->element, "payload-type-map", pt_map, NULL);
+  g_object_set (h->element, "max-size-packets", 100, NULL);
+
+  gst_harness_set_src_caps_str (h, "application/x-rtp, "
+      "clock-rate = (int)90000");
+
+  /* push packets across the seqnum wraparound, with 65534 missing and 2
+   * arriving late */
+  for (seqnum = 65530; seqnum != 6; seqnum++) {
+    if (seqnum == 65534 || seqnum == 2)
+      continue;
+    push_pull_and_verify (h, create_rtp_buffer (main_ssrc, main_pt, seqnum),
+        FALSE, main_ssrc, main_pt, seqnum);
+  }
+  push_pull_and_verify (h, create_rtp_buffer (main_ssrc, main_pt, 2),
+      FALSE, main_ssrc, main_pt, 2);
+
+  /* every stored packet can be retransmitted, the missing one can't */
+  for (seqnum = 65530; seqnum != 6; seqnum++) {
+    gst_harness_push_upstream_event (h,
+        create_rtx_event (main_ssrc, main_pt, seqnum));
+    if (seqnum != 65534)
+      pull_and_verify (h, TRUE, rtx_ssrc, rtx_pt, seqnum);
+  }
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 0);
+
+  gst_structure_free (ssrc_map);
+  gst_structure_free (pt_map);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtxsend_seqnum_restart)
+{
+  const guint32 main_ssrc = 1234567;
+  const guint main_pt = 96;
+  const guint32 rtx_ssrc = 7654321;
+  const guint rtx_pt = 106;
+  guint16 seqnum;
+
+  GstHarness *h = gst_harness_new ("rtprtxsend");
+  GstStructure *ssrc_map =
+      create_rtx_map ("application/x-rtp-ssrc-map", main_ssrc, rtx_ssrc);
+  GstStructure *pt_map =
+      create_rtx_map ("application/x-rtp-pt-map", main_pt, rtx_pt);
+
+  g_object_set (h->element, "ssrc-map", ssrc_map, NULL);
+  g_object_set (h->element, "payload-type-map", pt_map, NULL);
+  g_object_set (h->element, "max-size-packets", 10, NULL);
+
+  gst_harness_set_src_caps_str (h, "application/x-rtp, "
+      "clock-rate = (int)90000");
+
+  for (seqnum = 10000; seqnum < 10020; seqnum++)
+    push_pull_and_verify (h, create_rtp_buffer (main_ssrc, main_pt, seqnum),
+        FALSE, main_ssrc, main_pt, seqnum);
+
+  /* the payloader restarts with lower seqnums, which must not be trimmed as
+   * if they were older than the ones stored before */
+  for (seqnum = 5000; seqnum < 5005; seqnum++)
+    push_pull_and_verify (h, create_rtp_buffer (main_ssrc, main_pt, seqnum),
+        FALSE, main_ssrc, main_pt, seqnum);
+
+  for (seqnum = 5000; seqnum < 5005; seqnum++) {
+    gst_harness_push_upstream_event (h,
+        create_rtx_event (main_ssrc, main_pt, seqnum));
+    pull_and_verify (h, TRUE, rtx_ssrc, rtx_pt, seqnum);
+  }
+
+  /* the packets from before the restart are gone */
+  gst_harness_push_upstream_event (h,
+      create_rtx_event (main_ssrc, main_pt, 10019));
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 0);
+
+  gst_structure_free (ssrc_map);
+  gst_structure_free (pt_map);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtxsend_disabled_enabled_disabled)
 {
   const guint32 main_ssrc = 1234567;
@@ -1173,6 +1270,8 @@ rtprtx_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_rtxsend_basic);
+  tcase_add_test (tc_chain, test_rtxsend_seqnum_wraparound);
+  tcase_add_test (tc_chain, test_rtxsend_seqnum_restart);
   tcase_add_test (tc_chain, test_rtxsend_disabled_enabled_disabled);
   tcase_add_test (tc_chain, test_rtxsend_configured_not_playing_cleans_up);
 
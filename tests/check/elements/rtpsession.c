@@ -2477,6 +2477,55 @@ GST_START_TEST (test_disable_probation)
 
 GST_END_TEST;
 
+GST_START_TEST (test_many_sources_receive_stats)
+{
+  SessionHarness *h = session_harness_new ();
+  const guint num_sources = 500;
+  const guint num_packets = 10;
+  guint i, j;
+
+  /* packets of validated senders don't take the session lock, make sure
+   * their statistics are kept as before */
+  for (i = 0; i < num_packets; i++) {
+    for (j = 0; j < num_sources; j++) {
+      fail_unless_equals_int (GST_FLOW_OK, session_harness_recv_rtp (h,
+              generate_test_buffer (i, 0x10000 + j)));
+    }
+  }
+  fail_unless_equals_int (num_sources * num_packets,
+      gst_harness_buffers_in_queue (h->recv_rtp_h));
+
+  for (j = 0; j < num_sources; j++) {
+    GObject *source;
+    GstStructure *stats;
+    guint64 packets_received;
+    gint packets_lost;
+    gboolean is_sender, validated;
+
+    g_signal_emit_by_name (h->internal_session, "get-source-by-ssrc",
+        0x10000 + j, &source);
+    fail_unless (source != NULL);
+
+    g_object_get (source, "stats", &stats, NULL);
+    fail_unless (gst_structure_get (stats,
+            "packets-received", G_TYPE_UINT64, &packets_received,
+            "packets-lost", G_TYPE_INT, &packets_lost,
+            "is-sender", G_TYPE_BOOLEAN, &is_sender,
+            "validated", G_TYPE_BOOLEAN, &validated, NULL));
+    fail_unless_equals_uint64 (packets_received, num_packets);
+    fail_unless_equals_int (packets_lost, 0);
+    fail_unless (is_sender);
+    fail_unless (validated);
+
+    gst_structure_free (stats);
+    g_object_unref (source);
+  }
+
+  session_harness_free (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_request_late_nack)
 {
   SessionHarness *h = session_harness_new ();
@@ -3833,6 +3882,51 @@ GST_START_TEST (test_twcc_recv_packets_reordered)
 
 GST_END_TEST;
 
+GST_START_TEST (test_twcc_recv_packets_reordered_and_duplicated)
+{
+  SessionHarness *h = session_harness_new ();
+  GstBuffer *buf;
+
+  /* #2 arrives after #3, and #3 arrives twice */
+  TWCCPacket packets[] = {
+    {1, 1 * 250 * GST_USECOND, FALSE}
+    ,
+    {3, 2 * 250 * GST_USECOND, FALSE}
+    ,
+    {2, 3 * 250 * GST_USECOND, FALSE}
+    ,
+    {3, 4 * 250 * GST_USECOND, FALSE}
+    ,
+    {4, 5 * 250 * GST_USECOND, TRUE}
+    ,
+  };
+
+  /* all packets are reported in seqnum order, and only the first arrival
+     of #3 is used */
+  guint8 exp_fci[] = {
+    0x00, 0x01,                 /* base sequence number: 1 */
+    0x00, 0x04,                 /* packet status count: 4 */
+    0x00, 0x00, 0x00,           /* reference time: 0 */
+    0x00,                       /* feedback packet count: 0 */
+    /* packet chunks: */
+    0xd6, 0x40,                 /* 1 1 0 1 0 1 1 0 | 0 1 0 0 0 0 0 0 */
+    0x01, 0x02,                 /* recv deltas, +1, +2 */
+    0xff, 0xff,                 /* recv delta, -1 */
+    0x03,                       /* recv delta, +3 */
+    0x00,                       /* padding */
+  };
+
+  twcc_push_packets (h, packets);
+
+  buf = session_harness_produce_twcc (h);
+  twcc_verify_fci (buf, exp_fci);
+  gst_buffer_unref (buf);
+
+  session_harness_free (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_twcc_recv_late_packet_fb_pkt_count_wrap)
 {
   SessionHarness *h = session_harness_new ();
@@ -4041,6 +4135,117 @@ GST_START_TEST (test_twcc_send_and_recv)
 
 GST_END_TEST;
 
+GST_START_TEST (test_twcc_target_bitrate)
+{
+  SessionHarness *h_send = session_harness_new ();
+  SessionHarness *h_recv = session_harness_new ();
+  guint frame;
+  const guint num_frames = 20;
+  const guint num_slices = 15;
+  GstClockTime queuing_delay = 0;
+  guint target_bitrate, stable_bitrate = 0;
+
+  /* enable twcc */
+  session_harness_set_twcc_recv_ext_id (h_recv, TEST_TWCC_EXT_ID);
+  session_harness_set_twcc_send_ext_id (h_send, TEST_TWCC_EXT_ID);
+
+  for (frame = 0; frame < num_frames; frame++) {
+    GstBuffer *buf;
+    guint slice;
+
+    for (slice = 0; slice < num_slices; slice++) {
+      guint seq = frame * num_slices + slice;
+
+      buf = generate_twcc_send_buffer (seq, slice == num_slices - 1);
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_send_rtp (h_send, buf));
+      session_harness_advance_and_crank (h_send, TEST_BUF_DURATION);
+      buf = session_harness_pull_send_rtp (h_send);
+
+      /* for the second half, the network queues more and more */
+      if (frame >= num_frames / 2) {
+        queuing_delay += 10 * GST_MSECOND;
+        buf = gst_buffer_make_writable (buf);
+        GST_BUFFER_DTS (buf) += queuing_delay;
+      }
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_recv_rtp (h_recv, buf));
+    }
+
+    session_harness_recv_rtcp (h_send, session_harness_produce_twcc (h_recv));
+
+    if (frame == num_frames / 2 - 1) {
+      /* the estimation goes up from the 300 kbps it starts from */
+      g_object_get (h_send->session, "twcc-target-bitrate", &stable_bitrate,
+          NULL);
+      fail_unless (stable_bitrate > 300000);
+      fail_unless (stable_bitrate <= 1.5 * TEST_BUF_BPS + 10000);
+    }
+  }
+
+  /* and comes down once the delay starts building up */
+  g_object_get (h_send->session, "twcc-target-bitrate", &target_bitrate,
+      NULL);
+  fail_unless (target_bitrate < stable_bitrate, "%u >= %u", target_bitrate,
+      stable_bitrate);
+
+  session_harness_free (h_send);
+  session_harness_free (h_recv);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_twcc_target_bitrate_sustained_loss)
+{
+  SessionHarness *h_send = session_harness_new ();
+  SessionHarness *h_recv = session_harness_new ();
+  guint frame;
+  const guint num_frames = 40;
+  const guint num_slices = 15;
+  guint target_bitrate;
+
+  /* enable twcc */
+  session_harness_set_twcc_recv_ext_id (h_recv, TEST_TWCC_EXT_ID);
+  session_harness_set_twcc_send_ext_id (h_send, TEST_TWCC_EXT_ID);
+
+  for (frame = 0; frame < num_frames; frame++) {
+    GstBuffer *buf;
+    guint slice;
+
+    for (slice = 0; slice < num_slices; slice++) {
+      guint seq = frame * num_slices + slice;
+
+      buf = generate_twcc_send_buffer (seq, slice == num_slices - 1);
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_send_rtp (h_send, buf));
+      session_harness_advance_and_crank (h_send, TEST_BUF_DURATION);
+      buf = session_harness_pull_send_rtp (h_send);
+
+      /* the network loses one packet out of 16, about 6% */
+      if (seq % 16 == 15) {
+        gst_buffer_unref (buf);
+        continue;
+      }
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_recv_rtp (h_recv, buf));
+    }
+
+    session_harness_recv_rtcp (h_send, session_harness_produce_twcc (h_recv));
+
+    /* the loss based estimation neither grows between the feedbacks that
+     * happen to report no loss nor collapses */
+    g_object_get (h_send->session, "twcc-target-bitrate", &target_bitrate,
+        NULL);
+    fail_unless (target_bitrate <= 300000, "%u > 300000", target_bitrate);
+    fail_unless (target_bitrate >= 250000, "%u < 250000", target_bitrate);
+  }
+
+  session_harness_free (h_send);
+  session_harness_free (h_recv);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_twcc_multiple_payloads_below_window)
 {
   SessionHarness *h_send = session_harness_new ();
@@ -4343,6 +4548,7 @@ rtpsession_suite (void)
   tcase_add_test (tc_chain, test_disable_sr_timestamp);
   tcase_add_test (tc_chain, test_on_sending_nacks);
   tcase_add_test (tc_chain, test_disable_probation);
+  tcase_add_test (tc_chain, test_many_sources_receive_stats);
   tcase_add_test (tc_chain, test_request_late_nack);
   tcase_add_test (tc_chain, test_clear_pt_map_stress);
   tcase_add_test (tc_chain, test_packet_rate);
@@ -4373,10 +4579,13 @@ rtpsession_suite (void)
   tcase_add_test (tc_chain, test_twcc_delta_ts_rounding);
   tcase_add_test (tc_chain, test_twcc_double_gap);
   tcase_add_test (tc_chain, test_twcc_recv_packets_reordered);
+  tcase_add_test (tc_chain, test_twcc_recv_packets_reordered_and_duplicated);
   tcase_add_test (tc_chain, test_twcc_recv_late_packet_fb_pkt_count_wrap);
   tcase_add_test (tc_chain, test_twcc_recv_rtcp_reordered);
   tcase_add_test (tc_chain, test_twcc_no_exthdr_in_buffer);
   tcase_add_test (tc_chain, test_twcc_send_and_recv);
+  tcase_add_test (tc_chain, test_twcc_target_bitrate);
+  tcase_add_test (tc_chain, test_twcc_target_bitrate_sustained_loss);
   tcase_add_test (tc_chain, test_twcc_multiple_payloads_below_window);
   tcase_add_loop_test (tc_chain, test_twcc_feedback_interval, 0,
       G_N_ELEMENTS (test_twcc_feedback_interval_ctx));
@@ -453,6 +453,104 @@ GST_START_TEST (test_rtp_and_rtcp_arrives_simultaneously)
 
 GST_END_TEST;
 
+static void
+new_ssrc_pad_indexed (GstElement * element, guint ssrc,
+    G_GNUC_UNUSED GstPad * pad, GstHarness ** src_h)
+{
+  gchar *name = g_strdup_printf ("src_%u", ssrc);
+
+  src_h[ssrc] = gst_harness_new_with_element (element, NULL, name);
+  g_free (name);
+}
+
+static GstPadProbeReturn
+block_probe_cb (G_GNUC_UNUSED GstPad * pad,
+    G_GNUC_UNUSED GstPadProbeInfo * info, gint * blocked)
+{
+  g_atomic_int_set (blocked, 1);
+  return GST_PAD_PROBE_OK;
+}
+
+static guint16
+pull_seqnum (GstHarness * h)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf = gst_harness_pull (h);
+  guint16 seqnum;
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  seqnum = gst_rtp_buffer_get_seq (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+
+  return seqnum;
+}
+
+GST_START_TEST (test_rtpssrcdemux_threaded_leaky)
+{
+  GstHarness *h = gst_harness_new_with_padnames ("rtpssrcdemux", "sink", NULL);
+  GstHarness *src_h[2] = { NULL, NULL };
+  gint blocked = 0;
+  GstPad *srcpad;
+  gulong probe_id;
+  guint level;
+  guint64 dropped;
+  guint i;
+
+  g_object_set (h->element, "threaded", TRUE, "max-size-buffers", 5,
+      "leaky", 2 /* downstream */ , NULL);
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+  g_signal_connect (h->element,
+      "new-ssrc-pad", (GCallback) new_ssrc_pad_indexed, src_h);
+  gst_harness_play (h);
+
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          create_buffer (0, 0)));
+  fail_unless (src_h[0] != NULL);
+  fail_unless_equals_int (pull_seqnum (src_h[0]), 0);
+
+  /* stall the branch of SSRC 0 on its next buffer */
+  srcpad = gst_element_get_static_pad (h->element, "src_0");
+  probe_id = gst_pad_add_probe (srcpad,
+      GST_PAD_PROBE_TYPE_BLOCK | GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) block_probe_cb, &blocked, NULL);
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          create_buffer (1, 0)));
+  while (!g_atomic_int_get (&blocked))
+    g_usleep (G_USEC_PER_SEC / 100);
+
+  /* the queue of SSRC 0 fills up and leaks its oldest buffers, without
+   * blocking upstream */
+  for (i = 2; i < 20; i++) {
+    fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+            create_buffer (i, 0)));
+  }
+  g_object_get (srcpad, "current-level-buffers", &level, "dropped", &dropped,
+      NULL);
+  fail_unless_equals_int (level, 5);
+  fail_unless_equals_int (dropped, 13);
+
+  /* meanwhile SSRC 1 flows */
+  fail_unless_equals_int (GST_FLOW_OK, gst_harness_push (h,
+          create_buffer (0, 1)));
+  fail_unless (src_h[1] != NULL);
+  fail_unless_equals_int (pull_seqnum (src_h[1]), 0);
+
+  /* once unblocked, SSRC 0 gets the buffer it was stuck on and the most
+   * recent ones */
+  gst_pad_remove_probe (srcpad, probe_id);
+  fail_unless_equals_int (pull_seqnum (src_h[0]), 1);
+  for (i = 15; i < 20; i++)
+    fail_unless_equals_int (pull_seqnum (src_h[0]), i);
+
+  gst_object_unref (srcpad);
+  gst_harness_teardown (src_h[0]);
+  gst_harness_teardown (src_h[1]);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtpssrcdemux_suite (void)
 {
@@ -467,6 +565,7 @@ rtpssrcdemux_suite (void)
   tcase_add_test (tc_chain, test_rtpssrcdemux_invalid_rtp);
   tcase_add_test (tc_chain, test_rtpssrcdemux_invalid_rtcp);
   tcase_add_test (tc_chain, test_rtp_and_rtcp_arrives_simultaneously);
+  tcase_add_test (tc_chain, test_rtpssrcdemux_threaded_leaky);
 
   return s;
 }
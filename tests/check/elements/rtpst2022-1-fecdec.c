@@ -424,6 +424,65 @@ GST_START_TEST (test_variable_length)
 
 GST_END_TEST;
 
+/**
+ * +-------------------------+
+ * | 65534 | 65535 |    x    | l1
+ * +-------------------------+
+ *
+ * Recovers seqnum 0 across the seqnum wraparound, with payloads large
+ * enough to go through the vectorized XOR path and a length that isn't a
+ * multiple of the vector size
+ */
+#define WRAP_PAYLOAD_LEN 1331
+
+GST_START_TEST (test_wraparound)
+{
+  guint8 payload[WRAP_PAYLOAD_LEN];
+  guint8 fec_payload[WRAP_PAYLOAD_LEN];
+  GstHarness *h =
+      gst_harness_new_with_padnames ("rtpst2022-1-fecdec", NULL, "src");
+  GstHarness *h0 = gst_harness_new_with_element (h->element, "sink", NULL);
+  GstHarness *h_fec_1 =
+      gst_harness_new_with_element (h->element, "fec_1", NULL);
+  guint i;
+
+  gst_harness_set_src_caps_str (h0, "application/x-rtp");
+  gst_harness_set_src_caps_str (h_fec_1, "application/x-rtp");
+
+  memset (fec_payload, 0x00, WRAP_PAYLOAD_LEN);
+
+  for (i = 0; i < WRAP_PAYLOAD_LEN; i++)
+    payload[i] = i * 7;
+  _xor_mem (fec_payload, payload, WRAP_PAYLOAD_LEN);
+  gst_harness_push (h0, make_media_sample (65534, 0, payload,
+          WRAP_PAYLOAD_LEN));
+
+  for (i = 0; i < WRAP_PAYLOAD_LEN; i++)
+    payload[i] = i * 13 + 5;
+  _xor_mem (fec_payload, payload, WRAP_PAYLOAD_LEN);
+  gst_harness_push (h0, make_media_sample (65535, 0, payload,
+          WRAP_PAYLOAD_LEN));
+
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 2);
+  while (gst_harness_buffers_in_queue (h)) {
+    gst_buffer_unref (gst_harness_pull (h));
+  }
+
+  for (i = 0; i < WRAP_PAYLOAD_LEN; i++)
+    payload[i] = i ^ 0xa5;
+  _xor_mem (fec_payload, payload, WRAP_PAYLOAD_LEN);
+  gst_harness_push (h_fec_1, make_fec_sample (0, 0, 65534, TRUE, 1, 3, 0,
+          fec_payload, WRAP_PAYLOAD_LEN, WRAP_PAYLOAD_LEN));
+
+  pull_and_check (h, 0, 0, payload, WRAP_PAYLOAD_LEN, 1);
+
+  gst_harness_teardown (h);
+  gst_harness_teardown (h0);
+  gst_harness_teardown (h_fec_1);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 st2022_1_dec_suite (void)
@@ -437,6 +496,7 @@ st2022_1_dec_suite (void)
   tcase_add_test (tc_chain, test_column);
   tcase_add_test (tc_chain, test_2d);
   tcase_add_test (tc_chain, test_variable_length);
+  tcase_add_test (tc_chain, test_wraparound);
 
   return s;
 }
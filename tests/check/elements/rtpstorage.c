@@ -260,6 +260,103 @@ GST_START_TEST (test_rtpstorage_put_recovered_packet)
 
 GST_END_TEST;
 
+static void
+verify_packets_for_recovery (GstHarness * h, guint16 lost_seq,
+    GstBuffer ** expected, guint n_expected)
+{
+  GstBufferList *bufs_out;
+  guint i;
+
+  bufs_out = get_packets_for_recovery (h, 100, 0xabe2b0b, lost_seq);
+  if (n_expected == 0) {
+    fail_unless (NULL == bufs_out);
+    return;
+  }
+
+  fail_unless (NULL != bufs_out);
+  fail_unless_equals_int (n_expected, gst_buffer_list_length (bufs_out));
+  for (i = 0; i < n_expected; ++i)
+    fail_unless (gst_buffer_list_get (bufs_out, i) == expected[i]);
+  gst_buffer_list_unref (bufs_out);
+}
+
+GST_START_TEST (rtpstorage_recovery_search)
+{
+  /* Seqnums wrap around, 65534 and 3 are lost */
+  const guint16 seqs[] = { 65533, 65535, 0, 1, 2, 4 };
+  const guint8 pts[] = { 96, 96, 100, 100, 96, 100 };
+  GstBuffer *bufs[G_N_ELEMENTS (seqs)];
+  GstHarness *h = gst_harness_new ("rtpstorage");
+  guint i;
+
+  g_object_set (h->element, "size-time", (guint64) 10 * RTP_PACKET_DUR, NULL);
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+
+  for (i = 0; i < G_N_ELEMENTS (seqs); ++i) {
+    GstBuffer *buf = create_rtp_packet (pts[i], 0xabe2b0b, RTP_TSTAMP (i),
+        seqs[i]);
+
+    GST_BUFFER_DTS (buf) = GST_TSTAMP (i);
+    bufs[i] = gst_harness_push_and_pull (h, buf);
+  }
+
+  /* The media run before the first FEC run, across the wraparound */
+  verify_packets_for_recovery (h, 65534, bufs, 4);
+  /* Older than anything stored, the search starts from the oldest packet */
+  verify_packets_for_recovery (h, 65500, bufs, 4);
+  /* The last media run and its FEC */
+  verify_packets_for_recovery (h, 3, &bufs[4], 2);
+  /* A stored packet is returned alone */
+  verify_packets_for_recovery (h, 0, &bufs[2], 1);
+  /* Nothing newer than the newest packet can be recovered */
+  verify_packets_for_recovery (h, 5, NULL, 0);
+
+  for (i = 0; i < G_N_ELEMENTS (bufs); ++i)
+    gst_buffer_unref (bufs[i]);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (rtpstorage_seqnum_restart)
+{
+  /* After the restart 5001 is lost */
+  const guint16 restart_seqs[] = { 5000, 5002, 5003 };
+  const guint8 restart_pts[] = { 96, 100, 100 };
+  GstBuffer *bufs[10], *restart_bufs[G_N_ELEMENTS (restart_seqs)];
+  GstHarness *h = gst_harness_new ("rtpstorage");
+  guint i;
+
+  g_object_set (h->element, "size-time", (guint64) 20 * RTP_PACKET_DUR, NULL);
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+
+  for (i = 0; i < G_N_ELEMENTS (bufs); ++i)
+    bufs[i] = gst_harness_push_and_pull (h, create_rtp_packet (96, 0xabe2b0b,
+            RTP_TSTAMP (i), 10000 + i));
+
+  /* The sender restarts with lower seqnums */
+  for (i = 0; i < G_N_ELEMENTS (restart_seqs); ++i) {
+    GstBuffer *buf = create_rtp_packet (restart_pts[i], 0xabe2b0b,
+        RTP_TSTAMP (G_N_ELEMENTS (bufs) + i), restart_seqs[i]);
+
+    GST_BUFFER_DTS (buf) = GST_TSTAMP (10000 + G_N_ELEMENTS (bufs) + i);
+    restart_bufs[i] = gst_harness_push_and_pull (h, buf);
+  }
+
+  /* The packets from before the restart were dropped right away */
+  for (i = 0; i < G_N_ELEMENTS (bufs); ++i) {
+    fail_unless (gst_buffer_is_writable (bufs[i]));
+    gst_buffer_unref (bufs[i]);
+  }
+
+  verify_packets_for_recovery (h, 5001, restart_bufs, 3);
+
+  for (i = 0; i < G_N_ELEMENTS (restart_bufs); ++i)
+    gst_buffer_unref (restart_bufs[i]);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
 
 static void
 _single_ssrc_test (GstHarness * h, guint32 ssrc,
@@ -542,6 +639,8 @@ rtpstorage_suite (void)
   tcase_add_test (tc_chain, rtpstorage_loss_pattern8);
   tcase_add_test (tc_chain, rtpstorage_loss_pattern9);
   tcase_add_test (tc_chain, test_rtpstorage_put_recovered_packet);
+  tcase_add_test (tc_chain, rtpstorage_recovery_search);
+  tcase_add_test (tc_chain, rtpstorage_seqnum_restart);
   tcase_add_test (tc_chain, rtpstorage_stress);
 
   return s;
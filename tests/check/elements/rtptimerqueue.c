@@ -20,6 +20,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/rtp/gstrtpbuffer.h>
 #include "gst/rtpmanager/rtptimerqueue.h"
 
 GST_START_TEST (test_timer_queue_set_timer)
@@ -305,6 +306,156 @@ GST_START_TEST (test_timer_queue_timer_offset)
 
 GST_END_TEST;
 
+/* Checks that the queue is sorted the same way as with few timers */
+static void
+check_queue_order (RtpTimerQueue * queue, guint expected_length)
+{
+  RtpTimer *timer, *next;
+  guint length = 0;
+
+  for (timer = rtp_timer_queue_peek_earliest (queue); timer; timer = next) {
+    next = rtp_timer_get_next (timer);
+    length++;
+
+    if (next == NULL)
+      break;
+
+    fail_unless (rtp_timer_get_prev (next) == timer);
+
+    if (GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+      fail_unless (GST_CLOCK_TIME_IS_VALID (next->timeout));
+      fail_unless (timer->timeout <= next->timeout);
+    }
+    if (timer->timeout == next->timeout)
+      fail_unless (gst_rtp_buffer_compare_seqnum (timer->seqnum,
+              next->seqnum) > 0);
+  }
+
+  fail_unless_equals_int (length, expected_length);
+  fail_unless_equals_int (rtp_timer_queue_length (queue), expected_length);
+}
+
+GST_START_TEST (test_timer_queue_many_timers)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  GRand *rand = g_rand_new_with_seed (42);
+  RtpTimer *timer;
+  GstClockTime last = 0;
+  guint i, n = 0;
+
+  /* enough timers to have the queue indexed, with random timeouts and some
+   * identical ones and some without timeout */
+  for (i = 0; i < 1000; i++) {
+    GstClockTime timeout = g_rand_int_range (rand, 0, 100) * GST_MSECOND;
+
+    if (i % 50 == 0)
+      timeout = GST_CLOCK_TIME_NONE;
+
+    rtp_timer_queue_set_expected (queue, i, timeout, 0, 0);
+  }
+  check_queue_order (queue, 1000);
+
+  /* reschedule, change seqnum and unschedule some timers */
+  for (i = 0; i < 1000; i += 3) {
+    timer = rtp_timer_queue_find (queue, i);
+    fail_unless (timer != NULL);
+    rtp_timer_queue_update_timer (queue, timer, i + 2000,
+        g_rand_int_range (rand, 0, 100) * GST_MSECOND, 0, 0, FALSE);
+  }
+  check_queue_order (queue, 1000);
+
+  for (i = 1; i < 1000; i += 3) {
+    timer = rtp_timer_queue_find (queue, i);
+    fail_unless (timer != NULL);
+    rtp_timer_queue_unschedule (queue, timer);
+    rtp_timer_free (timer);
+  }
+  check_queue_order (queue, 667);
+
+  /* pop everything, going back to an unindexed queue on the way */
+  while ((timer = rtp_timer_queue_pop_until (queue, 50 * GST_MSECOND))) {
+    if (GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+      fail_unless (timer->timeout >= last);
+      last = timer->timeout;
+    }
+    rtp_timer_free (timer);
+    n++;
+  }
+  fail_unless (n > 0);
+  check_queue_order (queue, 667 - n);
+
+  while ((timer = rtp_timer_queue_pop_until (queue, GST_CLOCK_TIME_NONE))) {
+    fail_unless (timer->timeout >= last);
+    last = timer->timeout;
+    rtp_timer_free (timer);
+  }
+  check_queue_order (queue, 0);
+
+  /* and use it again */
+  for (i = 0; i < 500; i++)
+    rtp_timer_queue_set_lost (queue, i, (500 - i) * GST_MSECOND, 0, 0);
+  check_queue_order (queue, 500);
+  timer = rtp_timer_queue_peek_earliest (queue);
+  fail_unless_equals_int (timer->seqnum, 499);
+
+  g_rand_free (rand);
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
+#define BENCH_NUM_TIMERS 4000
+#define BENCH_NUM_ROUNDS 20
+
+/* Mimics a lossy stream with a big latency: thousands of expected timers of
+ * which the ones around random seqnums get rescheduled, as when
+ * retransmissions are requested or packets arrive reordered */
+GST_START_TEST (test_timer_queue_benchmark)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  GRand *rand = g_rand_new_with_seed (42);
+  RtpTimer *timer;
+  gint64 start, elapsed;
+  guint i, round;
+
+  start = g_get_monotonic_time ();
+
+  for (round = 0; round < BENCH_NUM_ROUNDS; round++) {
+    for (i = 0; i < BENCH_NUM_TIMERS; i++)
+      rtp_timer_queue_set_expected (queue, i, i * GST_MSECOND,
+          2 * GST_SECOND, 0);
+
+    for (i = 0; i < BENCH_NUM_TIMERS; i++) {
+      guint seqnum = g_rand_int_range (rand, 0, BENCH_NUM_TIMERS);
+
+      timer = rtp_timer_queue_find (queue, seqnum);
+      rtp_timer_queue_update_timer (queue, timer, seqnum,
+          g_rand_int_range (rand, 0, BENCH_NUM_TIMERS) * GST_MSECOND,
+          2 * GST_SECOND, 0, FALSE);
+    }
+
+    for (i = 0; i < BENCH_NUM_TIMERS; i += 2) {
+      timer = rtp_timer_queue_find (queue, i);
+      rtp_timer_queue_unschedule (queue, timer);
+      rtp_timer_free (timer);
+    }
+
+    rtp_timer_queue_remove_all (queue);
+  }
+
+  elapsed = g_get_monotonic_time () - start;
+
+  GST_INFO ("%d rounds with %d timers took %" G_GINT64_FORMAT " us",
+      BENCH_NUM_ROUNDS, BENCH_NUM_TIMERS, elapsed);
+
+  fail_unless_equals_int (rtp_timer_queue_length (queue), 0);
+
+  g_rand_free (rand);
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtptimerqueue_suite (void)
 {
@@ -319,6 +470,8 @@ rtptimerqueue_suite (void)
   tcase_add_test (tc_chain, test_timer_queue_update_timer_seqnum);
   tcase_add_test (tc_chain, test_timer_queue_dup_timer);
   tcase_add_test (tc_chain, test_timer_queue_timer_offset);
+  tcase_add_test (tc_chain, test_timer_queue_many_timers);
+  tcase_add_test (tc_chain, test_timer_queue_benchmark);
 
   return s;
 }
@@ -644,6 +644,130 @@ GST_START_TEST (rtpulpfecdec_fecstorage_gives_no_buffers)
 
 GST_END_TEST;
 
+#define BENCH_NUM_FRAMES 500
+#define BENCH_PACKETS_PER_FRAME 10
+#define BENCH_PAYLOAD_LEN 1200
+#define BENCH_SSRC 0x2a2a2a2a
+#define BENCH_MEDIA_PT 96
+#define BENCH_FEC_PT 100
+
+static const guint bench_fec_percentage[] = { 10, 30 };
+
+/* Protects frames of full-size packets with rtpulpfecenc, loses the first
+ * packet of every frame and recovers it with rtpulpfecdec, reporting the
+ * throughput of both sides at 10% and 30% FEC overhead */
+GST_START_TEST (rtpulpfec_benchmark)
+{
+  guint percentage = bench_fec_percentage[__i__];
+  GstHarness *h_enc = gst_harness_new ("rtpulpfecenc");
+  GstHarness *h_dec =
+      harness_rtpulpfecdec (BENCH_SSRC, BENCH_MEDIA_PT, BENCH_FEC_PT);
+  GstBuffer *frame_bufs[BENCH_PACKETS_PER_FRAME];
+  guint8 payload[BENCH_PAYLOAD_LEN];
+  gint64 start, enc_time = 0, dec_time = 0;
+  guint n_fec = 0, n_recovered = 0, packets_recovered = 0;
+  guint64 n_bytes;
+  guint16 seq = 0;
+  guint frame, i;
+
+  gst_harness_set (h_enc, "rtpulpfecenc", "pt", BENCH_FEC_PT,
+      "percentage", percentage, "multipacket", TRUE, NULL);
+  gst_harness_set_src_caps_str (h_enc, "application/x-rtp");
+
+  for (i = 0; i < BENCH_PAYLOAD_LEN; i++)
+    payload[i] = i * 7;
+
+  for (frame = 0; frame < BENCH_NUM_FRAMES; frame++) {
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    GstBuffer *buf;
+    gboolean have_lost = FALSE;
+    guint16 lost_seq = 0;
+
+    for (i = 0; i < BENCH_PACKETS_PER_FRAME; i++) {
+      buf = gst_rtp_buffer_new_allocate (BENCH_PAYLOAD_LEN, 0, 0);
+      fail_unless (gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp));
+      gst_rtp_buffer_set_ssrc (&rtp, BENCH_SSRC);
+      gst_rtp_buffer_set_payload_type (&rtp, BENCH_MEDIA_PT);
+      gst_rtp_buffer_set_seq (&rtp, seq++);
+      gst_rtp_buffer_set_timestamp (&rtp, frame * 900);
+      gst_rtp_buffer_set_marker (&rtp, i == BENCH_PACKETS_PER_FRAME - 1);
+      payload[i] ^= frame;
+      memcpy (gst_rtp_buffer_get_payload (&rtp), payload, BENCH_PAYLOAD_LEN);
+      gst_rtp_buffer_unmap (&rtp);
+      GST_BUFFER_PTS (buf) = frame * RTP_PACKET_DUR;
+      frame_bufs[i] = buf;
+    }
+
+    start = g_get_monotonic_time ();
+    for (i = 0; i < BENCH_PACKETS_PER_FRAME; i++)
+      fail_unless_equals_int (gst_harness_push (h_enc, frame_bufs[i]),
+          GST_FLOW_OK);
+    enc_time += g_get_monotonic_time () - start;
+
+    start = g_get_monotonic_time ();
+    while ((buf = gst_harness_try_pull (h_enc))) {
+      GstBuffer *out;
+      guint8 pt;
+      guint16 buf_seq;
+
+      fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+      pt = gst_rtp_buffer_get_payload_type (&rtp);
+      buf_seq = gst_rtp_buffer_get_seq (&rtp);
+      gst_rtp_buffer_unmap (&rtp);
+
+      if (pt == BENCH_FEC_PT)
+        n_fec++;
+
+      if (pt == BENCH_MEDIA_PT && !have_lost) {
+        lost_seq = buf_seq;
+        have_lost = TRUE;
+        gst_buffer_unref (buf);
+        continue;
+      }
+
+      fail_unless_equals_int (gst_harness_push (h_dec, buf), GST_FLOW_OK);
+      while ((out = gst_harness_try_pull (h_dec)))
+        gst_buffer_unref (out);
+    }
+
+    if (have_lost) {
+      GstBuffer *out;
+
+      gst_harness_push_event (h_dec,
+          gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+              gst_structure_new ("GstRTPPacketLost",
+                  "seqnum", G_TYPE_UINT, (guint) lost_seq,
+                  "timestamp", G_TYPE_UINT64, frame * RTP_PACKET_DUR,
+                  "duration", G_TYPE_UINT64, RTP_PACKET_DUR, NULL)));
+      if ((out = gst_harness_try_pull (h_dec))) {
+        n_recovered++;
+        gst_buffer_unref (out);
+      }
+    }
+    dec_time += g_get_monotonic_time () - start;
+  }
+
+  n_bytes = (guint64) BENCH_NUM_FRAMES * BENCH_PACKETS_PER_FRAME *
+      BENCH_PAYLOAD_LEN;
+  GST_INFO ("%u%% FEC: %u FEC packets for %u media packets, encoding at "
+      "%.1f MB/s, decoding at %.1f MB/s, %u of %u losses recovered",
+      percentage, n_fec, BENCH_NUM_FRAMES * BENCH_PACKETS_PER_FRAME,
+      enc_time ? (gdouble) n_bytes / enc_time : 0.,
+      dec_time ? (gdouble) n_bytes / dec_time : 0., n_recovered,
+      BENCH_NUM_FRAMES);
+
+  fail_unless (n_fec > 0);
+  fail_unless (n_recovered > 0);
+  gst_harness_get (h_dec, "rtpulpfecdec", "recovered", &packets_recovered,
+      NULL);
+  fail_unless_equals_int (packets_recovered, n_recovered);
+
+  gst_harness_teardown (h_enc);
+  gst_harness_teardown (h_dec);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtpfec_suite (void)
 {
@@ -665,6 +789,10 @@ rtpfec_suite (void)
   tcase_add_test (tc_chain, rtpulpfecdec_invalid_recovered);
   tcase_add_test (tc_chain, rtpulpfecdec_invalid_recovered_pt_mismatch);
   tcase_add_test (tc_chain, rtpulpfecdec_fecstorage_gives_no_buffers);
+
+  tcase_add_loop_test (tc_chain, rtpulpfec_benchmark, 0,
+      G_N_ELEMENTS (bench_fec_percentage));
+
   return s;
 }
 
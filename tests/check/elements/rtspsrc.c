@@ -0,0 +1,679 @@
+/* GStreamer RTSP source unit tests
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include <gst/check/gstcheck.h>
+#include <gst/app/gstappsink.h>
+#include <gst/rtp/gstrtpbuffer.h>
+#include <gst/rtsp/rtsp.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#define TEST_N_STREAMS 3
+#define TEST_N_PACKETS 20
+#define TEST_PAYLOAD_SIZE 160
+#define TEST_SSRC 0x12345600
+
+/* A minimal RTSP server, just enough for rtspsrc to set up TEST_N_STREAMS
+ * audio streams over UDP and to play them. Each connection is handled in its
+ * own thread and the server counts the requests it got. In interleaved
+ * mode, the streams go over TCP and the server sends TEST_N_PACKETS packets
+ * for each stream after the PLAY response. */
+typedef struct
+{
+  GSocketListener *listener;
+  GCancellable *cancellable;
+  GThread *thread;
+  guint16 port;
+
+  /* ask for basic authentication */
+  gboolean require_auth;
+  /* with require_auth, only accept this password of "user" if set */
+  const gchar *password;
+  /* close the first connection when SETUP requests are pipelined */
+  gboolean drop_pipelined_setup;
+  /* send the data interleaved in the RTSP connection */
+  gboolean interleaved;
+
+  GMutex lock;
+  GCond cond;
+  GList *conn_threads;
+  guint n_connections;
+  guint n_setup;
+  guint n_pipelined_setup;
+  guint n_play;
+  guint n_unauthorized;
+} TestServer;
+
+typedef struct
+{
+  TestServer *server;
+  GstRTSPConnection *conn;
+  guint index;
+} TestServerConn;
+
+static gchar *
+test_server_make_sdp (void)
+{
+  GString *sdp;
+  guint i;
+
+  sdp = g_string_new ("v=0\r\n"
+      "o=- 1 1 IN IP4 127.0.0.1\r\n"
+      "s=test\r\n" "c=IN IP4 127.0.0.1\r\n" "t=0 0\r\n" "a=control:*\r\n");
+  for (i = 0; i < TEST_N_STREAMS; i++)
+    g_string_append_printf (sdp, "m=audio 0 RTP/AVP 96\r\n"
+        "a=rtpmap:96 L16/8000/1\r\n" "a=control:stream=%u\r\n", i);
+
+  return g_string_free (sdp, FALSE);
+}
+
+/* Sends TEST_N_PACKETS RTP packets for each stream, alternating between
+ * the streams, in two writes that split a packet in the middle */
+static void
+test_server_send_interleaved (TestServerConn * tconn)
+{
+  GByteArray *data = g_byte_array_new ();
+  guint i, stream;
+  gsize split;
+
+  for (i = 0; i < TEST_N_PACKETS; i++) {
+    for (stream = 0; stream < TEST_N_STREAMS; stream++) {
+      GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+      GstBuffer *buf;
+      GstMapInfo map;
+      guint8 header[4];
+
+      buf = gst_rtp_buffer_new_allocate (TEST_PAYLOAD_SIZE, 0, 0);
+      gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp);
+      gst_rtp_buffer_set_payload_type (&rtp, 96);
+      gst_rtp_buffer_set_ssrc (&rtp, TEST_SSRC + stream);
+      gst_rtp_buffer_set_seq (&rtp, i);
+      gst_rtp_buffer_set_timestamp (&rtp, i * TEST_PAYLOAD_SIZE / 2);
+      memset (gst_rtp_buffer_get_payload (&rtp), i, TEST_PAYLOAD_SIZE);
+      gst_rtp_buffer_unmap (&rtp);
+
+      /* the RTP channel of the stream */
+      gst_buffer_map (buf, &map, GST_MAP_READ);
+      header[0] = '$';
+      header[1] = 2 * stream;
+      GST_WRITE_UINT16_BE (header + 2, map.size);
+      g_byte_array_append (data, header, sizeof (header));
+      g_byte_array_append (data, map.data, map.size);
+      gst_buffer_unmap (buf, &map);
+      gst_buffer_unref (buf);
+    }
+  }
+
+  /* the client gets the first half and a partial packet first */
+  split = data->len / 2 + TEST_PAYLOAD_SIZE / 2;
+  fail_unless_equals_int (gst_rtsp_connection_write_usec (tconn->conn,
+          data->data, split, G_USEC_PER_SEC), GST_RTSP_OK);
+  g_usleep (G_USEC_PER_SEC / 10);
+  fail_unless_equals_int (gst_rtsp_connection_write_usec (tconn->conn,
+          data->data + split, data->len - split, G_USEC_PER_SEC), GST_RTSP_OK);
+
+  g_byte_array_unref (data);
+}
+
+static gboolean
+test_server_check_auth (TestServer * server, GstRTSPMessage * request)
+{
+  gchar *header, *credentials, *expected;
+  gboolean ret;
+
+  if (gst_rtsp_message_get_header (request, GST_RTSP_HDR_AUTHORIZATION,
+          &header, 0) != GST_RTSP_OK)
+    return FALSE;
+
+  if (server->password == NULL)
+    return TRUE;
+
+  credentials = g_strdup_printf ("user:%s", server->password);
+  expected = g_base64_encode ((const guchar *) credentials,
+      strlen (credentials));
+  ret = g_str_has_prefix (header, "Basic ")
+      && strcmp (header + strlen ("Basic "), expected) == 0;
+  g_free (expected);
+  g_free (credentials);
+
+  return ret;
+}
+
+/* Returns FALSE when the connection has to be closed */
+static gboolean
+test_server_handle_request (TestServerConn * tconn, GstRTSPMessage * request)
+{
+  TestServer *server = tconn->server;
+  GstRTSPMessage response = { 0, };
+  GstRTSPMessage next = { 0, };
+  GstRTSPMethod method;
+  const gchar *uri;
+  gchar *header;
+  gboolean pipelined = FALSE;
+  gboolean send_data = FALSE;
+  gboolean ret = TRUE;
+
+  /* RTCP from the client in interleaved mode */
+  if (gst_rtsp_message_get_type (request) == GST_RTSP_MESSAGE_DATA)
+    return TRUE;
+
+  fail_unless_equals_int (gst_rtsp_message_parse_request (request, &method,
+          &uri, NULL), GST_RTSP_OK);
+
+  if (server->require_auth && !test_server_check_auth (server, request)) {
+    gst_rtsp_message_init_response (&response, GST_RTSP_STS_UNAUTHORIZED,
+        NULL, request);
+    gst_rtsp_message_add_header (&response, GST_RTSP_HDR_WWW_AUTHENTICATE,
+        "Basic realm=\"test\"");
+
+    g_mutex_lock (&server->lock);
+    server->n_unauthorized++;
+    g_mutex_unlock (&server->lock);
+    goto send;
+  }
+
+  gst_rtsp_message_init_response (&response, GST_RTSP_STS_OK, NULL, request);
+
+  switch (method) {
+    case GST_RTSP_OPTIONS:
+      gst_rtsp_message_add_header (&response, GST_RTSP_HDR_PUBLIC,
+          "OPTIONS, DESCRIBE, SETUP, PLAY, PAUSE, TEARDOWN, GET_PARAMETER");
+      break;
+    case GST_RTSP_DESCRIBE:
+    {
+      gchar *sdp = test_server_make_sdp ();
+
+      gst_rtsp_message_take_header (&response, GST_RTSP_HDR_CONTENT_BASE,
+          g_strdup_printf ("rtsp://127.0.0.1:%u/test/", server->port));
+      gst_rtsp_message_add_header (&response, GST_RTSP_HDR_CONTENT_TYPE,
+          "application/sdp");
+      gst_rtsp_message_take_body (&response, (guint8 *) sdp, strlen (sdp));
+      break;
+    }
+    case GST_RTSP_SETUP:
+    {
+      guint n_setup;
+
+      fail_unless_equals_int (gst_rtsp_message_get_header (request,
+              GST_RTSP_HDR_TRANSPORT, &header, 0), GST_RTSP_OK);
+      if (server->interleaved)
+        gst_rtsp_message_add_header (&response, GST_RTSP_HDR_TRANSPORT,
+            header);
+      else
+        gst_rtsp_message_take_header (&response, GST_RTSP_HDR_TRANSPORT,
+            g_strdup_printf ("%s;server_port=50000-50001", header));
+      if (gst_rtsp_message_get_header (request, GST_RTSP_HDR_SESSION,
+              &header, 0) != GST_RTSP_OK)
+        gst_rtsp_message_add_header (&response, GST_RTSP_HDR_SESSION,
+            "12345678;timeout=60");
+
+      g_mutex_lock (&server->lock);
+      n_setup = server->n_setup++;
+      g_mutex_unlock (&server->lock);
+
+      /* once the session exists, see if the next request comes without
+       * waiting for this response */
+      if (n_setup > 0 && gst_rtsp_connection_receive_usec (tconn->conn,
+              &next, G_USEC_PER_SEC) == GST_RTSP_OK) {
+        pipelined = TRUE;
+
+        g_mutex_lock (&server->lock);
+        server->n_pipelined_setup++;
+        g_mutex_unlock (&server->lock);
+
+        if (server->drop_pipelined_setup && tconn->index == 0) {
+          ret = FALSE;
+          goto done;
+        }
+      }
+      break;
+    }
+    case GST_RTSP_PLAY:
+      send_data = server->interleaved;
+      g_mutex_lock (&server->lock);
+      server->n_play++;
+      g_cond_broadcast (&server->cond);
+      g_mutex_unlock (&server->lock);
+      break;
+    default:
+      break;
+  }
+
+send:
+  fail_unless_equals_int (gst_rtsp_connection_send_usec (tconn->conn,
+          &response, G_USEC_PER_SEC), GST_RTSP_OK);
+  if (send_data)
+    test_server_send_interleaved (tconn);
+  if (pipelined)
+    ret = test_server_handle_request (tconn, &next);
+
+done:
+  gst_rtsp_message_unset (&next);
+  gst_rtsp_message_unset (&response);
+
+  return ret;
+}
+
+static gpointer
+test_server_conn_func (TestServerConn * tconn)
+{
+  GstRTSPMessage request = { 0, };
+
+  /* until the client closes the connection */
+  while (gst_rtsp_connection_receive_usec (tconn->conn, &request,
+          0) == GST_RTSP_OK) {
+    gboolean keep = test_server_handle_request (tconn, &request);
+
+    gst_rtsp_message_unset (&request);
+    if (!keep)
+      break;
+  }
+  gst_rtsp_message_unset (&request);
+
+  gst_rtsp_connection_free (tconn->conn);
+  g_free (tconn);
+
+  return NULL;
+}
+
+static gpointer
+test_server_accept_func (TestServer * server)
+{
+  GSocket *socket;
+
+  while ((socket = g_socket_listener_accept_socket (server->listener, NULL,
+              server->cancellable, NULL))) {
+    TestServerConn *tconn = g_new0 (TestServerConn, 1);
+    GThread *thread;
+
+    tconn->server = server;
+    fail_unless_equals_int (gst_rtsp_connection_create_from_socket (socket,
+            "127.0.0.1", 0, NULL, &tconn->conn), GST_RTSP_OK);
+    g_object_unref (socket);
+
+    g_mutex_lock (&server->lock);
+    tconn->index = server->n_connections++;
+    thread = g_thread_new ("rtsp-conn", (GThreadFunc) test_server_conn_func,
+        tconn);
+    server->conn_threads = g_list_prepend (server->conn_threads, thread);
+    g_mutex_unlock (&server->lock);
+  }
+
+  return NULL;
+}
+
+static TestServer *
+test_server_new (void)
+{
+  TestServer *server = g_new0 (TestServer, 1);
+  GInetAddress *addr;
+  GSocketAddress *sa, *effective = NULL;
+
+  addr = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  sa = g_inet_socket_address_new (addr, 0);
+  server->listener = g_socket_listener_new ();
+  fail_unless (g_socket_listener_add_address (server->listener, sa,
+          G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, NULL, &effective,
+          NULL));
+  server->port =
+      g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (effective));
+  g_object_unref (effective);
+  g_object_unref (sa);
+  g_object_unref (addr);
+
+  server->cancellable = g_cancellable_new ();
+  g_mutex_init (&server->lock);
+  g_cond_init (&server->cond);
+
+  return server;
+}
+
+static void
+test_server_start (TestServer * server)
+{
+  server->thread = g_thread_new ("rtsp-server",
+      (GThreadFunc) test_server_accept_func, server);
+}
+
+/* The clients must have closed their connections */
+static void
+test_server_free (TestServer * server)
+{
+  g_cancellable_cancel (server->cancellable);
+  g_thread_join (server->thread);
+  g_socket_listener_close (server->listener);
+  g_list_free_full (server->conn_threads, (GDestroyNotify) g_thread_join);
+
+  g_object_unref (server->listener);
+  g_object_unref (server->cancellable);
+  g_mutex_clear (&server->lock);
+  g_cond_clear (&server->cond);
+  g_free (server);
+}
+
+static gboolean
+test_server_wait_play (TestServer * server, guint n_play)
+{
+  gint64 end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_SECOND;
+  gboolean ret;
+
+  g_mutex_lock (&server->lock);
+  while (server->n_play < n_play) {
+    if (!g_cond_wait_until (&server->cond, &server->lock, end_time))
+      break;
+  }
+  ret = server->n_play >= n_play;
+  g_mutex_unlock (&server->lock);
+
+  return ret;
+}
+
+static GstElement *
+create_rtspsrc_pipeline (TestServer * server, GstElement ** rtspsrc)
+{
+  GstElement *pipeline;
+  gchar *location;
+
+  pipeline = gst_pipeline_new (NULL);
+  *rtspsrc = gst_element_factory_make ("rtspsrc", NULL);
+  fail_unless (*rtspsrc != NULL);
+
+  location = g_strdup_printf ("rtsp://127.0.0.1:%u/test", server->port);
+  /* no UDP timeout, so that it never retries over TCP */
+  g_object_set (*rtspsrc, "location", location, "timeout", (guint64) 0,
+      NULL);
+  gst_util_set_object_arg (G_OBJECT (*rtspsrc), "protocols", "udp");
+  g_free (location);
+
+  gst_bin_add (GST_BIN (pipeline), *rtspsrc);
+
+  return pipeline;
+}
+
+/* Plays @pipeline until the server got @n_play PLAY requests in total */
+static void
+play_and_check_no_error (GstElement * pipeline, TestServer * server,
+    guint n_play)
+{
+  GstMessage *msg;
+  GstBus *bus;
+
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  fail_unless (test_server_wait_play (server, n_play));
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  fail_unless (msg == NULL);
+  gst_object_unref (bus);
+}
+
+GST_START_TEST (test_rtspsrc_pipelined_setup)
+{
+  TestServer *server = test_server_new ();
+  GstElement *pipeline, *rtspsrc;
+
+  test_server_start (server);
+
+  pipeline = create_rtspsrc_pipeline (server, &rtspsrc);
+  g_object_set (rtspsrc, "pipelined-setup", TRUE, NULL);
+  play_and_check_no_error (pipeline, server, 1);
+
+  /* the first SETUP is done on its own, the other ones back-to-back */
+  fail_unless_equals_int (server->n_setup, TEST_N_STREAMS);
+  fail_unless_equals_int (server->n_pipelined_setup, 1);
+  fail_unless_equals_int (server->n_connections, 1);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  test_server_free (server);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtspsrc_pipelined_setup_connection_closed)
+{
+  TestServer *server = test_server_new ();
+  GstElement *pipeline, *rtspsrc;
+
+  server->drop_pipelined_setup = TRUE;
+  test_server_start (server);
+
+  pipeline = create_rtspsrc_pipeline (server, &rtspsrc);
+  g_object_set (rtspsrc, "pipelined-setup", TRUE, NULL);
+  play_and_check_no_error (pipeline, server, 1);
+
+  /* the streams that got no response were set up again one by one on a new
+   * connection */
+  fail_unless_equals_int (server->n_setup, 2 * TEST_N_STREAMS - 1);
+  fail_unless_equals_int (server->n_pipelined_setup, 1);
+  fail_unless_equals_int (server->n_connections, 2);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  test_server_free (server);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtspsrc_share_auth)
+{
+  TestServer *server = test_server_new ();
+  GstElement *pipelines[2], *rtspsrc;
+  guint i;
+
+  server->require_auth = TRUE;
+  test_server_start (server);
+
+  for (i = 0; i < G_N_ELEMENTS (pipelines); i++) {
+    pipelines[i] = create_rtspsrc_pipeline (server, &rtspsrc);
+    g_object_set (rtspsrc, "share-auth", TRUE, "user-id", "user", "user-pw",
+        "password", NULL);
+    play_and_check_no_error (pipelines[i], server, i + 1);
+  }
+
+  /* the second instance authenticated from its first request */
+  fail_unless_equals_int (server->n_unauthorized, 1);
+
+  for (i = 0; i < G_N_ELEMENTS (pipelines); i++) {
+    gst_element_set_state (pipelines[i], GST_STATE_NULL);
+    gst_object_unref (pipelines[i]);
+  }
+  test_server_free (server);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtspsrc_share_auth_rejected)
+{
+  TestServer *server = test_server_new ();
+  GstElement *pipeline, *rtspsrc;
+  GstMessage *msg;
+  guint n_unauthorized;
+  GstBus *bus;
+
+  server->require_auth = TRUE;
+  server->password = "password";
+  test_server_start (server);
+
+  pipeline = create_rtspsrc_pipeline (server, &rtspsrc);
+  g_object_set (rtspsrc, "share-auth", TRUE, "user-id", "user", "user-pw",
+      "password", NULL);
+  play_and_check_no_error (pipeline, server, 1);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  /* the shared authentication is rejected with a wrong password */
+  pipeline = create_rtspsrc_pipeline (server, &rtspsrc);
+  g_object_set (rtspsrc, "share-auth", TRUE, "user-id", "user", "user-pw",
+      "wrong", NULL);
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, 10 * GST_SECOND, GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  /* so it is not shared anymore, and neither is what failed */
+  g_mutex_lock (&server->lock);
+  n_unauthorized = server->n_unauthorized;
+  g_mutex_unlock (&server->lock);
+
+  pipeline = create_rtspsrc_pipeline (server, &rtspsrc);
+  g_object_set (rtspsrc, "share-auth", TRUE, "user-id", "user", "user-pw",
+      "password", NULL);
+  play_and_check_no_error (pipeline, server, 2);
+  fail_unless_equals_int (server->n_unauthorized, n_unauthorized + 1);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+  test_server_free (server);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GstElement *pipeline;
+  GMutex lock;
+  GCond cond;
+  GstElement *sinks[TEST_N_STREAMS];
+} InterleavedTest;
+
+static void
+on_pad_added (GstElement * rtspsrc, GstPad * pad, InterleavedTest * test)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+  guint64 stream;
+
+  fail_unless (g_str_has_prefix (GST_PAD_NAME (pad), "stream_"));
+  stream = g_ascii_strtoull (GST_PAD_NAME (pad) + 7, NULL, 10);
+  fail_unless (stream < TEST_N_STREAMS);
+
+  sink = gst_element_factory_make ("appsink", NULL);
+  fail_unless (sink != NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add (GST_BIN (test->pipeline), sink);
+  gst_element_sync_state_with_parent (sink);
+
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless_equals_int (gst_pad_link (pad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+
+  g_mutex_lock (&test->lock);
+  test->sinks[stream] = gst_object_ref (sink);
+  g_cond_broadcast (&test->cond);
+  g_mutex_unlock (&test->lock);
+}
+
+static GstElement *
+wait_stream_sink (InterleavedTest * test, guint stream)
+{
+  gint64 end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_SECOND;
+  GstElement *sink;
+
+  g_mutex_lock (&test->lock);
+  while (test->sinks[stream] == NULL) {
+    if (!g_cond_wait_until (&test->cond, &test->lock, end_time))
+      break;
+  }
+  sink = test->sinks[stream];
+  g_mutex_unlock (&test->lock);
+
+  fail_unless (sink != NULL, "no pad for stream %u", stream);
+
+  return sink;
+}
+
+GST_START_TEST (test_rtspsrc_interleaved)
+{
+  TestServer *server = test_server_new ();
+  InterleavedTest test = { NULL, };
+  GstElement *rtspsrc;
+  guint i, stream;
+
+  server->interleaved = TRUE;
+  test_server_start (server);
+
+  g_mutex_init (&test.lock);
+  g_cond_init (&test.cond);
+  test.pipeline = create_rtspsrc_pipeline (server, &rtspsrc);
+  gst_util_set_object_arg (G_OBJECT (rtspsrc), "protocols", "tcp");
+  g_object_set (rtspsrc, "latency", 0, NULL);
+  g_signal_connect (rtspsrc, "pad-added", G_CALLBACK (on_pad_added), &test);
+  play_and_check_no_error (test.pipeline, server, 1);
+
+  /* all packets come out in order on the pad of their stream, whether or
+   * not they were split over reads */
+  for (stream = 0; stream < TEST_N_STREAMS; stream++) {
+    GstElement *sink = wait_stream_sink (&test, stream);
+
+    for (i = 0; i < TEST_N_PACKETS; i++) {
+      GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+      GstSample *sample;
+      guint8 *payload;
+
+      sample = gst_app_sink_try_pull_sample (GST_APP_SINK (sink),
+          10 * GST_SECOND);
+      fail_unless (sample != NULL, "stream %u: no packet %u", stream, i);
+      fail_unless (gst_rtp_buffer_map (gst_sample_get_buffer (sample),
+              GST_MAP_READ, &rtp));
+      fail_unless_equals_int (gst_rtp_buffer_get_ssrc (&rtp),
+          TEST_SSRC + stream);
+      fail_unless_equals_int (gst_rtp_buffer_get_seq (&rtp), i);
+      fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp),
+          TEST_PAYLOAD_SIZE);
+      payload = gst_rtp_buffer_get_payload (&rtp);
+      fail_unless_equals_int (payload[0], i);
+      fail_unless_equals_int (payload[TEST_PAYLOAD_SIZE - 1], i);
+      gst_rtp_buffer_unmap (&rtp);
+      gst_sample_unref (sample);
+    }
+  }
+
+  gst_element_set_state (test.pipeline, GST_STATE_NULL);
+  for (stream = 0; stream < TEST_N_STREAMS; stream++)
+    gst_object_unref (test.sinks[stream]);
+  gst_object_unref (test.pipeline);
+  g_mutex_clear (&test.lock);
+  g_cond_clear (&test.cond);
+  test_server_free (server);
+}
+
+GST_END_TEST;
+
+static Suite *
+rtspsrc_suite (void)
+{
+  Suite *s = suite_create ("rtspsrc");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_rtspsrc_pipelined_setup);
+  tcase_add_test (tc_chain, test_rtspsrc_pipelined_setup_connection_closed);
+  tcase_add_test (tc_chain, test_rtspsrc_share_auth);
+  tcase_add_test (tc_chain, test_rtspsrc_share_auth_rejected);
+  tcase_add_test (tc_chain, test_rtspsrc_interleaved);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rtspsrc)
@@ -21,6 +21,7 @@
 #include <gst/base/gstbasesink.h>
 #include <gio/gio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -244,6 +245,269 @@ GST_START_TEST (test_udpsink_dscp)
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsink_segmentation_offload)
+{
+  static const gsize sizes[] = { 1000, 1000, 1000, 1000, 500, 1200, 700 };
+  GInetAddress *ia;
+  GSocketAddress *sa;
+  GstSegment segment;
+  GstElement *udpsink;
+  GstBufferList *list;
+  GSocket *socket;
+  GstPad *srcpad;
+  gchar data[2000];
+  gint port;
+  guint i;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, NULL);
+  fail_unless (socket != NULL);
+  g_socket_set_timeout (socket, 5);
+
+  ia = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  sa = g_inet_socket_address_new (ia, 0);
+  fail_unless (g_socket_bind (socket, sa, TRUE, NULL));
+  g_object_unref (sa);
+  g_object_unref (ia);
+
+  sa = g_socket_get_local_address (socket, NULL);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (sa));
+  g_object_unref (sa);
+
+  udpsink = gst_check_setup_element ("udpsink");
+  g_object_set (udpsink, "host", "127.0.0.1", "port", port,
+      "segmentation-offload", TRUE, NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (udpsink, &srctemplate, "sink");
+
+  gst_element_set_state (udpsink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, sizes[i], NULL);
+
+    gst_buffer_memset (buf, 0, i, sizes[i]);
+    gst_buffer_list_add (list, buf);
+  }
+
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  /* whether segmented by the kernel or not, every buffer must arrive as a
+   * separate datagram */
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    gssize len;
+
+    len = g_socket_receive (socket, data, sizeof (data), NULL, NULL);
+    fail_unless_equals_int (len, sizes[i]);
+    fail_unless_equals_int (data[0], i);
+    fail_unless_equals_int (data[len - 1], i);
+  }
+
+  gst_check_teardown_pad_by_name (udpsink, "sink");
+  gst_check_teardown_element (udpsink);
+
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
+static void
+segmentation_disabled_log_func (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function, gint line,
+    GObject * object, GstDebugMessage * message, gpointer user_data)
+{
+  const gchar *msg = gst_debug_message_get (message);
+
+  if (msg && strstr (msg, "segmentation offload failed"))
+    g_atomic_int_set ((gint *) user_data, TRUE);
+}
+
+GST_START_TEST (test_multiudpsink_segmentation_client_error)
+{
+  static const gsize sizes[] = { 1000, 1000, 1000, 1000 };
+  GInetAddress *ia;
+  GSocketAddress *sa;
+  GstSegment segment;
+  GstElement *sink;
+  GstBufferList *list;
+  GSocket *socket;
+  GstPad *srcpad;
+  gchar data[2000];
+  gchar *clients;
+  gint disabled = FALSE;
+  gint port;
+  guint i, n;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, NULL);
+  fail_unless (socket != NULL);
+  g_socket_set_timeout (socket, 5);
+
+  ia = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  sa = g_inet_socket_address_new (ia, 0);
+  fail_unless (g_socket_bind (socket, sa, TRUE, NULL));
+  g_object_unref (sa);
+  g_object_unref (ia);
+
+  sa = g_socket_get_local_address (socket, NULL);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (sa));
+  g_object_unref (sa);
+
+  gst_debug_add_log_function (segmentation_disabled_log_func, &disabled,
+      NULL);
+  gst_debug_set_threshold_for_name ("multiudpsink", GST_LEVEL_WARNING);
+
+  /* the kernel refuses anything sent to port 0, segmented or not */
+  sink = gst_check_setup_element ("multiudpsink");
+  clients = g_strdup_printf ("127.0.0.1:0,127.0.0.1:%d", port);
+  g_object_set (sink, "clients", clients, "segmentation-offload", TRUE, NULL);
+  g_free (clients);
+
+  srcpad = gst_check_setup_src_pad_by_name (sink, &srctemplate, "sink");
+
+  gst_element_set_state (sink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  for (n = 0; n < 2; n++) {
+    list = gst_buffer_list_new ();
+    for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+      GstBuffer *buf = gst_buffer_new_allocate (NULL, sizes[i], NULL);
+
+      gst_buffer_memset (buf, 0, i, sizes[i]);
+      gst_buffer_list_add (list, buf);
+    }
+
+    fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+    /* the other client gets everything */
+    for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+      gssize len;
+
+      len = g_socket_receive (socket, data, sizeof (data), NULL, NULL);
+      fail_unless_equals_int (len, sizes[i]);
+      fail_unless_equals_int (data[0], i);
+    }
+  }
+
+  /* and the error of one client did not disable the segmentation */
+  fail_if (g_atomic_int_get (&disabled));
+
+  gst_check_teardown_pad_by_name (sink, "sink");
+  gst_check_teardown_element (sink);
+
+  gst_debug_unset_threshold_for_name ("multiudpsink");
+  gst_debug_remove_log_function (segmentation_disabled_log_func);
+
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  GstElement *sink;
+  gint stop;
+  guint num_changes;
+} ClientChurnData;
+
+static gpointer
+client_churn_thread (ClientChurnData * data)
+{
+  while (!g_atomic_int_get (&data->stop)) {
+    gint port = 51000 + (data->num_changes % 100);
+
+    g_signal_emit_by_name (data->sink, "add", "127.0.0.1", port, NULL);
+    g_signal_emit_by_name (data->sink, "remove", "127.0.0.1", port, NULL);
+    data->num_changes++;
+  }
+
+  return NULL;
+}
+
+#define BENCH_NUM_CLIENTS 1000
+#define BENCH_NUM_LISTS 20
+#define BENCH_LIST_SIZE 10
+
+/* Measures render throughput with many clients while the client list is
+ * changed concurrently from another thread */
+GST_START_TEST (test_multiudpsink_many_clients_benchmark)
+{
+  ClientChurnData churn = { NULL, 0, 0 };
+  GstStructure *stats;
+  GstSegment segment;
+  GstElement *sink;
+  GThread *thread;
+  GstPad *srcpad;
+  guint64 packets_sent = 0;
+  gint64 start, elapsed;
+  guint i, j;
+
+  sink = gst_check_setup_element ("multiudpsink");
+  for (i = 0; i < BENCH_NUM_CLIENTS; i++)
+    g_signal_emit_by_name (sink, "add", "127.0.0.1", 50000 + i, NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (sink, &srctemplate, "sink");
+
+  gst_element_set_state (sink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  churn.sink = sink;
+  thread = g_thread_new ("client-churn", (GThreadFunc) client_churn_thread,
+      &churn);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < BENCH_NUM_LISTS; i++) {
+    GstBufferList *list = gst_buffer_list_new_sized (BENCH_LIST_SIZE);
+
+    for (j = 0; j < BENCH_LIST_SIZE; j++) {
+      GstBuffer *buf = gst_buffer_new_allocate (NULL,
+          RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE, NULL);
+
+      gst_buffer_memset (buf, 0, 0, RTP_HEADER_SIZE + RTP_PAYLOAD_SIZE);
+      gst_buffer_list_add (list, buf);
+    }
+    fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+  }
+  elapsed = g_get_monotonic_time () - start;
+
+  g_atomic_int_set (&churn.stop, 1);
+  g_thread_join (thread);
+
+  GST_INFO ("sent %u packets to %u clients in %" G_GINT64_FORMAT " us "
+      "(%.0f packets/s) with %u concurrent client changes",
+      BENCH_NUM_LISTS * BENCH_LIST_SIZE, BENCH_NUM_CLIENTS, elapsed,
+      (gdouble) BENCH_NUM_LISTS * BENCH_LIST_SIZE * BENCH_NUM_CLIENTS *
+      G_USEC_PER_SEC / MAX (elapsed, 1), churn.num_changes);
+
+  /* the static clients got every single packet */
+  g_signal_emit_by_name (sink, "get-stats", "127.0.0.1", 50000, &stats);
+  fail_unless (gst_structure_get_uint64 (stats, "packets-sent",
+          &packets_sent));
+  fail_unless_equals_uint64 (packets_sent, BENCH_NUM_LISTS * BENCH_LIST_SIZE);
+  gst_structure_free (stats);
+
+  gst_check_teardown_pad_by_name (sink, "sink");
+  gst_check_teardown_element (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsink_suite (void)
 {
@@ -256,6 +520,9 @@ udpsink_suite (void)
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
   tcase_add_test (tc_chain, test_udpsink_dscp);
+  tcase_add_test (tc_chain, test_udpsink_segmentation_offload);
+  tcase_add_test (tc_chain, test_multiudpsink_segmentation_client_error);
+  tcase_add_test (tc_chain, test_multiudpsink_many_clients_benchmark);
 
   return s;
 }
@@ -19,6 +19,7 @@
 #include <gst/check/gstcheck.h>
 #include <gio/gio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -26,8 +27,9 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_STATIC_CAPS_ANY);
 
 static gboolean
-udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
-    GstPad ** sinkpad, GSocketAddress ** sa)
+udpsrc_setup_full (GstElement ** udpsrc, GSocket ** socket,
+    GstPad ** sinkpad, GSocketAddress ** sa, guint batch_size,
+    gboolean kernel_rx_info)
 {
   GInetAddress *ia;
   int port = 0;
@@ -35,7 +37,8 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
 
   *udpsrc = gst_check_setup_element ("udpsrc");
   fail_unless (*udpsrc != NULL);
-  g_object_set (*udpsrc, "port", 0, NULL);
+  g_object_set (*udpsrc, "port", 0, "batch-size", batch_size,
+      "kernel-rx-info", kernel_rx_info, NULL);
 
   *sinkpad = gst_check_setup_sink_pad_by_name (*udpsrc, &sinktemplate, "src");
   fail_unless (*sinkpad != NULL);
@@ -63,6 +66,13 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
   return TRUE;
 }
 
+static gboolean
+udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
+    GstPad ** sinkpad, GSocketAddress ** sa)
+{
+  return udpsrc_setup_full (udpsrc, socket, sinkpad, sa, 1, FALSE);
+}
+
 GST_START_TEST (test_udpsrc_empty_packet)
 {
   GSocketAddress *sa = NULL;
@@ -247,6 +257,241 @@ send_failure:
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsrc_batch)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  GstBuffer *buf;
+  GstMapInfo map;
+  guint8 data[3000];
+  gssize sent;
+  GError *err = NULL;
+  int i, len = 0;
+
+  if (!udpsrc_setup_full (&udpsrc, &socket, &sinkpad, &sa, 8, FALSE))
+    goto no_socket;
+
+  /* more packets than fit into one batch, including one bigger than the
+   * mtu */
+  for (i = 0; i < 20; i++) {
+    gsize size = (i == 5) ? 3000 : 100 + i;
+
+    memset (data, i, size);
+    if ((sent = g_socket_send_to (socket, sa, (gchar *) data, size, NULL,
+                &err)) == -1)
+      goto send_failure;
+    fail_unless_equals_int (sent, size);
+  }
+
+  GST_INFO ("sent some packets");
+
+  g_mutex_lock (&check_mutex);
+  len = g_list_length (buffers);
+  while (len < 20) {
+    g_cond_wait (&check_cond, &check_mutex);
+    len = g_list_length (buffers);
+    GST_INFO ("%u buffers", len);
+  }
+
+  for (i = 0; i < 20; i++) {
+    gsize size = (i == 5) ? 3000 : 100 + i;
+
+    buf = GST_BUFFER (g_list_nth_data (buffers, i));
+    fail_unless_equals_int (gst_buffer_get_size (buf), size);
+    fail_unless (GST_BUFFER_DTS_IS_VALID (buf));
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.data[0], i);
+    fail_unless_equals_int (map.data[size - 1], i);
+    gst_buffer_unmap (buf, &map);
+  }
+
+  g_list_foreach (buffers, (GFunc) gst_buffer_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  g_mutex_unlock (&check_mutex);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_object_unref (socket);
+  g_object_unref (sa);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_udpsrc_batch_partial)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  GstBuffer *buf;
+  GstMapInfo map;
+  guint8 data[3000];
+  gssize sent;
+  GError *err = NULL;
+  int i, n = 0, round, len = 0;
+
+  if (!udpsrc_setup_full (&udpsrc, &socket, &sinkpad, &sa, 8, FALSE))
+    goto no_socket;
+
+  /* batches that are only partially filled, so that slots which did not
+   * receive anything are used for a later batch, one packet bigger than
+   * the mtu */
+  for (round = 0; round < 10; round++) {
+    for (i = 0; i < round % 3 + 1; i++, n++) {
+      gsize size = (n == 8) ? 3000 : 100 + n;
+
+      memset (data, n, size);
+      if ((sent = g_socket_send_to (socket, sa, (gchar *) data, size, NULL,
+                  &err)) == -1)
+        goto send_failure;
+      fail_unless_equals_int (sent, size);
+    }
+
+    g_mutex_lock (&check_mutex);
+    len = g_list_length (buffers);
+    while (len < n) {
+      g_cond_wait (&check_cond, &check_mutex);
+      len = g_list_length (buffers);
+      GST_INFO ("%u buffers", len);
+    }
+    g_mutex_unlock (&check_mutex);
+  }
+
+  g_mutex_lock (&check_mutex);
+  fail_unless_equals_int (g_list_length (buffers), n);
+  for (i = 0; i < n; i++) {
+    gsize size = (i == 8) ? 3000 : 100 + i;
+
+    buf = GST_BUFFER (g_list_nth_data (buffers, i));
+    fail_unless_equals_int (gst_buffer_get_size (buf), size);
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.data[0], i);
+    fail_unless_equals_int (map.data[size - 1], i);
+    gst_buffer_unmap (buf, &map);
+  }
+
+  g_list_foreach (buffers, (GFunc) gst_buffer_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  g_mutex_unlock (&check_mutex);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_object_unref (socket);
+  g_object_unref (sa);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_udpsrc_kernel_rx_info)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  GstStructure *stats;
+  guint64 packets_received = 0, kernel_drops = G_MAXUINT64;
+  gchar data[100] = { 0, };
+  gssize sent;
+  GError *err = NULL;
+  int i, len = 0;
+
+  if (!udpsrc_setup_full (&udpsrc, &socket, &sinkpad, &sa, 1, TRUE))
+    goto no_socket;
+
+  for (i = 0; i < 5; i++) {
+    if ((sent = g_socket_send_to (socket, sa, data, sizeof (data), NULL,
+                &err)) == -1)
+      goto send_failure;
+    fail_unless_equals_int (sent, sizeof (data));
+  }
+
+  g_mutex_lock (&check_mutex);
+  len = g_list_length (buffers);
+  while (len < 5) {
+    g_cond_wait (&check_cond, &check_mutex);
+    len = g_list_length (buffers);
+  }
+
+#ifdef __linux__
+  {
+    GstCaps *caps = gst_caps_new_empty_simple ("timestamp/x-unix");
+    GList *l;
+
+    for (l = buffers; l; l = l->next) {
+      GstReferenceTimestampMeta *meta;
+
+      meta = gst_buffer_get_reference_timestamp_meta (GST_BUFFER (l->data),
+          caps);
+      fail_unless (meta != NULL);
+      fail_unless (GST_CLOCK_TIME_IS_VALID (meta->timestamp));
+      fail_unless (meta->timestamp > 0);
+    }
+    gst_caps_unref (caps);
+  }
+#endif
+
+  g_list_foreach (buffers, (GFunc) gst_buffer_unref, NULL);
+  g_list_free (buffers);
+  buffers = NULL;
+
+  g_mutex_unlock (&check_mutex);
+
+  g_object_get (udpsrc, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "packets-received",
+          &packets_received));
+  fail_unless (gst_structure_get_uint64 (stats, "kernel-drops",
+          &kernel_drops));
+  fail_unless_equals_uint64 (packets_received, 5);
+  fail_unless_equals_uint64 (kernel_drops, 0);
+  gst_structure_free (stats);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_object_unref (socket);
+  g_object_unref (sa);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsrc_suite (void)
 {
@@ -256,6 +501,9 @@ udpsrc_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_udpsrc_empty_packet);
   tcase_add_test (tc_chain, test_udpsrc);
+  tcase_add_test (tc_chain, test_udpsrc_batch);
+  tcase_add_test (tc_chain, test_udpsrc_batch_partial);
+  tcase_add_test (tc_chain, test_udpsrc_kernel_rx_info);
   return s;
 }
 